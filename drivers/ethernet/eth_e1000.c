@@ -58,6 +58,7 @@ static const char *e1000_reg_to_string(enum e1000_reg_t r)
 	_(TDLEN);
 	_(TDH);
 	_(TDT);
+	_(RXCSUM);
 	_(RAL);
 	_(RAH);
 	}
@@ -93,6 +94,9 @@ static enum ethernet_hw_caps e1000_caps(const struct device *dev)
 #endif
 #if IS_ENABLED(CONFIG_ETH_E1000_PTP_CLOCK)
 		ETHERNET_PTP |
+#endif
+#if IS_ENABLED(CONFIG_ETH_E1000_CHKSUM_OFFLOAD)
+		ETHERNET_HW_TX_CHKSUM_OFFLOAD |
 #endif
 		ETHERNET_LINK_10BASE_T | ETHERNET_LINK_100BASE_T |
 		ETHERNET_LINK_1000BASE_T;
@@ -107,23 +111,186 @@ static const struct device *e1000_get_ptp_clock(const struct device *dev)
 }
 #endif
 
-static int e1000_tx(struct e1000_dev *dev, void *buf, size_t len)
+#if defined(CONFIG_ETH_E1000_CHKSUM_OFFLOAD)
+static uint32_t chksum_add(uint32_t sum, const uint8_t *data, size_t len)
+{
+	for (; len > 1; len -= 2, data += 2) {
+		sum += sys_get_be16(data);
+	}
+
+	if (len) {
+		sum += data[0] << 8;
+	}
+
+	return sum;
+}
+
+static uint16_t chksum_fold(uint32_t sum)
+{
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+
+	return sum;
+}
+
+/* The stack leaves the IPv4 header, UDP and TCP checksums of the frame
+ * to the device. Describe where they are in a context descriptor, the
+ * UDP or TCP one being seeded with the sum of the pseudo header as the
+ * device sums the segment from its start up to the end of the frame.
+ */
+static bool e1000_tx_ctx_setup(uint8_t *frame, size_t len,
+			       struct e1000_tx_ctx *ctx)
+{
+	size_t off = sizeof(struct net_eth_hdr);
+	uint16_t type = ntohs(((struct net_eth_hdr *)frame)->type);
+	size_t chksum_off;
+	uint16_t l4_len;
+	uint32_t sum;
+	uint8_t proto;
+
+	memset(ctx, 0, sizeof(*ctx));
+	ctx->cmd = TDESC_DEXT;
+
+	if (type == NET_ETH_PTYPE_VLAN) {
+		type = ntohs(((struct net_eth_vlan_hdr *)frame)->type);
+		off = sizeof(struct net_eth_vlan_hdr);
+	}
+
+	if (type == NET_ETH_PTYPE_IP &&
+	    len >= off + sizeof(struct net_ipv4_hdr)) {
+		struct net_ipv4_hdr *ip = (struct net_ipv4_hdr *)(frame + off);
+		size_t hdr_len = (ip->vhl & 0x0f) * 4U;
+
+		ip->chksum = 0U;
+
+		ctx->ipcss = off;
+		ctx->ipcso = off + offsetof(struct net_ipv4_hdr, chksum);
+		ctx->ipcse = off + hdr_len - 1;
+		ctx->cmd |= TDESC_TUCMD_IP;
+
+		/* The payload checksum of a fragment is the one of the
+		 * whole datagram, already computed by the stack.
+		 */
+		if ((ip->offset[0] & 0x3f) || ip->offset[1]) {
+			return true;
+		}
+
+		proto = ip->proto;
+		l4_len = ntohs(ip->len) - hdr_len;
+		sum = chksum_add(0, (uint8_t *)&ip->src,
+				 2 * sizeof(struct in_addr));
+		off += hdr_len;
+	} else if (type == NET_ETH_PTYPE_IPV6 &&
+		   len >= off + sizeof(struct net_ipv6_hdr)) {
+		struct net_ipv6_hdr *ip = (struct net_ipv6_hdr *)(frame + off);
+
+		proto = ip->nexthdr;
+		l4_len = ntohs(ip->len);
+		sum = chksum_add(0, (uint8_t *)&ip->src,
+				 2 * sizeof(struct in6_addr));
+		off += sizeof(struct net_ipv6_hdr);
+
+		while ((proto == NET_IPV6_NEXTHDR_HBHO ||
+			proto == NET_IPV6_NEXTHDR_DESTO ||
+			proto == NET_IPV6_NEXTHDR_ROUTING) && off + 2 <= len) {
+			size_t ext_len = (frame[off + 1] + 1) * 8U;
+
+			proto = frame[off];
+			l4_len -= ext_len;
+			off += ext_len;
+		}
+	} else {
+		return false;
+	}
+
+	if (proto == IPPROTO_UDP) {
+		chksum_off = offsetof(struct net_udp_hdr, chksum);
+	} else if (proto == IPPROTO_TCP) {
+		chksum_off = offsetof(struct net_tcp_hdr, chksum);
+		ctx->cmd |= TDESC_TUCMD_TCP;
+	} else {
+		return ctx->ipcso != 0U;
+	}
+
+	if (off + l4_len > len || l4_len < chksum_off + sizeof(uint16_t)) {
+		return ctx->ipcso != 0U;
+	}
+
+	sum += proto + l4_len;
+
+	if (off + chksum_off > UINT8_MAX) {
+		/* Out of reach of the device, done here */
+		uint16_t chksum = ~chksum_fold(chksum_add(sum, frame + off,
+							  l4_len));
+
+		sys_put_be16(chksum ? chksum : 0xffff,
+			     frame + off + chksum_off);
+
+		return ctx->ipcso != 0U;
+	}
+
+	sys_put_be16(chksum_fold(sum), frame + off + chksum_off);
+
+	ctx->tucss = off;
+	ctx->tucso = off + chksum_off;
+
+	return true;
+}
+#endif /* CONFIG_ETH_E1000_CHKSUM_OFFLOAD */
+
+static volatile union e1000_tx_desc *e1000_tx_next(struct e1000_dev *dev)
+{
+	volatile union e1000_tx_desc *desc = &dev->tx[dev->tx_tail];
+
+	dev->tx_tail = (dev->tx_tail + 1) % E1000_TX_DESC;
+
+	return desc;
+}
+
+static int e1000_tx(struct e1000_dev *dev, void *buf, size_t len,
+		    const struct e1000_tx_ctx *ctx)
 {
+	volatile union e1000_tx_desc *desc;
+
 	hexdump(buf, len, "%zu byte(s)", len);
 
-	dev->tx.addr = POINTER_TO_INT(buf);
-	dev->tx.len = len;
-	dev->tx.cmd = TDESC_EOP | TDESC_RS;
+	if (ctx) {
+		/* The context stays loaded in the device for the next frames */
+		if (memcmp(ctx, &dev->tx_ctx, sizeof(*ctx))) {
+			dev->tx_ctx = *ctx;
 
-	iow32(dev, TDT, 1);
+			desc = e1000_tx_next(dev);
+			desc->ctx = *ctx;
+		}
 
-	while (!(dev->tx.sta)) {
+		desc = e1000_tx_next(dev);
+		desc->data.addr = POINTER_TO_INT(buf);
+		desc->data.cmd = len | TDESC_DTYP_DATA | TDESC_DEXT |
+				 TDESC_DCMD_EOP | TDESC_DCMD_RS;
+		desc->data.popts = (ctx->ipcso ? TDESC_IXSM : 0) |
+				   (ctx->tucso ? TDESC_TXSM : 0);
+		desc->data.special = 0U;
+	} else {
+		desc = e1000_tx_next(dev);
+		desc->legacy.addr = POINTER_TO_INT(buf);
+		desc->legacy.len = len;
+		desc->legacy.cso = 0U;
+		desc->legacy.cmd = TDESC_EOP | TDESC_RS;
+		desc->legacy.css = 0U;
+		desc->legacy.special = 0U;
+	}
+
+	desc->legacy.sta = 0U;
+
+	iow32(dev, TDT, dev->tx_tail);
+
+	while (!(desc->legacy.sta)) {
 		k_yield();
 	}
 
-	LOG_DBG("tx.sta: 0x%02hx", dev->tx.sta);
+	LOG_DBG("tx.sta: 0x%02hx", desc->legacy.sta);
 
-	return (dev->tx.sta & TDESC_STA_DD) ? 0 : -EIO;
+	return (desc->legacy.sta & TDESC_STA_DD) ? 0 : -EIO;
 }
 
 static int e1000_send(const struct device *ddev, struct net_pkt *pkt)
@@ -135,7 +302,15 @@ static int e1000_send(const struct device *ddev, struct net_pkt *pkt)
 		return -EIO;
 	}
 
-	return e1000_tx(dev, dev->txb, len);
+#if defined(CONFIG_ETH_E1000_CHKSUM_OFFLOAD)
+	struct e1000_tx_ctx ctx;
+
+	if (e1000_tx_ctx_setup(dev->txb, len, &ctx)) {
+		return e1000_tx(dev, dev->txb, len, &ctx);
+	}
+#endif
+
+	return e1000_tx(dev, dev->txb, len, NULL);
 }
 
 static struct net_pkt *e1000_rx(struct e1000_dev *dev)
@@ -172,6 +347,18 @@ static struct net_pkt *e1000_rx(struct e1000_dev *dev)
 		LOG_ERR("Out of memory for received frame");
 		net_pkt_unref(pkt);
 		pkt = NULL;
+		goto out;
+	}
+
+	/* The device checks the IPv4 packets only, tell the stack when
+	 * both their header and TCP or UDP checksums are good.
+	 */
+	if (IS_ENABLED(CONFIG_ETH_E1000_CHKSUM_OFFLOAD) &&
+	    (dev->rx.sta & (RDESC_STA_IXSM | RDESC_STA_IPCS |
+			    RDESC_STA_TCPCS)) ==
+	    (RDESC_STA_IPCS | RDESC_STA_TCPCS) &&
+	    !(dev->rx.err & (RDESC_ERR_IPE | RDESC_ERR_TCPE))) {
+		net_pkt_set_chksum_done(pkt, true);
 	}
 
 out:
@@ -251,7 +438,7 @@ int e1000_probe(const struct device *ddev)
 
 	iow32(dev, TDBAL, (uint32_t) &dev->tx);
 	iow32(dev, TDBAH, 0);
-	iow32(dev, TDLEN, 1*16);
+	iow32(dev, TDLEN, sizeof(dev->tx));
 
 	iow32(dev, TDH, 0);
 	iow32(dev, TDT, 0);
@@ -301,6 +488,10 @@ static void e1000_iface_init(struct net_if *iface)
 		irq_enable(DT_INST_IRQN(0));
 		iow32(dev, CTRL, CTRL_SLU); /* Set link up */
 		iow32(dev, RCTL, RCTL_EN | RCTL_MPE);
+
+		if (IS_ENABLED(CONFIG_ETH_E1000_CHKSUM_OFFLOAD)) {
+			iow32(dev, RXCSUM, RXCSUM_IPOFL | RXCSUM_TUOFL);
+		}
 	}
 
 	ethernet_init(iface);
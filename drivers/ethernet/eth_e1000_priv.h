@@ -24,12 +24,34 @@ extern "C" {
 
 #define RCTL_MPE	(1 << 4) /* Multicast Promiscuous Enabled */
 
+#define RXCSUM_IPOFL	(1 << 8) /* IP Checksum Offload Enable */
+#define RXCSUM_TUOFL	(1 << 9) /* TCP/UDP Checksum Offload Enable */
+
 #define TDESC_EOP	     (1) /* End Of Packet */
 #define TDESC_RS	(1 << 3) /* Report Status */
 
+/* Command fields of the TCP/IP context and data descriptors */
+#define TDESC_DTYP_DATA	(1 << 20) /* Data Descriptor */
+#define TDESC_TUCMD_TCP	(1 << 24) /* TCP packet, UDP if clear */
+#define TDESC_TUCMD_IP	(1 << 25) /* IPv4 packet, IPv6 if clear */
+#define TDESC_DCMD_EOP	(1 << 24) /* End Of Packet */
+#define TDESC_DCMD_RS	(1 << 27) /* Report Status */
+#define TDESC_DEXT	(1 << 29) /* Descriptor Extension */
+
+#define TDESC_IXSM	     (1) /* Insert IP Checksum */
+#define TDESC_TXSM	(1 << 1) /* Insert TCP/UDP Checksum */
+
 #define RDESC_STA_DD	     (1) /* Descriptor Done */
+#define RDESC_STA_IXSM	(1 << 2) /* Ignore Checksum Indication */
+#define RDESC_STA_TCPCS	(1 << 5) /* TCP/UDP Checksum Calculated */
+#define RDESC_STA_IPCS	(1 << 6) /* IP Checksum Calculated */
 #define TDESC_STA_DD	     (1) /* Descriptor Done */
 
+#define RDESC_ERR_TCPE	(1 << 5) /* TCP/UDP Checksum Error */
+#define RDESC_ERR_IPE	(1 << 6) /* IP Checksum Error */
+
+#define E1000_TX_DESC	8 /* The TX ring must be a multiple of 128 bytes */
+
 #define ETH_ALEN 6	/* TODO: Add a global reusable definition in OS */
 
 enum e1000_reg_t {
@@ -49,6 +71,7 @@ enum e1000_reg_t {
 	TDLEN	= 0x3808,	/* Tx Descriptor Length */
 	TDH	= 0x3810,	/* Tx Descriptor Head */
 	TDT	= 0x3818,	/* Tx Descriptor Tail */
+	RXCSUM	= 0x5000,	/* Receive Checksum Control */
 	RAL	= 0x5400,	/* Receive Address Low */
 	RAH	= 0x5404,	/* Receive Address High */
 };
@@ -64,6 +87,36 @@ struct e1000_tx {
 	uint16_t special;
 };
 
+/* TCP/IP Context Descriptor */
+struct e1000_tx_ctx {
+	uint8_t  ipcss;
+	uint8_t  ipcso;
+	uint16_t ipcse;
+	uint8_t  tucss;
+	uint8_t  tucso;
+	uint16_t tucse;
+	uint32_t cmd;
+	uint8_t  sta;
+	uint8_t  hdrlen;
+	uint16_t mss;
+};
+
+/* TCP/IP Data Descriptor */
+struct e1000_tx_data {
+	uint64_t addr;
+	uint32_t cmd;
+	uint8_t  sta;
+	uint8_t  popts;
+	uint16_t special;
+};
+
+/* The status is at the same place in all the TX descriptors */
+union e1000_tx_desc {
+	struct e1000_tx legacy;
+	struct e1000_tx_ctx ctx;
+	struct e1000_tx_data data;
+};
+
 /* Legacy RX Descriptor */
 struct e1000_rx {
 	uint64_t addr;
@@ -75,9 +128,12 @@ struct e1000_rx {
 };
 
 struct e1000_dev {
-	volatile struct e1000_tx tx __aligned(16);
+	volatile union e1000_tx_desc tx[E1000_TX_DESC] __aligned(16);
 	volatile struct e1000_rx rx __aligned(16);
 	mm_reg_t address;
+	unsigned int tx_tail;
+	/* Last context loaded into the device */
+	struct e1000_tx_ctx tx_ctx;
 	/* If VLAN is enabled, there can be multiple VLAN interfaces related to
 	 * this physical device. In that case, this iface pointer value is not
 	 * really used for anything.
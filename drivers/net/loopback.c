@@ -21,9 +21,49 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #include <net/buf.h>
 #include <net/net_ip.h>
 #include <net/net_if.h>
+#include <random/rand32.h>
 
 #include <net/dummy.h>
 
+#if CONFIG_NET_LOOPBACK_DELAY > 0
+/* Packets held back to simulate link latency, delivered in order by
+ * a delayed work item once they are due.
+ */
+struct loopback_delayed {
+	struct net_pkt *pkt;
+	uint32_t due;
+};
+
+K_MSGQ_DEFINE(loopback_delay_q, sizeof(struct loopback_delayed),
+	      CONFIG_NET_LOOPBACK_DELAY_QUEUE_SIZE, 4);
+
+static void loopback_deliver(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(loopback_delay_work, loopback_deliver);
+
+static void loopback_deliver(struct k_work *work)
+{
+	struct loopback_delayed d;
+
+	ARG_UNUSED(work);
+
+	while (k_msgq_peek(&loopback_delay_q, &d) == 0) {
+		int32_t left = (int32_t)(d.due - k_uptime_get_32());
+
+		if (left > 0) {
+			k_work_reschedule(&loopback_delay_work, K_MSEC(left));
+			return;
+		}
+
+		(void)k_msgq_get(&loopback_delay_q, &d, K_NO_WAIT);
+
+		if (net_recv_data(net_pkt_iface(d.pkt), d.pkt) < 0) {
+			LOG_ERR("Data receive failed.");
+			net_pkt_unref(d.pkt);
+		}
+	}
+}
+#endif /* CONFIG_NET_LOOPBACK_DELAY > 0 */
+
 int loopback_dev_init(const struct device *dev)
 {
 	ARG_UNUSED(dev);
@@ -70,6 +110,15 @@ static int loopback_send(const struct device *dev, struct net_pkt *pkt)
 		net_ipaddr_copy(&NET_IPV4_HDR(pkt)->dst, &addr);
 	}
 
+#if CONFIG_NET_LOOPBACK_LOSS_PERMILLE > 0
+	/* A lost packet looks like a sent one to the caller */
+	if ((sys_rand32_get() % 1000U) < CONFIG_NET_LOOPBACK_LOSS_PERMILLE) {
+		LOG_DBG("Dropping pkt %p", pkt);
+		res = 0;
+		goto out;
+	}
+#endif
+
 	/* We should simulate normal driver meaning that if the packet is
 	 * properly sent (which is always in this driver), then the packet
 	 * must be dropped. This is very much needed for TCP packets where
@@ -81,6 +130,27 @@ static int loopback_send(const struct device *dev, struct net_pkt *pkt)
 		goto out;
 	}
 
+#if CONFIG_NET_LOOPBACK_DELAY > 0
+	{
+		struct loopback_delayed d = {
+			.pkt = cloned,
+			.due = k_uptime_get_32() + CONFIG_NET_LOOPBACK_DELAY,
+		};
+
+		/* A full queue behaves like a congested link */
+		if (k_msgq_put(&loopback_delay_q, &d, K_NO_WAIT) < 0) {
+			LOG_DBG("Delay queue full, dropping pkt %p", pkt);
+			net_pkt_unref(cloned);
+		} else {
+			k_work_schedule(&loopback_delay_work,
+					K_MSEC(CONFIG_NET_LOOPBACK_DELAY));
+		}
+
+		res = 0;
+		goto out;
+	}
+#endif
+
 	res = net_recv_data(net_pkt_iface(cloned), cloned);
 	if (res < 0) {
 		LOG_ERR("Data receive failed.");
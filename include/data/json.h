@@ -43,6 +43,9 @@ enum json_tokens {
 	JSON_TOK_COLON = ':',
 	JSON_TOK_COMMA = ',',
 	JSON_TOK_NUMBER = '0',
+	JSON_TOK_FLOAT = '1',
+	JSON_TOK_OPAQUE = '2',
+	JSON_TOK_INT64 = '3',
 	JSON_TOK_TRUE = 't',
 	JSON_TOK_FALSE = 'f',
 	JSON_TOK_NULL = 'n',
@@ -64,7 +67,8 @@ struct json_obj_descr {
 	uint32_t field_name_len : 7;
 
 	/* Valid values here (enum json_tokens): JSON_TOK_STRING,
-	 * JSON_TOK_NUMBER, JSON_TOK_TRUE, JSON_TOK_FALSE,
+	 * JSON_TOK_NUMBER, JSON_TOK_FLOAT, JSON_TOK_OPAQUE,
+	 * JSON_TOK_INT64, JSON_TOK_TRUE, JSON_TOK_FALSE,
 	 * JSON_TOK_OBJECT_START, JSON_TOK_LIST_START.  (All others
 	 * ignored.) Maximum value is '}' (125), so this has to be 7 bits
 	 * long.
@@ -86,6 +90,22 @@ struct json_obj_descr {
 	};
 };
 
+/**
+ * @brief Raw text of a JSON value
+ *
+ * Fields described as JSON_TOK_FLOAT hold the text of a number, as
+ * there is no strtod() in the minimal libc, and fields described as
+ * JSON_TOK_OPAQUE hold the contents of a string, still escaped, both
+ * without a terminating NUL character.  The decoded values point into
+ * the parsed payload, and the values to encode are written as they
+ * are, though encoding fails with -EINVAL if a JSON_TOK_FLOAT field is
+ * not a JSON number.
+ */
+struct json_obj_token {
+	char *start;
+	size_t length;
+};
+
 /**
  * @brief Function pointer type to append bytes to a buffer while
  * encoding JSON data.
@@ -115,7 +135,10 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
  *
  * @param type_ Token type for JSON value corresponding to a primitive
  * type. Must be one of: JSON_TOK_STRING for strings, JSON_TOK_NUMBER
- * for numbers, JSON_TOK_TRUE (or JSON_TOK_FALSE) for booleans.
+ * for 32-bit integers, JSON_TOK_INT64 for 64-bit integers,
+ * JSON_TOK_FLOAT for other numbers and JSON_TOK_OPAQUE for raw strings,
+ * both kept as a struct json_obj_token, JSON_TOK_TRUE (or
+ * JSON_TOK_FALSE) for booleans.
  *
  * Here's an example of use:
  *
@@ -574,7 +597,8 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
  * (1) strings are not unescaped (but only valid escape sequences are
  * accepted);
  * (2) no UTF-8 validation is performed; and
- * (3) only integer numbers are supported (no strtod() in the minimal libc).
+ * (3) only integer numbers are decoded (no strtod() in the minimal libc),
+ * other numbers can be kept as text with JSON_TOK_FLOAT.
  *
  * @param json Pointer to JSON-encoded value to be parsed
  *
@@ -678,6 +702,10 @@ int json_arr_encode_buf(const struct json_obj_descr *descr, const void *val,
 /**
  * @brief Encodes an object using an arbitrary writer function
  *
+ * The output is gathered on the stack and handed to @p append_bytes in
+ * chunks of up to CONFIG_JSON_ENCODE_BUF_SIZE bytes, longer strings
+ * being passed straight from the value.
+ *
  * @param descr Pointer to the descriptor array
  *
  * @param descr_len Number of elements in the descriptor array
@@ -699,6 +727,9 @@ int json_obj_encode(const struct json_obj_descr *descr, size_t descr_len,
 /**
  * @brief Encodes an array using an arbitrary writer function
  *
+ * The output is handed to @p append_bytes in chunks, as with
+ * json_obj_encode().
+ *
  * @param descr Pointer to the descriptor array
  *
  * @param val Struct holding the values
@@ -714,6 +745,95 @@ int json_obj_encode(const struct json_obj_descr *descr, size_t descr_len,
 int json_arr_encode(const struct json_obj_descr *descr, const void *val,
 		    json_append_bytes_t append_bytes, void *data);
 
+/**
+ * @brief Token returned by the streaming tokenizer
+ */
+struct json_token {
+	/** Token type, JSON_TOK_EOF once the whole value has been read */
+	enum json_tokens type;
+	/** Contents of strings, without the quotes and still escaped, and
+	 * text of numbers and literals.  Not NUL terminated.
+	 */
+	const char *start;
+	/** Length of the contents */
+	size_t length;
+};
+
+/**
+ * @brief Streaming JSON tokenizer
+ *
+ * Splits a JSON value received in chunks into tokens, checking the
+ * grammar on the way, without allocating memory.  The tokens point
+ * into the chunk being read, except for those split across two
+ * chunks, which are gathered in a scratch buffer given by the caller
+ * and must fit in it.  The fields are private.
+ */
+struct json_tokenizer {
+	const char *pos;
+	const char *end;
+	char *scratch;
+	size_t scratch_size;
+	size_t scratch_len;
+	/* Bit n is set if nesting level n is an object */
+	uint32_t objects;
+	uint8_t depth;
+	uint8_t expect;
+	uint8_t in_token;
+	uint8_t literal;
+	uint8_t matched;
+	bool last;
+};
+
+/**
+ * @brief Initialize a streaming tokenizer
+ *
+ * @param tok Tokenizer
+ *
+ * @param scratch Buffer to gather the tokens split across chunks, as
+ * large as the longest string or number expected
+ *
+ * @param scratch_size Size of the scratch buffer
+ */
+void json_tokenizer_init(struct json_tokenizer *tok, char *scratch,
+			 size_t scratch_size);
+
+/**
+ * @brief Give the next chunk of the JSON value to a tokenizer
+ *
+ * To be called once json_tokenizer_next() has consumed the previous
+ * chunk, that is has returned -EAGAIN.  The chunk must stay
+ * unchanged until then.
+ *
+ * @param tok Tokenizer
+ *
+ * @param data Chunk of the JSON value
+ *
+ * @param len Length of the chunk
+ *
+ * @param last Whether this is the last chunk of the value
+ */
+void json_tokenizer_feed(struct json_tokenizer *tok, const char *data,
+			 size_t len, bool last);
+
+/**
+ * @brief Read the next token
+ *
+ * Returns the same tokens as the lexer of json_obj_parse(), commas and
+ * colons included, and then a JSON_TOK_EOF token once the last chunk
+ * has been read.  The contents of the token stay valid until the next
+ * call.
+ *
+ * @param tok Tokenizer
+ *
+ * @param token Token read
+ *
+ * @return 0 if a token has been read, -EAGAIN if the chunk has been
+ * consumed and the next one is needed, -EINVAL if the value is not
+ * valid JSON, -ENOSPC if a token split across chunks does not fit in
+ * the scratch buffer, -E2BIG if the value is nested more than 32 deep.
+ */
+int json_tokenizer_next(struct json_tokenizer *tok, struct json_token *token);
+
 #ifdef __cplusplus
 }
 #endif
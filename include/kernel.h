@@ -4371,6 +4371,190 @@ static inline uint32_t z_impl_k_msgq_num_used_get(struct k_msgq *msgq)
 
 /** @} */
 
+/**
+ * @defgroup mpsc_msgq_apis Lock-free Message Queue APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @brief Lock-free Message Queue Structure
+ *
+ * A fixed size message ring for the multi-producer/single-consumer and
+ * single-producer/single-consumer cases, typically an ISR feeding a
+ * thread.  Producers and a consumer with data available never take a
+ * lock; the wait queue is only used when the consumer has to block.
+ */
+struct k_mpsc_msgq {
+	/** Consumer wait queue */
+	_wait_q_t wait_q;
+	/** Lock, only taken when the consumer blocks or is woken up */
+	struct k_spinlock lock;
+	/** Start of slot buffer */
+	atomic_t *buffer;
+	/** Message size */
+	size_t msg_size;
+	/** Slot size, in atomic_t words */
+	uint32_t slot_words;
+	/** Maximal number of messages minus one, a power of two mask */
+	uint32_t mask;
+	/** Producer position */
+	atomic_t tail;
+	/** Consumer position */
+	uint32_t head;
+	/** Non-zero while the consumer is about to pend or pended */
+	atomic_t waiting;
+	/** Queue flags */
+	uint8_t flags;
+};
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+#define Z_MPSC_MSGQ_SLOT_WORDS(q_msg_size) \
+	(1 + DIV_ROUND_UP(q_msg_size, sizeof(atomic_t)))
+
+#define Z_MPSC_MSGQ_INITIALIZER(obj, q_buffer, q_msg_size, q_max_msgs, \
+				q_flags) \
+	{ \
+	.wait_q = Z_WAIT_Q_INIT(&obj.wait_q), \
+	.buffer = q_buffer, \
+	.msg_size = q_msg_size, \
+	.slot_words = Z_MPSC_MSGQ_SLOT_WORDS(q_msg_size), \
+	.mask = (q_max_msgs) - 1, \
+	.flags = q_flags, \
+	}
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @brief Queue has a single producer.
+ *
+ * Producers reserve their slot with a plain store instead of a
+ * compare-and-swap.  Only set this if at most one context ever calls
+ * k_mpsc_msgq_put() on the queue.
+ */
+#define K_MPSC_MSGQ_FLAG_SPSC	BIT(0)
+
+/**
+ * @brief Size of the buffer needed by k_mpsc_msgq_init().
+ *
+ * @param q_msg_size Message size (in bytes).
+ * @param q_max_msgs Maximum number of messages that can be queued.
+ */
+#define K_MPSC_MSGQ_BUF_SIZE(q_msg_size, q_max_msgs) \
+	((q_max_msgs) * Z_MPSC_MSGQ_SLOT_WORDS(q_msg_size) * sizeof(atomic_t))
+
+/**
+ * @brief Statically define and initialize a lock-free message queue.
+ *
+ * The queue's ring buffer contains space for @a q_max_msgs messages,
+ * each of which is @a q_msg_size bytes long, plus one sequence word per
+ * message.  @a q_max_msgs must be a power of two, at least 2.
+ *
+ * The message queue can be accessed outside the module where it is defined
+ * using:
+ *
+ * @code extern struct k_mpsc_msgq <name>; @endcode
+ *
+ * @param q_name Name of the message queue.
+ * @param q_msg_size Message size (in bytes).
+ * @param q_max_msgs Maximum number of messages that can be queued.
+ * @param q_flags Queue flags, 0 or K_MPSC_MSGQ_FLAG_SPSC.
+ */
+#define K_MPSC_MSGQ_DEFINE(q_name, q_msg_size, q_max_msgs, q_flags)	\
+	BUILD_ASSERT(((q_max_msgs) & ((q_max_msgs) - 1)) == 0,		\
+		     "q_max_msgs must be a power of two");		\
+	BUILD_ASSERT((q_max_msgs) >= 2, "q_max_msgs must be at least 2"); \
+	static atomic_t _k_mpsc_msgq_buf_##q_name[(q_max_msgs) *	\
+			Z_MPSC_MSGQ_SLOT_WORDS(q_msg_size)];		\
+	struct k_mpsc_msgq q_name =					\
+		Z_MPSC_MSGQ_INITIALIZER(q_name, _k_mpsc_msgq_buf_##q_name, \
+					q_msg_size, q_max_msgs, q_flags)
+
+/**
+ * @brief Initialize a lock-free message queue.
+ *
+ * This routine initializes a lock-free message queue object, prior to its
+ * first use.
+ *
+ * @param q Address of the message queue.
+ * @param buffer Ring buffer of at least
+ *	  K_MPSC_MSGQ_BUF_SIZE(@a msg_size, @a max_msgs) bytes, aligned to
+ *	  sizeof(atomic_t).
+ * @param msg_size Message size (in bytes).
+ * @param max_msgs Maximum number of messages that can be queued, a power
+ *	  of two, at least 2.
+ * @param flags Queue flags, 0 or K_MPSC_MSGQ_FLAG_SPSC.
+ *
+ * @retval 0 Queue initialized.
+ * @retval -EINVAL @a max_msgs is not a power of two or is less than 2.
+ */
+int k_mpsc_msgq_init(struct k_mpsc_msgq *q, void *buffer, size_t msg_size,
+		     uint32_t max_msgs, uint8_t flags);
+
+/**
+ * @brief Send a message to a lock-free message queue.
+ *
+ * This routine copies a message into @a q without taking any lock.  It
+ * never blocks: if the queue is full the message is dropped.  If the
+ * consumer is pended on the queue it is woken up.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param q Address of the message queue.
+ * @param data Pointer to the message.
+ *
+ * @retval 0 Message sent.
+ * @retval -ENOMSG Queue is full.
+ */
+int k_mpsc_msgq_put(struct k_mpsc_msgq *q, const void *data);
+
+/**
+ * @brief Receive a message from a lock-free message queue.
+ *
+ * This routine receives a message from @a q in a "first in, first out"
+ * manner.  Only one context may consume from a given queue.  The wait
+ * queue lock is only taken when no message is available and @a timeout
+ * allows blocking.
+ *
+ * @note @a timeout must be set to K_NO_WAIT if called from ISR.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param q Address of the message queue.
+ * @param data Address of area to hold the received message.
+ * @param timeout Waiting period to receive the message,
+ *                or one of the special values K_NO_WAIT and
+ *                K_FOREVER.
+ *
+ * @retval 0 Message received.
+ * @retval -ENOMSG Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+int k_mpsc_msgq_get(struct k_mpsc_msgq *q, void *data, k_timeout_t timeout);
+
+/**
+ * @brief Get the number of messages in a lock-free message queue.
+ *
+ * The value is a snapshot and may be stale by the time it is returned if
+ * producers are running concurrently.  It includes messages whose slot
+ * has been reserved but not yet filled.
+ *
+ * @param q Address of the message queue.
+ *
+ * @return Number of messages.
+ */
+static inline uint32_t k_mpsc_msgq_num_used_get(struct k_mpsc_msgq *q)
+{
+	return (uint32_t)atomic_get(&q->tail) - q->head;
+}
+
+/** @} */
+
 /**
  * @defgroup mailbox_apis Mailbox APIs
  * @ingroup kernel_apis
@@ -4710,6 +4894,153 @@ __syscall size_t k_pipe_read_avail(struct k_pipe *pipe);
  */
 __syscall size_t k_pipe_write_avail(struct k_pipe *pipe);
 
+/** Pipe scatter-gather segment */
+struct k_pipe_iovec {
+	void  *data;	/**< Start of the segment */
+	size_t len;	/**< Size of the segment (in bytes) */
+};
+
+/**
+ * @brief Write a vector of buffers to a pipe.
+ *
+ * This routine writes up to the combined size of all @a iovcnt segments
+ * of @a iov to @a pipe, in order, with the same @a min_xfer and
+ * @a timeout semantics as k_pipe_put() applied to the vector as a whole.
+ *
+ * When no reader is waiting and the data does not have to wait for
+ * space, the whole vector is copied into the pipe's ring buffer under a
+ * single acquisition of the pipe's lock. Otherwise the segments are
+ * handed over one by one, as by k_pipe_put().
+ *
+ * This routine is not available to user mode threads.
+ *
+ * @param pipe Address of the pipe.
+ * @param iov Array of segments to write.
+ * @param iovcnt Number of segments in @a iov.
+ * @param bytes_written Address of area to hold the number of bytes written.
+ * @param min_xfer Minimum number of bytes to write.
+ * @param timeout Waiting period to wait for the data to be written,
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 At least @a min_xfer bytes of data were written.
+ * @retval -EINVAL invalid parameters supplied
+ * @retval -EIO Returned without waiting; fewer than @a min_xfer data bytes
+ *              were written.
+ * @retval -EAGAIN Waiting period timed out; between zero and @a min_xfer
+ *                 minus one data bytes were written.
+ */
+int k_pipe_putv(struct k_pipe *pipe, const struct k_pipe_iovec *iov,
+		size_t iovcnt, size_t *bytes_written, size_t min_xfer,
+		k_timeout_t timeout);
+
+/**
+ * @brief Read data from a pipe into a vector of buffers.
+ *
+ * This routine reads up to the combined size of all @a iovcnt segments
+ * of @a iov from @a pipe, filling them in order, with the same
+ * @a min_xfer and @a timeout semantics as k_pipe_get() applied to the
+ * vector as a whole.
+ *
+ * When no writer is waiting and the request does not have to wait for
+ * data, the whole vector is filled from the pipe's ring buffer under a
+ * single acquisition of the pipe's lock. Otherwise the segments are
+ * filled one by one, as by k_pipe_get().
+ *
+ * This routine is not available to user mode threads.
+ *
+ * @param pipe Address of the pipe.
+ * @param iov Array of segments to fill.
+ * @param iovcnt Number of segments in @a iov.
+ * @param bytes_read Address of area to hold the number of bytes read.
+ * @param min_xfer Minimum number of data bytes to read.
+ * @param timeout Waiting period to wait for the data to be read,
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 At least @a min_xfer bytes of data were read.
+ * @retval -EINVAL invalid parameters supplied
+ * @retval -EIO Returned without waiting; fewer than @a min_xfer data bytes
+ *              were read.
+ * @retval -EAGAIN Waiting period timed out; between zero and @a min_xfer
+ *                 minus one data bytes were read.
+ */
+int k_pipe_getv(struct k_pipe *pipe, const struct k_pipe_iovec *iov,
+		size_t iovcnt, size_t *bytes_read, size_t min_xfer,
+		k_timeout_t timeout);
+
+/**
+ * @brief Claim contiguous free space in a pipe's ring buffer.
+ *
+ * Gives direct access to free space in the ring buffer so that a producer
+ * can build data in place instead of copying it in with k_pipe_put().
+ * The claimed space is made available to readers by k_pipe_put_finish().
+ *
+ * Claims are meant for a single producer: no other thread may write to
+ * @a pipe between the claim and the matching finish.
+ *
+ * This routine is not available to user mode threads.
+ *
+ * @param pipe Address of the pipe.
+ * @param data Address of the pointer to the claimed space.
+ * @param size Requested size (in bytes).
+ *
+ * @return Size of the claimed space, at most @a size. It may be smaller
+ *         when the free space wraps around the end of the ring buffer, and
+ *         is zero for unbuffered or full pipes.
+ */
+size_t k_pipe_put_claim(struct k_pipe *pipe, uint8_t **data, size_t size);
+
+/**
+ * @brief Commit data written into space claimed with k_pipe_put_claim().
+ *
+ * Passes the first @a size bytes of the claimed space to waiting readers
+ * and leaves the rest in the ring buffer. Claimed space that is not
+ * committed is released.
+ *
+ * @param pipe Address of the pipe.
+ * @param size Number of valid bytes written into the claimed space.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL @a size exceeds the space that can have been claimed
+ */
+int k_pipe_put_finish(struct k_pipe *pipe, size_t size);
+
+/**
+ * @brief Claim contiguous data in a pipe's ring buffer.
+ *
+ * Gives direct access to data in the ring buffer so that a consumer can
+ * process it in place instead of copying it out with k_pipe_get(). The
+ * space is given back to writers by k_pipe_get_finish().
+ *
+ * Claims are meant for a single consumer: no other thread may read from
+ * @a pipe between the claim and the matching finish.
+ *
+ * This routine is not available to user mode threads.
+ *
+ * @param pipe Address of the pipe.
+ * @param data Address of the pointer to the claimed data.
+ * @param size Requested size (in bytes).
+ *
+ * @return Size of the claimed data, at most @a size. It may be smaller
+ *         when the data wraps around the end of the ring buffer, and is
+ *         zero for unbuffered or empty pipes.
+ */
+size_t k_pipe_get_claim(struct k_pipe *pipe, uint8_t **data, size_t size);
+
+/**
+ * @brief Release data claimed with k_pipe_get_claim().
+ *
+ * Removes the first @a size bytes of the claimed data from the pipe and
+ * lets waiting writers refill the freed space. Claimed data that is not
+ * released stays in the pipe.
+ *
+ * @param pipe Address of the pipe.
+ * @param size Number of bytes consumed.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL @a size exceeds the data that can have been claimed
+ */
+int k_pipe_get_finish(struct k_pipe *pipe, size_t size);
+
 /** @} */
 
 /**
@@ -4900,10 +5231,31 @@ static inline uint32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
 
 /* kernel synchronized heap struct */
 
+#if defined(CONFIG_SYS_HEAP_SLAB) && defined(CONFIG_SMP) && \
+	(CONFIG_SYS_HEAP_SLAB_MAGAZINE_SIZE > 0)
+#define Z_HEAP_MAGAZINES
+#endif
+
+#ifdef Z_HEAP_MAGAZINES
+/* Per-CPU cache of freed slab objects of one size class */
+struct z_heap_magazine {
+	uint8_t count;
+	void *objs[CONFIG_SYS_HEAP_SLAB_MAGAZINE_SIZE];
+};
+#endif
+
 struct k_heap {
 	struct sys_heap heap;
 	_wait_q_t wait_q;
 	struct k_spinlock lock;
+#ifdef Z_HEAP_MAGAZINES
+	struct z_heap_magazine mag[CONFIG_MP_NUM_CPUS]
+				  [CONFIG_SYS_HEAP_SLAB_CLASSES];
+	/* Protects the magazines of each CPU */
+	struct k_spinlock mag_lock[CONFIG_MP_NUM_CPUS];
+	/* Number of allocations which found the heap exhausted */
+	atomic_t waiters;
+#endif
 };
 
 /**
@@ -4921,6 +5273,37 @@ struct k_heap {
  */
 void k_heap_init(struct k_heap *h, void *mem, size_t bytes);
 
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+/**
+ * @brief Get the runtime statistics of a k_heap
+ *
+ * Takes the heap lock and calls sys_heap_runtime_stats_get().
+ *
+ * @param h Heap to query
+ * @param stats Where to store the statistics
+ * @return 0 on success, -EINVAL on a NULL argument
+ */
+int k_heap_runtime_stats_get(struct k_heap *h,
+			     struct sys_heap_runtime_stats *stats);
+#endif
+
+#ifdef CONFIG_SYS_HEAP_SLAB
+/**
+ * @brief Enable the slab front end on a k_heap
+ *
+ * Puts the small size slab classes of sys_heap_slab_init() in front
+ * of the heap.  On SMP, freed slab objects are additionally cached in
+ * small per-CPU magazines (CONFIG_SYS_HEAP_SLAB_MAGAZINE_SIZE) which
+ * are used without taking the heap lock.  An allocation that fails
+ * drains the magazines of every CPU before giving up or waiting.  Must
+ * be called before any allocation is made from the heap.
+ *
+ * @param h Heap on which to enable the slab front end
+ * @return 0 on success, -ENOMEM if the slab metadata does not fit
+ */
+int k_heap_slab_init(struct k_heap *h);
+#endif
+
 /** @brief Allocate aligned memory from a k_heap
  *
  * Behaves in all ways like k_heap_alloc(), except that the returned
@@ -4981,7 +5364,11 @@ void k_heap_free(struct k_heap *h, void *mem);
 /* Hand-calculated minimum heap sizes needed to return a successful
  * 1-byte allocation.  See details in lib/os/heap.[ch]
  */
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+#define Z_HEAP_MIN_SIZE (sizeof(void *) > 4 ? 88 : 60)
+#else
 #define Z_HEAP_MIN_SIZE (sizeof(void *) > 4 ? 56 : 44)
+#endif
 
 /**
  * @brief Define a static k_heap
@@ -5626,6 +6013,33 @@ int k_thread_runtime_stats_all_get(k_thread_runtime_stats_t *stats);
 
 #endif
 
+#ifdef CONFIG_SCHED_STATS
+
+/**
+ * @brief Get the scheduler histograms of a thread
+ *
+ * Bucket 0 of each histogram counts intervals shorter than
+ * 2^CONFIG_SCHED_STATS_SHIFT timing cycles; bucket N counts intervals
+ * of [2^(N - 1 + CONFIG_SCHED_STATS_SHIFT),
+ * 2^(N + CONFIG_SCHED_STATS_SHIFT)) cycles, with the last bucket
+ * also counting everything longer.
+ *
+ * @param thread ID of thread.
+ * @param stats Pointer to struct to copy statistics into.
+ * @return -EINVAL if null pointers, otherwise 0
+ */
+int k_thread_sched_stats_get(k_tid_t thread, k_thread_sched_stats_t *stats);
+
+/**
+ * @brief Get the scheduler histograms of all threads combined
+ *
+ * @param stats Pointer to struct to copy statistics into.
+ * @return -EINVAL if null pointers, otherwise 0
+ */
+int k_sched_stats_all_get(k_thread_sched_stats_t *stats);
+
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -102,6 +102,11 @@ struct _thread_base {
 	/* Recursive count of irq_lock() calls */
 	uint8_t global_lock_count;
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* CPU whose run queue holds (or last held) this thread */
+	uint8_t runq_cpu;
+#endif
+
 #endif
 
 #ifdef CONFIG_SCHED_CPU_MASK
@@ -189,6 +194,28 @@ struct _thread_runtime_stats {
 };
 #endif
 
+#ifdef CONFIG_SCHED_STATS
+struct k_thread_sched_stats {
+	/* log2 histogram of cycles from ready to switched in */
+	uint32_t wake_latency[CONFIG_SCHED_STATS_BUCKETS];
+
+	/* log2 histogram of cycles from switched in to switched out */
+	uint32_t run_slice[CONFIG_SCHED_STATS_BUCKETS];
+};
+
+typedef struct k_thread_sched_stats k_thread_sched_stats_t;
+
+struct _thread_sched_stats {
+	/* Timestamp when last made ready, zero if not waiting to run */
+	timing_t ready_stamp;
+
+	/* Timestamp when last switched in, zero if not running */
+	timing_t switched_in_stamp;
+
+	k_thread_sched_stats_t stats;
+};
+#endif
+
 struct z_poller {
 	bool is_polling;
 	uint8_t mode;
@@ -283,6 +310,11 @@ struct k_thread {
 	struct _thread_runtime_stats rt_stats;
 #endif
 
+#ifdef CONFIG_SCHED_STATS
+	/** Scheduler latency and run slice histograms */
+	struct _thread_sched_stats sched_stats;
+#endif
+
 #ifdef CONFIG_DEMAND_PAGING_THREAD_STATS
 	/** Paging statistics */
 	struct k_mem_paging_stats_t paging_stats;
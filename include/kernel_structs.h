@@ -93,6 +93,11 @@ struct _ready_q {
 #elif defined(CONFIG_SCHED_MULTIQ)
 	struct _priq_mq runq;
 #endif
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* number of threads in runq */
+	unsigned int count;
+#endif
 };
 
 typedef struct _ready_q _ready_q_t;
@@ -129,6 +134,11 @@ struct _cpu {
 
 	/* Per CPU architecture specifics */
 	struct _cpu_arch arch;
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* this CPU's own ready queue, see CONFIG_SCHED_CPU_RUNQ */
+	struct _ready_q ready_q;
+#endif
 };
 
 typedef struct _cpu _cpu_t;
@@ -145,11 +155,13 @@ struct z_kernel {
 	int32_t idle; /* Number of ticks for kernel idling */
 #endif
 
+#ifndef CONFIG_SCHED_CPU_RUNQ
 	/*
 	 * ready queue: can be big, keep after small fields, since some
 	 * assembly (e.g. ARC) are limited in the encoding of the offset
 	 */
 	struct _ready_q ready_q;
+#endif
 
 #ifdef CONFIG_FPU_SHARING
 	/*
@@ -47,10 +47,24 @@ struct log_dict_output_dropped_msg_t {
 	uint16_t num_dropped_messages;
 } __packed;
 
+/** @brief Get the length of a log message in dictionary-based output.
+ *
+ * @param msg Log message.
+ *
+ * @return Number of bytes log_dict_output_msg2_process() outputs for it.
+ */
+static inline size_t log_dict_output_msg2_len(struct log_msg2 *msg)
+{
+	return sizeof(struct log_dict_output_normal_msg_hdr_t) +
+	       msg->hdr.desc.package_len + msg->hdr.desc.data_len;
+}
+
 /** @brief Process log messages v2 for dictionary-basde logging.
  *
  * Function is using provided context with the buffer and output function to
- * process formatted string and output the data.
+ * process formatted string and output the data. The message is gathered in
+ * the output buffer and flushed at the end, a message no larger than the
+ * buffer reaching the output function in a single call.
  *
  * @param log_output Pointer to the log output instance.
  * @param msg Log message.
@@ -959,6 +959,11 @@ struct net_buf {
 		struct net_buf_simple b;
 	};
 
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+	/** Cycle count when the buffer was allocated. */
+	uint32_t alloc_time;
+#endif /* CONFIG_NET_BUF_POOL_USAGE */
+
 	/** System metadata for this buffer. */
 	uint8_t user_data[CONFIG_NET_BUF_USER_DATA_SIZE] __net_buf_align;
 };
@@ -994,6 +999,15 @@ struct net_buf_pool {
 	/** Amount of available buffers in the pool. */
 	atomic_t avail_count;
 
+	/** Highest amount of buffers in use at the same time. */
+	atomic_t max_used;
+
+	/** Amount of allocations that failed. */
+	atomic_t alloc_failures;
+
+	/** Moving average of the time buffers are held, in microseconds. */
+	uint32_t hold_time_avg;
+
 	/** Total size of the pool. */
 	const uint16_t pool_size;
 
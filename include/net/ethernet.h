@@ -102,10 +102,17 @@ struct net_eth_addr {
 
 /** Ethernet hardware capabilities */
 enum ethernet_hw_caps {
-	/** TX Checksum offloading supported for all of IPv4, UDP, TCP */
+	/** TX Checksum offloading supported for all of IPv4, UDP, TCP.
+	 * These checksums are then left zero by the stack, except the UDP
+	 * and TCP ones of the packets it fragments.
+	 */
 	ETHERNET_HW_TX_CHKSUM_OFFLOAD	= BIT(0),
 
-	/** RX Checksum offloading supported for all of IPv4, UDP, TCP */
+	/** RX Checksum offloading supported for all of IPv4, UDP, TCP.
+	 * These checksums are then not verified by the stack. A device
+	 * verifying only some packets marks them with
+	 * net_pkt_set_chksum_done() instead.
+	 */
 	ETHERNET_HW_RX_CHKSUM_OFFLOAD	= BIT(1),
 
 	/** VLAN supported */
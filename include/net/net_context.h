@@ -281,6 +281,11 @@ __net_socket struct net_context {
 		/** Mutex used by condition variable */
 		struct k_mutex *lock;
 	} cond;
+
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+	/** Readiness watches of epoll instances, see struct z_fd_watch */
+	sys_slist_t watches;
+#endif
 #endif /* CONFIG_NET_SOCKETS */
 
 #if defined(CONFIG_NET_OFFLOAD)
@@ -312,6 +317,10 @@ __net_socket struct net_context {
 #endif
 #if defined(CONFIG_NET_CONTEXT_SNDTIMEO)
 		k_timeout_t sndtimeo;
+#endif
+#if defined(CONFIG_NET_CONTEXT_UDP_SEGMENT)
+		/** Payload size of the datagrams a send is split into */
+		uint16_t udp_segment;
 #endif
 	} options;
 
@@ -965,6 +974,34 @@ int net_context_sendto(struct net_context *context,
 		       k_timeout_t timeout,
 		       void *user_data);
 
+/**
+ * @brief Send data held in network buffers without copying it.
+ *
+ * @details Like net_context_sendto(), but the payload is the buffer
+ * chain @p frags which gets linked into the network packet instead of
+ * being copied. Only UDP and TCP contexts support this. On success the
+ * stack takes over the caller's reference to @p frags, on failure the
+ * caller still owns it. A UDP datagram larger than one packet can carry
+ * is refused with -EMSGSIZE rather than cut short.
+ *
+ * @param context The network context to use.
+ * @param frags The buffer chain to send
+ * @param dst_addr Destination address, NULL for a connected context.
+ * @param addrlen Length of the address.
+ * @param cb Caller-supplied callback function.
+ * @param timeout Currently this value is not used.
+ * @param user_data Caller-supplied user data.
+ *
+ * @return numbers of bytes sent on success, a negative errno otherwise
+ */
+int net_context_send_buf(struct net_context *context,
+			 struct net_buf *frags,
+			 const struct sockaddr *dst_addr,
+			 socklen_t addrlen,
+			 net_context_send_cb_t cb,
+			 k_timeout_t timeout,
+			 void *user_data);
+
 /**
  * @brief Send data in iovec to a peer specified in msghdr struct.
  *
@@ -1060,6 +1097,7 @@ enum net_context_option {
 	NET_OPT_SOCKS5		= 3,
 	NET_OPT_RCVTIMEO        = 4,
 	NET_OPT_SNDTIMEO        = 5,
+	NET_OPT_UDP_SEGMENT     = 6,
 };
 
 /**
@@ -121,6 +121,11 @@ struct net_pkt {
 	uint64_t txtime;
 #endif /* CONFIG_NET_PKT_TXTIME */
 
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+	/** Cycle count when the packet was allocated */
+	uint32_t alloc_time;
+#endif /* CONFIG_NET_BUF_POOL_USAGE */
+
 	/** Reference counter */
 	atomic_t atomic_ref;
 
@@ -184,6 +189,10 @@ struct net_pkt {
 	uint8_t captured : 1; /* Set to 1 if this packet is already being
 			       * captured
 			       */
+	uint8_t chksum_done : 1; /* For incoming packet: the IPv4, UDP and
+				  * TCP checksums were verified by the
+				  * network device.
+				  */
 
 	union {
 		/* IPv6 hop limit or IPv4 ttl for this network packet.
@@ -340,6 +349,17 @@ static inline void net_pkt_set_captured(struct net_pkt *pkt, bool is_captured)
 	pkt->captured = is_captured;
 }
 
+static inline bool net_pkt_is_chksum_done(struct net_pkt *pkt)
+{
+	return !!(pkt->chksum_done);
+}
+
+static inline void net_pkt_set_chksum_done(struct net_pkt *pkt,
+					   bool is_chksum_done)
+{
+	pkt->chksum_done = is_chksum_done;
+}
+
 static inline uint8_t net_pkt_ip_hdr_len(struct net_pkt *pkt)
 {
 	return pkt->ip_hdr_len;
@@ -1434,6 +1454,39 @@ void net_pkt_get_info(struct k_mem_slab **rx,
 		      struct net_buf_pool **rx_data,
 		      struct net_buf_pool **tx_data);
 
+struct net_stats_mem;
+
+/**
+ * @brief Get the usage statistics of the predefined RX, TX and DATA pools.
+ *
+ * Only available with CONFIG_NET_BUF_POOL_USAGE.
+ *
+ * @param stats Where the statistics are stored.
+ */
+void net_pkt_get_mem_stats(struct net_stats_mem *stats);
+
+/** Upper bound of the first bucket of the data size histograms. */
+#define NET_PKT_SIZE_HIST_MIN 64U
+
+/** Number of buckets in the data size histograms, each one twice as large as
+ * the previous one, the last one counting all the larger sizes.
+ */
+#define NET_PKT_SIZE_HIST_BUCKETS 6
+
+/**
+ * @brief Get the histogram of the data sizes requested from the RX or TX
+ * DATA pool.
+ *
+ * Only available with CONFIG_NET_BUF_VARIABLE_DATA_SIZE_ADAPTIVE.
+ *
+ * @param tx True for the TX DATA pool, false for the RX one.
+ * @param count Request counts of the histogram buckets.
+ * @param buf_size Size of the buffers the requests are currently split in,
+ *        0 if they are not split.
+ */
+void net_pkt_get_size_hist(bool tx, uint16_t count[NET_PKT_SIZE_HIST_BUCKETS],
+			   size_t *buf_size);
+
 /** @cond INTERNAL_HIDDEN */
 
 #if defined(CONFIG_NET_DEBUG_NET_PKT_ALLOC)
@@ -1683,6 +1736,23 @@ size_t net_pkt_available_buffer(struct net_pkt *pkt);
 size_t net_pkt_available_payload_buffer(struct net_pkt *pkt,
 					enum net_ip_protocol proto);
 
+/**
+ * @brief Get the largest payload a pkt could be allocated for
+ *
+ * @details This is the limit net_pkt_alloc_buffer() applies when asked
+ *          for @p size bytes of payload, given the MTU of the pkt's
+ *          interface and its family, whether or not the pkt actually has
+ *          a buffer.
+ *
+ * @param pkt   The net_pkt which would carry the payload
+ * @param size  The amount of payload wanted
+ * @param proto The IP protocol type (can be 0 for none).
+ *
+ * @return @p size, or less if that much does not fit
+ */
+size_t net_pkt_max_payload_len(struct net_pkt *pkt, size_t size,
+			       enum net_ip_protocol proto);
+
 /**
  * @brief Trim net_pkt buffer
  *
@@ -1795,6 +1865,28 @@ int net_pkt_copy(struct net_pkt *pkt_dst,
 		 struct net_pkt *pkt_src,
 		 size_t length);
 
+/**
+ * @brief Append data of a packet to another one without copying it.
+ *
+ * @details The source net_pkt cursor should be properly initialized and,
+ *          if needed, positioned using net_pkt_skip. It will be updated
+ *          after the operation. The data is appended to pkt in buffers
+ *          of its own which refer to the ones of pkt_src when their pool
+ *          supports it, the data being copied otherwise. The cursor of
+ *          pkt is left untouched.
+ *
+ * @param pkt     Network packet the data is appended to.
+ * @param pkt_src Source network packet.
+ * @param length  Length of data to be appended.
+ * @param timeout Maximum time to wait for a buffer.
+ *
+ * @return 0 on success, negative errno code otherwise.
+ */
+int net_pkt_append_shared(struct net_pkt *pkt,
+			  struct net_pkt *pkt_src,
+			  size_t length,
+			  k_timeout_t timeout);
+
 /**
  * @brief Clone pkt and its buffer.
  *
@@ -286,6 +286,44 @@ struct net_stats_pm {
 };
 
 
+/**
+ * @brief Usage of a network packet slab or data buffer pool
+ */
+struct net_stats_mem_pool {
+	/** Number of packets or buffers in the pool */
+	uint32_t count;
+
+	/** Number of packets or buffers in use */
+	uint32_t used;
+
+	/** Highest number of packets or buffers in use at the same time */
+	uint32_t max_used;
+
+	/** Number of failed allocations */
+	net_stats_t alloc_failures;
+
+	/** Moving average of how long they are held, in microseconds */
+	uint32_t hold_time_avg;
+};
+
+/**
+ * @brief Network memory statistics of the predefined packet slabs and
+ * data buffer pools.
+ */
+struct net_stats_mem {
+	/** RX packet slab */
+	struct net_stats_mem_pool rx_pkts;
+
+	/** TX packet slab */
+	struct net_stats_mem_pool tx_pkts;
+
+	/** RX data buffer pool */
+	struct net_stats_mem_pool rx_bufs;
+
+	/** TX data buffer pool */
+	struct net_stats_mem_pool tx_bufs;
+};
+
 /**
  * @brief All network statistics in one struct.
  */
@@ -493,7 +531,8 @@ enum net_request_stats_cmd {
 	NET_REQUEST_STATS_CMD_GET_TCP,
 	NET_REQUEST_STATS_CMD_GET_ETHERNET,
 	NET_REQUEST_STATS_CMD_GET_PPP,
-	NET_REQUEST_STATS_CMD_GET_PM
+	NET_REQUEST_STATS_CMD_GET_PM,
+	NET_REQUEST_STATS_CMD_GET_MEM,
 };
 
 #define NET_REQUEST_STATS_GET_ALL				\
@@ -581,6 +620,13 @@ NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PPP);
 NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PM);
 #endif /* CONFIG_NET_STATISTICS_POWER_MANAGEMENT */
 
+#if defined(CONFIG_NET_STATISTICS_MEMORY)
+#define NET_REQUEST_STATS_GET_MEM				\
+	(_NET_STATS_BASE | NET_REQUEST_STATS_CMD_GET_MEM)
+
+NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_MEM);
+#endif /* CONFIG_NET_STATISTICS_MEMORY */
+
 /**
  * @}
  */
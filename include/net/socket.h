@@ -27,6 +27,7 @@
 #include <net/net_ip.h>
 #include <net/dns_resolve.h>
 #include <net/socket_select.h>
+#include <net/socket_epoll.h>
 #include <stdlib.h>
 
 #ifdef __cplusplus
@@ -380,6 +381,29 @@ static inline ssize_t zsock_send(int sock, const void *buf, size_t len,
 __syscall ssize_t zsock_sendmsg(int sock, const struct msghdr *msg,
 				int flags);
 
+/**
+ * @brief Send several messages with a single call
+ *
+ * @details
+ * @rst
+ * Sends the messages of @p msgvec in order, as :c:func:`zsock_sendmsg`
+ * would, and sets their ``msg_len`` to the number of bytes sent. See
+ * the Linux ``sendmmsg(2)`` manual page for the semantics.
+ * This function is also exposed as ``sendmmsg()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @param sock Socket to send on
+ * @param msgvec Messages to send
+ * @param vlen Number of entries in @p msgvec
+ * @param flags Flags, as for zsock_sendmsg()
+ *
+ * @return Number of messages sent, or -1 with errno set if none could
+ *         be sent
+ */
+__syscall int zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
 /**
  * @brief Receive data from an arbitrary network address
  *
@@ -396,6 +420,32 @@ __syscall ssize_t zsock_recvfrom(int sock, void *buf, size_t max_len,
 				 int flags, struct sockaddr *src_addr,
 				 socklen_t *addrlen);
 
+/**
+ * @brief Receive several messages with a single call
+ *
+ * @details
+ * @rst
+ * Receives into the messages of @p msgvec in order, as
+ * :c:func:`zsock_recvfrom` would, and sets their ``msg_len`` to the
+ * number of bytes received. Only the first message waits for data, as
+ * with ``MSG_WAITFORONE`` on Linux; the call returns as soon as no
+ * more data is queued. Every message takes exactly one ``iovec``.
+ * See the Linux ``recvmmsg(2)`` manual page for the semantics.
+ * This function is also exposed as ``recvmmsg()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @param sock Socket to receive from
+ * @param msgvec Messages to fill in
+ * @param vlen Number of entries in @p msgvec
+ * @param flags Flags, as for zsock_recvfrom()
+ *
+ * @return Number of messages received, or -1 with errno set if none
+ *         could be received
+ */
+__syscall int zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
 /**
  * @brief Receive data from a connected peer
  *
@@ -414,6 +464,59 @@ static inline ssize_t zsock_recv(int sock, void *buf, size_t max_len,
 	return zsock_recvfrom(sock, buf, max_len, flags, NULL, NULL);
 }
 
+struct net_buf;
+
+/**
+ * @brief Send data held in network buffers without copying it
+ *
+ * @details
+ * Like zsock_sendto(), but the payload is taken from the buffer chain
+ * @p frags, which is queued as it is instead of being copied into
+ * buffers of the stack. Only native TCP and UDP sockets support this.
+ * The call is not available to user mode threads.
+ *
+ * On success the stack takes over the caller's reference to @p frags,
+ * the data must not be touched afterwards. On failure the caller still
+ * owns the chain and can retry or release it. A datagram too large for
+ * one packet fails with EMSGSIZE.
+ *
+ * @param sock Socket to send on
+ * @param frags Buffer chain holding the payload
+ * @param flags Only ZSOCK_MSG_DONTWAIT is supported
+ * @param dest_addr Destination, or NULL for a connected socket
+ * @param addrlen Length of @p dest_addr
+ *
+ * @return Number of bytes sent, or -1 with errno set
+ */
+ssize_t zsock_send_buf(int sock, struct net_buf *frags, int flags,
+		       const struct sockaddr *dest_addr, socklen_t addrlen);
+
+/**
+ * @brief Receive data as network buffers without copying it
+ *
+ * @details
+ * Like zsock_recvfrom(), but instead of copying the payload out, the
+ * buffers it was received in are handed over. For a datagram socket
+ * @p frags holds one whole datagram, for a stream socket the data of
+ * one received segment. The call is not available to user mode
+ * threads.
+ *
+ * The buffers come from the receive pool of the stack, they have to
+ * be released with net_buf_unref() as soon as possible.
+ *
+ * @param sock Socket to receive from
+ * @param frags Set to the buffer chain holding the payload, or NULL
+ *        if none is returned
+ * @param flags Only ZSOCK_MSG_DONTWAIT is supported
+ * @param src_addr Set to the source address if not NULL
+ * @param addrlen Length of @p src_addr, updated on return
+ *
+ * @return Number of bytes in @p frags, 0 at end of stream, or -1 with
+ *         errno set
+ */
+ssize_t zsock_recv_buf(int sock, struct net_buf **frags, int flags,
+		       struct sockaddr *src_addr, socklen_t *addrlen);
+
 /**
  * @brief Control blocking/non-blocking mode of a socket
  *
@@ -728,12 +831,24 @@ static inline ssize_t sendmsg(int sock, const struct msghdr *message,
 	return zsock_sendmsg(sock, message, flags);
 }
 
+static inline int sendmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_sendmmsg(sock, msgvec, vlen, flags);
+}
+
 static inline ssize_t recvfrom(int sock, void *buf, size_t max_len, int flags,
 			       struct sockaddr *src_addr, socklen_t *addrlen)
 {
 	return zsock_recvfrom(sock, buf, max_len, flags, src_addr, addrlen);
 }
 
+static inline int recvmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_recvmmsg(sock, msgvec, vlen, flags);
+}
+
 static inline int poll(struct zsock_pollfd *fds, int nfds, int timeout)
 {
 	return zsock_poll(fds, nfds, timeout);
@@ -865,6 +980,10 @@ struct ifreq {
 /** sockopt: Disable TCP buffering (ignored, for compatibility) */
 #define TCP_NODELAY 1
 
+/* Socket options for IPPROTO_UDP level */
+/** sockopt: Split sends into datagrams of this payload size */
+#define UDP_SEGMENT 103
+
 /* Socket options for IPPROTO_IPV6 level */
 /** sockopt: Don't support IPv4 access (ignored, for compatibility) */
 #define IPV6_V6ONLY 26
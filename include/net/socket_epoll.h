@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_
+#define ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_
+
+/**
+ * @brief BSD Sockets compatible API
+ * @defgroup bsd_sockets BSD Sockets compatible API
+ * @ingroup networking
+ * @{
+ */
+
+#include <zephyr/types.h>
+#include <sys/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** zsock_epoll_wait: Readable, same value as ZSOCK_POLLIN */
+#define ZSOCK_EPOLLIN 1
+/** zsock_epoll_wait: Writable, same value as ZSOCK_POLLOUT */
+#define ZSOCK_EPOLLOUT 4
+/** zsock_epoll_wait: Error condition (output value only) */
+#define ZSOCK_EPOLLERR 8
+/** zsock_epoll_wait: Closed connection (output value only) */
+#define ZSOCK_EPOLLHUP 0x10
+/** zsock_epoll_ctl: Report the descriptor once, then disable it */
+#define ZSOCK_EPOLLONESHOT BIT(30)
+/** zsock_epoll_ctl: Edge-triggered instead of level-triggered */
+#define ZSOCK_EPOLLET BIT(31)
+
+/** zsock_epoll_ctl: Add a descriptor to the interest set */
+#define ZSOCK_EPOLL_CTL_ADD 1
+/** zsock_epoll_ctl: Remove a descriptor from the interest set */
+#define ZSOCK_EPOLL_CTL_DEL 2
+/** zsock_epoll_ctl: Change the events of a descriptor */
+#define ZSOCK_EPOLL_CTL_MOD 3
+
+typedef union zsock_epoll_data {
+	void *ptr;
+	int fd;
+	uint32_t u32;
+	uint64_t u64;
+} zsock_epoll_data_t;
+
+struct zsock_epoll_event {
+	/** ZSOCK_EPOLL* events requested or reported */
+	uint32_t events;
+	/** Caller data, returned as is with the events */
+	zsock_epoll_data_t data;
+};
+
+/**
+ * @brief Create an epoll instance
+ *
+ * @details
+ * @rst
+ * Creates a file descriptor holding a persistent set of descriptors
+ * to watch, see the Linux ``epoll(7)`` manual page for the semantics.
+ * Unlike :c:func:`zsock_poll`, the cost of waiting does not depend on
+ * the number of descriptors watched but on the number of ready ones.
+ * Only native TCP and UDP sockets can be watched. The instance is
+ * released with :c:func:`zsock_close`.
+ * This function is also exposed as ``epoll_create1()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @param flags Must be 0
+ *
+ * @return File descriptor, or -1 with errno set
+ */
+int zsock_epoll_create1(int flags);
+
+/**
+ * @brief Change the interest set of an epoll instance
+ *
+ * @details
+ * @rst
+ * Adds (``ZSOCK_EPOLL_CTL_ADD``), changes (``ZSOCK_EPOLL_CTL_MOD``) or
+ * removes (``ZSOCK_EPOLL_CTL_DEL``) @p fd. A closed descriptor is
+ * removed automatically.
+ * This function is also exposed as ``epoll_ctl()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @param epfd Epoll instance
+ * @param op Operation
+ * @param fd Descriptor to watch
+ * @param event Events to watch for and data to report, unused for
+ *        ZSOCK_EPOLL_CTL_DEL
+ *
+ * @return 0, or -1 with errno set
+ */
+int zsock_epoll_ctl(int epfd, int op, int fd, struct zsock_epoll_event *event);
+
+/**
+ * @brief Wait for events on an epoll instance
+ *
+ * @details
+ * @rst
+ * A level-triggered descriptor is reported as long as it is ready, an
+ * edge-triggered one (``ZSOCK_EPOLLET``) only again after new data
+ * arrived.
+ * This function is also exposed as ``epoll_wait()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @param epfd Epoll instance
+ * @param events Set to the ready descriptors
+ * @param maxevents Size of @p events
+ * @param timeout Timeout in milliseconds, -1 to wait forever
+ *
+ * @return Number of entries filled in @p events, 0 on timeout, or -1
+ *         with errno set
+ */
+int zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+		     int maxevents, int timeout);
+
+#ifdef CONFIG_NET_SOCKETS_POSIX_NAMES
+
+#define epoll_event zsock_epoll_event
+#define epoll_data_t zsock_epoll_data_t
+
+#define EPOLLIN ZSOCK_EPOLLIN
+#define EPOLLOUT ZSOCK_EPOLLOUT
+#define EPOLLERR ZSOCK_EPOLLERR
+#define EPOLLHUP ZSOCK_EPOLLHUP
+#define EPOLLONESHOT ZSOCK_EPOLLONESHOT
+#define EPOLLET ZSOCK_EPOLLET
+
+#define EPOLL_CTL_ADD ZSOCK_EPOLL_CTL_ADD
+#define EPOLL_CTL_DEL ZSOCK_EPOLL_CTL_DEL
+#define EPOLL_CTL_MOD ZSOCK_EPOLL_CTL_MOD
+
+static inline int epoll_create1(int flags)
+{
+	return zsock_epoll_create1(flags);
+}
+
+static inline int epoll_ctl(int epfd, int op, int fd,
+			    struct zsock_epoll_event *event)
+{
+	return zsock_epoll_ctl(epfd, op, fd, event);
+}
+
+static inline int epoll_wait(int epfd, struct zsock_epoll_event *events,
+			     int maxevents, int timeout)
+{
+	return zsock_epoll_wait(epfd, events, maxevents, timeout);
+}
+
+#endif /* CONFIG_NET_SOCKETS_POSIX_NAMES */
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_ */
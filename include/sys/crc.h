@@ -204,6 +204,33 @@ uint8_t crc8_ccitt(uint8_t initial_value, const void *buf, size_t len);
  */
 uint8_t crc7_be(uint8_t seed, const uint8_t *src, size_t len);
 
+/**
+ * @brief Operations of a hardware CRC unit
+ *
+ * A driver for a CRC unit registers these with crc_hw_register() to
+ * take over the CRC-32 computations of crc32_ieee(),
+ * crc32_ieee_update() and crc32_c(). The operations work on the
+ * reflected CRC register, neither the initial nor the final inversion
+ * is applied to it, and they may be called from any context.
+ */
+struct crc_hw_api {
+	/** Update a CRC-32 (IEEE) register, NULL if not supported */
+	uint32_t (*crc32_ieee)(uint32_t crc, const uint8_t *data, size_t len);
+	/** Update a CRC-32C (Castagnoli) register, NULL if not supported */
+	uint32_t (*crc32_c)(uint32_t crc, const uint8_t *data, size_t len);
+	/** Shorter buffers are still processed by the CPU */
+	size_t min_len;
+};
+
+/**
+ * @brief Register a hardware CRC unit
+ *
+ * Requires CONFIG_CRC_HW_HOOK.
+ *
+ * @param api Operations of the CRC unit, NULL to go back to the CPU.
+ */
+void crc_hw_register(const struct crc_hw_api *api);
+
 /**
  * @}
  */
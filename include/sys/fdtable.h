@@ -8,6 +8,8 @@
 
 #include <stdarg.h>
 #include <sys/types.h>
+#include <sys/slist.h>
+#include <sys/util.h>
 /* FIXME: For native_posix ssize_t, off_t. */
 #include <fs/fs.h>
 
@@ -147,8 +149,35 @@ enum {
 	ZFD_IOCTL_POLL_UPDATE,
 	ZFD_IOCTL_POLL_OFFLOAD,
 	ZFD_IOCTL_SET_LOCK,
+	ZFD_IOCTL_WATCH_ADD,
+	ZFD_IOCTL_WATCH_DEL,
+	ZFD_IOCTL_WATCH_EVENTS,
 };
 
+/**
+ * Readiness watch on a descriptor object.
+ *
+ * An object supporting ZFD_IOCTL_WATCH_ADD/ZFD_IOCTL_WATCH_DEL keeps
+ * the watches added to it in a list and calls z_fd_watch_notify() on
+ * it, with its descriptor lock held, whenever it may have become ready
+ * for any of the ZSOCK_POLL* @p events, and with ZSOCK_POLLNVAL when it
+ * is closed, after which the watch is dropped. ZFD_IOCTL_WATCH_EVENTS
+ * returns the ZSOCK_POLL* events the object is currently ready for.
+ */
+struct z_fd_watch {
+	sys_snode_t node;
+	void (*notify)(struct z_fd_watch *watch, uint32_t events);
+};
+
+static inline void z_fd_watch_notify(sys_slist_t *watches, uint32_t events)
+{
+	struct z_fd_watch *watch, *next;
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(watches, watch, next, node) {
+		watch->notify(watch, events);
+	}
+}
+
 #ifdef __cplusplus
 }
 #endif
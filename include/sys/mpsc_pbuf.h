@@ -39,6 +39,14 @@ extern "C" {
  * Reading packets is performed in two steps. First packet is claimed. Claiming
  * returns pointer to the packet within the buffer. Packet is freed when no
  * longer in use.
+ *
+ * A buffer created with MPSC_PBUF_MODE_READERS has instead any number of
+ * readers, up to CONFIG_MPSC_PBUF_READERS, each reading every packet at its
+ * own pace with its own read index. Space is reclaimed once all the readers
+ * have freed a packet. When space is needed for a new packet and a reader has
+ * not read the oldest one yet, the packet is dropped for that reader if it was
+ * added with MPSC_PBUF_READER_MODE_OVERWRITE, otherwise allocation waits or
+ * fails as for a buffer without overwrite mode.
  */
 
 /**@defgroup MPSC_PBUF_FLAGS MPSC packet buffer flags
@@ -58,6 +66,22 @@ extern "C" {
  */
 #define MPSC_PBUF_MODE_OVERWRITE BIT(1)
 
+/** @brief Flag indicating that the buffer is read by readers.
+ *
+ * Packets are read with @ref mpsc_pbuf_reader_claim by each reader added with
+ * @ref mpsc_pbuf_reader_add, the full buffer policy is set for each reader and
+ * MPSC_PBUF_MODE_OVERWRITE is ignored.
+ */
+#define MPSC_PBUF_MODE_READERS BIT(2)
+
+/** @brief Flag indicating reader full buffer policy.
+ *
+ * If flag is set then packets not read yet by the reader are dropped for it
+ * when space is needed. When flag is not set then the reader holds the space
+ * until it has read the packets.
+ */
+#define MPSC_PBUF_READER_MODE_OVERWRITE BIT(0)
+
 /**@} */
 
 /* Forward declaration */
@@ -80,6 +104,24 @@ typedef uint32_t (*mpsc_pbuf_get_wlen)(union mpsc_pbuf_generic *packet);
 typedef void (*mpsc_pbuf_notify_drop)(struct mpsc_pbuf_buffer *buffer,
 					union mpsc_pbuf_generic *packet);
 
+/** @brief Reader of a MPSC packet buffer. */
+struct mpsc_pbuf_reader {
+	/** Read index, start of the next packet to read. */
+	uint32_t rd_idx;
+
+	/** Flags. */
+	uint32_t flags;
+
+	/** Number of packets dropped before being read. */
+	uint32_t dropped;
+
+	/** Set while a packet is claimed. */
+	bool claimed;
+
+	/** Given whenever packets are committed. */
+	struct k_sem sem;
+};
+
 /** @brief MPSC packet buffer structure. */
 struct mpsc_pbuf_buffer {
 	/** Temporary write index. */
@@ -106,6 +148,11 @@ struct mpsc_pbuf_buffer {
 	/** Callback for getting packet length. */
 	mpsc_pbuf_get_wlen get_wlen;
 
+#if CONFIG_MPSC_PBUF_READERS > 0
+	/** Readers, if MPSC_PBUF_MODE_READERS is set. */
+	struct mpsc_pbuf_reader *readers[CONFIG_MPSC_PBUF_READERS];
+#endif
+
 	/* Buffer. */
 	uint32_t *buf;
 
@@ -234,6 +281,90 @@ void mpsc_pbuf_free(struct mpsc_pbuf_buffer *buffer,
  */
 bool mpsc_pbuf_is_pending(struct mpsc_pbuf_buffer *buffer);
 
+/** @brief Add a reader to a buffer.
+ *
+ * The reader starts with the oldest packet held by the buffer.
+ *
+ * @param buffer Buffer created with MPSC_PBUF_MODE_READERS.
+ *
+ * @param reader Reader.
+ *
+ * @param flags Reader flags.
+ *
+ * @retval 0 on success.
+ * @retval -ENOMEM if the buffer has CONFIG_MPSC_PBUF_READERS readers already.
+ */
+int mpsc_pbuf_reader_add(struct mpsc_pbuf_buffer *buffer,
+			 struct mpsc_pbuf_reader *reader, uint32_t flags);
+
+/** @brief Remove a reader from a buffer.
+ *
+ * The reader must not hold a claimed packet. The space of the packets it has
+ * not read is reclaimed when needed. A packet committed at the same time may
+ * still give the semaphore of the reader.
+ *
+ * @param buffer Buffer.
+ *
+ * @param reader Reader.
+ */
+void mpsc_pbuf_reader_remove(struct mpsc_pbuf_buffer *buffer,
+			     struct mpsc_pbuf_reader *reader);
+
+/** @brief Claim the next packet of a reader.
+ *
+ * A reader claims one packet at a time.
+ *
+ * @param buffer Buffer.
+ *
+ * @param reader Reader.
+ *
+ * @param timeout Timeout. If called from thread context it will pend for given
+ * timeout if there is no packet to read.
+ *
+ * @return Pointer to the packet or null if there is none.
+ */
+union mpsc_pbuf_generic *mpsc_pbuf_reader_claim(struct mpsc_pbuf_buffer *buffer,
+						struct mpsc_pbuf_reader *reader,
+						k_timeout_t timeout);
+
+/** @brief Free a packet claimed by a reader.
+ *
+ * @param buffer Buffer.
+ *
+ * @param reader Reader.
+ *
+ * @param packet Packet.
+ */
+void mpsc_pbuf_reader_free(struct mpsc_pbuf_buffer *buffer,
+			   struct mpsc_pbuf_reader *reader,
+			   union mpsc_pbuf_generic *packet);
+
+/** @brief Check if a reader has packets to read.
+ *
+ * @param buffer Buffer.
+ *
+ * @param reader Reader.
+ *
+ * @retval true if pending.
+ * @retval false if no packet is pending.
+ */
+bool mpsc_pbuf_reader_is_pending(struct mpsc_pbuf_buffer *buffer,
+				 struct mpsc_pbuf_reader *reader);
+
+/** @brief Get the number of packets dropped for a reader.
+ *
+ * The count is cleared.
+ *
+ * @param buffer Buffer.
+ *
+ * @param reader Reader.
+ *
+ * @return Number of packets dropped before the reader read them, since the
+ * previous call.
+ */
+uint32_t mpsc_pbuf_reader_dropped(struct mpsc_pbuf_buffer *buffer,
+				  struct mpsc_pbuf_reader *reader);
+
 /**
  * @}
  */
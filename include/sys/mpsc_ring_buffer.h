@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/** @file */
+
+#ifndef ZEPHYR_INCLUDE_SYS_MPSC_RING_BUFFER_H_
+#define ZEPHYR_INCLUDE_SYS_MPSC_RING_BUFFER_H_
+
+#include <kernel.h>
+#include <sys/atomic.h>
+#include <sys/util.h>
+#include <errno.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A structure to represent a multi producer ring buffer
+ *
+ * Producers reserve space by moving @a claim forward with an atomic
+ * operation, copy their data, then publish it by moving @a tail forward in
+ * the order in which the space was reserved. Indexes run freely and wrap with
+ * the size, which is a power of 2.
+ */
+struct mpsc_ring_buf {
+	atomic_t claim;	/**< End of the space reserved by producers */
+	atomic_t tail;	/**< End of the data published by producers */
+	atomic_t head;	/**< Start of the data, moved by the consumer */
+	atomic_t dropped_put_count; /**< Running tally of the number of
+				     * failed put attempts.
+				     */
+	uint32_t size;	/**< Size of buf in 32-bit chunks or bytes */
+	uint32_t mask;	/**< Modulo mask, size - 1 */
+
+	union mpsc_ring_buf_buffer {
+		uint32_t *buf32; /**< Memory region for stored entries */
+		uint8_t *buf8;
+	} buf;
+};
+
+/**
+ * @defgroup mpsc_ring_buffer_apis Multi producer ring buffer APIs
+ * @ingroup datastructure_apis
+ * @{
+ */
+
+/**
+ * @brief Statically define and initialize a multi producer ring buffer for
+ * data items.
+ *
+ * The ring buffer contains 2^pow 32-bit words.
+ *
+ * @param name Name of the ring buffer.
+ * @param pow Ring buffer size exponent.
+ */
+#define MPSC_RING_BUF_ITEM_DECLARE_POW2(name, pow) \
+	BUILD_ASSERT(pow < 31, "Size too big"); \
+	static uint32_t _mpsc_ring_buffer_data_##name[BIT(pow)]; \
+	struct mpsc_ring_buf name = { \
+		.size = BIT(pow), \
+		.mask = BIT(pow) - 1, \
+		.buf = { .buf32 = _mpsc_ring_buffer_data_##name } \
+	}
+
+/**
+ * @brief Statically define and initialize a multi producer ring buffer for
+ * byte data.
+ *
+ * The ring buffer contains 2^pow bytes.
+ *
+ * @param name Name of the ring buffer.
+ * @param pow Ring buffer size exponent.
+ */
+#define MPSC_RING_BUF_DECLARE_POW2(name, pow) \
+	BUILD_ASSERT(pow < 31, "Size too big"); \
+	static uint8_t _mpsc_ring_buffer_data_##name[BIT(pow)]; \
+	struct mpsc_ring_buf name = { \
+		.size = BIT(pow), \
+		.mask = BIT(pow) - 1, \
+		.buf = { .buf8 = _mpsc_ring_buffer_data_##name } \
+	}
+
+/**
+ * @brief Initialize a multi producer ring buffer.
+ *
+ * This routine initializes a ring buffer, prior to its first use. It is only
+ * used for ring buffers not defined using MPSC_RING_BUF_DECLARE_POW2 or
+ * MPSC_RING_BUF_ITEM_DECLARE_POW2.
+ *
+ * @param buf Address of ring buffer.
+ * @param size Ring buffer size (in 32-bit words or bytes), a power of 2.
+ * @param data Ring buffer data area (uint32_t data[size] or uint8_t data[size]
+ *	       for bytes mode).
+ */
+static inline void mpsc_ring_buf_init(struct mpsc_ring_buf *buf,
+				      uint32_t size, void *data)
+{
+	__ASSERT(is_power_of_two(size) && size < BIT(31),
+		 "Size must be a power of 2");
+
+	memset(buf, 0, sizeof(struct mpsc_ring_buf));
+	buf->size = size;
+	buf->mask = size - 1U;
+	buf->buf.buf32 = (uint32_t *)data;
+}
+
+/**
+ * @brief Determine if a multi producer ring buffer is empty.
+ *
+ * Data being written by producers is not accounted for.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return 1 if the ring buffer is empty, or 0 if not.
+ */
+static inline int mpsc_ring_buf_is_empty(struct mpsc_ring_buf *buf)
+{
+	return atomic_get(&buf->head) == atomic_get(&buf->tail);
+}
+
+/**
+ * @brief Determine free space in a multi producer ring buffer.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return Ring buffer free space (in 32-bit words or bytes).
+ */
+static inline uint32_t mpsc_ring_buf_space_get(struct mpsc_ring_buf *buf)
+{
+	uint32_t head = (uint32_t)atomic_get(&buf->head);
+
+	return buf->size - ((uint32_t)atomic_get(&buf->claim) - head);
+}
+
+/**
+ * @brief Return multi producer ring buffer capacity.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return Ring buffer capacity (in 32-bit words or bytes).
+ */
+static inline uint32_t mpsc_ring_buf_capacity_get(struct mpsc_ring_buf *buf)
+{
+	return buf->size;
+}
+
+/**
+ * @brief Write a data item to a multi producer ring buffer.
+ *
+ * This routine writes a data item to ring buffer @a buf. The data item
+ * is an array of 32-bit words (from zero to 1020 bytes in length),
+ * coupled with a 16-bit type identifier and an 8-bit integer value.
+ *
+ * It can be called concurrently by several threads and interrupts, on any
+ * CPU. Interrupts are locked on the calling CPU while the item is written.
+ *
+ * @param buf Address of ring buffer.
+ * @param type Data item's type identifier (application specific).
+ * @param value Data item's integer value (application specific).
+ * @param data Address of data item.
+ * @param size32 Data item size (number of 32-bit words).
+ *
+ * @retval 0 Data item was written.
+ * @retval -EMSGSIZE Ring buffer has insufficient free space.
+ */
+int mpsc_ring_buf_item_put(struct mpsc_ring_buf *buf, uint16_t type,
+			   uint8_t value, const uint32_t *data,
+			   uint8_t size32);
+
+/**
+ * @brief Read a data item from a multi producer ring buffer.
+ *
+ * This routine reads a data item from ring buffer @a buf. The data item
+ * is an array of 32-bit words (up to 1020 bytes in length),
+ * coupled with a 16-bit type identifier and an 8-bit integer value.
+ *
+ * @warning
+ * There must be a single reader.
+ *
+ * @param buf Address of ring buffer.
+ * @param type Area to store the data item's type identifier.
+ * @param value Area to store the data item's integer value.
+ * @param data Area to store the data item. Can be NULL to discard data.
+ * @param size32 Size of the data item storage area (number of 32-bit chunks).
+ *
+ * @retval 0 Data item was fetched; @a size32 now contains the number of
+ *         32-bit words read into data area @a data.
+ * @retval -EAGAIN Ring buffer is empty.
+ * @retval -EMSGSIZE Data area @a data is too small; @a size32 now contains
+ *         the number of 32-bit words needed.
+ */
+int mpsc_ring_buf_item_get(struct mpsc_ring_buf *buf, uint16_t *type,
+			   uint8_t *value, uint32_t *data, uint8_t *size32);
+
+/**
+ * @brief Write (copy) data to a multi producer ring buffer.
+ *
+ * This routine writes data to a ring buffer @a buf. Data is written whole or
+ * not at all, so that data of different producers never interleaves.
+ *
+ * It can be called concurrently by several threads and interrupts, on any
+ * CPU. Interrupts are locked on the calling CPU while data is written.
+ *
+ * @param buf Address of ring buffer.
+ * @param data Address of data.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes written, @a size or 0.
+ */
+uint32_t mpsc_ring_buf_put(struct mpsc_ring_buf *buf, const uint8_t *data,
+			   uint32_t size);
+
+/**
+ * @brief Get address of a valid data in a multi producer ring buffer.
+ *
+ * With this routine, memory copying can be reduced since internal ring buffer
+ * can be used directly by the user. Once data is processed it can be freed
+ * using @ref mpsc_ring_buf_get_finish.
+ *
+ * @warning
+ * There must be a single reader.
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] data Pointer to the address. It is set to a location within
+ *		    ring buffer.
+ * @param[in]  size Requested size (in bytes).
+ *
+ * @return Number of valid bytes in the provided buffer which can be smaller
+ *	   than requested if there is not enough data or buffer wraps.
+ */
+uint32_t mpsc_ring_buf_get_claim(struct mpsc_ring_buf *buf, uint8_t **data,
+				 uint32_t size);
+
+/**
+ * @brief Indicate number of bytes read from claimed buffer.
+ *
+ * @warning
+ * There must be a single reader.
+ *
+ * @param  buf  Address of ring buffer.
+ * @param  size Number of bytes that can be freed.
+ *
+ * @retval 0 Successful operation.
+ * @retval -EINVAL Provided @a size exceeds valid bytes in the ring buffer.
+ */
+int mpsc_ring_buf_get_finish(struct mpsc_ring_buf *buf, uint32_t size);
+
+/**
+ * @brief Read data from a multi producer ring buffer.
+ *
+ * @warning
+ * There must be a single reader.
+ *
+ * @param buf  Address of ring buffer.
+ * @param data Address of the output buffer. Can be NULL to discard data.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes written to the output buffer.
+ */
+uint32_t mpsc_ring_buf_get(struct mpsc_ring_buf *buf, uint8_t *data,
+			   uint32_t size);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_MPSC_RING_BUFFER_H_ */
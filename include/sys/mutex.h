@@ -11,9 +11,9 @@
  * sys_mutex behaves almost exactly like k_mutex, with the added advantage
  * that a sys_mutex instance can reside in user memory.
  *
- * Further enhancements will support locking/unlocking uncontended sys_mutexes
- * with simple atomic ops instead of syscalls, similar to Linux's
- * FUTEX_LOCK_PI and FUTEX_UNLOCK_PI
+ * With CONFIG_SYS_MUTEX_FAST_PATH, uncontended sys_mutexes are locked and
+ * unlocked with simple atomic ops instead of syscalls, similar to Linux's
+ * FUTEX_LOCK_PI and FUTEX_UNLOCK_PI.
  */
 
 #ifdef __cplusplus
@@ -24,15 +24,48 @@ extern "C" {
 #include <sys/atomic.h>
 #include <zephyr/types.h>
 #include <sys_clock.h>
+#ifdef CONFIG_SYS_MUTEX_FAST_PATH
+#include <kernel.h>
+#endif
 
 struct sys_mutex {
-	/* Currently unused, but will be used to store state for fast mutexes
-	 * that can be locked/unlocked with atomic ops if there is no
-	 * contention
+	/* Lock state, only used with CONFIG_SYS_MUTEX_FAST_PATH: one of
+	 * the Z_SYS_MUTEX_* values below
 	 */
 	atomic_t val;
+#ifdef CONFIG_SYS_MUTEX_FAST_PATH
+	/* Owning thread, written by the owner after taking the lock or by
+	 * the kernel when handing the lock over to a waiter
+	 */
+	struct k_thread *owner;
+	uint32_t lock_count;
+#endif
 };
 
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+#define Z_SYS_MUTEX_UNLOCKED	0
+#define Z_SYS_MUTEX_LOCKED	1
+#define Z_SYS_MUTEX_CONTENDED	2	/* Locked, waiters may be in the kernel */
+
+#ifdef CONFIG_SYS_MUTEX_FAST_PATH
+extern __thread k_tid_t z_sys_mutex_self_tid;
+
+/* k_current_get() is a system call in user mode, so remember it */
+static inline k_tid_t z_sys_mutex_self(void)
+{
+	if (z_sys_mutex_self_tid == NULL) {
+		z_sys_mutex_self_tid = k_current_get();
+	}
+
+	return z_sys_mutex_self_tid;
+}
+#endif
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
 /**
  * @defgroup user_mutex_apis User mode mutex APIs
  * @ingroup kernel_apis
@@ -100,10 +133,42 @@ __syscall int z_sys_mutex_kernel_unlock(struct sys_mutex *mutex);
  * @retval -EAGAIN Waiting period timed out.
  * @retval -EACCES Caller has no access to provided mutex address
  * @retval -EINVAL Provided mutex not recognized by the kernel
+ *
+ * @note With CONFIG_SYS_MUTEX_FAST_PATH, a user mode caller accesses the
+ *       mutex directly while it is uncontended: a mutex outside the
+ *       caller's memory domain faults instead of returning -EACCES, and
+ *       -EINVAL is only returned once the kernel is entered. A NULL mutex
+ *       and supervisor mode callers always get the checks.
  */
 static inline int sys_mutex_lock(struct sys_mutex *mutex, k_timeout_t timeout)
 {
-	/* For now, make the syscall unconditionally */
+#ifdef CONFIG_SYS_MUTEX_FAST_PATH
+	k_tid_t self;
+
+	/* Supervisor mode calls the kernel directly, without a system call,
+	 * so the fast path would only skip the checks of the mutex
+	 */
+	if (!k_is_user_context() || mutex == NULL) {
+		return z_sys_mutex_kernel_lock(mutex, timeout);
+	}
+
+	self = z_sys_mutex_self();
+
+	if (mutex->owner == self) {
+		mutex->lock_count++;
+		return 0;
+	}
+
+	if (atomic_cas(&mutex->val, Z_SYS_MUTEX_UNLOCKED, Z_SYS_MUTEX_LOCKED)) {
+		mutex->owner = self;
+		mutex->lock_count = 1U;
+		return 0;
+	}
+
+	if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		return -EBUSY;
+	}
+#endif
 	return z_sys_mutex_kernel_lock(mutex, timeout);
 }
 
@@ -123,10 +188,45 @@ static inline int sys_mutex_lock(struct sys_mutex *mutex, k_timeout_t timeout)
  * @retval -EINVAL Provided mutex not recognized by the kernel or mutex wasn't
  *                 locked
  * @retval -EPERM Caller does not own the mutex
+ *
+ * @note With CONFIG_SYS_MUTEX_FAST_PATH, the same restrictions on error
+ *       reporting as for sys_mutex_lock() apply.
  */
 static inline int sys_mutex_unlock(struct sys_mutex *mutex)
 {
-	/* For now, make the syscall unconditionally */
+#ifdef CONFIG_SYS_MUTEX_FAST_PATH
+	k_tid_t self;
+
+	if (!k_is_user_context() || mutex == NULL) {
+		return z_sys_mutex_kernel_unlock(mutex);
+	}
+
+	self = z_sys_mutex_self();
+
+	if (mutex->owner != self) {
+		return (mutex->owner == NULL) ? -EINVAL : -EPERM;
+	}
+
+	if (mutex->lock_count > 1U) {
+		mutex->lock_count--;
+		return 0;
+	}
+
+	if (atomic_get(&mutex->val) == Z_SYS_MUTEX_LOCKED) {
+		/* Give up ownership before the lock can be taken again */
+		mutex->owner = NULL;
+		mutex->lock_count = 0U;
+
+		if (atomic_cas(&mutex->val, Z_SYS_MUTEX_LOCKED,
+			       Z_SYS_MUTEX_UNLOCKED)) {
+			return 0;
+		}
+
+		/* A waiter showed up, the kernel hands the lock over */
+		mutex->owner = self;
+		mutex->lock_count = 1U;
+	}
+#endif
 	return z_sys_mutex_kernel_unlock(mutex);
 }
 
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef ZEPHYR_INCLUDE_SYS_P4WQ_POOL_H_
+#define ZEPHYR_INCLUDE_SYS_P4WQ_POOL_H_
+
+#include <sys/p4wq.h>
+#include <sys/atomic.h>
+
+/* Work-stealing fork/join task pool built on P4 work queue threads */
+
+struct k_p4wq_task;
+struct k_p4wq_pool;
+
+/**
+ * Task handler callback
+ */
+typedef void (*k_p4wq_task_handler_t)(struct k_p4wq_task *task);
+
+/**
+ * Range callback for k_p4wq_parallel_for(), handles [start, end)
+ */
+typedef void (*k_p4wq_range_fn_t)(uint32_t start, uint32_t end, void *arg);
+
+/**
+ * @brief Task group
+ *
+ * Tracks a set of submitted tasks so that a thread can join them
+ * with k_p4wq_task_group_wait().
+ */
+struct k_p4wq_task_group {
+	/* reserved for implementation */
+	struct k_p4wq_pool *pool;
+	atomic_t pending;
+	struct k_sem done;
+};
+
+/**
+ * @brief Task
+ *
+ * User-populated struct representing a unit of work.  Embed it in a
+ * larger struct to pass arguments to the handler.
+ */
+struct k_p4wq_task {
+	/* Filled out by submitting code */
+	k_p4wq_task_handler_t handler;
+
+	/* reserved for implementation */
+	struct k_p4wq_task_group *group;
+};
+
+/**
+ * @brief Pool worker
+ *
+ * One per worker; each is served by one thread of the underlying P4
+ * queue and owns a deque of tasks.
+ */
+struct k_p4wq_pool_worker {
+	struct k_spinlock lock;
+	/* Oldest (stolen from) and one past the newest (owner end) task */
+	uint32_t head;
+	uint32_t tail;
+	struct k_p4wq_task *deque[CONFIG_P4WQ_POOL_DEQUE_SIZE];
+
+	struct k_p4wq_work work;
+	struct k_p4wq_pool *pool;
+};
+
+/**
+ * @brief Work-stealing task pool
+ */
+struct k_p4wq_pool {
+	struct k_p4wq_pool_worker *workers;
+	uint32_t n_workers;
+
+	/* Tasks sitting in any deque, and workers about to sleep */
+	atomic_t queued;
+	atomic_t idle;
+	/* Round robin cursor for submissions from outside the pool */
+	atomic_t next;
+	atomic_t stopping;
+	struct k_sem wake;
+};
+
+/**
+ * @brief Statically define a task pool
+ *
+ * The pool is ready for k_p4wq_pool_start(), no k_p4wq_pool_init()
+ * call is needed.
+ *
+ * @param name Symbol name of the struct k_p4wq_pool to define
+ * @param n Number of workers
+ */
+#define K_P4WQ_POOL_DEFINE(name, n)					\
+	static struct k_p4wq_pool_worker _p4pool_workers_##name[n];	\
+	static struct k_p4wq_pool name = {				\
+		.workers = _p4pool_workers_##name,			\
+		.n_workers = n,						\
+		.wake = Z_SEM_INITIALIZER(name.wake, 0, n),		\
+	}
+
+/**
+ * @brief Initialize a task pool
+ *
+ * @param pool Pool to initialize
+ * @param workers Array of @p n_workers worker structs
+ * @param n_workers Number of workers, normally CONFIG_MP_NUM_CPUS
+ */
+void k_p4wq_pool_init(struct k_p4wq_pool *pool,
+		      struct k_p4wq_pool_worker *workers, uint32_t n_workers);
+
+/**
+ * @brief Start the workers of a task pool
+ *
+ * Submits one long running item per worker to @p queue, which must
+ * have at least as many threads as the pool has workers for all of
+ * them to run concurrently.  The workers keep their P4 threads until
+ * k_p4wq_pool_stop() is called.
+ *
+ * @param pool Pool to start
+ * @param queue P4 queue providing the worker threads
+ * @param priority Thread priority the workers run at
+ */
+void k_p4wq_pool_start(struct k_p4wq_pool *pool, struct k_p4wq *queue,
+		       int32_t priority);
+
+/**
+ * @brief Stop the workers of a task pool
+ *
+ * Waits for every worker to return its thread to the P4 queue.  All
+ * task groups must have been joined first.
+ *
+ * @param pool Pool to stop
+ */
+void k_p4wq_pool_stop(struct k_p4wq_pool *pool);
+
+/**
+ * @brief Initialize a task group
+ *
+ * @param group Group to initialize
+ * @param pool Pool the tasks of the group will run on
+ */
+void k_p4wq_task_group_init(struct k_p4wq_task_group *group,
+			    struct k_p4wq_pool *pool);
+
+/**
+ * @brief Submit a task to a group
+ *
+ * When called from a pool worker the task is pushed onto that
+ * worker's own deque, otherwise onto the deques of the workers in
+ * turn.  If the deque is full the task runs right away on the calling
+ * thread.  The task must stay valid until its group has been joined.
+ *
+ * @param group Group the task belongs to
+ * @param task Task to submit, with the handler filled in
+ */
+void k_p4wq_task_submit(struct k_p4wq_task_group *group,
+			struct k_p4wq_task *task);
+
+/**
+ * @brief Join a task group
+ *
+ * Returns once every task submitted to the group has completed.  The
+ * caller runs queued tasks of the pool while it waits; a pool worker
+ * keeps doing so until the group is complete, any other thread blocks
+ * once there is nothing left to steal.  Tasks may submit to and join
+ * groups of their own.  The group can be re-initialized and reused
+ * afterwards.
+ *
+ * @param group Group to join
+ */
+void k_p4wq_task_group_wait(struct k_p4wq_task_group *group);
+
+/**
+ * @brief Run a loop over a range in parallel
+ *
+ * Calls @p fn on disjoint sub-ranges covering [start, end), none of
+ * them longer than @p grain, by recursively splitting the range in
+ * half into tasks.  The calling thread takes part and the call
+ * returns when the whole range has been processed.
+ *
+ * @param pool Pool to run on
+ * @param start First index
+ * @param end One past the last index
+ * @param grain Largest sub-range handed to a single call of @p fn
+ * @param fn Range callback
+ * @param arg Opaque argument passed to @p fn
+ *
+ * @retval 0 on success
+ * @retval -EINVAL if @p grain is zero or @p end is before @p start
+ */
+int k_p4wq_parallel_for(struct k_p4wq_pool *pool, uint32_t start,
+			uint32_t end, uint32_t grain, k_p4wq_range_fn_t fn,
+			void *arg);
+
+#endif /* ZEPHYR_INCLUDE_SYS_P4WQ_POOL_H_ */
@@ -52,6 +52,9 @@ struct sys_heap {
 	struct z_heap *heap;
 	void *init_mem;
 	size_t init_bytes;
+#ifdef CONFIG_SYS_HEAP_SLAB
+	struct z_heap_slab *slab;
+#endif
 };
 
 struct z_heap_stress_result {
@@ -149,6 +152,119 @@ void *sys_heap_aligned_realloc(struct sys_heap *heap, void *ptr,
 #define sys_heap_realloc(heap, ptr, bytes) \
 	sys_heap_aligned_realloc(heap, ptr, 0, bytes)
 
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+
+/* One per possible free list bucket of a heap */
+#define SYS_HEAP_RUNTIME_STATS_BUCKETS 32
+
+struct sys_heap_runtime_stats {
+	/** Bytes in free chunks */
+	size_t free_bytes;
+	/** Bytes in allocated chunks */
+	size_t allocated_bytes;
+	/** Highest value allocated_bytes has had */
+	size_t max_allocated_bytes;
+	/** Largest block a sys_heap_alloc() could currently return */
+	size_t largest_free_bytes;
+	/** Number of live allocations */
+	uint32_t alloc_count;
+	/** Number of valid entries in @a free_chunks */
+	uint32_t nb_buckets;
+	/** Free chunks per bucket.  Bucket n holds the chunks of 2^n to
+	 * 2^(n+1) - 1 units (of 8 bytes) more than the smallest chunk.
+	 */
+	uint32_t free_chunks[SYS_HEAP_RUNTIME_STATS_BUCKETS];
+};
+
+/** @brief Get the runtime statistics of a sys_heap
+ *
+ * Byte counts are of whole chunks, including their headers and any
+ * rounding, so free_bytes + allocated_bytes is constant.  Slab pages
+ * (see sys_heap_slab_init()) count as single allocations of their
+ * full size.  The free chunk histogram and largest free block are
+ * computed by walking the free lists, so this call is linear in the
+ * number of free chunks.
+ *
+ * @note Like the rest of the sys_heap API, this is not synchronized.
+ *
+ * @param heap Heap to query
+ * @param stats Where to store the statistics
+ * @return 0 on success, -EINVAL on a NULL argument
+ */
+int sys_heap_runtime_stats_get(struct sys_heap *heap,
+			       struct sys_heap_runtime_stats *stats);
+
+/** @brief Restart peak usage tracking of a sys_heap
+ *
+ * Sets max_allocated_bytes to the current allocated_bytes.
+ *
+ * @param heap Heap to reset
+ * @return 0 on success, -EINVAL on a NULL argument
+ */
+int sys_heap_runtime_stats_reset_max(struct sys_heap *heap);
+
+#endif /* CONFIG_SYS_HEAP_RUNTIME_STATS */
+
+#ifdef CONFIG_SYS_HEAP_SLAB
+
+/* Slab classes are powers of two from 32 bytes up */
+#define SYS_HEAP_SLAB_MIN_SIZE 32U
+#define SYS_HEAP_SLAB_MAX_SIZE \
+	(SYS_HEAP_SLAB_MIN_SIZE << (CONFIG_SYS_HEAP_SLAB_CLASSES - 1))
+
+/** @brief Enable the slab front end on a sys_heap
+ *
+ * Allocates the slab metadata from the heap itself.  From then on
+ * sys_heap_alloc() requests of up to SYS_HEAP_SLAB_MAX_SIZE bytes are
+ * served from per size class free lists, refilled one page
+ * (CONFIG_SYS_HEAP_SLAB_PAGE_SIZE bytes) at a time from the heap.
+ * Must be called before any allocation is made from the heap.
+ *
+ * @param heap Heap on which to enable the slab front end
+ * @return 0 on success, -ENOMEM if the metadata does not fit
+ */
+int sys_heap_slab_init(struct sys_heap *heap);
+
+/** @brief Return unused slab pages to a sys_heap
+ *
+ * Gives every slab page none of whose objects is allocated back to
+ * the heap.  This is done automatically when a regular allocation
+ * fails, but may also be called explicitly, e.g. before a phase of
+ * large allocations.  Runs in time linear in the number of free slab
+ * objects and heap pages.
+ *
+ * @param heap Heap to trim
+ * @return Number of bytes returned to the heap
+ */
+size_t sys_heap_slab_reclaim(struct sys_heap *heap);
+
+/** @brief Find the slab class of an allocated pointer
+ *
+ * @param heap Heap the memory was allocated from
+ * @param mem A pointer previously returned from sys_heap_alloc()
+ * @return Slab class index, or -1 if @a mem is not a slab object
+ */
+int sys_heap_slab_class(struct sys_heap *heap, void *mem);
+
+/** @brief Find the slab class serving a request size
+ *
+ * @param bytes Number of bytes requested
+ * @return Slab class index, or -1 if @a bytes is not served by a slab
+ */
+static inline int sys_heap_slab_size_class(size_t bytes)
+{
+	if (bytes == 0U || bytes > SYS_HEAP_SLAB_MAX_SIZE) {
+		return -1;
+	}
+	if (bytes <= SYS_HEAP_SLAB_MIN_SIZE) {
+		return 0;
+	}
+
+	return 32 - __builtin_clz((unsigned int)bytes - 1U) - 5;
+}
+
+#endif /* CONFIG_SYS_HEAP_SLAB */
+
 /** @brief Validate heap integrity
  *
  * Validates the internal integrity of a sys_heap.  Intended for unit
@@ -208,6 +208,30 @@ void z_thread_mark_switched_out(void);
 
 #endif /* CONFIG_INSTRUMENT_THREAD_SWITCHING */
 
+#ifdef CONFIG_SCHED_STATS
+void z_sched_stats_ready(struct k_thread *thread);
+void z_sched_stats_switched_in(struct k_thread *thread);
+void z_sched_stats_switched_out(struct k_thread *thread);
+void z_sched_stats_init(struct k_thread *thread);
+#else
+#define z_sched_stats_ready(thread)
+#define z_sched_stats_switched_in(thread)
+#define z_sched_stats_switched_out(thread)
+#define z_sched_stats_init(thread)
+#endif /* CONFIG_SCHED_STATS */
+
+#ifdef CONFIG_SYS_MUTEX_FAST_PATH
+struct sys_mutex;
+
+/* Slow paths of sys_mutex_lock()/sys_mutex_unlock(), kernel_mutex only
+ * tracks the waiters and the priority inheritance state.
+ */
+int z_sys_mutex_contended_lock(struct k_mutex *kernel_mutex,
+			       struct sys_mutex *mutex, k_timeout_t timeout);
+int z_sys_mutex_contended_unlock(struct k_mutex *kernel_mutex,
+				 struct sys_mutex *mutex);
+#endif /* CONFIG_SYS_MUTEX_FAST_PATH */
+
 /* Init hook for page frame management, invoked immediately upon entry of
  * main thread, before POST_KERNEL tasks
  */
@@ -8,15 +8,169 @@
 #include <ksched.h>
 #include <wait_q.h>
 #include <init.h>
+#include <string.h>
 
 void k_heap_init(struct k_heap *h, void *mem, size_t bytes)
 {
 	z_waitq_init(&h->wait_q);
 	sys_heap_init(&h->heap, mem, bytes);
+#ifdef Z_HEAP_MAGAZINES
+	(void)memset(h->mag, 0, sizeof(h->mag));
+	atomic_clear(&h->waiters);
+#endif
 
 	SYS_PORT_TRACING_OBJ_INIT(k_heap, h);
 }
 
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+int k_heap_runtime_stats_get(struct k_heap *h,
+			     struct sys_heap_runtime_stats *stats)
+{
+	if (h == NULL) {
+		return -EINVAL;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&h->lock);
+	int ret = sys_heap_runtime_stats_get(&h->heap, stats);
+
+	k_spin_unlock(&h->lock, key);
+	return ret;
+}
+#endif
+
+#ifdef CONFIG_SYS_HEAP_SLAB
+int k_heap_slab_init(struct k_heap *h)
+{
+	k_spinlock_key_t key = k_spin_lock(&h->lock);
+	int ret = sys_heap_slab_init(&h->heap);
+
+	k_spin_unlock(&h->lock, key);
+	return ret;
+}
+#endif
+
+#ifdef Z_HEAP_MAGAZINES
+/* The magazines of a CPU are protected by that CPU's magazine lock.
+ * Only the CPU itself takes it, without contention, except when an
+ * allocation finds the heap exhausted and mag_flush() drains the
+ * magazines of every CPU.  The slab class of a live object cannot
+ * change under us, since its page is in use.
+ */
+static int mag_cpu(void)
+{
+	unsigned int key = arch_irq_lock();
+	int cpu = _current_cpu->id;
+
+	/* A thread moved to another CPU right after this just uses the
+	 * magazines of the CPU it left, which their lock still protects.
+	 */
+	arch_irq_unlock(key);
+
+	return cpu;
+}
+
+static void *mag_get(struct k_heap *h, size_t align, size_t bytes)
+{
+	int cls = sys_heap_slab_size_class(bytes);
+	k_spinlock_key_t key;
+	void *mem = NULL;
+	int cpu;
+
+	if (h->heap.slab == NULL || cls < 0 ||
+	    align > (SYS_HEAP_SLAB_MIN_SIZE << cls)) {
+		return NULL;
+	}
+
+	cpu = mag_cpu();
+	key = k_spin_lock(&h->mag_lock[cpu]);
+
+	struct z_heap_magazine *m = &h->mag[cpu][cls];
+
+	if (m->count != 0U) {
+		mem = m->objs[--m->count];
+	}
+
+	k_spin_unlock(&h->mag_lock[cpu], key);
+
+	return mem;
+}
+
+static bool mag_put(struct k_heap *h, void *mem)
+{
+	int cls = sys_heap_slab_class(&h->heap, mem);
+	k_spinlock_key_t key;
+	bool ret = false;
+	int cpu;
+
+	if (cls < 0) {
+		return false;
+	}
+
+	cpu = mag_cpu();
+	key = k_spin_lock(&h->mag_lock[cpu]);
+
+	struct z_heap_magazine *m = &h->mag[cpu][cls];
+
+	if (m->count < CONFIG_SYS_HEAP_SLAB_MAGAZINE_SIZE) {
+		m->objs[m->count++] = mem;
+		ret = true;
+	}
+
+	k_spin_unlock(&h->mag_lock[cpu], key);
+
+	return ret;
+}
+
+/* Called with the heap lock held, under memory pressure */
+static bool mag_flush(struct k_heap *h)
+{
+	bool flushed = false;
+
+	for (int cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+		k_spinlock_key_t mkey = k_spin_lock(&h->mag_lock[cpu]);
+
+		for (int cls = 0; cls < CONFIG_SYS_HEAP_SLAB_CLASSES; cls++) {
+			struct z_heap_magazine *m = &h->mag[cpu][cls];
+
+			while (m->count != 0U) {
+				sys_heap_free(&h->heap, m->objs[--m->count]);
+				flushed = true;
+			}
+		}
+
+		k_spin_unlock(&h->mag_lock[cpu], mkey);
+	}
+
+	return flushed;
+}
+
+/* An allocation about to pend counts itself as waiting, then drains
+ * the magazines one last time, and a free checks for waiters after
+ * parking its object.  Both are sequentially consistent and the drain
+ * takes every magazine lock, so either the drain finds the object or
+ * the free sees the waiter and wakes it up to drain again.
+ */
+static inline void mag_wait(struct k_heap *h, bool waiting)
+{
+	if (waiting) {
+		(void)atomic_inc(&h->waiters);
+	} else {
+		(void)atomic_dec(&h->waiters);
+	}
+}
+
+static inline bool mag_waiting(struct k_heap *h)
+{
+	return atomic_get(&h->waiters) != 0;
+}
+#else
+#define mag_get(h, align, bytes) NULL
+#define mag_put(h, mem) false
+#define mag_flush(h) false
+#define mag_wait(h, waiting)
+#define mag_waiting(h) false
+#endif /* Z_HEAP_MAGAZINES */
+
 static int statics_init(const struct device *unused)
 {
 	ARG_UNUSED(unused);
@@ -32,17 +186,28 @@ void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
 			k_timeout_t timeout)
 {
 	int64_t now, end = sys_clock_timeout_end_calc(timeout);
-	void *ret = NULL;
-	k_spinlock_key_t key = k_spin_lock(&h->lock);
+	k_spinlock_key_t key;
+	void *ret;
 
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_heap, aligned_alloc, h, timeout);
 
 	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
 
+	ret = mag_get(h, align, bytes);
+	if (ret != NULL) {
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_heap, aligned_alloc, h, timeout, ret);
+		return ret;
+	}
+
+	key = k_spin_lock(&h->lock);
+
 	bool blocked_alloc = false;
 
 	while (ret == NULL) {
 		ret = sys_heap_aligned_alloc(&h->heap, align, bytes);
+		if (ret == NULL && mag_flush(h)) {
+			ret = sys_heap_aligned_alloc(&h->heap, align, bytes);
+		}
 
 		now = sys_clock_tick_get();
 		if (!IS_ENABLED(CONFIG_MULTITHREADING) ||
@@ -60,9 +225,17 @@ void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
 			 */
 		}
 
+		/* Drain once more now that frees can see us, see mag_wait() */
+		mag_wait(h, true);
+		if (mag_flush(h)) {
+			mag_wait(h, false);
+			continue;
+		}
+
 		(void) z_pend_curr(&h->lock, key, &h->wait_q,
 				   K_TICKS(end - now));
 		key = k_spin_lock(&h->lock);
+		mag_wait(h, false);
 	}
 
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_heap, aligned_alloc, h, timeout, ret);
@@ -84,9 +257,27 @@ void *k_heap_alloc(struct k_heap *h, size_t bytes, k_timeout_t timeout)
 
 void k_heap_free(struct k_heap *h, void *mem)
 {
-	k_spinlock_key_t key = k_spin_lock(&h->lock);
+	k_spinlock_key_t key;
+	bool parked = false;
 
-	sys_heap_free(&h->heap, mem);
+	/* Don't park memory in a magazine while someone waits for it */
+	if (mem != NULL && !mag_waiting(h)) {
+		parked = mag_put(h, mem);
+
+		/* An allocation may have found the heap exhausted since,
+		 * and drained the magazines before we parked: wake it up
+		 * to drain them again.
+		 */
+		if (parked && !mag_waiting(h)) {
+			return;
+		}
+	}
+
+	key = k_spin_lock(&h->lock);
+
+	if (!parked) {
+		sys_heap_free(&h->heap, mem);
+	}
 
 	SYS_PORT_TRACING_OBJ_FUNC(k_heap, free, h);
 	if (IS_ENABLED(CONFIG_MULTITHREADING) && z_unpend_all(&h->wait_q) != 0) {
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Lock-free multi-producer/single-consumer message queues.
+ *
+ * Each slot carries a sequence word in front of the message.  With
+ * positions counting up forever and N the (power of two) queue size,
+ * the sequence word of the slot used by position p is:
+ *
+ *   lap(p)         free, a producer at p may claim it
+ *   lap(p) + 1     filled, the consumer at p may read it
+ *   lap(p) + N     consumed, free for position p + N
+ *
+ * where lap(p) is p rounded down to a multiple of N.  An all zero buffer
+ * is therefore an empty queue.  N must be at least 2: with a single
+ * slot, "filled" for p and "free" for p + 1 would be the same value.
+ *
+ * Producers claim positions by advancing the tail (a compare-and-swap,
+ * or a plain store for single producer queues), the single consumer
+ * owns the head.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <string.h>
+#include <ksched.h>
+#include <wait_q.h>
+#include <sys/util.h>
+
+static inline uint32_t lap(struct k_mpsc_msgq *q, uint32_t pos)
+{
+	return pos & ~q->mask;
+}
+
+static inline atomic_t *slot_seq(struct k_mpsc_msgq *q, uint32_t pos)
+{
+	return &q->buffer[(pos & q->mask) * q->slot_words];
+}
+
+static inline void *slot_msg(struct k_mpsc_msgq *q, uint32_t pos)
+{
+	return slot_seq(q, pos) + 1;
+}
+
+int k_mpsc_msgq_init(struct k_mpsc_msgq *q, void *buffer, size_t msg_size,
+		     uint32_t max_msgs, uint8_t flags)
+{
+	__ASSERT(((uintptr_t)buffer % sizeof(atomic_t)) == 0,
+		 "buffer must be aligned to atomic_t");
+
+	if (!is_power_of_two(max_msgs) || max_msgs < 2U) {
+		return -EINVAL;
+	}
+
+	q->buffer = buffer;
+	q->msg_size = msg_size;
+	q->slot_words = Z_MPSC_MSGQ_SLOT_WORDS(msg_size);
+	q->mask = max_msgs - 1;
+	q->head = 0U;
+	q->flags = flags;
+	atomic_clear(&q->tail);
+	atomic_clear(&q->waiting);
+	z_waitq_init(&q->wait_q);
+
+	for (uint32_t i = 0U; i < max_msgs; i++) {
+		atomic_clear(slot_seq(q, i));
+	}
+
+	return 0;
+}
+
+static void wake_consumer(struct k_mpsc_msgq *q)
+{
+	k_spinlock_key_t key = k_spin_lock(&q->lock);
+	struct k_thread *thread = z_unpend_first_thread(&q->wait_q);
+
+	if (thread != NULL) {
+		arch_thread_return_value_set(thread, 0);
+		z_ready_thread(thread);
+		z_reschedule(&q->lock, key);
+	} else {
+		k_spin_unlock(&q->lock, key);
+	}
+}
+
+int k_mpsc_msgq_put(struct k_mpsc_msgq *q, const void *data)
+{
+	uint32_t pos;
+	int32_t diff;
+
+	for (;;) {
+		pos = (uint32_t)atomic_get(&q->tail);
+		diff = (int32_t)((uint32_t)atomic_get(slot_seq(q, pos)) -
+				 lap(q, pos));
+
+		if (diff < 0) {
+			/* Slot still holds the message of the previous lap */
+			return -ENOMSG;
+		}
+
+		if (diff == 0) {
+			if ((q->flags & K_MPSC_MSGQ_FLAG_SPSC) != 0U) {
+				atomic_set(&q->tail, (atomic_val_t)(pos + 1U));
+				break;
+			}
+			if (atomic_cas(&q->tail, (atomic_val_t)pos,
+				       (atomic_val_t)(pos + 1U))) {
+				break;
+			}
+		}
+
+		/* Another producer claimed this position first, retry */
+	}
+
+	(void)memcpy(slot_msg(q, pos), data, q->msg_size);
+	atomic_set(slot_seq(q, pos), (atomic_val_t)(lap(q, pos) + 1U));
+
+	/* Both the store above and the load below are sequentially
+	 * consistent, pairing with the consumer setting waiting before
+	 * re-checking the queue: either it sees our message or we see
+	 * the flag.
+	 */
+	if (atomic_get(&q->waiting) != 0) {
+		wake_consumer(q);
+	}
+
+	return 0;
+}
+
+static bool try_get(struct k_mpsc_msgq *q, void *data)
+{
+	uint32_t pos = q->head;
+	atomic_t *seq = slot_seq(q, pos);
+
+	if ((uint32_t)atomic_get(seq) != (lap(q, pos) + 1U)) {
+		/* Empty, or the producer of this slot is still copying */
+		return false;
+	}
+
+	(void)memcpy(data, slot_msg(q, pos), q->msg_size);
+	atomic_set(seq, (atomic_val_t)(lap(q, pos) + q->mask + 1U));
+	q->head = pos + 1U;
+
+	return true;
+}
+
+int k_mpsc_msgq_get(struct k_mpsc_msgq *q, void *data, k_timeout_t timeout)
+{
+	bool forever = K_TIMEOUT_EQ(timeout, K_FOREVER);
+	int64_t now, end = 0;
+	k_spinlock_key_t key;
+	int ret = 0;
+
+	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
+
+	if (try_get(q, data)) {
+		return 0;
+	}
+
+	if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		return -ENOMSG;
+	}
+
+	if (!forever) {
+		end = (int64_t)sys_clock_timeout_end_calc(timeout);
+	}
+
+	key = k_spin_lock(&q->lock);
+	atomic_set(&q->waiting, 1);
+
+	while (!try_get(q, data)) {
+		if (!forever) {
+			now = sys_clock_tick_get();
+			if ((end - now) <= 0) {
+				ret = -EAGAIN;
+				break;
+			}
+			timeout = K_TICKS(end - now);
+		}
+
+		/* A wakeup may be spurious: a producer that saw the flag
+		 * from an earlier wait can race with us, so always
+		 * re-check the ring.
+		 */
+		(void)z_pend_curr(&q->lock, key, &q->wait_q, timeout);
+		key = k_spin_lock(&q->lock);
+	}
+
+	atomic_clear(&q->waiting);
+	k_spin_unlock(&q->lock, key);
+
+	return ret;
+}
@@ -36,6 +36,10 @@
 #include <syscall_handler.h>
 #include <tracing/tracing.h>
 #include <sys/check.h>
+#ifdef CONFIG_SYS_MUTEX_FAST_PATH
+#include <sys/mutex.h>
+#include <kernel_internal.h>
+#endif
 #include <logging/log.h>
 LOG_MODULE_DECLARE(os, CONFIG_KERNEL_LOG_LEVEL);
 
@@ -279,3 +283,186 @@ static inline int z_vrfy_k_mutex_unlock(struct k_mutex *mutex)
 }
 #include <syscalls/k_mutex_unlock_mrsh.c>
 #endif
+
+#ifdef CONFIG_SYS_MUTEX_FAST_PATH
+/*
+ * Contended sys_mutex operations.  The lock state lives in the sys_mutex
+ * itself (in user memory); the backing k_mutex only provides the wait
+ * queue and remembers whose priority was raised and what it was before,
+ * in its owner and owner_orig_prio fields.
+ *
+ * Once the state is Z_SYS_MUTEX_CONTENDED the owner can no longer unlock
+ * with an atomic op and has to come here, where the lock is handed over
+ * to the highest priority waiter.
+ */
+
+/* The owner field can be written by user mode, so only trust it if it
+ * names a thread the caller has been granted access to, as a system call
+ * on that thread would require.  Otherwise any user thread could get an
+ * arbitrary thread boosted by publishing it as the owner and waiting.
+ */
+static struct k_thread *sys_mutex_owner(struct sys_mutex *mutex)
+{
+	struct k_thread *owner = mutex->owner;
+
+	if (owner == NULL) {
+		return NULL;
+	}
+
+	if (z_object_validate(z_object_find(owner), K_OBJ_THREAD,
+			      _OBJ_INIT_TRUE) != 0) {
+		return NULL;
+	}
+
+	return owner;
+}
+
+int z_sys_mutex_contended_lock(struct k_mutex *kernel_mutex,
+			       struct sys_mutex *mutex, k_timeout_t timeout)
+{
+	struct k_thread *owner;
+	atomic_val_t val;
+	int new_prio;
+	bool resched = false;
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	for (;;) {
+		val = atomic_get(&mutex->val);
+
+		if (val == Z_SYS_MUTEX_UNLOCKED) {
+			if (atomic_cas(&mutex->val, val, Z_SYS_MUTEX_LOCKED)) {
+				mutex->owner = _current;
+				mutex->lock_count = 1U;
+				k_spin_unlock(&lock, key);
+
+				return 0;
+			}
+			continue;
+		}
+
+		if (mutex->owner == _current) {
+			mutex->lock_count++;
+			k_spin_unlock(&lock, key);
+
+			return 0;
+		}
+
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			k_spin_unlock(&lock, key);
+
+			return -EBUSY;
+		}
+
+		if ((val == Z_SYS_MUTEX_CONTENDED) ||
+		    atomic_cas(&mutex->val, val, Z_SYS_MUTEX_CONTENDED)) {
+			break;
+		}
+	}
+
+	/* An owner caught between taking the lock and publishing itself
+	 * can't be boosted, it still has to come here to unlock.
+	 */
+	owner = sys_mutex_owner(mutex);
+	if (owner != NULL) {
+		if (kernel_mutex->owner != owner) {
+			/* Drop the boost of whoever was published before */
+			if (kernel_mutex->owner != NULL) {
+				resched = adjust_owner_prio(kernel_mutex,
+					kernel_mutex->owner_orig_prio);
+			}
+
+			kernel_mutex->owner = owner;
+			kernel_mutex->owner_orig_prio = owner->base.prio;
+		}
+
+		new_prio = new_prio_for_inheritance(_current->base.prio,
+						    owner->base.prio);
+		if (z_is_prio_higher(new_prio, owner->base.prio)) {
+			resched = adjust_owner_prio(kernel_mutex, new_prio);
+		}
+	}
+
+	if (z_pend_curr(&lock, key, &kernel_mutex->wait_q, timeout) == 0) {
+		/* Handed over by z_sys_mutex_contended_unlock() */
+		return 0;
+	}
+
+	/* timed out */
+
+	key = k_spin_lock(&lock);
+
+	if (kernel_mutex->owner != NULL) {
+		struct k_thread *waiter = z_waitq_head(&kernel_mutex->wait_q);
+
+		new_prio = (waiter != NULL) ?
+			new_prio_for_inheritance(waiter->base.prio,
+						 kernel_mutex->owner_orig_prio) :
+			kernel_mutex->owner_orig_prio;
+
+		resched = adjust_owner_prio(kernel_mutex, new_prio) || resched;
+	}
+
+	if (resched) {
+		z_reschedule(&lock, key);
+	} else {
+		k_spin_unlock(&lock, key);
+	}
+
+	return -EAGAIN;
+}
+
+int z_sys_mutex_contended_unlock(struct k_mutex *kernel_mutex,
+				 struct sys_mutex *mutex)
+{
+	struct k_thread *new_owner;
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (mutex->owner != _current) {
+		k_spin_unlock(&lock, key);
+
+		return (mutex->owner == NULL) ? -EINVAL : -EPERM;
+	}
+
+	if (mutex->lock_count > 1U) {
+		mutex->lock_count--;
+		k_spin_unlock(&lock, key);
+
+		return 0;
+	}
+
+	if (kernel_mutex->owner == _current) {
+		adjust_owner_prio(kernel_mutex, kernel_mutex->owner_orig_prio);
+		kernel_mutex->owner = NULL;
+	}
+
+	new_owner = z_unpend_first_thread(&kernel_mutex->wait_q);
+
+	if (new_owner == NULL) {
+		mutex->owner = NULL;
+		mutex->lock_count = 0U;
+		atomic_set(&mutex->val, Z_SYS_MUTEX_UNLOCKED);
+		k_spin_unlock(&lock, key);
+
+		return 0;
+	}
+
+	mutex->owner = new_owner;
+	mutex->lock_count = 1U;
+
+	if (z_waitq_head(&kernel_mutex->wait_q) != NULL) {
+		/* Stay contended. The new owner was the highest priority
+		 * waiter, so it needs no boost yet.
+		 */
+		kernel_mutex->owner = new_owner;
+		kernel_mutex->owner_orig_prio = new_owner->base.prio;
+	} else {
+		atomic_set(&mutex->val, Z_SYS_MUTEX_LOCKED);
+	}
+
+	arch_thread_return_value_set(new_owner, 0);
+	z_ready_thread(new_owner);
+	z_reschedule(&lock, key);
+
+	return 0;
+}
+#endif /* CONFIG_SYS_MUTEX_FAST_PATH */
@@ -12,6 +12,7 @@
 
 #include <kernel.h>
 #include <kernel_structs.h>
+#include <string.h>
 
 #include <toolchain.h>
 #include <ksched.h>
@@ -168,12 +169,9 @@ static size_t pipe_xfer(unsigned char *dest, size_t dest_size,
 			 const unsigned char *src, size_t src_size)
 {
 	size_t num_bytes = MIN(dest_size, src_size);
-	const unsigned char *end = src + num_bytes;
 
-	while (src != end) {
-		*dest = *src;
-		dest++;
-		src++;
+	if (num_bytes != 0U) {
+		(void)memcpy(dest, src, num_bytes);
 	}
 
 	return num_bytes;
@@ -825,3 +823,333 @@ size_t z_vrfy_k_pipe_write_avail(struct k_pipe *pipe)
 }
 #include <syscalls/k_pipe_write_avail_mrsh.c>
 #endif
+
+/**
+ * @brief Hand data from the pipe's circular buffer to waiting readers
+ *
+ * Readers only pend on an empty buffer, so this must be called whenever
+ * data is added to the buffer other than by z_pipe_put_internal().
+ */
+static void pipe_readers_feed(struct k_pipe *pipe)
+{
+	struct k_thread    *thread;
+	struct k_pipe_desc *desc;
+	size_t              bytes_copied;
+
+	while ((pipe->bytes_used != 0U) &&
+	       ((thread = z_waitq_head(&pipe->wait_q.readers)) != NULL)) {
+		desc = (struct k_pipe_desc *)thread->base.swap_data;
+		bytes_copied = pipe_buffer_get(pipe, desc->buffer,
+						desc->bytes_to_xfer);
+
+		desc->buffer        += bytes_copied;
+		desc->bytes_to_xfer -= bytes_copied;
+
+		if (desc->bytes_to_xfer != 0U) {
+			/* Buffer drained, the reader keeps waiting */
+			break;
+		}
+
+		z_unpend_thread(thread);
+		z_ready_thread(thread);
+	}
+}
+
+/**
+ * @brief Let waiting writers refill the pipe's circular buffer
+ *
+ * Writers only pend on a full buffer, so this must be called whenever
+ * space is freed in the buffer other than by z_impl_k_pipe_get().
+ */
+static void pipe_writers_drain(struct k_pipe *pipe)
+{
+	struct k_thread    *thread;
+	struct k_pipe_desc *desc;
+	size_t              bytes_copied;
+
+	while ((pipe->bytes_used != pipe->size) &&
+	       ((thread = z_waitq_head(&pipe->wait_q.writers)) != NULL)) {
+		desc = (struct k_pipe_desc *)thread->base.swap_data;
+		bytes_copied = pipe_buffer_put(pipe, desc->buffer,
+						desc->bytes_to_xfer);
+
+		desc->buffer        += bytes_copied;
+		desc->bytes_to_xfer -= bytes_copied;
+
+		if (desc->bytes_to_xfer != 0U) {
+			/* Buffer full again, the writer keeps waiting */
+			break;
+		}
+
+		z_unpend_thread(thread);
+		pipe_thread_ready(thread);
+	}
+}
+
+/**
+ * @brief Check if a vector request can complete without waiting
+ *
+ * @a avail is what the circular buffer can supply (data or space) when
+ * nothing can be exchanged directly with a waiting thread.
+ */
+static bool pipe_vec_fits(size_t avail, size_t total, size_t min_xfer,
+			  k_timeout_t timeout)
+{
+	if (avail >= total) {
+		return true;
+	}
+
+	return (avail >= min_xfer) &&
+	       (K_TIMEOUT_EQ(timeout, K_NO_WAIT) || (min_xfer > 0U));
+}
+
+static size_t pipe_vec_size(const struct k_pipe_iovec *iov, size_t iovcnt)
+{
+	size_t total = 0;
+
+	for (size_t i = 0; i < iovcnt; i++) {
+		total += iov[i].len;
+	}
+
+	return total;
+}
+
+static k_timeout_t pipe_timeout_left(k_timeout_t timeout, uint64_t end)
+{
+	int64_t remaining;
+
+	if (K_TIMEOUT_EQ(timeout, K_FOREVER) ||
+	    K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		return timeout;
+	}
+
+	remaining = (int64_t)end - sys_clock_tick_get();
+
+	return (remaining > 0) ? K_TICKS(remaining) : K_NO_WAIT;
+}
+
+/**
+ * @brief Move a vector segment by segment through k_pipe_put/k_pipe_get
+ *
+ * Used when the vector can not go through the circular buffer in one
+ * step: threads are waiting on the other end, or this one has to wait.
+ */
+static int pipe_xfer_vec(struct k_pipe *pipe, const struct k_pipe_iovec *iov,
+			 size_t iovcnt, size_t *bytes_xferred,
+			 size_t min_xfer, k_timeout_t timeout, bool put)
+{
+	uint64_t end = sys_clock_timeout_end_calc(timeout);
+	size_t   num_bytes = 0;
+	size_t   bytes_copied;
+	int      ret = 0;
+
+	for (size_t i = 0; i < iovcnt; i++) {
+		k_timeout_t left = K_NO_WAIT;
+		size_t      seg_min = 0;
+
+		if ((min_xfer == 0U) || (num_bytes < min_xfer)) {
+			/* Still owed: wait for it like a single request */
+			left = pipe_timeout_left(timeout, end);
+			if (min_xfer != 0U) {
+				seg_min = MIN(iov[i].len, min_xfer - num_bytes);
+			}
+		}
+
+		if (put) {
+			ret = z_impl_k_pipe_put(pipe, iov[i].data, iov[i].len,
+						&bytes_copied, seg_min, left);
+		} else {
+			ret = z_impl_k_pipe_get(pipe, iov[i].data, iov[i].len,
+						&bytes_copied, seg_min, left);
+		}
+
+		num_bytes += bytes_copied;
+
+		if ((ret != 0) || (bytes_copied < iov[i].len)) {
+			break;
+		}
+	}
+
+	*bytes_xferred = num_bytes;
+
+	if ((ret == -EIO) && !K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		/* The overall waiting period ran out between segments */
+		ret = -EAGAIN;
+	}
+
+	return ret;
+}
+
+int k_pipe_putv(struct k_pipe *pipe, const struct k_pipe_iovec *iov,
+		size_t iovcnt, size_t *bytes_written, size_t min_xfer,
+		k_timeout_t timeout)
+{
+	size_t num_bytes_written = 0;
+	size_t bytes_copied;
+	size_t total;
+	size_t space;
+
+	CHECKIF(bytes_written == NULL || (iov == NULL && iovcnt != 0U)) {
+		return -EINVAL;
+	}
+
+	total = pipe_vec_size(iov, iovcnt);
+
+	CHECKIF(min_xfer > total) {
+		return -EINVAL;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+
+	if (z_waitq_head(&pipe->wait_q.readers) == NULL) {
+		space = pipe->size - pipe->bytes_used;
+
+		if (pipe_vec_fits(space, total, min_xfer, timeout)) {
+			for (size_t i = 0; i < iovcnt; i++) {
+				bytes_copied = pipe_buffer_put(pipe,
+							       iov[i].data,
+							       iov[i].len);
+				num_bytes_written += bytes_copied;
+				if (bytes_copied < iov[i].len) {
+					break;
+				}
+			}
+			k_spin_unlock(&pipe->lock, key);
+			*bytes_written = num_bytes_written;
+
+			return 0;
+		}
+
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			k_spin_unlock(&pipe->lock, key);
+			*bytes_written = 0;
+
+			return -EIO;
+		}
+	}
+
+	k_spin_unlock(&pipe->lock, key);
+
+	return pipe_xfer_vec(pipe, iov, iovcnt, bytes_written, min_xfer,
+			     timeout, true);
+}
+
+int k_pipe_getv(struct k_pipe *pipe, const struct k_pipe_iovec *iov,
+		size_t iovcnt, size_t *bytes_read, size_t min_xfer,
+		k_timeout_t timeout)
+{
+	size_t num_bytes_read = 0;
+	size_t bytes_copied;
+	size_t total;
+
+	CHECKIF(bytes_read == NULL || (iov == NULL && iovcnt != 0U)) {
+		return -EINVAL;
+	}
+
+	total = pipe_vec_size(iov, iovcnt);
+
+	CHECKIF(min_xfer > total) {
+		return -EINVAL;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+
+	if (z_waitq_head(&pipe->wait_q.writers) == NULL) {
+		if (pipe_vec_fits(pipe->bytes_used, total, min_xfer, timeout)) {
+			for (size_t i = 0; i < iovcnt; i++) {
+				bytes_copied = pipe_buffer_get(pipe,
+							       iov[i].data,
+							       iov[i].len);
+				num_bytes_read += bytes_copied;
+				if (bytes_copied < iov[i].len) {
+					break;
+				}
+			}
+			k_spin_unlock(&pipe->lock, key);
+			*bytes_read = num_bytes_read;
+
+			return 0;
+		}
+
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			k_spin_unlock(&pipe->lock, key);
+			*bytes_read = 0;
+
+			return -EIO;
+		}
+	}
+
+	k_spin_unlock(&pipe->lock, key);
+
+	return pipe_xfer_vec(pipe, iov, iovcnt, bytes_read, min_xfer,
+			     timeout, false);
+}
+
+size_t k_pipe_put_claim(struct k_pipe *pipe, uint8_t **data, size_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+	size_t run_length = MIN(pipe->size - pipe->bytes_used,
+				pipe->size - pipe->write_index);
+
+	*data = pipe->buffer + pipe->write_index;
+	k_spin_unlock(&pipe->lock, key);
+
+	return MIN(size, run_length);
+}
+
+int k_pipe_put_finish(struct k_pipe *pipe, size_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+
+	CHECKIF(size > MIN(pipe->size - pipe->bytes_used,
+			   pipe->size - pipe->write_index)) {
+		k_spin_unlock(&pipe->lock, key);
+
+		return -EINVAL;
+	}
+
+	pipe->bytes_used += size;
+	pipe->write_index += size;
+	if (pipe->write_index == pipe->size) {
+		pipe->write_index = 0;
+	}
+
+	pipe_readers_feed(pipe);
+	z_reschedule(&pipe->lock, key);
+
+	return 0;
+}
+
+size_t k_pipe_get_claim(struct k_pipe *pipe, uint8_t **data, size_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+	size_t run_length = MIN(pipe->bytes_used,
+				pipe->size - pipe->read_index);
+
+	*data = pipe->buffer + pipe->read_index;
+	k_spin_unlock(&pipe->lock, key);
+
+	return MIN(size, run_length);
+}
+
+int k_pipe_get_finish(struct k_pipe *pipe, size_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+
+	CHECKIF(size > MIN(pipe->bytes_used, pipe->size - pipe->read_index)) {
+		k_spin_unlock(&pipe->lock, key);
+
+		return -EINVAL;
+	}
+
+	pipe->bytes_used -= size;
+	pipe->read_index += size;
+	if (pipe->read_index == pipe->size) {
+		pipe->read_index = 0;
+	}
+
+	pipe_writers_drain(pipe);
+	z_reschedule(&pipe->lock, key);
+
+	return 0;
+}
@@ -170,6 +170,152 @@ static ALWAYS_INLINE struct k_thread *_priq_dumb_mask_best(sys_dlist_t *pq)
 }
 #endif
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+/* With per-CPU run queues, a queued thread lives in the queue of
+ * exactly one CPU, recorded in base.runq_cpu.  All of the queues are
+ * still protected by sched_spinlock: there is no per-CPU lock, so
+ * next_up() serializes with every other CPU's scheduler operations.
+ */
+static ALWAYS_INLINE void *cpu_runq(int cpu)
+{
+	return &_kernel.cpus[cpu].ready_q.runq;
+}
+
+static ALWAYS_INLINE bool runq_cpu_allowed(struct k_thread *thread, int cpu)
+{
+#ifdef CONFIG_SCHED_CPU_MASK
+	return (thread->base.cpu_mask & BIT(cpu)) != 0;
+#else
+	ARG_UNUSED(thread);
+	ARG_UNUSED(cpu);
+	return true;
+#endif
+}
+
+static ALWAYS_INLINE bool cpu_is_idle(int cpu)
+{
+	struct _cpu *c = &_kernel.cpus[cpu];
+
+	return c->current != NULL && z_is_idle_thread_object(c->current) &&
+		c->ready_q.count == 0U;
+}
+
+/* Choose the run queue for a thread being made runnable: the CPU it
+ * last ran on keeps it (for cache affinity) unless that CPU is busy
+ * and another allowed CPU is sitting idle with an empty queue.
+ */
+static int select_runq_cpu(struct k_thread *thread)
+{
+	int cpu = thread->base.runq_cpu;
+
+	if (!runq_cpu_allowed(thread, cpu)) {
+		for (cpu = 0; cpu < CONFIG_MP_NUM_CPUS - 1; cpu++) {
+			if (runq_cpu_allowed(thread, cpu)) {
+				break;
+			}
+		}
+	}
+
+	if (cpu_is_idle(cpu)) {
+		return cpu;
+	}
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (i != cpu && runq_cpu_allowed(thread, i) && cpu_is_idle(i)) {
+			return i;
+		}
+	}
+
+	return cpu;
+}
+
+/* Best thread in the run queue of @cpu which @self may run */
+static struct k_thread *runq_best_allowed(int cpu, int self)
+{
+#ifdef CONFIG_SCHED_CPU_MASK
+	sys_dlist_t *pq = cpu_runq(cpu);
+	struct k_thread *thread;
+
+	BUILD_ASSERT(IS_ENABLED(CONFIG_SCHED_DUMB),
+		     "CPU mask walk needs the dlist run queue");
+
+	SYS_DLIST_FOR_EACH_CONTAINER(pq, thread, base.qnode_dlist) {
+		if (runq_cpu_allowed(thread, self)) {
+			return thread;
+		}
+	}
+	return NULL;
+#else
+	ARG_UNUSED(self);
+	return _priq_run_best(cpu_runq(cpu));
+#endif
+}
+
+/* Called when the local run queue has nothing this CPU can run:
+ * returns the best thread queued on any other CPU whose mask allows
+ * it here (it is left in that queue; the caller dequeues it if it
+ * decides to run it).
+ */
+static struct k_thread *steal_thread(void)
+{
+	struct k_thread *best = NULL;
+	int self = _current_cpu->id;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct k_thread *thread;
+
+		if (i == self || _kernel.cpus[i].ready_q.count == 0U) {
+			continue;
+		}
+
+		thread = runq_best_allowed(i, self);
+		if (thread != NULL &&
+		    (best == NULL || z_sched_prio_cmp(thread, best) > 0)) {
+			best = thread;
+		}
+	}
+
+	return best;
+}
+#endif /* CONFIG_SCHED_CPU_RUNQ */
+
+static ALWAYS_INLINE void *thread_runq(struct k_thread *thread)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	return cpu_runq(thread->base.runq_cpu);
+#else
+	ARG_UNUSED(thread);
+	return &_kernel.ready_q.runq;
+#endif
+}
+
+static ALWAYS_INLINE void runq_add(struct k_thread *thread)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	_kernel.cpus[thread->base.runq_cpu].ready_q.count++;
+#endif
+	_priq_run_add(thread_runq(thread), thread);
+}
+
+static ALWAYS_INLINE void runq_remove(struct k_thread *thread)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	_kernel.cpus[thread->base.runq_cpu].ready_q.count--;
+#endif
+	_priq_run_remove(thread_runq(thread), thread);
+}
+
+static ALWAYS_INLINE struct k_thread *runq_best(void)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	struct k_thread *thread = _priq_run_best(cpu_runq(_current_cpu->id));
+
+	return (thread != NULL) ? thread : steal_thread();
+#else
+	return _priq_run_best(&_kernel.ready_q.runq);
+#endif
+}
+
 /* _current is never in the run queue until context switch on
  * SMP configurations, see z_requeue_current()
  */
@@ -178,12 +324,14 @@ static inline bool should_queue_thread(struct k_thread *th)
 	return !IS_ENABLED(CONFIG_SMP) || th != _current;
 }
 
-static ALWAYS_INLINE void queue_thread(void *pq,
-				       struct k_thread *thread)
+static ALWAYS_INLINE void queue_thread(struct k_thread *thread)
 {
 	thread->base.thread_state |= _THREAD_QUEUED;
 	if (should_queue_thread(thread)) {
-		_priq_run_add(pq, thread);
+#ifdef CONFIG_SCHED_CPU_RUNQ
+		thread->base.runq_cpu = select_runq_cpu(thread);
+#endif
+		runq_add(thread);
 	}
 #ifdef CONFIG_SMP
 	if (thread == _current) {
@@ -193,12 +341,11 @@ static ALWAYS_INLINE void queue_thread(void *pq,
 #endif
 }
 
-static ALWAYS_INLINE void dequeue_thread(void *pq,
-					 struct k_thread *thread)
+static ALWAYS_INLINE void dequeue_thread(struct k_thread *thread)
 {
 	thread->base.thread_state &= ~_THREAD_QUEUED;
 	if (should_queue_thread(thread)) {
-		_priq_run_remove(pq, thread);
+		runq_remove(thread);
 	}
 }
 
@@ -212,7 +359,7 @@ static ALWAYS_INLINE void dequeue_thread(void *pq,
 void z_requeue_current(struct k_thread *curr)
 {
 	if (z_is_thread_queued(curr)) {
-		_priq_run_add(&_kernel.ready_q.runq, curr);
+		runq_add(curr);
 	}
 }
 #endif
@@ -226,7 +373,7 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 {
 	struct k_thread *thread;
 
-	thread = _priq_run_best(&_kernel.ready_q.runq);
+	thread = runq_best();
 
 #if (CONFIG_NUM_METAIRQ_PRIORITIES > 0) && (CONFIG_NUM_COOP_PRIORITIES > 0)
 	/* MetaIRQs must always attempt to return back to a
@@ -292,14 +439,21 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 	/* Put _current back into the queue */
 	if (thread != _current && active &&
 		!z_is_idle_thread_object(_current) && !queued) {
-		queue_thread(&_kernel.ready_q.runq, _current);
+		queue_thread(_current);
 	}
 
 	/* Take the new _current out of the queue */
 	if (z_is_thread_queued(thread)) {
-		dequeue_thread(&_kernel.ready_q.runq, thread);
+		dequeue_thread(thread);
 	}
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* The thread now belongs to this CPU, which is where it will
+	 * be queued again when it next becomes runnable.
+	 */
+	thread->base.runq_cpu = _current_cpu->id;
+#endif
+
 	_current_cpu->swap_ok = false;
 	return thread;
 #endif
@@ -308,9 +462,9 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 static void move_thread_to_end_of_prio_q(struct k_thread *thread)
 {
 	if (z_is_thread_queued(thread)) {
-		dequeue_thread(&_kernel.ready_q.runq, thread);
+		dequeue_thread(thread);
 	}
-	queue_thread(&_kernel.ready_q.runq, thread);
+	queue_thread(thread);
 	update_cache(thread == _current);
 }
 
@@ -476,7 +630,8 @@ static void ready_thread(struct k_thread *thread)
 	if (!z_is_thread_queued(thread) && z_is_thread_ready(thread)) {
 		SYS_PORT_TRACING_OBJ_FUNC(k_thread, sched_ready, thread);
 
-		queue_thread(&_kernel.ready_q.runq, thread);
+		z_sched_stats_ready(thread);
+		queue_thread(thread);
 		update_cache(0);
 #if defined(CONFIG_SMP) &&  defined(CONFIG_SCHED_IPI_SUPPORTED)
 		arch_sched_ipi();
@@ -522,7 +677,7 @@ void z_impl_k_thread_suspend(struct k_thread *thread)
 
 	LOCKED(&sched_spinlock) {
 		if (z_is_thread_queued(thread)) {
-			dequeue_thread(&_kernel.ready_q.runq, thread);
+			dequeue_thread(thread);
 		}
 		z_mark_thread_as_suspended(thread);
 		update_cache(thread == _current);
@@ -583,7 +738,7 @@ static _wait_q_t *pended_on_thread(struct k_thread *thread)
 static void unready_thread(struct k_thread *thread)
 {
 	if (z_is_thread_queued(thread)) {
-		dequeue_thread(&_kernel.ready_q.runq, thread);
+		dequeue_thread(thread);
 	}
 	update_cache(thread == _current);
 }
@@ -746,9 +901,9 @@ bool z_set_prio(struct k_thread *thread, int prio)
 		if (need_sched) {
 			/* Don't requeue on SMP if it's the running thread */
 			if (!IS_ENABLED(CONFIG_SMP) || z_is_thread_queued(thread)) {
-				dequeue_thread(&_kernel.ready_q.runq, thread);
+				dequeue_thread(thread);
 				thread->base.prio = prio;
-				queue_thread(&_kernel.ready_q.runq, thread);
+				queue_thread(thread);
 			} else {
 				thread->base.prio = prio;
 			}
@@ -907,8 +1062,7 @@ void *z_get_next_switch_handle(void *interrupted)
 			 * will not return into it.
 			 */
 			if (z_is_thread_queued(old_thread)) {
-				_priq_run_add(&_kernel.ready_q.runq,
-					      old_thread);
+				runq_add(old_thread);
 			}
 		}
 		old_thread->switch_handle = interrupted;
@@ -1081,24 +1235,31 @@ int z_unpend_all(_wait_q_t *wait_q)
 	return need_sched;
 }
 
-void z_sched_init(void)
+static void init_ready_q(struct _ready_q *rq)
 {
-#ifdef CONFIG_SCHED_DUMB
-	sys_dlist_init(&_kernel.ready_q.runq);
-#endif
-
-#ifdef CONFIG_SCHED_SCALABLE
-	_kernel.ready_q.runq = (struct _priq_rb) {
+#if defined(CONFIG_SCHED_SCALABLE)
+	rq->runq = (struct _priq_rb) {
 		.tree = {
 			.lessthan_fn = z_priq_rb_lessthan,
 		}
 	};
+#elif defined(CONFIG_SCHED_MULTIQ)
+	for (int i = 0; i < ARRAY_SIZE(rq->runq.queues); i++) {
+		sys_dlist_init(&rq->runq.queues[i]);
+	}
+#else
+	sys_dlist_init(&rq->runq);
 #endif
+}
 
-#ifdef CONFIG_SCHED_MULTIQ
-	for (int i = 0; i < ARRAY_SIZE(_kernel.ready_q.runq.queues); i++) {
-		sys_dlist_init(&_kernel.ready_q.runq.queues[i]);
+void z_sched_init(void)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		init_ready_q(&_kernel.cpus[i].ready_q);
 	}
+#else
+	init_ready_q(&_kernel.ready_q);
 #endif
 
 #ifdef CONFIG_TIMESLICING
@@ -1158,8 +1319,8 @@ void z_impl_k_thread_deadline_set(k_tid_t tid, int deadline)
 	LOCKED(&sched_spinlock) {
 		thread->base.prio_deadline = k_cycle_get_32() + deadline;
 		if (z_is_thread_queued(thread)) {
-			dequeue_thread(&_kernel.ready_q.runq, thread);
-			queue_thread(&_kernel.ready_q.runq, thread);
+			dequeue_thread(thread);
+			queue_thread(thread);
 		}
 	}
 }
@@ -1190,10 +1351,9 @@ void z_impl_k_yield(void)
 
 	if (!IS_ENABLED(CONFIG_SMP) ||
 	    z_is_thread_queued(_current)) {
-		dequeue_thread(&_kernel.ready_q.runq,
-			       _current);
+		dequeue_thread(_current);
 	}
-	queue_thread(&_kernel.ready_q.runq, _current);
+	queue_thread(_current);
 	update_cache(1);
 	z_swap(&sched_spinlock, key);
 }
@@ -1469,7 +1629,7 @@ static void end_thread(struct k_thread *thread)
 		thread->base.thread_state |= _THREAD_DEAD;
 		thread->base.thread_state &= ~_THREAD_ABORTING;
 		if (z_is_thread_queued(thread)) {
-			dequeue_thread(&_kernel.ready_q.runq, thread);
+			dequeue_thread(thread);
 		}
 		if (thread->base.pended_on != NULL) {
 			unpend_thread_no_timeout(thread);
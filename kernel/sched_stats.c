@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <kernel_internal.h>
+#include <timing/timing.h>
+#include <string.h>
+
+#define BUCKETS CONFIG_SCHED_STATS_BUCKETS
+
+/* System wide histograms, one set per CPU so that the switch path
+ * never has to write a shared cache line.  They are summed up when
+ * read.
+ */
+static k_thread_sched_stats_t cpu_stats[CONFIG_MP_NUM_CPUS];
+
+static ALWAYS_INLINE int bucket(uint64_t cycles)
+{
+	uint64_t v = cycles >> CONFIG_SCHED_STATS_SHIFT;
+	int b;
+
+	if (v == 0ULL) {
+		return 0;
+	}
+
+	b = 64 - __builtin_clzll(v);
+
+	return MIN(b, BUCKETS - 1);
+}
+
+static ALWAYS_INLINE bool is_dummy(struct k_thread *thread)
+{
+	return (thread->base.thread_state & _THREAD_DUMMY) != 0U;
+}
+
+void z_sched_stats_init(struct k_thread *thread)
+{
+	memset(&thread->sched_stats, 0, sizeof(thread->sched_stats));
+}
+
+void z_sched_stats_ready(struct k_thread *thread)
+{
+	thread->sched_stats.ready_stamp = timing_counter_get();
+}
+
+void z_sched_stats_switched_in(struct k_thread *thread)
+{
+	struct _thread_sched_stats *s = &thread->sched_stats;
+	timing_t now;
+
+	if (unlikely(is_dummy(thread))) {
+		return;
+	}
+
+	now = timing_counter_get();
+
+	if (s->ready_stamp != 0U) {
+		int b = bucket(timing_cycles_get(&s->ready_stamp, &now));
+
+		s->stats.wake_latency[b]++;
+		cpu_stats[_current_cpu->id].wake_latency[b]++;
+		s->ready_stamp = 0U;
+	}
+
+	s->switched_in_stamp = now;
+}
+
+void z_sched_stats_switched_out(struct k_thread *thread)
+{
+	struct _thread_sched_stats *s = &thread->sched_stats;
+	timing_t now;
+	int b;
+
+	if (unlikely(is_dummy(thread) || s->switched_in_stamp == 0U)) {
+		return;
+	}
+
+	now = timing_counter_get();
+	b = bucket(timing_cycles_get(&s->switched_in_stamp, &now));
+
+	s->stats.run_slice[b]++;
+	cpu_stats[_current_cpu->id].run_slice[b]++;
+	s->switched_in_stamp = 0U;
+}
+
+int k_thread_sched_stats_get(k_tid_t thread, k_thread_sched_stats_t *stats)
+{
+	if ((thread == NULL) || (stats == NULL)) {
+		return -EINVAL;
+	}
+
+	(void)memcpy(stats, &thread->sched_stats.stats, sizeof(*stats));
+
+	return 0;
+}
+
+int k_sched_stats_all_get(k_thread_sched_stats_t *stats)
+{
+	if (stats == NULL) {
+		return -EINVAL;
+	}
+
+	(void)memset(stats, 0, sizeof(*stats));
+
+	for (int cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+		for (int b = 0; b < BUCKETS; b++) {
+			stats->wake_latency[b] += cpu_stats[cpu].wake_latency[b];
+			stats->run_slice[b] += cpu_stats[cpu].run_slice[b];
+		}
+	}
+
+	return 0;
+}
@@ -611,6 +611,7 @@ char *z_setup_new_thread(struct k_thread *new_thread,
 #ifdef CONFIG_THREAD_RUNTIME_STATS
 	memset(&new_thread->rt_stats, 0, sizeof(new_thread->rt_stats));
 #endif
+	z_sched_stats_init(new_thread);
 
 	return stack_ptr;
 }
@@ -782,6 +783,10 @@ void z_init_thread_base(struct _thread_base *thread_base, int priority,
 	thread_base->is_idle = 0;
 #endif
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	thread_base->runq_cpu = 0;
+#endif
+
 	/* swap_data does not need to be initialized */
 
 	z_init_thread_timeout(thread_base);
@@ -1022,10 +1027,14 @@ void z_thread_mark_switched_in(void)
 #endif /* CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS */
 
 #endif /* CONFIG_THREAD_RUNTIME_STATS */
+
+	z_sched_stats_switched_in(k_current_get());
 }
 
 void z_thread_mark_switched_out(void)
 {
+	z_sched_stats_switched_out(k_current_get());
+
 #ifdef CONFIG_THREAD_RUNTIME_STATS
 #ifdef CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS
 	timing_t now;
@@ -11,11 +11,10 @@
 #include <syscall_handler.h>
 #include <drivers/timer/system_timer.h>
 #include <sys_clock.h>
+#include <init.h>
 
 static uint64_t curr_tick;
 
-static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
-
 static struct k_spinlock timeout_lock;
 
 #define MAX_WAIT (IS_ENABLED(CONFIG_SYSTEM_CLOCK_SLOPPY_IDLE) \
@@ -36,6 +35,206 @@ static inline int z_vrfy_sys_clock_hw_cycles_per_sec_runtime_get(void)
 #endif /* CONFIG_USERSPACE */
 #endif /* CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME */
 
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+
+/* Hierarchical timer wheel.  Each timeout stores its absolute expiry
+ * tick in dticks.  A timeout lives on level L when its expiry agrees
+ * with curr_tick in every bit above bit WHEEL_BITS * (L + 1) but not
+ * in the WHEEL_BITS bits of level L (level 0: all bits above
+ * WHEEL_BITS agree), in the slot indexed by those WHEEL_BITS bits.
+ * So every slot holds timeouts of a single tick range, slots on
+ * level L > 0 are always ahead of the current index, and each level
+ * is entirely later than the one below.  The level of a queued
+ * timeout can therefore be recomputed from its expiry and curr_tick
+ * at any time.  Timeouts beyond the top level sit on an overflow
+ * list.  When curr_tick reaches a non-empty slot on level L > 0, its
+ * timeouts are "cascaded" down to finer levels.
+ */
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS BIT(WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS CONFIG_TIMEOUT_WHEEL_LEVELS
+
+static sys_dlist_t wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+static uint64_t wheel_bitmap[WHEEL_LEVELS];
+static sys_dlist_t wheel_overflow = SYS_DLIST_STATIC_INIT(&wheel_overflow);
+
+static inline int wheel_level(uint64_t expiry)
+{
+	uint64_t diff = expiry ^ curr_tick;
+
+	if (diff < WHEEL_SLOTS) {
+		return 0;
+	}
+	return (63 - __builtin_clzll(diff)) / WHEEL_BITS;
+}
+
+static inline int wheel_slot(uint64_t expiry, int level)
+{
+	return (expiry >> (level * WHEEL_BITS)) & WHEEL_MASK;
+}
+
+static int wheel_init(const struct device *unused)
+{
+	ARG_UNUSED(unused);
+
+	for (int l = 0; l < WHEEL_LEVELS; l++) {
+		for (int i = 0; i < WHEEL_SLOTS; i++) {
+			sys_dlist_init(&wheel[l][i]);
+		}
+	}
+
+	return 0;
+}
+
+SYS_INIT(wheel_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+
+static void tq_insert(struct _timeout *to, k_ticks_t ticks)
+{
+	to->dticks = curr_tick + MAX(ticks, 0);
+
+	int level = wheel_level(to->dticks);
+
+	if (level >= WHEEL_LEVELS) {
+		sys_dlist_append(&wheel_overflow, &to->node);
+	} else {
+		int slot = wheel_slot(to->dticks, level);
+
+		sys_dlist_append(&wheel[level][slot], &to->node);
+		wheel_bitmap[level] |= BIT64(slot);
+	}
+}
+
+static void tq_remove(struct _timeout *to)
+{
+	int level = wheel_level(to->dticks);
+
+	sys_dlist_remove(&to->node);
+
+	if (level < WHEEL_LEVELS) {
+		int slot = wheel_slot(to->dticks, level);
+
+		if (sys_dlist_is_empty(&wheel[level][slot])) {
+			wheel_bitmap[level] &= ~BIT64(slot);
+		}
+	}
+}
+
+/* Absolute tick of the next thing that needs doing: an expiry on
+ * level 0, or the start of the next slot to cascade.
+ */
+static uint64_t wheel_next_event(void)
+{
+	for (int l = 0; l < WHEEL_LEVELS; l++) {
+		if (wheel_bitmap[l] != 0ULL) {
+			int shift = (l + 1) * WHEEL_BITS;
+			uint64_t base = (curr_tick >> shift) << shift;
+
+			return base + ((uint64_t)__builtin_ctzll(wheel_bitmap[l])
+				       << (l * WHEEL_BITS));
+		}
+	}
+
+	if (!sys_dlist_is_empty(&wheel_overflow)) {
+		int shift = WHEEL_LEVELS * WHEEL_BITS;
+
+		return ((curr_tick >> shift) + 1) << shift;
+	}
+
+	return UINT64_MAX;
+}
+
+static void wheel_requeue_list(sys_dlist_t *list)
+{
+	sys_dlist_t tmp;
+	sys_dnode_t *node;
+
+	sys_dlist_init(&tmp);
+	while ((node = sys_dlist_get(list)) != NULL) {
+		sys_dlist_append(&tmp, node);
+	}
+
+	while ((node = sys_dlist_get(&tmp)) != NULL) {
+		struct _timeout *t = CONTAINER_OF(node, struct _timeout, node);
+
+		tq_insert(t, t->dticks - curr_tick);
+	}
+}
+
+/* curr_tick just moved to a new value: push the timeouts of any slot
+ * it reached down to finer levels, coarsest first so that they can
+ * fall through several levels at once.
+ */
+static void wheel_cascade(void)
+{
+	int top = WHEEL_LEVELS * WHEEL_BITS;
+
+	if ((curr_tick & (BIT64(top) - 1)) == 0ULL) {
+		wheel_requeue_list(&wheel_overflow);
+	}
+
+	for (int l = WHEEL_LEVELS - 1; l > 0; l--) {
+		int slot = wheel_slot(curr_tick, l);
+
+		if ((wheel_bitmap[l] & BIT64(slot)) != 0ULL) {
+			wheel_bitmap[l] &= ~BIT64(slot);
+			wheel_requeue_list(&wheel[l][slot]);
+		}
+	}
+}
+
+static k_ticks_t tq_first_ticks(void)
+{
+	uint64_t next = wheel_next_event();
+
+	return next == UINT64_MAX ? K_TICKS_FOREVER : next - curr_tick;
+}
+
+static k_ticks_t tq_ticks(const struct _timeout *to)
+{
+	return to->dticks - curr_tick;
+}
+
+/* Dequeues and returns the next timeout expiring within the current
+ * announcement, advancing curr_tick to its expiry.
+ */
+static struct _timeout *tq_pop_expired(void)
+{
+	for (;;) {
+		sys_dnode_t *n;
+		uint64_t next;
+
+		n = sys_dlist_peek_head(&wheel[0][curr_tick & WHEEL_MASK]);
+		if (n != NULL) {
+			struct _timeout *t = CONTAINER_OF(n, struct _timeout,
+							  node);
+
+			tq_remove(t);
+			return t;
+		}
+
+		next = wheel_next_event();
+		if (next > curr_tick + announce_remaining) {
+			return NULL;
+		}
+
+		announce_remaining -= next - curr_tick;
+		curr_tick = next;
+		wheel_cascade();
+	}
+}
+
+static void tq_announce_done(void)
+{
+	/* Nothing is due before the end of the announcement, so
+	 * curr_tick can jump there without any cascading.
+	 */
+}
+
+#else /* !CONFIG_TIMEOUT_QUEUE_WHEEL */
+
+static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
+
 static struct _timeout *first(void)
 {
 	sys_dnode_t *t = sys_dlist_peek_head(&timeout_list);
@@ -50,7 +249,7 @@ static struct _timeout *next(struct _timeout *t)
 	return n == NULL ? NULL : CONTAINER_OF(n, struct _timeout, node);
 }
 
-static void remove_timeout(struct _timeout *t)
+static void tq_remove(struct _timeout *t)
 {
 	if (next(t) != NULL) {
 		next(t)->dticks += t->dticks;
@@ -59,6 +258,72 @@ static void remove_timeout(struct _timeout *t)
 	sys_dlist_remove(&t->node);
 }
 
+static void tq_insert(struct _timeout *to, k_ticks_t ticks)
+{
+	struct _timeout *t;
+
+	to->dticks = ticks;
+
+	for (t = first(); t != NULL; t = next(t)) {
+		if (t->dticks > to->dticks) {
+			t->dticks -= to->dticks;
+			sys_dlist_insert(&t->node, &to->node);
+			break;
+		}
+		to->dticks -= t->dticks;
+	}
+
+	if (t == NULL) {
+		sys_dlist_append(&timeout_list, &to->node);
+	}
+}
+
+static k_ticks_t tq_first_ticks(void)
+{
+	struct _timeout *to = first();
+
+	return to == NULL ? K_TICKS_FOREVER : to->dticks;
+}
+
+static k_ticks_t tq_ticks(const struct _timeout *timeout)
+{
+	k_ticks_t ticks = 0;
+
+	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
+		ticks += t->dticks;
+		if (timeout == t) {
+			break;
+		}
+	}
+
+	return ticks;
+}
+
+static struct _timeout *tq_pop_expired(void)
+{
+	struct _timeout *t = first();
+
+	if (t == NULL || t->dticks > announce_remaining) {
+		return NULL;
+	}
+
+	curr_tick += t->dticks;
+	announce_remaining -= t->dticks;
+	t->dticks = 0;
+	tq_remove(t);
+
+	return t;
+}
+
+static void tq_announce_done(void)
+{
+	if (first() != NULL) {
+		first()->dticks -= announce_remaining;
+	}
+}
+
+#endif /* CONFIG_TIMEOUT_QUEUE_WHEEL */
+
 static int32_t elapsed(void)
 {
 	return announce_remaining == 0 ? sys_clock_elapsed() : 0U;
@@ -66,10 +331,10 @@ static int32_t elapsed(void)
 
 static int32_t next_timeout(void)
 {
-	struct _timeout *to = first();
+	k_ticks_t ticks = tq_first_ticks();
 	int32_t ticks_elapsed = elapsed();
-	int32_t ret = to == NULL ? MAX_WAIT
-		: CLAMP(to->dticks - ticks_elapsed, 0, MAX_WAIT);
+	int32_t ret = ticks == K_TICKS_FOREVER ? MAX_WAIT
+		: CLAMP(ticks - ticks_elapsed, 0, MAX_WAIT);
 
 #ifdef CONFIG_TIMESLICING
 	if (_current_cpu->slice_ticks && _current_cpu->slice_ticks < ret) {
@@ -94,31 +359,19 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
 	to->fn = fn;
 
 	LOCKED(&timeout_lock) {
-		struct _timeout *t;
+		k_ticks_t ticks, prev_first = tq_first_ticks();
 
 		if (IS_ENABLED(CONFIG_TIMEOUT_64BIT) &&
 		    Z_TICK_ABS(timeout.ticks) >= 0) {
-			k_ticks_t ticks = Z_TICK_ABS(timeout.ticks) - curr_tick;
-
-			to->dticks = MAX(1, ticks);
+			ticks = Z_TICK_ABS(timeout.ticks) - curr_tick;
+			ticks = MAX(1, ticks);
 		} else {
-			to->dticks = timeout.ticks + 1 + elapsed();
+			ticks = timeout.ticks + 1 + elapsed();
 		}
 
-		for (t = first(); t != NULL; t = next(t)) {
-			if (t->dticks > to->dticks) {
-				t->dticks -= to->dticks;
-				sys_dlist_insert(&t->node, &to->node);
-				break;
-			}
-			to->dticks -= t->dticks;
-		}
+		tq_insert(to, ticks);
 
-		if (t == NULL) {
-			sys_dlist_append(&timeout_list, &to->node);
-		}
-
-		if (to == first()) {
+		if (tq_first_ticks() != prev_first) {
 #if CONFIG_TIMESLICING
 			/*
 			 * This is not ideal, since it does not
@@ -147,7 +400,7 @@ int z_abort_timeout(struct _timeout *to)
 
 	LOCKED(&timeout_lock) {
 		if (sys_dnode_is_linked(&to->node)) {
-			remove_timeout(to);
+			tq_remove(to);
 			ret = 0;
 		}
 	}
@@ -158,20 +411,11 @@ int z_abort_timeout(struct _timeout *to)
 /* must be locked */
 static k_ticks_t timeout_rem(const struct _timeout *timeout)
 {
-	k_ticks_t ticks = 0;
-
 	if (z_is_inactive_timeout(timeout)) {
 		return 0;
 	}
 
-	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
-		ticks += t->dticks;
-		if (timeout == t) {
-			break;
-		}
-	}
-
-	return ticks - elapsed();
+	return tq_ticks(timeout) - elapsed();
 }
 
 k_ticks_t z_timeout_remaining(const struct _timeout *timeout)
@@ -232,6 +476,8 @@ void z_set_timeout_expiry(int32_t ticks, bool is_idle)
 
 void sys_clock_announce(int32_t ticks)
 {
+	struct _timeout *t;
+
 #ifdef CONFIG_TIMESLICING
 	z_time_slice(ticks);
 #endif
@@ -240,23 +486,13 @@ void sys_clock_announce(int32_t ticks)
 
 	announce_remaining = ticks;
 
-	while (first() != NULL && first()->dticks <= announce_remaining) {
-		struct _timeout *t = first();
-		int dt = t->dticks;
-
-		curr_tick += dt;
-		announce_remaining -= dt;
-		t->dticks = 0;
-		remove_timeout(t);
-
+	while ((t = tq_pop_expired()) != NULL) {
 		k_spin_unlock(&timeout_lock, key);
 		t->fn(t);
 		key = k_spin_lock(&timeout_lock);
 	}
 
-	if (first() != NULL) {
-		first()->dticks -= announce_remaining;
-	}
+	tq_announce_done();
 
 	curr_tick += announce_remaining;
 	announce_remaining = 0;
@@ -8,7 +8,6 @@
 #include <kernel.h>
 #include <string.h>
 #include <sys/math_extras.h>
-#include <sys/rb.h>
 #include <kernel_structs.h>
 #include <sys/sys_io.h>
 #include <ksched.h>
@@ -46,7 +45,7 @@ LOG_MODULE_DECLARE(os, CONFIG_KERNEL_LOG_LEVEL);
  * not.
  */
 #ifdef CONFIG_DYNAMIC_OBJECTS
-static struct k_spinlock lists_lock;       /* kobj rbtree/dlist */
+static struct k_spinlock lists_lock;       /* kobj dlist */
 static struct k_spinlock objfree_lock;     /* k_object_free */
 #endif
 static struct k_spinlock obj_lock;         /* kobj struct data */
@@ -135,7 +134,7 @@ uint8_t *z_priv_stack_find(k_thread_stack_t *stack)
 struct dyn_obj {
 	struct z_object kobj;
 	sys_dnode_t dobj_list;
-	struct rbnode node; /* must be immediately before data member */
+	sys_snode_t hash_node;
 
 	/* The object itself */
 	uint8_t data[] __aligned(DYN_OBJ_DATA_ALIGN_K_THREAD);
@@ -145,15 +144,22 @@ extern struct z_object *z_object_gperf_find(const void *obj);
 extern void z_object_gperf_wordlist_foreach(_wordlist_cb_func_t func,
 					     void *context);
 
-static bool node_lessthan(struct rbnode *a, struct rbnode *b);
+#define OBJ_HASH_BUCKETS	CONFIG_DYNAMIC_OBJECTS_HASH_BUCKETS
+
+BUILD_ASSERT((OBJ_HASH_BUCKETS & (OBJ_HASH_BUCKETS - 1)) == 0,
+	     "CONFIG_DYNAMIC_OBJECTS_HASH_BUCKETS must be a power of two");
 
 /*
- * Red/black tree of allocated kernel objects, for reasonably fast lookups
- * based on object pointer values.
+ * Hash table of allocated kernel objects, keyed by object pointer value.
+ * Every bucket has its own lock, so looking up an object during syscall
+ * argument validation only serializes against other users of the same
+ * bucket, never against the whole table.  Lookups compare addresses
+ * only and never dereference the pointer being validated.
  */
-static struct rbtree obj_rb_tree = {
-	.lessthan_fn = node_lessthan
-};
+static struct obj_bucket {
+	struct k_spinlock lock;
+	sys_slist_t list;
+} obj_hash[OBJ_HASH_BUCKETS];
 
 /*
  * Linked list of allocated kernel objects, for iteration over all allocated
@@ -161,11 +167,6 @@ static struct rbtree obj_rb_tree = {
  */
 static sys_dlist_t obj_list = SYS_DLIST_STATIC_INIT(&obj_list);
 
-/*
- * TODO: Write some hash table code that will replace both obj_rb_tree
- * and obj_list.
- */
-
 static size_t obj_size_get(enum k_objects otype)
 {
 	size_t ret;
@@ -200,42 +201,51 @@ static size_t obj_align_get(enum k_objects otype)
 	return ret;
 }
 
-static bool node_lessthan(struct rbnode *a, struct rbnode *b)
+static struct obj_bucket *obj_bucket_get(const void *obj)
 {
-	return a < b;
+	uint32_t h = (uint32_t)((uintptr_t)obj / DYN_OBJ_DATA_ALIGN);
+
+	/* Objects come from a heap, so their addresses differ in only a
+	 * handful of bits; mix everything down before picking a bucket.
+	 */
+	h ^= h >> 16;
+	h *= 0x45d9f3bU;
+	h ^= h >> 16;
+
+	return &obj_hash[h & (OBJ_HASH_BUCKETS - 1)];
 }
 
-static inline struct dyn_obj *node_to_dyn_obj(struct rbnode *node)
+static void obj_hash_insert(struct dyn_obj *dyn)
 {
-	return CONTAINER_OF(node, struct dyn_obj, node);
+	struct obj_bucket *b = obj_bucket_get(&dyn->data);
+	k_spinlock_key_t key = k_spin_lock(&b->lock);
+
+	sys_slist_prepend(&b->list, &dyn->hash_node);
+	k_spin_unlock(&b->lock, key);
 }
 
-static inline struct rbnode *dyn_obj_to_node(void *obj)
+static void obj_hash_remove(struct dyn_obj *dyn)
 {
-	struct dyn_obj *dobj = CONTAINER_OF(obj, struct dyn_obj, data);
+	struct obj_bucket *b = obj_bucket_get(&dyn->data);
+	k_spinlock_key_t key = k_spin_lock(&b->lock);
 
-	return &dobj->node;
+	(void)sys_slist_find_and_remove(&b->list, &dyn->hash_node);
+	k_spin_unlock(&b->lock, key);
 }
 
 static struct dyn_obj *dyn_object_find(void *obj)
 {
-	struct rbnode *node;
-	struct dyn_obj *ret;
+	struct obj_bucket *b = obj_bucket_get(obj);
+	struct dyn_obj *dyn, *ret = NULL;
+	k_spinlock_key_t key = k_spin_lock(&b->lock);
 
-	/* For any dynamically allocated kernel object, the object
-	 * pointer is just a member of the conatining struct dyn_obj,
-	 * so just a little arithmetic is necessary to locate the
-	 * corresponding struct rbnode
-	 */
-	node = dyn_obj_to_node(obj);
-
-	k_spinlock_key_t key = k_spin_lock(&lists_lock);
-	if (rb_contains(&obj_rb_tree, node)) {
-		ret = node_to_dyn_obj(node);
-	} else {
-		ret = NULL;
+	SYS_SLIST_FOR_EACH_CONTAINER(&b->list, dyn, hash_node) {
+		if ((void *)&dyn->data == obj) {
+			ret = dyn;
+			break;
+		}
 	}
-	k_spin_unlock(&lists_lock, key);
+	k_spin_unlock(&b->lock, key);
 
 	return ret;
 }
@@ -320,7 +330,7 @@ struct z_object *z_dynamic_object_aligned_create(size_t align, size_t size)
 
 	k_spinlock_key_t key = k_spin_lock(&lists_lock);
 
-	rb_insert(&obj_rb_tree, &dyn->node);
+	obj_hash_insert(dyn);
 	sys_dlist_append(&obj_list, &dyn->dobj_list);
 	k_spin_unlock(&lists_lock, key);
 
@@ -394,7 +404,7 @@ void k_object_free(void *obj)
 
 	dyn = dyn_object_find(obj);
 	if (dyn != NULL) {
-		rb_remove(&obj_rb_tree, &dyn->node);
+		obj_hash_remove(dyn);
 		sys_dlist_remove(&dyn->dobj_list);
 
 		if (dyn->kobj.type == K_OBJ_THREAD) {
@@ -498,7 +508,7 @@ static void unref_check(struct z_object *ko, uintptr_t index)
 		break;
 	}
 
-	rb_remove(&obj_rb_tree, &dyn->node);
+	obj_hash_remove(dyn);
 	sys_dlist_remove(&dyn->dobj_list);
 	k_free(dyn);
 out:
@@ -552,6 +562,14 @@ static void clear_perms_cb(struct z_object *ko, void *ctx_ptr)
 {
 	uintptr_t id = (uintptr_t)ctx_ptr;
 
+	/* Most objects were never granted to this thread, skip taking
+	 * obj_lock for those: clearing an already clear bit changes
+	 * nothing and cannot drop the last reference.
+	 */
+	if (!sys_bitfield_test_bit((mem_addr_t)&ko->perms, id)) {
+		return;
+	}
+
 	unref_check(ko, id);
 }
 
@@ -6,6 +6,8 @@
 
 #include <sys/crc.h>
 
+#include "crc_table.h"
+
 uint16_t crc16(const uint8_t *src, size_t len, uint16_t polynomial,
 	    uint16_t initial_value, bool pad)
 {
@@ -38,11 +40,15 @@ uint16_t crc16(const uint8_t *src, size_t len, uint16_t polynomial,
 uint16_t crc16_ccitt(uint16_t seed, const uint8_t *src, size_t len)
 {
 	for (; len > 0; len--) {
+#if CRC32_SLICES > 0
+		seed = (seed >> 8) ^ crc16_ccitt_table[(seed ^ *src++) & 0xff];
+#else
 		uint8_t e, f;
 
 		e = seed ^ *src++;
 		f = e ^ (e << 4);
 		seed = (seed >> 8) ^ (f << 8) ^ (f << 3) ^ (f >> 4);
+#endif
 	}
 
 	return seed;
@@ -51,11 +57,15 @@ uint16_t crc16_ccitt(uint16_t seed, const uint8_t *src, size_t len)
 uint16_t crc16_itu_t(uint16_t seed, const uint8_t *src, size_t len)
 {
 	for (; len > 0; len--) {
+#if CRC32_SLICES > 0
+		seed = (seed << 8U) ^ crc16_itu_t_table[(seed >> 8U) ^ *src++];
+#else
 		seed = (seed >> 8U) | (seed << 8U);
 		seed ^= *src++;
 		seed ^= (seed & 0xffU) >> 4U;
 		seed ^= seed << 12U;
 		seed ^= (seed & 0xffU) << 5U;
+#endif
 	}
 
 	return seed;
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* The CRC instructions of the CPU are only used when the compiler is
+ * told they are there, no probing is done at run time.
+ *
+ * The intrinsics headers come first: on hosts with a C library they
+ * pull in <stdlib.h>, whose byte swap helpers clash with the macros of
+ * the same name in <sys/byteorder.h> if that is seen before.
+ */
+#if defined(CONFIG_CRC_CPU_INSTRUCTIONS) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#elif defined(CONFIG_CRC_CPU_INSTRUCTIONS) && defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+#include <sys/crc.h>
+#include <sys/byteorder.h>
+
+#include "crc_table.h"
+
+#if defined(CONFIG_CRC_CPU_INSTRUCTIONS) && defined(__ARM_FEATURE_CRC32)
+#if defined(__aarch64__)
+#define CRC32_WORD_LEN 8
+#define crc32_ieee_word(crc, p) __crc32d(crc, sys_get_le64(p))
+#define crc32_c_word(crc, p) __crc32cd(crc, sys_get_le64(p))
+#else
+#define CRC32_WORD_LEN 4
+#define crc32_ieee_word(crc, p) __crc32w(crc, sys_get_le32(p))
+#define crc32_c_word(crc, p) __crc32cw(crc, sys_get_le32(p))
+#endif
+#define crc32_ieee_byte(crc, b) __crc32b(crc, b)
+#define crc32_c_byte(crc, b) __crc32cb(crc, b)
+
+#elif defined(CONFIG_CRC_CPU_INSTRUCTIONS) && defined(__SSE4_2__)
+/* SSE4.2 only knows the Castagnoli polynomial */
+#if defined(__x86_64__)
+#define CRC32_WORD_LEN 8
+#define crc32_c_word(crc, p) ((uint32_t)_mm_crc32_u64(crc, sys_get_le64(p)))
+#else
+#define CRC32_WORD_LEN 4
+#define crc32_c_word(crc, p) _mm_crc32_u32(crc, sys_get_le32(p))
+#endif
+#define crc32_c_byte(crc, b) _mm_crc32_u8(crc, b)
+#endif
+
+#if CRC32_SLICES > 0
+typedef const uint32_t (*crc32_table_t)[256];
+#else
+typedef const uint32_t *crc32_table_t;
+#endif
+
+#if defined(CONFIG_CRC_HW_HOOK)
+static const struct crc_hw_api *crc_hw;
+
+void crc_hw_register(const struct crc_hw_api *api)
+{
+	crc_hw = api;
+}
+#endif
+
+static inline uint32_t crc32_table_update(crc32_table_t t, uint32_t crc,
+					  const uint8_t *data, size_t len)
+{
+#if CRC32_SLICES == 8
+	for (; len >= 8; data += 8, len -= 8) {
+		uint32_t lo = crc ^ sys_get_le32(data);
+		uint32_t hi = sys_get_le32(data + 4);
+
+		crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^
+		      t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+		      t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^
+		      t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+	}
+#elif CRC32_SLICES == 4
+	for (; len >= 4; data += 4, len -= 4) {
+		crc ^= sys_get_le32(data);
+		crc = t[3][crc & 0xff] ^ t[2][(crc >> 8) & 0xff] ^
+		      t[1][(crc >> 16) & 0xff] ^ t[0][crc >> 24];
+	}
+#endif
+
+	for (size_t i = 0; i < len; i++) {
+#if CRC32_SLICES > 0
+		crc = (crc >> 8) ^ t[0][(crc ^ data[i]) & 0xff];
+#else
+		crc = (crc >> 4) ^ t[(crc ^ data[i]) & 0x0f];
+		crc = (crc >> 4) ^ t[(crc ^ (data[i] >> 4)) & 0x0f];
+#endif
+	}
+
+	return crc;
+}
+
+uint32_t crc32_ieee_raw(uint32_t crc, const uint8_t *data, size_t len)
+{
+#if defined(CONFIG_CRC_HW_HOOK)
+	const struct crc_hw_api *hw = crc_hw;
+
+	if (hw != NULL && hw->crc32_ieee != NULL && len >= hw->min_len) {
+		return hw->crc32_ieee(crc, data, len);
+	}
+#endif
+
+#if defined(crc32_ieee_word)
+	for (; len >= CRC32_WORD_LEN; data += CRC32_WORD_LEN,
+	     len -= CRC32_WORD_LEN) {
+		crc = crc32_ieee_word(crc, data);
+	}
+
+	for (; len > 0; len--) {
+		crc = crc32_ieee_byte(crc, *data++);
+	}
+
+	return crc;
+#else
+	return crc32_table_update(crc32_ieee_table, crc, data, len);
+#endif
+}
+
+uint32_t crc32_c_raw(uint32_t crc, const uint8_t *data, size_t len)
+{
+#if defined(CONFIG_CRC_HW_HOOK)
+	const struct crc_hw_api *hw = crc_hw;
+
+	if (hw != NULL && hw->crc32_c != NULL && len >= hw->min_len) {
+		return hw->crc32_c(crc, data, len);
+	}
+#endif
+
+#if defined(crc32_c_word)
+	for (; len >= CRC32_WORD_LEN; data += CRC32_WORD_LEN,
+	     len -= CRC32_WORD_LEN) {
+		crc = crc32_c_word(crc, data);
+	}
+
+	for (; len > 0; len--) {
+		crc = crc32_c_byte(crc, *data++);
+	}
+
+	return crc;
+#else
+	return crc32_table_update(crc32_c_table, crc, data, len);
+#endif
+}
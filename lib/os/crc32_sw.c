@@ -6,6 +6,8 @@
 
 #include <sys/crc.h>
 
+#include "crc_table.h"
+
 uint32_t crc32_ieee(const uint8_t *data, size_t len)
 {
 	return crc32_ieee_update(0x0, data, len);
@@ -13,22 +15,5 @@ uint32_t crc32_ieee(const uint8_t *data, size_t len)
 
 uint32_t crc32_ieee_update(uint32_t crc, const uint8_t *data, size_t len)
 {
-	/* crc table generated from polynomial 0xedb88320 */
-	static const uint32_t table[16] = {
-		0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
-		0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
-		0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
-		0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
-	};
-
-	crc = ~crc;
-
-	for (size_t i = 0; i < len; i++) {
-		uint8_t byte = data[i];
-
-		crc = (crc >> 4) ^ table[(crc ^ byte) & 0x0f];
-		crc = (crc >> 4) ^ table[(crc ^ (byte >> 4)) & 0x0f];
-	}
-
-	return (~crc);
+	return ~crc32_ieee_raw(~crc, data, len);
 }
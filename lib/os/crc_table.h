@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_LIB_OS_CRC_TABLE_H_
+#define ZEPHYR_LIB_OS_CRC_TABLE_H_
+
+#include <zephyr/types.h>
+#include <stddef.h>
+
+/* Number of 256 entry tables of each CRC-32, which is also the number
+ * of bytes processed per step. Zero stands for the 16 entry tables
+ * processing half a byte per step.
+ */
+#if defined(CONFIG_CRC_TABLE_SLICE_BY_8)
+#define CRC32_SLICES 8
+#elif defined(CONFIG_CRC_TABLE_SLICE_BY_4)
+#define CRC32_SLICES 4
+#elif defined(CONFIG_CRC_TABLE_BYTE)
+#define CRC32_SLICES 1
+#else
+#define CRC32_SLICES 0
+#endif
+
+#if CRC32_SLICES > 0
+extern const uint32_t crc32_ieee_table[CRC32_SLICES][256];
+extern const uint32_t crc32_c_table[CRC32_SLICES][256];
+extern const uint16_t crc16_ccitt_table[256];
+extern const uint16_t crc16_itu_t_table[256];
+extern const uint8_t crc8_ccitt_table[256];
+#else
+extern const uint32_t crc32_ieee_table[16];
+extern const uint32_t crc32_c_table[16];
+extern const uint8_t crc8_ccitt_table[16];
+#endif
+
+/* Update the register of a reflected CRC-32, with neither the initial
+ * nor the final inversion, in hardware when a CRC unit is registered,
+ * with the CRC instructions of the CPU when there are some, and with
+ * the tables otherwise.
+ */
+uint32_t crc32_ieee_raw(uint32_t crc, const uint8_t *data, size_t len);
+uint32_t crc32_c_raw(uint32_t crc, const uint8_t *data, size_t len);
+
+#endif /* ZEPHYR_LIB_OS_CRC_TABLE_H_ */
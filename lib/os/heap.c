@@ -18,6 +18,31 @@ static void *chunk_mem(struct z_heap *h, chunkid_t c)
 	return ret;
 }
 
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+static void stats_alloc(struct z_heap *h, chunksz_t sz)
+{
+	size_t bytes = (size_t)sz * CHUNK_UNIT;
+
+	h->allocated_bytes += bytes;
+	h->free_bytes -= bytes;
+	h->alloc_count++;
+	h->max_allocated_bytes = MAX(h->max_allocated_bytes,
+				     h->allocated_bytes);
+}
+
+static void stats_free(struct z_heap *h, chunksz_t sz)
+{
+	size_t bytes = (size_t)sz * CHUNK_UNIT;
+
+	h->allocated_bytes -= bytes;
+	h->free_bytes += bytes;
+	h->alloc_count--;
+}
+#else
+static inline void stats_alloc(struct z_heap *h, chunksz_t sz) { }
+static inline void stats_free(struct z_heap *h, chunksz_t sz) { }
+#endif
+
 static void free_list_remove_bidx(struct z_heap *h, chunkid_t c, int bidx)
 {
 	struct z_heap_bucket *b = &h->buckets[bidx];
@@ -139,12 +164,8 @@ static chunkid_t mem_to_chunkid(struct z_heap *h, void *p)
 	return (mem - chunk_header_bytes(h) - base) / CHUNK_UNIT;
 }
 
-void sys_heap_free(struct sys_heap *heap, void *mem)
+static void free_mem(struct z_heap *h, void *mem)
 {
-	if (mem == NULL) {
-		return; /* ISO C free() semantics */
-	}
-	struct z_heap *h = heap->heap;
 	chunkid_t c = mem_to_chunkid(h, mem);
 
 	/*
@@ -163,10 +184,48 @@ void sys_heap_free(struct sys_heap *heap, void *mem)
 		 "corrupted heap bounds (buffer overflow?) for memory at %p",
 		 mem);
 
+	stats_free(h, chunk_size(h, c));
 	set_chunk_used(h, c, false);
 	free_chunk(h, c);
 }
 
+#ifdef CONFIG_SYS_HEAP_SLAB
+static void slab_free(struct z_heap_slab *s, struct z_heap_slab_page *pg,
+		      void *mem)
+{
+	int cls = pg->cls - 1;
+
+	__ASSERT(pg->used != 0U,
+		 "unexpected slab state (double-free?) for memory at %p", mem);
+
+	*(void **)mem = s->free[cls];
+	s->free[cls] = mem;
+	if (--pg->used == 0U) {
+		s->empty_pages++;
+	}
+}
+#endif
+
+void sys_heap_free(struct sys_heap *heap, void *mem)
+{
+	if (mem == NULL) {
+		return; /* ISO C free() semantics */
+	}
+
+#ifdef CONFIG_SYS_HEAP_SLAB
+	if (heap->slab != NULL) {
+		struct z_heap_slab_page *pg = slab_page(heap->slab, mem);
+
+		if (pg->cls != 0U) {
+			slab_free(heap->slab, pg, mem);
+			return;
+		}
+	}
+#endif
+
+	free_mem(heap->heap, mem);
+}
+
 static chunkid_t alloc_chunk(struct z_heap *h, chunksz_t sz)
 {
 	int bi = bucket_idx(h, sz);
@@ -219,10 +278,8 @@ static chunkid_t alloc_chunk(struct z_heap *h, chunksz_t sz)
 	return 0;
 }
 
-void *sys_heap_alloc(struct sys_heap *heap, size_t bytes)
+static void *heap_alloc(struct z_heap *h, size_t bytes)
 {
-	struct z_heap *h = heap->heap;
-
 	if (bytes == 0U || size_too_big(h, bytes)) {
 		return NULL;
 	}
@@ -240,12 +297,12 @@ void *sys_heap_alloc(struct sys_heap *heap, size_t bytes)
 	}
 
 	set_chunk_used(h, c, true);
+	stats_alloc(h, chunk_size(h, c));
 	return chunk_mem(h, c);
 }
 
-void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes)
+static void *heap_aligned_alloc(struct z_heap *h, size_t align, size_t bytes)
 {
-	struct z_heap *h = heap->heap;
 	size_t gap, rew;
 
 	/*
@@ -261,7 +318,7 @@ void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes)
 		gap = MIN(rew, chunk_header_bytes(h));
 	} else {
 		if (align <= chunk_header_bytes(h)) {
-			return sys_heap_alloc(heap, bytes);
+			return heap_alloc(h, bytes);
 		}
 		rew = 0;
 		gap = chunk_header_bytes(h);
@@ -307,6 +364,188 @@ void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes)
 	}
 
 	set_chunk_used(h, c, true);
+	stats_alloc(h, chunk_size(h, c));
+	return mem;
+}
+
+#ifdef CONFIG_SYS_HEAP_SLAB
+size_t sys_heap_slab_reclaim(struct sys_heap *heap)
+{
+	struct z_heap_slab *s = heap->slab;
+	size_t freed = 0;
+
+	if (s == NULL || s->empty_pages == 0U) {
+		return 0;
+	}
+
+	/* Unlink the objects of empty pages from the free lists... */
+	for (int cls = 0; cls < CONFIG_SYS_HEAP_SLAB_CLASSES; cls++) {
+		void **link = &s->free[cls];
+
+		while (*link != NULL) {
+			void **obj = *link;
+
+			if (slab_page(s, obj)->used == 0U) {
+				*link = *obj;
+			} else {
+				link = obj;
+			}
+		}
+	}
+
+	/* ...then give the pages back */
+	for (uint32_t i = 0; i < s->npages; i++) {
+		struct z_heap_slab_page *pg = &s->map[i];
+
+		if (pg->cls != 0U && pg->used == 0U) {
+			pg->cls = 0U;
+			free_mem(heap->heap,
+				 (void *)((s->first_page + i) << SLAB_PAGE_SHIFT));
+			freed += SLAB_PAGE_SIZE;
+		}
+	}
+	s->empty_pages = 0U;
+
+	return freed;
+}
+
+static bool slab_grow(struct sys_heap *heap, int cls)
+{
+	struct z_heap_slab *s = heap->slab;
+	size_t sz = slab_class_size(cls);
+	uint8_t *page;
+
+	page = heap_aligned_alloc(heap->heap, SLAB_PAGE_SIZE, SLAB_PAGE_SIZE);
+	if (page == NULL && sys_heap_slab_reclaim(heap) != 0U) {
+		page = heap_aligned_alloc(heap->heap, SLAB_PAGE_SIZE,
+					  SLAB_PAGE_SIZE);
+	}
+	if (page == NULL) {
+		return false;
+	}
+
+	struct z_heap_slab_page *pg = slab_page(s, page);
+
+	pg->cls = cls + 1;
+	pg->used = 0U;
+	s->empty_pages++;
+
+	/* Push from the top so objects are handed out in address order */
+	for (size_t off = SLAB_PAGE_SIZE; off >= sz; off -= sz) {
+		void **obj = (void **)(page + off - sz);
+
+		*obj = s->free[cls];
+		s->free[cls] = obj;
+	}
+
+	return true;
+}
+
+static void *slab_alloc(struct sys_heap *heap, int cls)
+{
+	struct z_heap_slab *s = heap->slab;
+	void **obj = s->free[cls];
+
+	if (obj == NULL) {
+		if (!slab_grow(heap, cls)) {
+			return NULL;
+		}
+		obj = s->free[cls];
+	}
+
+	struct z_heap_slab_page *pg = slab_page(s, obj);
+
+	s->free[cls] = *obj;
+	if (pg->used++ == 0U) {
+		s->empty_pages--;
+	}
+
+	return obj;
+}
+
+int sys_heap_slab_class(struct sys_heap *heap, void *mem)
+{
+	if (heap->slab == NULL) {
+		return -1;
+	}
+
+	return slab_page(heap->slab, mem)->cls - 1;
+}
+
+int sys_heap_slab_init(struct sys_heap *heap)
+{
+	struct z_heap *h = heap->heap;
+	uintptr_t first = (uintptr_t)chunk_buf(h) >> SLAB_PAGE_SHIFT;
+	uintptr_t last = (uintptr_t)&chunk_buf(h)[h->end_chunk] >> SLAB_PAGE_SHIFT;
+	uint32_t npages = last - first + 1;
+	struct z_heap_slab *s;
+
+	s = heap_alloc(h, sizeof(*s) + npages * sizeof(s->map[0]));
+	if (s == NULL) {
+		return -ENOMEM;
+	}
+
+	(void)memset(s, 0, sizeof(*s) + npages * sizeof(s->map[0]));
+	s->first_page = first;
+	s->npages = npages;
+	heap->slab = s;
+
+	return 0;
+}
+#else
+static inline size_t sys_heap_slab_reclaim(struct sys_heap *heap)
+{
+	ARG_UNUSED(heap);
+
+	return 0;
+}
+#endif /* CONFIG_SYS_HEAP_SLAB */
+
+void *sys_heap_alloc(struct sys_heap *heap, size_t bytes)
+{
+	void *mem;
+
+#ifdef CONFIG_SYS_HEAP_SLAB
+	int cls = sys_heap_slab_size_class(bytes);
+
+	if (heap->slab != NULL && cls >= 0) {
+		mem = slab_alloc(heap, cls);
+		if (mem != NULL) {
+			return mem;
+		}
+	}
+#endif
+
+	mem = heap_alloc(heap->heap, bytes);
+	if (mem == NULL && sys_heap_slab_reclaim(heap) != 0U) {
+		mem = heap_alloc(heap->heap, bytes);
+	}
+
+	return mem;
+}
+
+void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes)
+{
+	void *mem;
+
+#ifdef CONFIG_SYS_HEAP_SLAB
+	int cls = sys_heap_slab_size_class(bytes);
+
+	/* Slab objects are naturally aligned to their class size */
+	if (heap->slab != NULL && cls >= 0 && (align & (align - 1)) == 0 &&
+	    align <= slab_class_size(cls)) {
+		mem = slab_alloc(heap, cls);
+		if (mem != NULL) {
+			return mem;
+		}
+	}
+#endif
+
+	mem = heap_aligned_alloc(heap->heap, align, bytes);
+	if (mem == NULL && sys_heap_slab_reclaim(heap) != 0U) {
+		mem = heap_aligned_alloc(heap->heap, align, bytes);
+	}
+
 	return mem;
 }
 
@@ -326,6 +565,27 @@ void *sys_heap_aligned_realloc(struct sys_heap *heap, void *ptr,
 
 	__ASSERT((align & (align - 1)) == 0, "align must be a power of 2");
 
+#ifdef CONFIG_SYS_HEAP_SLAB
+	int cls = sys_heap_slab_class(heap, ptr);
+
+	if (cls >= 0) {
+		size_t sz = slab_class_size(cls);
+
+		if (bytes <= sz && (align == 0 ||
+				    ((uintptr_t)ptr & (align - 1)) == 0)) {
+			return ptr;
+		}
+
+		void *ptr2 = sys_heap_aligned_alloc(heap, align, bytes);
+
+		if (ptr2 != NULL) {
+			memcpy(ptr2, ptr, MIN(sz, bytes));
+			sys_heap_free(heap, ptr);
+		}
+		return ptr2;
+	}
+#endif
+
 	if (size_too_big(h, bytes)) {
 		return NULL;
 	}
@@ -342,8 +602,10 @@ void *sys_heap_aligned_realloc(struct sys_heap *heap, void *ptr,
 		return ptr;
 	} else if (chunk_size(h, c) > chunks_need) {
 		/* Shrink in place, split off and free unused suffix */
+		stats_free(h, chunk_size(h, c));
 		split_chunks(h, c, c + chunks_need);
 		set_chunk_used(h, c, true);
+		stats_alloc(h, chunk_size(h, c));
 		free_chunk(h, c + chunks_need);
 		return ptr;
 	} else if (!chunk_used(h, rc) &&
@@ -351,6 +613,7 @@ void *sys_heap_aligned_realloc(struct sys_heap *heap, void *ptr,
 		/* Expand: split the right chunk and append */
 		chunkid_t split_size = chunks_need - chunk_size(h, c);
 
+		stats_free(h, chunk_size(h, c));
 		free_list_remove(h, rc);
 
 		if (split_size < chunk_size(h, rc)) {
@@ -360,6 +623,7 @@ void *sys_heap_aligned_realloc(struct sys_heap *heap, void *ptr,
 
 		merge_chunks(h, c, rc);
 		set_chunk_used(h, c, true);
+		stats_alloc(h, chunk_size(h, c));
 		return ptr;
 	} else {
 		;
@@ -396,6 +660,9 @@ void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
 
 	struct z_heap *h = (struct z_heap *)addr;
 	heap->heap = h;
+#ifdef CONFIG_SYS_HEAP_SLAB
+	heap->slab = NULL;
+#endif
 	h->end_chunk = heap_sz;
 	h->avail_buckets = 0;
 
@@ -414,6 +681,13 @@ void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
 	set_left_chunk_size(h, 0, 0);
 	set_chunk_used(h, 0, true);
 
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+	h->free_bytes = (size_t)(heap_sz - chunk0_size) * CHUNK_UNIT;
+	h->allocated_bytes = 0;
+	h->max_allocated_bytes = 0;
+	h->alloc_count = 0;
+#endif
+
 	/* chunk containing the free heap */
 	set_chunk_size(h, chunk0_size, heap_sz - chunk0_size);
 	set_left_chunk_size(h, chunk0_size, chunk0_size);
@@ -425,3 +699,56 @@ void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
 
 	free_list_add(h, chunk0_size);
 }
+
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+int sys_heap_runtime_stats_get(struct sys_heap *heap,
+			       struct sys_heap_runtime_stats *stats)
+{
+	if ((heap == NULL) || (stats == NULL)) {
+		return -EINVAL;
+	}
+
+	struct z_heap *h = heap->heap;
+	int nb_buckets = bucket_idx(h, h->end_chunk) + 1;
+	chunksz_t largest = 0;
+
+	(void)memset(stats, 0, sizeof(*stats));
+	stats->free_bytes = h->free_bytes;
+	stats->allocated_bytes = h->allocated_bytes;
+	stats->max_allocated_bytes = h->max_allocated_bytes;
+	stats->alloc_count = h->alloc_count;
+	stats->nb_buckets = MIN(nb_buckets, SYS_HEAP_RUNTIME_STATS_BUCKETS);
+
+	for (int b = 0; b < stats->nb_buckets; b++) {
+		chunkid_t first = h->buckets[b].next;
+		chunkid_t c = first;
+
+		if (first == 0U) {
+			continue;
+		}
+
+		do {
+			stats->free_chunks[b]++;
+			largest = MAX(largest, chunk_size(h, c));
+			c = next_free_chunk(h, c);
+		} while (c != first);
+	}
+
+	if (largest != 0U) {
+		stats->largest_free_bytes = chunksz_to_bytes(h, largest);
+	}
+
+	return 0;
+}
+
+int sys_heap_runtime_stats_reset_max(struct sys_heap *heap)
+{
+	if (heap == NULL) {
+		return -EINVAL;
+	}
+
+	heap->heap->max_allocated_bytes = heap->heap->allocated_bytes;
+
+	return 0;
+}
+#endif /* CONFIG_SYS_HEAP_RUNTIME_STATS */
@@ -69,6 +69,12 @@ struct z_heap {
 	chunkid_t chunk0_hdr[2];
 	chunkid_t end_chunk;
 	uint32_t avail_buckets;
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+	size_t free_bytes;
+	size_t allocated_bytes;
+	size_t max_allocated_bytes;
+	uint32_t alloc_count;
+#endif
 	struct z_heap_bucket buckets[0];
 };
 
@@ -251,6 +257,54 @@ static inline bool size_too_big(struct z_heap *h, size_t bytes)
 	return (bytes / CHUNK_UNIT) >= h->end_chunk;
 }
 
+#ifdef CONFIG_SYS_HEAP_SLAB
+
+/* The slab front end lives outside the chunk machinery.  Whole pages
+ * of CONFIG_SYS_HEAP_SLAB_PAGE_SIZE bytes are allocated as (aligned)
+ * chunks and cut into objects of one size class, threaded on a per
+ * class singly linked free list through their first word.  A page
+ * map with one entry per page of the heap's address range tells
+ * whether a pointer lies in a slab page (so frees never need to look
+ * at chunk headers) and how many of the page's objects are in use,
+ * so empty pages can be handed back to the heap.
+ */
+#define SLAB_PAGE_SIZE CONFIG_SYS_HEAP_SLAB_PAGE_SIZE
+#define SLAB_PAGE_SHIFT (__builtin_ctz(SLAB_PAGE_SIZE))
+
+BUILD_ASSERT((SLAB_PAGE_SIZE & (SLAB_PAGE_SIZE - 1)) == 0,
+	     "slab page size must be a power of two");
+BUILD_ASSERT(SLAB_PAGE_SIZE >= 2 * SYS_HEAP_SLAB_MAX_SIZE,
+	     "slab page size must hold at least two of the largest objects");
+
+struct z_heap_slab_page {
+	uint16_t used;	/* allocated objects */
+	uint8_t cls;	/* size class + 1, zero if not a slab page */
+};
+
+struct z_heap_slab {
+	uintptr_t first_page;	/* page number of the first map entry */
+	uint32_t npages;
+	uint32_t empty_pages;	/* slab pages with no object in use */
+	void *free[CONFIG_SYS_HEAP_SLAB_CLASSES];
+	struct z_heap_slab_page map[0];
+};
+
+static inline size_t slab_class_size(int cls)
+{
+	return SYS_HEAP_SLAB_MIN_SIZE << cls;
+}
+
+static inline struct z_heap_slab_page *slab_page(struct z_heap_slab *s,
+						  void *mem)
+{
+	uintptr_t pg = ((uintptr_t)mem >> SLAB_PAGE_SHIFT) - s->first_page;
+
+	CHECK(pg < s->npages);
+	return &s->map[pg];
+}
+
+#endif /* CONFIG_SYS_HEAP_SLAB */
+
 /* For debugging */
 void heap_print_info(struct z_heap *h, bool dump_chunks);
 
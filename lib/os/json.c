@@ -214,15 +214,134 @@ static void *lexer_null(struct lexer *lexer)
 	return lexer_json;
 }
 
+/* Position in the number grammar: an optional minus, an integer part
+ * without leading zeros, then optional fraction and exponent.
+ */
+enum number_state {
+	NUM_START,
+	NUM_MINUS,
+	NUM_ZERO,
+	NUM_INT,
+	NUM_POINT,
+	NUM_FRAC,
+	NUM_EXP_START,
+	NUM_EXP_SIGN,
+	NUM_EXP,
+};
+
+static bool number_complete(uint8_t state)
+{
+	return state == NUM_ZERO || state == NUM_INT || state == NUM_FRAC ||
+	       state == NUM_EXP;
+}
+
+/* Returns 1 if chr goes on with the number, 0 if the number ended just
+ * before it, or -EINVAL if the number is malformed.
+ */
+static int number_next(uint8_t *state, int chr)
+{
+	bool digit = isdigit(chr);
+
+	switch (*state) {
+	case NUM_START:
+		if (chr == '-') {
+			*state = NUM_MINUS;
+			return 1;
+		}
+
+		__fallthrough;
+	case NUM_MINUS:
+		if (!digit) {
+			return -EINVAL;
+		}
+
+		*state = chr == '0' ? NUM_ZERO : NUM_INT;
+		return 1;
+	case NUM_INT:
+	case NUM_FRAC:
+	case NUM_EXP:
+		if (digit) {
+			return 1;
+		}
+
+		__fallthrough;
+	case NUM_ZERO:
+		if (chr == '.' && *state <= NUM_INT) {
+			*state = NUM_POINT;
+			return 1;
+		}
+
+		if ((chr == 'e' || chr == 'E') && *state != NUM_EXP) {
+			*state = NUM_EXP_START;
+			return 1;
+		}
+
+		/* "01", "1-2" or "1.2.3" are not a number and another token */
+		if (digit || chr == '.' || chr == 'e' || chr == 'E' ||
+		    chr == '+' || chr == '-') {
+			return -EINVAL;
+		}
+
+		return 0;
+	case NUM_POINT:
+		if (!digit) {
+			return -EINVAL;
+		}
+
+		*state = NUM_FRAC;
+		return 1;
+	case NUM_EXP_START:
+		if (chr == '+' || chr == '-') {
+			*state = NUM_EXP_SIGN;
+			return 1;
+		}
+
+		__fallthrough;
+	case NUM_EXP_SIGN:
+		if (!digit) {
+			return -EINVAL;
+		}
+
+		*state = NUM_EXP;
+		return 1;
+	}
+
+	return -EINVAL;
+}
+
+static bool number_valid(const char *text, size_t len)
+{
+	uint8_t state = NUM_START;
+
+	for (; len > 0; text++, len--) {
+		if (number_next(&state, (unsigned char)*text) <= 0) {
+			return false;
+		}
+	}
+
+	return number_complete(state);
+}
+
 static void *lexer_number(struct lexer *lexer)
 {
+	uint8_t state = NUM_START;
+
+	/* Go back to the sign or first digit lexer_json() saw */
+	backup(lexer);
+
 	while (true) {
 		int chr = next(lexer);
+		int ret = number_next(&state, chr);
 
-		if (isdigit(chr) || chr == '.') {
+		if (ret > 0) {
 			continue;
 		}
 
+		if (ret < 0 || !number_complete(state)) {
+			emit(lexer, JSON_TOK_ERROR);
+			return NULL;
+		}
+
 		backup(lexer);
 		emit(lexer, JSON_TOK_NUMBER);
 
@@ -388,30 +507,44 @@ static int arr_next(struct json_obj *json, struct token *value)
 	return element_token(value->type);
 }
 
-static int decode_num(const struct token *token, int32_t *num)
+/* strtol() would need the token to be NUL terminated, and there is no
+ * strtoll() in the minimal libc, so integers are decoded here.
+ */
+static int decode_int(const struct token *token, int64_t min, int64_t max,
+		      int64_t *num)
 {
-	/* FIXME: strtod() is not available in newlib/minimal libc,
-	 * so using strtol() here.
-	 */
-	char *endptr;
-	char prev_end;
+	const char *pos = token->start;
+	bool negative = false;
+	uint64_t value = 0U;
+	uint64_t limit;
+
+	if (pos < token->end && *pos == '-') {
+		negative = true;
+		pos++;
+	}
 
-	prev_end = *token->end;
-	*token->end = '\0';
+	if (pos == token->end) {
+		return -EINVAL;
+	}
 
-	errno = 0;
-	*num = strtol(token->start, &endptr, 10);
+	limit = negative ? (uint64_t)(-(min + 1)) + 1U : (uint64_t)max;
 
-	*token->end = prev_end;
+	for (; pos < token->end; pos++) {
+		unsigned int digit = (unsigned int)(*pos - '0');
 
-	if (errno != 0) {
-		return -errno;
-	}
+		if (digit > 9U) {
+			return -EINVAL;
+		}
 
-	if (endptr != token->end) {
-		return -EINVAL;
+		if (value > (limit - digit) / 10U) {
+			return -ERANGE;
+		}
+
+		value = value * 10U + digit;
 	}
 
+	*num = negative ? (int64_t)(0U - value) : (int64_t)value;
+
 	return 0;
 }
 
@@ -421,6 +554,14 @@ static bool equivalent_types(enum json_tokens type1, enum json_tokens type2)
 		return type2 == JSON_TOK_TRUE || type2 == JSON_TOK_FALSE;
 	}
 
+	if (type2 == JSON_TOK_FLOAT || type2 == JSON_TOK_INT64) {
+		return type1 == JSON_TOK_NUMBER;
+	}
+
+	if (type2 == JSON_TOK_OPAQUE) {
+		return type1 == JSON_TOK_STRING;
+	}
+
 	return type1 == type2;
 }
 
@@ -458,8 +599,29 @@ static int decode_value(struct json_obj *obj,
 	}
 	case JSON_TOK_NUMBER: {
 		int32_t *num = field;
+		int64_t num64;
+		int ret;
+
+		ret = decode_int(value, INT32_MIN, INT32_MAX, &num64);
+		if (ret == 0) {
+			*num = (int32_t)num64;
+		}
+
+		return ret;
+	}
+	case JSON_TOK_INT64: {
+		int64_t *num = field;
+
+		return decode_int(value, INT64_MIN, INT64_MAX, num);
+	}
+	case JSON_TOK_FLOAT:
+	case JSON_TOK_OPAQUE: {
+		struct json_obj_token *raw = field;
+
+		raw->start = value->start;
+		raw->length = (size_t)(value->end - value->start);
 
-		return decode_num(value, num);
+		return 0;
 	}
 	case JSON_TOK_STRING: {
 		char **str = field;
@@ -479,6 +641,11 @@ static ptrdiff_t get_elem_size(const struct json_obj_descr *descr)
 	switch (descr->type) {
 	case JSON_TOK_NUMBER:
 		return sizeof(int32_t);
+	case JSON_TOK_INT64:
+		return sizeof(int64_t);
+	case JSON_TOK_FLOAT:
+	case JSON_TOK_OPAQUE:
+		return sizeof(struct json_obj_token);
 	case JSON_TOK_STRING:
 		return sizeof(char *);
 	case JSON_TOK_TRUE:
@@ -607,6 +774,349 @@ int json_obj_parse(char *payload, size_t len,
 	return obj_parse(&obj, descr, descr_len, val);
 }
 
+/* What the streaming tokenizer accepts next */
+enum json_expect {
+	EXPECT_VALUE,
+	EXPECT_VALUE_OR_END,
+	EXPECT_KEY,
+	EXPECT_KEY_OR_END,
+	EXPECT_COLON,
+	EXPECT_COMMA_OR_END,
+	EXPECT_NOTHING,
+};
+
+/* Token being read when a chunk ends */
+enum json_in_token {
+	IN_NONE,
+	IN_KEY,
+	IN_STRING,
+	IN_NUMBER,
+	IN_LITERAL,
+};
+
+/* Progress in an escape sequence of a string: 1 to 4 hex digits
+ * remaining, or just after the backslash.
+ */
+#define ESCAPE_NONE 0
+#define ESCAPE_START 5
+
+#define MAX_DEPTH 32
+
+static const struct {
+	const char *text;
+	uint8_t len;
+	enum json_tokens type;
+} literals[] = {
+	{ "true", 4, JSON_TOK_TRUE },
+	{ "false", 5, JSON_TOK_FALSE },
+	{ "null", 4, JSON_TOK_NULL },
+};
+
+void json_tokenizer_init(struct json_tokenizer *tok, char *scratch,
+			 size_t scratch_size)
+{
+	memset(tok, 0, sizeof(*tok));
+	tok->scratch = scratch;
+	tok->scratch_size = scratch_size;
+	tok->expect = EXPECT_VALUE;
+}
+
+void json_tokenizer_feed(struct json_tokenizer *tok, const char *data,
+			 size_t len, bool last)
+{
+	tok->pos = data;
+	tok->end = data + len;
+	tok->last = last;
+}
+
+static bool tok_in_object(struct json_tokenizer *tok)
+{
+	return tok->objects & BIT(tok->depth - 1);
+}
+
+static void tok_value_done(struct json_tokenizer *tok)
+{
+	tok->expect = tok->depth ? EXPECT_COMMA_OR_END : EXPECT_NOTHING;
+}
+
+static int tok_emit(struct json_tokenizer *tok, struct json_token *token,
+		    enum json_tokens type, const char *start, size_t length)
+{
+	token->type = type;
+	token->start = start;
+	token->length = length;
+
+	return 0;
+}
+
+/* Go on with the string, number or literal started, in this chunk or
+ * in a previous one.  Sets *end to where the token ends, or to NULL if
+ * it goes on in the next chunk.
+ */
+static int tok_scan(struct json_tokenizer *tok, const char **end)
+{
+	*end = NULL;
+
+	for (; tok->pos < tok->end; tok->pos++) {
+		unsigned char chr = *tok->pos;
+
+		switch (tok->in_token) {
+		case IN_KEY:
+		case IN_STRING:
+			if (tok->matched == ESCAPE_START) {
+				if (chr == 'u') {
+					tok->matched = 4;
+				} else if (strchr("\"\\/bfnrt", chr) && chr) {
+					tok->matched = ESCAPE_NONE;
+				} else {
+					return -EINVAL;
+				}
+			} else if (tok->matched != ESCAPE_NONE) {
+				if (!isxdigit(chr)) {
+					return -EINVAL;
+				}
+
+				tok->matched--;
+			} else if (chr == '\\') {
+				tok->matched = ESCAPE_START;
+			} else if (chr == '"') {
+				*end = tok->pos++;
+				return 0;
+			} else if (chr < 0x20) {
+				return -EINVAL;
+			}
+			break;
+		case IN_NUMBER: {
+			int ret = number_next(&tok->matched, chr);
+
+			if (ret == 0 && number_complete(tok->matched)) {
+				*end = tok->pos;
+				return 0;
+			}
+
+			if (ret <= 0) {
+				return -EINVAL;
+			}
+			break;
+		}
+		case IN_LITERAL:
+			if (chr != literals[tok->literal].text[tok->matched]) {
+				return -EINVAL;
+			}
+
+			if (++tok->matched == literals[tok->literal].len) {
+				*end = ++tok->pos;
+				return 0;
+			}
+			break;
+		}
+	}
+
+	/* Only a number can end with the value */
+	if (tok->last && tok->in_token == IN_NUMBER &&
+	    number_complete(tok->matched)) {
+		*end = tok->pos;
+		return 0;
+	}
+
+	return tok->last ? -EINVAL : 0;
+}
+
+static int tok_gather(struct json_tokenizer *tok, const char *start,
+		      size_t len)
+{
+	if (len > tok->scratch_size - tok->scratch_len) {
+		return -ENOSPC;
+	}
+
+	memcpy(tok->scratch + tok->scratch_len, start, len);
+	tok->scratch_len += len;
+
+	return 0;
+}
+
+static int tok_finish(struct json_tokenizer *tok, struct json_token *token,
+		      const char *start)
+{
+	static const enum json_tokens types[] = {
+		[IN_KEY] = JSON_TOK_STRING,
+		[IN_STRING] = JSON_TOK_STRING,
+		[IN_NUMBER] = JSON_TOK_NUMBER,
+	};
+	enum json_in_token in_token = tok->in_token;
+	enum json_tokens type;
+	const char *end;
+	int ret;
+
+	ret = tok_scan(tok, &end);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (!end) {
+		ret = tok_gather(tok, start, tok->pos - start);
+		return ret < 0 ? ret : -EAGAIN;
+	}
+
+	type = in_token == IN_LITERAL ? literals[tok->literal].type :
+	       types[in_token];
+
+	tok->in_token = IN_NONE;
+	tok->matched = 0;
+
+	if (in_token == IN_KEY) {
+		tok->expect = EXPECT_COLON;
+	} else {
+		tok_value_done(tok);
+	}
+
+	if (tok->scratch_len) {
+		ret = tok_gather(tok, start, end - start);
+		if (ret < 0) {
+			return ret;
+		}
+
+		/* The scratch buffer is free again for the next token */
+		ret = tok->scratch_len;
+		tok->scratch_len = 0;
+
+		return tok_emit(tok, token, type, tok->scratch, ret);
+	}
+
+	return tok_emit(tok, token, type, start, end - start);
+}
+
+static int tok_open(struct json_tokenizer *tok, struct json_token *token,
+		    char chr)
+{
+	if (tok->depth == MAX_DEPTH) {
+		return -E2BIG;
+	}
+
+	WRITE_BIT(tok->objects, tok->depth, chr == '{');
+	tok->depth++;
+	tok->expect = chr == '{' ? EXPECT_KEY_OR_END : EXPECT_VALUE_OR_END;
+
+	return tok_emit(tok, token, (enum json_tokens)chr, tok->pos - 1, 1);
+}
+
+static int tok_close(struct json_tokenizer *tok, struct json_token *token,
+		     char chr)
+{
+	bool object = chr == '}';
+
+	if (tok->depth == 0 || tok_in_object(tok) != object) {
+		return -EINVAL;
+	}
+
+	if (tok->expect != EXPECT_COMMA_OR_END &&
+	    tok->expect != (object ? EXPECT_KEY_OR_END : EXPECT_VALUE_OR_END)) {
+		return -EINVAL;
+	}
+
+	tok->depth--;
+	tok_value_done(tok);
+
+	return tok_emit(tok, token, (enum json_tokens)chr, tok->pos - 1, 1);
+}
+
+int json_tokenizer_next(struct json_tokenizer *tok, struct json_token *token)
+{
+	bool value;
+
+	/* A token split across chunks goes on at the start of this one */
+	if (tok->in_token != IN_NONE) {
+		return tok_finish(tok, token, tok->pos);
+	}
+
+	while (tok->pos < tok->end) {
+		char chr = *tok->pos++;
+
+		value = tok->expect == EXPECT_VALUE ||
+			tok->expect == EXPECT_VALUE_OR_END;
+
+		switch (chr) {
+		case ' ':
+		case '\t':
+		case '\n':
+		case '\r':
+			continue;
+		case '{':
+		case '[':
+			if (!value) {
+				return -EINVAL;
+			}
+
+			return tok_open(tok, token, chr);
+		case '}':
+		case ']':
+			return tok_close(tok, token, chr);
+		case ':':
+			if (tok->expect != EXPECT_COLON) {
+				return -EINVAL;
+			}
+
+			tok->expect = EXPECT_VALUE;
+
+			return tok_emit(tok, token, JSON_TOK_COLON,
+					tok->pos - 1, 1);
+		case ',':
+			if (tok->expect != EXPECT_COMMA_OR_END) {
+				return -EINVAL;
+			}
+
+			tok->expect = tok_in_object(tok) ? EXPECT_KEY :
+				      EXPECT_VALUE;
+
+			return tok_emit(tok, token, JSON_TOK_COMMA,
+					tok->pos - 1, 1);
+		case '"':
+			if (tok->expect == EXPECT_KEY ||
+			    tok->expect == EXPECT_KEY_OR_END) {
+				tok->in_token = IN_KEY;
+			} else if (value) {
+				tok->in_token = IN_STRING;
+			} else {
+				return -EINVAL;
+			}
+
+			return tok_finish(tok, token, tok->pos);
+		case 't':
+		case 'f':
+		case 'n':
+			if (!value) {
+				return -EINVAL;
+			}
+
+			tok->in_token = IN_LITERAL;
+			tok->literal = chr == 't' ? 0 : chr == 'f' ? 1 : 2;
+			tok->matched = 1;
+
+			return tok_finish(tok, token, tok->pos - 1);
+		default:
+			if (!value || (chr != '-' && !isdigit((unsigned char)chr))) {
+				return -EINVAL;
+			}
+
+			tok->in_token = IN_NUMBER;
+			tok->matched = NUM_START;
+			number_next(&tok->matched, chr);
+
+			return tok_finish(tok, token, tok->pos - 1);
+		}
+	}
+
+	if (!tok->last) {
+		return -EAGAIN;
+	}
+
+	if (tok->expect != EXPECT_NOTHING) {
+		return -EINVAL;
+	}
+
+	return tok_emit(tok, token, JSON_TOK_EOF, tok->pos, 0);
+}
+
 static char escape_as(char chr)
 {
 	switch (chr) {
@@ -629,28 +1139,6 @@ static char escape_as(char chr)
 	return 0;
 }
 
-static int json_escape_internal(const char *str,
-				json_append_bytes_t append_bytes,
-				void *data)
-{
-	const char *cur;
-	int ret = 0;
-
-	for (cur = str; ret == 0 && *cur; cur++) {
-		char escaped = escape_as(*cur);
-
-		if (escaped) {
-			char bytes[2] = { '\\', escaped };
-
-			ret = append_bytes(bytes, 2, data);
-		} else {
-			ret = append_bytes(cur, 1, data);
-		}
-	}
-
-	return ret;
-}
-
 size_t json_calc_escaped_len(const char *str, size_t len)
 {
 	size_t escaped_len = len;
@@ -705,12 +1193,89 @@ ssize_t json_escape(char *str, size_t *len, size_t buf_size)
 	return 0;
 }
 
-static int encode(const struct json_obj_descr *descr, const void *val,
-		  json_append_bytes_t append_bytes, void *data);
+/* The encoded bytes are gathered in a buffer, which is either the
+ * output buffer itself, or a small one handed to append_bytes each
+ * time it fills up.  Without buffer nor append_bytes they are only
+ * counted.
+ */
+struct json_encoder {
+	json_append_bytes_t append_bytes;
+	void *data;
+	char *buffer;
+	size_t used;
+	size_t size;
+};
+
+static int enc_flush(struct json_encoder *enc)
+{
+	int ret = 0;
+
+	if (enc->append_bytes && enc->used) {
+		ret = enc->append_bytes(enc->buffer, enc->used, enc->data);
+		enc->used = 0;
+	}
+
+	return ret;
+}
 
-static int arr_encode(const struct json_obj_descr *elem_descr,
-		      const void *field, const void *val,
-		      json_append_bytes_t append_bytes, void *data)
+static int enc_write(struct json_encoder *enc, const char *bytes, size_t len)
+{
+	int ret;
+
+	/* One byte is kept for the terminating NUL of output buffers */
+	if (len < enc->size - enc->used) {
+		if (enc->buffer) {
+			memcpy(enc->buffer + enc->used, bytes, len);
+		}
+
+		enc->used += len;
+
+		return 0;
+	}
+
+	if (!enc->append_bytes) {
+		return -ENOMEM;
+	}
+
+	ret = enc_flush(enc);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (len < enc->size) {
+		memcpy(enc->buffer, bytes, len);
+		enc->used = len;
+
+		return 0;
+	}
+
+	return enc->append_bytes(bytes, len, enc->data);
+}
+
+static inline int enc_char(struct json_encoder *enc, char chr)
+{
+	if (enc->used + 1 < enc->size) {
+		if (enc->buffer) {
+			enc->buffer[enc->used] = chr;
+		}
+
+		enc->used++;
+
+		return 0;
+	}
+
+	return enc_write(enc, &chr, 1);
+}
+
+static int obj_encode(struct json_encoder *enc,
+		      const struct json_obj_descr *descr, size_t descr_len,
+		      const void *val);
+static int encode(struct json_encoder *enc,
+		  const struct json_obj_descr *descr, const void *val);
+
+static int arr_encode(struct json_encoder *enc,
+		      const struct json_obj_descr *elem_descr,
+		      const void *field, const void *val)
 {
 	ptrdiff_t elem_size = get_elem_size(elem_descr);
 	/*
@@ -723,7 +1288,7 @@ static int arr_encode(const struct json_obj_descr *elem_descr,
 	size_t i;
 	int ret;
 
-	ret = append_bytes("[", 1, data);
+	ret = enc_char(enc, '[');
 	if (ret < 0) {
 		return ret;
 	}
@@ -744,14 +1309,14 @@ static int arr_encode(const struct json_obj_descr *elem_descr,
 		 * offset to the length field in the parent struct,
 		 * but that would add a size_t to every descriptor.
 		 */
-		ret = encode(elem_descr, (char *)field - elem_descr->offset,
-			     append_bytes, data);
+		ret = encode(enc, elem_descr,
+			     (char *)field - elem_descr->offset);
 		if (ret < 0) {
 			return ret;
 		}
 
 		if (i < n_elem - 1) {
-			ret = append_bytes(",", 1, data);
+			ret = enc_char(enc, ',');
 			if (ret < 0) {
 				return ret;
 			}
@@ -760,187 +1325,247 @@ static int arr_encode(const struct json_obj_descr *elem_descr,
 		field = (char *)field + elem_size;
 	}
 
-	return append_bytes("]", 1, data);
+	return enc_char(enc, ']');
 }
 
-static int str_encode(const char **str, json_append_bytes_t append_bytes,
-		      void *data)
+static int str_encode(struct json_encoder *enc, const char *str)
 {
+	const char *run = str;
+	const char *cur;
 	int ret;
 
-	ret = append_bytes("\"", 1, data);
+	ret = enc_char(enc, '"');
 	if (ret < 0) {
 		return ret;
 	}
 
-	ret = json_escape_internal(*str, append_bytes, data);
-	if (!ret) {
-		return append_bytes("\"", 1, data);
+	/* The characters not to escape are written by runs */
+	for (cur = str; *cur; cur++) {
+		char escaped = escape_as(*cur);
+		char bytes[2] = { '\\', escaped };
+
+		if (!escaped) {
+			continue;
+		}
+
+		ret = enc_write(enc, run, cur - run);
+		if (ret < 0) {
+			return ret;
+		}
+
+		ret = enc_write(enc, bytes, sizeof(bytes));
+		if (ret < 0) {
+			return ret;
+		}
+
+		run = cur + 1;
+	}
+
+	ret = enc_write(enc, run, cur - run);
+	if (ret < 0) {
+		return ret;
 	}
 
-	return ret;
+	return enc_char(enc, '"');
 }
 
-static int num_encode(const int32_t *num, json_append_bytes_t append_bytes,
-		      void *data)
+static int opaque_encode(struct json_encoder *enc,
+			 const struct json_obj_token *raw)
 {
-	char buf[3 * sizeof(int32_t)];
 	int ret;
 
-	ret = snprintk(buf, sizeof(buf), "%d", *num);
+	ret = enc_char(enc, '"');
 	if (ret < 0) {
 		return ret;
 	}
-	if (ret >= (int)sizeof(buf)) {
-		return -ENOMEM;
+
+	ret = enc_write(enc, raw->start, raw->length);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return enc_char(enc, '"');
+}
+
+static int num_encode(struct json_encoder *enc, int64_t num)
+{
+	/* Digits of INT64_MIN and the sign */
+	char buf[20];
+	char *pos = buf + sizeof(buf);
+	uint64_t value = num < 0 ? 0U - (uint64_t)num : (uint64_t)num;
+
+	do {
+		*--pos = '0' + value % 10U;
+		value /= 10U;
+	} while (value);
+
+	if (num < 0) {
+		*--pos = '-';
 	}
 
-	return append_bytes(buf, (size_t)ret, data);
+	return enc_write(enc, pos, buf + sizeof(buf) - pos);
 }
 
-static int bool_encode(const bool *value, json_append_bytes_t append_bytes,
-		       void *data)
+static int bool_encode(struct json_encoder *enc, const bool *value)
 {
 	if (*value) {
-		return append_bytes("true", 4, data);
+		return enc_write(enc, "true", 4);
 	}
 
-	return append_bytes("false", 5, data);
+	return enc_write(enc, "false", 5);
 }
 
-static int encode(const struct json_obj_descr *descr, const void *val,
-		  json_append_bytes_t append_bytes, void *data)
+static int encode(struct json_encoder *enc,
+		  const struct json_obj_descr *descr, const void *val)
 {
 	void *ptr = (char *)val + descr->offset;
 
 	switch (descr->type) {
 	case JSON_TOK_FALSE:
 	case JSON_TOK_TRUE:
-		return bool_encode(ptr, append_bytes, data);
+		return bool_encode(enc, ptr);
 	case JSON_TOK_STRING:
-		return str_encode(ptr, append_bytes, data);
+		return str_encode(enc, *(const char **)ptr);
+	case JSON_TOK_OPAQUE:
+		return opaque_encode(enc, ptr);
 	case JSON_TOK_LIST_START:
-		return arr_encode(descr->array.element_descr, ptr,
-				  val, append_bytes, data);
+		return arr_encode(enc, descr->array.element_descr, ptr, val);
 	case JSON_TOK_OBJECT_START:
-		return json_obj_encode(descr->object.sub_descr,
-				       descr->object.sub_descr_len,
-				       ptr, append_bytes, data);
+		return obj_encode(enc, descr->object.sub_descr,
+				  descr->object.sub_descr_len, ptr);
 	case JSON_TOK_NUMBER:
-		return num_encode(ptr, append_bytes, data);
+		return num_encode(enc, *(int32_t *)ptr);
+	case JSON_TOK_INT64:
+		return num_encode(enc, *(int64_t *)ptr);
+	case JSON_TOK_FLOAT: {
+		struct json_obj_token *raw = ptr;
+
+		if (!number_valid(raw->start, raw->length)) {
+			return -EINVAL;
+		}
+
+		return enc_write(enc, raw->start, raw->length);
+	}
 	default:
 		return -EINVAL;
 	}
 }
 
-int json_obj_encode(const struct json_obj_descr *descr, size_t descr_len,
-		    const void *val, json_append_bytes_t append_bytes,
-		    void *data)
+static int obj_encode(struct json_encoder *enc,
+		      const struct json_obj_descr *descr, size_t descr_len,
+		      const void *val)
 {
 	size_t i;
 	int ret;
 
-	ret = append_bytes("{", 1, data);
+	ret = enc_char(enc, '{');
 	if (ret < 0) {
 		return ret;
 	}
 
 	for (i = 0; i < descr_len; i++) {
-		ret = str_encode((const char **)&descr[i].field_name,
-				 append_bytes, data);
+		ret = str_encode(enc, descr[i].field_name);
 		if (ret < 0) {
 			return ret;
 		}
 
-		ret = append_bytes(":", 1, data);
+		ret = enc_char(enc, ':');
 		if (ret < 0) {
 			return ret;
 		}
 
-		ret = encode(&descr[i], val, append_bytes, data);
+		ret = encode(enc, &descr[i], val);
 		if (ret < 0) {
 			return ret;
 		}
 
 		if (i < descr_len - 1) {
-			ret = append_bytes(",", 1, data);
+			ret = enc_char(enc, ',');
 			if (ret < 0) {
 				return ret;
 			}
 		}
 	}
 
-	return append_bytes("}", 1, data);
-}
-
-int json_arr_encode(const struct json_obj_descr *descr, const void *val,
-		    json_append_bytes_t append_bytes, void *data)
-{
-	void *ptr = (char *)val + descr->offset;
-
-	return arr_encode(descr->array.element_descr, ptr, val, append_bytes,
-			  data);
+	return enc_char(enc, '}');
 }
 
-struct appender {
-	char *buffer;
-	size_t used;
-	size_t size;
-};
-
-static int append_bytes_to_buf(const char *bytes, size_t len, void *data)
+static int encode_done(struct json_encoder *enc, int ret)
 {
-	struct appender *appender = data;
+	if (ret < 0) {
+		return ret;
+	}
 
-	if (len >= appender->size - appender->used) {
-		return -ENOMEM;
+	if (enc->append_bytes) {
+		return enc_flush(enc);
 	}
 
-	memcpy(appender->buffer + appender->used, bytes, len);
-	appender->used += len;
-	appender->buffer[appender->used] = '\0';
+	if (enc->buffer) {
+		enc->buffer[enc->used] = '\0';
+	}
 
 	return 0;
 }
 
-int json_obj_encode_buf(const struct json_obj_descr *descr, size_t descr_len,
-			const void *val, char *buffer, size_t buf_size)
+int json_obj_encode(const struct json_obj_descr *descr, size_t descr_len,
+		    const void *val, json_append_bytes_t append_bytes,
+		    void *data)
 {
-	struct appender appender = { .buffer = buffer, .size = buf_size };
-
-	return json_obj_encode(descr, descr_len, val, append_bytes_to_buf,
-			       &appender);
+	char buffer[CONFIG_JSON_ENCODE_BUF_SIZE];
+	struct json_encoder enc = {
+		.append_bytes = append_bytes,
+		.data = data,
+		.buffer = buffer,
+		.size = sizeof(buffer),
+	};
+
+	return encode_done(&enc, obj_encode(&enc, descr, descr_len, val));
 }
 
-int json_arr_encode_buf(const struct json_obj_descr *descr, const void *val,
-			char *buffer, size_t buf_size)
+int json_arr_encode(const struct json_obj_descr *descr, const void *val,
+		    json_append_bytes_t append_bytes, void *data)
 {
-	struct appender appender = { .buffer = buffer, .size = buf_size };
+	char buffer[CONFIG_JSON_ENCODE_BUF_SIZE];
+	struct json_encoder enc = {
+		.append_bytes = append_bytes,
+		.data = data,
+		.buffer = buffer,
+		.size = sizeof(buffer),
+	};
+	void *ptr = (char *)val + descr->offset;
 
-	return json_arr_encode(descr, val, append_bytes_to_buf, &appender);
+	return encode_done(&enc, arr_encode(&enc, descr->array.element_descr,
+					    ptr, val));
 }
 
-static int measure_bytes(const char *bytes, size_t len, void *data)
+int json_obj_encode_buf(const struct json_obj_descr *descr, size_t descr_len,
+			const void *val, char *buffer, size_t buf_size)
 {
-	ssize_t *total = data;
+	struct json_encoder enc = { .buffer = buffer, .size = buf_size };
 
-	*total += (ssize_t)len;
+	return encode_done(&enc, obj_encode(&enc, descr, descr_len, val));
+}
 
-	ARG_UNUSED(bytes);
+int json_arr_encode_buf(const struct json_obj_descr *descr, const void *val,
+			char *buffer, size_t buf_size)
+{
+	struct json_encoder enc = { .buffer = buffer, .size = buf_size };
+	void *ptr = (char *)val + descr->offset;
 
-	return 0;
+	return encode_done(&enc, arr_encode(&enc, descr->array.element_descr,
+					    ptr, val));
 }
 
 ssize_t json_calc_encoded_len(const struct json_obj_descr *descr,
 			      size_t descr_len, const void *val)
 {
-	ssize_t total = 0;
+	struct json_encoder enc = { .size = SIZE_MAX };
 	int ret;
 
-	ret = json_obj_encode(descr, descr_len, val, measure_bytes, &total);
+	ret = obj_encode(&enc, descr, descr_len, val);
 	if (ret < 0) {
 		return ret;
 	}
 
-	return total;
+	return enc.used;
 }
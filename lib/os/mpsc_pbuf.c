@@ -61,19 +61,25 @@ static inline bool free_space(struct mpsc_pbuf_buffer *buffer, uint32_t *res)
 	return true;
 }
 
-static inline bool available(struct mpsc_pbuf_buffer *buffer, uint32_t *res)
+static inline bool available_from(struct mpsc_pbuf_buffer *buffer,
+				  uint32_t rd_idx, uint32_t *res)
 {
-	if (buffer->tmp_rd_idx <= buffer->wr_idx) {
-		*res = (buffer->wr_idx - buffer->tmp_rd_idx);
+	if (rd_idx <= buffer->wr_idx) {
+		*res = (buffer->wr_idx - rd_idx);
 
 		return false;
 	}
 
-	*res = buffer->size - buffer->tmp_rd_idx;
+	*res = buffer->size - rd_idx;
 
 	return true;
 }
 
+static inline bool available(struct mpsc_pbuf_buffer *buffer, uint32_t *res)
+{
+	return available_from(buffer, buffer->tmp_rd_idx, res);
+}
+
 static inline bool is_valid(union mpsc_pbuf_generic *item)
 {
 	return item->hdr.valid;
@@ -128,6 +134,133 @@ static void add_skip_item(struct mpsc_pbuf_buffer *buffer, uint32_t wlen)
 	buffer->wr_idx = idx_inc(buffer, buffer->wr_idx, wlen);
 }
 
+#if CONFIG_MPSC_PBUF_READERS > 0
+/* Reclaims the oldest packet if no reader is left to read it. Readers standing
+ * at a skip packet are moved past it.
+ */
+static bool readers_reclaim_locked(struct mpsc_pbuf_buffer *buffer)
+{
+	union mpsc_pbuf_generic *item =
+		(union mpsc_pbuf_generic *)&buffer->buf[buffer->rd_idx];
+	uint32_t skip_wlen = get_skip(item);
+	uint32_t wlen;
+
+	if (!(buffer->flags & MPSC_PBUF_MODE_READERS)) {
+		return false;
+	}
+
+	if ((buffer->rd_idx == buffer->tmp_wr_idx) ||
+	    (!skip_wlen && !is_valid(item))) {
+		/* Empty or oldest packet not committed yet. */
+		return false;
+	}
+
+	wlen = skip_wlen ? skip_wlen : buffer->get_wlen(item);
+
+	for (int i = 0; i < CONFIG_MPSC_PBUF_READERS; i++) {
+		struct mpsc_pbuf_reader *reader = buffer->readers[i];
+
+		if (reader && reader->rd_idx == buffer->rd_idx) {
+			if (!skip_wlen) {
+				return false;
+			}
+
+			reader->rd_idx = idx_inc(buffer, reader->rd_idx, wlen);
+		}
+	}
+
+	buffer->rd_idx = idx_inc(buffer, buffer->rd_idx, wlen);
+
+	return true;
+}
+
+/* Drops the oldest packet for the readers which have not read it, if they all
+ * allow it and none of them has it claimed.
+ */
+static bool readers_drop_locked(struct mpsc_pbuf_buffer *buffer)
+{
+	union mpsc_pbuf_generic *item =
+		(union mpsc_pbuf_generic *)&buffer->buf[buffer->rd_idx];
+	uint32_t wlen;
+
+	if ((buffer->rd_idx == buffer->tmp_wr_idx) || !is_valid(item)) {
+		return false;
+	}
+
+	for (int i = 0; i < CONFIG_MPSC_PBUF_READERS; i++) {
+		struct mpsc_pbuf_reader *reader = buffer->readers[i];
+
+		if (reader && reader->rd_idx == buffer->rd_idx &&
+		    (reader->claimed ||
+		     !(reader->flags & MPSC_PBUF_READER_MODE_OVERWRITE))) {
+			return false;
+		}
+	}
+
+	wlen = buffer->get_wlen(item);
+
+	for (int i = 0; i < CONFIG_MPSC_PBUF_READERS; i++) {
+		struct mpsc_pbuf_reader *reader = buffer->readers[i];
+
+		if (reader && reader->rd_idx == buffer->rd_idx) {
+			reader->rd_idx = idx_inc(buffer, reader->rd_idx, wlen);
+			reader->dropped++;
+		}
+	}
+
+	buffer->rd_idx = idx_inc(buffer, buffer->rd_idx, wlen);
+
+	return true;
+}
+
+static union mpsc_pbuf_generic *readers_drop_item_locked(
+					struct mpsc_pbuf_buffer *buffer,
+					bool *user_packet)
+{
+	union mpsc_pbuf_generic *item =
+		(union mpsc_pbuf_generic *)&buffer->buf[buffer->rd_idx];
+
+	*user_packet = false;
+	if (readers_reclaim_locked(buffer)) {
+		return item;
+	}
+
+	if (readers_drop_locked(buffer)) {
+		*user_packet = true;
+		return item;
+	}
+
+	return NULL;
+}
+
+/* Semaphores are given without holding the lock, a reader removed meanwhile
+ * may get one extra wake up.
+ */
+static void readers_notify(struct mpsc_pbuf_buffer *buffer)
+{
+	if (!(buffer->flags & MPSC_PBUF_MODE_READERS)) {
+		return;
+	}
+
+	for (int i = 0; i < CONFIG_MPSC_PBUF_READERS; i++) {
+		struct mpsc_pbuf_reader *reader = buffer->readers[i];
+
+		if (reader) {
+			k_sem_give(&reader->sem);
+		}
+	}
+}
+#else
+static inline bool readers_reclaim_locked(struct mpsc_pbuf_buffer *buffer)
+{
+	return false;
+}
+
+static inline void readers_notify(struct mpsc_pbuf_buffer *buffer)
+{
+}
+#endif /* CONFIG_MPSC_PBUF_READERS > 0 */
+
 /* Attempts to drop a packet. If user packets dropping is allowed then any
  * type of packet is dropped. Otherwise only skip packets (internal padding).
  *
@@ -144,6 +277,12 @@ static union mpsc_pbuf_generic *drop_item_locked(struct mpsc_pbuf_buffer *buffer
 	uint32_t rd_wlen;
 	uint32_t skip_wlen;
 
+#if CONFIG_MPSC_PBUF_READERS > 0
+	if (buffer->flags & MPSC_PBUF_MODE_READERS) {
+		return readers_drop_item_locked(buffer, user_packet);
+	}
+#endif
+
 	*user_packet = false;
 	item = (union mpsc_pbuf_generic *)&buffer->buf[buffer->rd_idx];
 	skip_wlen = get_skip(item);
@@ -192,12 +331,14 @@ void mpsc_pbuf_put_word(struct mpsc_pbuf_buffer *buffer,
 	k_spinlock_key_t key;
 	union mpsc_pbuf_generic *dropped_item = NULL;
 	bool valid_drop;
+	bool stored = false;
 
 	do {
 		cont = false;
 		key = k_spin_lock(&buffer->lock);
 		(void)free_space(buffer, &free_wlen);
 		if (free_wlen) {
+			stored = true;
 			buffer->buf[buffer->tmp_wr_idx] = item.raw;
 			buffer->tmp_wr_idx = idx_inc(buffer,
 						     buffer->tmp_wr_idx, 1);
@@ -218,6 +359,9 @@ void mpsc_pbuf_put_word(struct mpsc_pbuf_buffer *buffer,
 		}
 	} while (cont);
 
+	if (stored) {
+		readers_notify(buffer);
+	}
 }
 
 union mpsc_pbuf_generic *mpsc_pbuf_alloc(struct mpsc_pbuf_buffer *buffer,
@@ -254,6 +398,8 @@ union mpsc_pbuf_generic *mpsc_pbuf_alloc(struct mpsc_pbuf_buffer *buffer,
 		} else if (wrap) {
 			add_skip_item(buffer, free_wlen);
 			cont = true;
+		} else if (readers_reclaim_locked(buffer)) {
+			cont = true;
 		} else if (!K_TIMEOUT_EQ(timeout, K_NO_WAIT) &&
 			   !k_is_in_isr()) {
 			int err;
@@ -302,6 +448,7 @@ void mpsc_pbuf_commit(struct mpsc_pbuf_buffer *buffer,
 	buffer->wr_idx = idx_inc(buffer, buffer->wr_idx, wlen);
 	k_spin_unlock(&buffer->lock, key);
 	MPSC_PBUF_DBG(buffer, "committed %p ", item);
+	readers_notify(buffer);
 }
 
 void mpsc_pbuf_put_word_ext(struct mpsc_pbuf_buffer *buffer,
@@ -312,6 +459,7 @@ void mpsc_pbuf_put_word_ext(struct mpsc_pbuf_buffer *buffer,
 	union mpsc_pbuf_generic *dropped_item = NULL;
 	bool cont;
 	bool valid_drop;
+	bool stored = false;
 
 	do {
 		k_spinlock_key_t key;
@@ -323,6 +471,7 @@ void mpsc_pbuf_put_word_ext(struct mpsc_pbuf_buffer *buffer,
 		wrap = free_space(buffer, &free_wlen);
 
 		if (free_wlen >= l) {
+			stored = true;
 			buffer->buf[buffer->tmp_wr_idx] = item.raw;
 			void **p =
 				(void **)&buffer->buf[buffer->tmp_wr_idx + 1];
@@ -350,6 +499,10 @@ void mpsc_pbuf_put_word_ext(struct mpsc_pbuf_buffer *buffer,
 			dropped_item = NULL;
 		}
 	} while (cont);
+
+	if (stored) {
+		readers_notify(buffer);
+	}
 }
 
 void mpsc_pbuf_put_data(struct mpsc_pbuf_buffer *buffer, uint32_t *data,
@@ -358,6 +511,7 @@ void mpsc_pbuf_put_data(struct mpsc_pbuf_buffer *buffer, uint32_t *data,
 	bool cont;
 	union mpsc_pbuf_generic *dropped_item = NULL;
 	bool valid_drop;
+	bool stored = false;
 
 	do {
 		uint32_t free_wlen;
@@ -369,6 +523,7 @@ void mpsc_pbuf_put_data(struct mpsc_pbuf_buffer *buffer, uint32_t *data,
 		wrap = free_space(buffer, &free_wlen);
 
 		if (free_wlen >= wlen) {
+			stored = true;
 			memcpy(&buffer->buf[buffer->tmp_wr_idx], data,
 				wlen * sizeof(uint32_t));
 			buffer->tmp_wr_idx =
@@ -393,6 +548,10 @@ void mpsc_pbuf_put_data(struct mpsc_pbuf_buffer *buffer, uint32_t *data,
 			dropped_item = NULL;
 		}
 	} while (cont);
+
+	if (stored) {
+		readers_notify(buffer);
+	}
 }
 
 union mpsc_pbuf_generic *mpsc_pbuf_claim(struct mpsc_pbuf_buffer *buffer)
@@ -400,6 +559,8 @@ union mpsc_pbuf_generic *mpsc_pbuf_claim(struct mpsc_pbuf_buffer *buffer)
 	union mpsc_pbuf_generic *item;
 	bool cont;
 
+	__ASSERT_NO_MSG(!(buffer->flags & MPSC_PBUF_MODE_READERS));
+
 	do {
 		uint32_t a;
 		k_spinlock_key_t key;
@@ -448,6 +609,7 @@ void mpsc_pbuf_free(struct mpsc_pbuf_buffer *buffer,
 	uint32_t wlen = buffer->get_wlen(item);
 	k_spinlock_key_t key = k_spin_lock(&buffer->lock);
 
+	__ASSERT_NO_MSG(!(buffer->flags & MPSC_PBUF_MODE_READERS));
 	item->hdr.valid = 0;
 	if (!(buffer->flags & MPSC_PBUF_MODE_OVERWRITE) ||
 		 ((uint32_t *)item == &buffer->buf[buffer->rd_idx])) {
@@ -470,3 +632,137 @@ bool mpsc_pbuf_is_pending(struct mpsc_pbuf_buffer *buffer)
 
 	return a ? true : false;
 }
+
+#if CONFIG_MPSC_PBUF_READERS > 0
+int mpsc_pbuf_reader_add(struct mpsc_pbuf_buffer *buffer,
+			 struct mpsc_pbuf_reader *reader, uint32_t flags)
+{
+	k_spinlock_key_t key;
+	int err = -ENOMEM;
+
+	__ASSERT_NO_MSG(buffer->flags & MPSC_PBUF_MODE_READERS);
+
+	reader->flags = flags;
+	reader->dropped = 0;
+	reader->claimed = false;
+	(void)k_sem_init(&reader->sem, 0, 1);
+
+	key = k_spin_lock(&buffer->lock);
+	for (int i = 0; i < CONFIG_MPSC_PBUF_READERS; i++) {
+		if (buffer->readers[i] == NULL) {
+			reader->rd_idx = buffer->rd_idx;
+			buffer->readers[i] = reader;
+			err = 0;
+			break;
+		}
+	}
+	k_spin_unlock(&buffer->lock, key);
+
+	return err;
+}
+
+void mpsc_pbuf_reader_remove(struct mpsc_pbuf_buffer *buffer,
+			     struct mpsc_pbuf_reader *reader)
+{
+	k_spinlock_key_t key = k_spin_lock(&buffer->lock);
+
+	__ASSERT_NO_MSG(!reader->claimed);
+
+	for (int i = 0; i < CONFIG_MPSC_PBUF_READERS; i++) {
+		if (buffer->readers[i] == reader) {
+			buffer->readers[i] = NULL;
+			break;
+		}
+	}
+	k_spin_unlock(&buffer->lock, key);
+
+	/* Producers may be waiting for the space the reader held. */
+	k_sem_give(&buffer->sem);
+}
+
+union mpsc_pbuf_generic *mpsc_pbuf_reader_claim(struct mpsc_pbuf_buffer *buffer,
+						struct mpsc_pbuf_reader *reader,
+						k_timeout_t timeout)
+{
+	union mpsc_pbuf_generic *item;
+	bool cont;
+
+	__ASSERT_NO_MSG(!reader->claimed);
+
+	do {
+		uint32_t a;
+		k_spinlock_key_t key;
+
+		cont = false;
+		key = k_spin_lock(&buffer->lock);
+		(void)available_from(buffer, reader->rd_idx, &a);
+		item = (union mpsc_pbuf_generic *)
+			&buffer->buf[reader->rd_idx];
+
+		if (!a || is_invalid(item)) {
+			item = NULL;
+		} else if (get_skip(item)) {
+			reader->rd_idx = idx_inc(buffer, reader->rd_idx,
+						 get_skip(item));
+			cont = true;
+		} else {
+			reader->claimed = true;
+		}
+		k_spin_unlock(&buffer->lock, key);
+
+		if (!item && !cont && !K_TIMEOUT_EQ(timeout, K_NO_WAIT) &&
+		    !k_is_in_isr()) {
+			cont = k_sem_take(&reader->sem, timeout) == 0;
+		}
+	} while (cont);
+
+	MPSC_PBUF_DBG(buffer, "reader %p claimed: %p ", reader, item);
+
+	return item;
+}
+
+void mpsc_pbuf_reader_free(struct mpsc_pbuf_buffer *buffer,
+			   struct mpsc_pbuf_reader *reader,
+			   union mpsc_pbuf_generic *item)
+{
+	uint32_t wlen = buffer->get_wlen(item);
+	k_spinlock_key_t key = k_spin_lock(&buffer->lock);
+
+	__ASSERT_NO_MSG(reader->claimed &&
+			(uint32_t *)item == &buffer->buf[reader->rd_idx]);
+	reader->rd_idx = idx_inc(buffer, reader->rd_idx, wlen);
+	reader->claimed = false;
+	MPSC_PBUF_DBG(buffer, "reader %p freed: %p ", reader, item);
+
+	k_spin_unlock(&buffer->lock, key);
+	k_sem_give(&buffer->sem);
+}
+
+bool mpsc_pbuf_reader_is_pending(struct mpsc_pbuf_buffer *buffer,
+				 struct mpsc_pbuf_reader *reader)
+{
+	k_spinlock_key_t key;
+	uint32_t a;
+
+	/* Producers move the read index of the reader when they drop packets
+	 * for it, it must be read together with the write index.
+	 */
+	key = k_spin_lock(&buffer->lock);
+	(void)available_from(buffer, reader->rd_idx, &a);
+	k_spin_unlock(&buffer->lock, key);
+
+	return a ? true : false;
+}
+
+uint32_t mpsc_pbuf_reader_dropped(struct mpsc_pbuf_buffer *buffer,
+				  struct mpsc_pbuf_reader *reader)
+{
+	k_spinlock_key_t key = k_spin_lock(&buffer->lock);
+	uint32_t dropped = reader->dropped;
+
+	reader->dropped = 0;
+	k_spin_unlock(&buffer->lock, key);
+
+	return dropped;
+}
+#endif /* CONFIG_MPSC_PBUF_READERS > 0 */
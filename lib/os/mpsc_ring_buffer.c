@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <sys/mpsc_ring_buffer.h>
+#include <string.h>
+
+/* A producer reserves space with a compare and swap on the claim index and
+ * publishes its data by setting the tail index once the producers which
+ * reserved before it have published theirs. Interrupts are locked on the
+ * local CPU from the reservation to the publication: a producer only ever
+ * waits for producers running on other CPUs, which are copying their data.
+ */
+
+/* Same layout as the items of ring_buffer.c */
+struct ring_element {
+	uint32_t  type   :16; /**< Application-specific */
+	uint32_t  length :8;  /**< length in 32-bit chunks */
+	uint32_t  value  :8;  /**< Room for small integral values */
+};
+
+static bool reserve(struct mpsc_ring_buf *buf, uint32_t size, uint32_t *start)
+{
+	atomic_val_t claim;
+	uint32_t used;
+
+	do {
+		claim = atomic_get(&buf->claim);
+		used = (uint32_t)claim - (uint32_t)atomic_get(&buf->head);
+
+		/* A head newer than claim makes used wrap, the compare and
+		 * swap then fails as claim has moved too.
+		 */
+		if (used <= buf->size && size > buf->size - used) {
+			return false;
+		}
+	} while (!atomic_cas(&buf->claim, claim,
+			     (atomic_val_t)((uint32_t)claim + size)));
+
+	*start = (uint32_t)claim;
+
+	return true;
+}
+
+static void publish(struct mpsc_ring_buf *buf, uint32_t start, uint32_t size)
+{
+	while ((uint32_t)atomic_get(&buf->tail) != start) {
+		/* Producers which reserved before are still copying */
+	}
+
+	(void)atomic_set(&buf->tail, (atomic_val_t)(start + size));
+}
+
+static void copy_in(uint8_t *ring, uint32_t ring_len, uint32_t offset,
+		    const void *data, uint32_t len)
+{
+	uint32_t first = MIN(len, ring_len - offset);
+
+	memcpy(&ring[offset], data, first);
+	memcpy(ring, (const uint8_t *)data + first, len - first);
+}
+
+static void copy_out(const uint8_t *ring, uint32_t ring_len, uint32_t offset,
+		     void *data, uint32_t len)
+{
+	uint32_t first = MIN(len, ring_len - offset);
+
+	memcpy(data, &ring[offset], first);
+	memcpy((uint8_t *)data + first, ring, len - first);
+}
+
+int mpsc_ring_buf_item_put(struct mpsc_ring_buf *buf, uint16_t type,
+			   uint8_t value, const uint32_t *data,
+			   uint8_t size32)
+{
+	struct ring_element header = {
+		.type = type,
+		.length = size32,
+		.value = value,
+	};
+	uint32_t start;
+	unsigned int key;
+
+	key = arch_irq_lock();
+
+	if (!reserve(buf, size32 + 1, &start)) {
+		arch_irq_unlock(key);
+		(void)atomic_inc(&buf->dropped_put_count);
+
+		return -EMSGSIZE;
+	}
+
+	memcpy(&buf->buf.buf32[start & buf->mask], &header, sizeof(header));
+	copy_in(buf->buf.buf8, buf->size * sizeof(uint32_t),
+		((start + 1) & buf->mask) * sizeof(uint32_t), data,
+		size32 * sizeof(uint32_t));
+	publish(buf, start, size32 + 1);
+
+	arch_irq_unlock(key);
+
+	return 0;
+}
+
+int mpsc_ring_buf_item_get(struct mpsc_ring_buf *buf, uint16_t *type,
+			   uint8_t *value, uint32_t *data, uint8_t *size32)
+{
+	uint32_t head = (uint32_t)atomic_get(&buf->head);
+	struct ring_element header;
+
+	if (head == (uint32_t)atomic_get(&buf->tail)) {
+		return -EAGAIN;
+	}
+
+	memcpy(&header, &buf->buf.buf32[head & buf->mask], sizeof(header));
+
+	if (data && (header.length > *size32)) {
+		*size32 = header.length;
+		return -EMSGSIZE;
+	}
+
+	*size32 = header.length;
+	*type = header.type;
+	*value = header.value;
+
+	if (data) {
+		copy_out(buf->buf.buf8, buf->size * sizeof(uint32_t),
+			 ((head + 1) & buf->mask) * sizeof(uint32_t), data,
+			 header.length * sizeof(uint32_t));
+	}
+
+	(void)atomic_set(&buf->head, (atomic_val_t)(head + header.length + 1));
+
+	return 0;
+}
+
+uint32_t mpsc_ring_buf_put(struct mpsc_ring_buf *buf, const uint8_t *data,
+			   uint32_t size)
+{
+	uint32_t start;
+	unsigned int key;
+
+	if (size == 0) {
+		return 0;
+	}
+
+	key = arch_irq_lock();
+
+	if (!reserve(buf, size, &start)) {
+		arch_irq_unlock(key);
+		(void)atomic_inc(&buf->dropped_put_count);
+
+		return 0;
+	}
+
+	copy_in(buf->buf.buf8, buf->size, start & buf->mask, data, size);
+	publish(buf, start, size);
+
+	arch_irq_unlock(key);
+
+	return size;
+}
+
+uint32_t mpsc_ring_buf_get_claim(struct mpsc_ring_buf *buf, uint8_t **data,
+				 uint32_t size)
+{
+	uint32_t head = (uint32_t)atomic_get(&buf->head);
+	uint32_t offset = head & buf->mask;
+	uint32_t available = (uint32_t)atomic_get(&buf->tail) - head;
+
+	size = MIN(size, MIN(available, buf->size - offset));
+	*data = &buf->buf.buf8[offset];
+
+	return size;
+}
+
+int mpsc_ring_buf_get_finish(struct mpsc_ring_buf *buf, uint32_t size)
+{
+	uint32_t head = (uint32_t)atomic_get(&buf->head);
+
+	if (size > (uint32_t)atomic_get(&buf->tail) - head) {
+		return -EINVAL;
+	}
+
+	(void)atomic_set(&buf->head, (atomic_val_t)(head + size));
+
+	return 0;
+}
+
+uint32_t mpsc_ring_buf_get(struct mpsc_ring_buf *buf, uint8_t *data,
+			   uint32_t size)
+{
+	uint32_t head = (uint32_t)atomic_get(&buf->head);
+	uint32_t available = (uint32_t)atomic_get(&buf->tail) - head;
+
+	size = MIN(size, available);
+	if (data) {
+		copy_out(buf->buf.buf8, buf->size, head & buf->mask, data,
+			 size);
+	}
+
+	(void)atomic_set(&buf->head, (atomic_val_t)(head + size));
+
+	return size;
+}
@@ -8,6 +8,11 @@
 #include <sys/mutex.h>
 #include <syscall_handler.h>
 #include <kernel_structs.h>
+#include <kernel_internal.h>
+
+#ifdef CONFIG_SYS_MUTEX_FAST_PATH
+__thread k_tid_t z_sys_mutex_self_tid;
+#endif
 
 static struct k_mutex *get_k_mutex(struct sys_mutex *mutex)
 {
@@ -38,7 +43,11 @@ int z_impl_z_sys_mutex_kernel_lock(struct sys_mutex *mutex, k_timeout_t timeout)
 		return -EINVAL;
 	}
 
+#ifdef CONFIG_SYS_MUTEX_FAST_PATH
+	return z_sys_mutex_contended_lock(kernel_mutex, mutex, timeout);
+#else
 	return k_mutex_lock(kernel_mutex, timeout);
+#endif
 }
 
 static inline int z_vrfy_z_sys_mutex_kernel_lock(struct sys_mutex *mutex,
@@ -56,11 +65,19 @@ int z_impl_z_sys_mutex_kernel_unlock(struct sys_mutex *mutex)
 {
 	struct k_mutex *kernel_mutex = get_k_mutex(mutex);
 
+#ifdef CONFIG_SYS_MUTEX_FAST_PATH
+	if (kernel_mutex == NULL) {
+		return -EINVAL;
+	}
+
+	return z_sys_mutex_contended_unlock(kernel_mutex, mutex);
+#else
 	if (kernel_mutex == NULL || kernel_mutex->lock_count == 0) {
 		return -EINVAL;
 	}
 
 	return k_mutex_unlock(kernel_mutex);
+#endif
 }
 
 static inline int z_vrfy_z_sys_mutex_kernel_unlock(struct sys_mutex *mutex)
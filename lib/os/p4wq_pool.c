@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <sys/p4wq_pool.h>
+#include <kernel.h>
+#include <ksched.h>
+#include <string.h>
+
+/* Each worker owns a ring of task pointers used as a deque: the
+ * owner pushes and pops at the tail (newest first, which keeps the
+ * working set of recursively split jobs hot in its cache) and thieves
+ * take from the head (oldest first, which for split jobs are the
+ * largest pieces).  The ends are serialized by a per-worker spinlock,
+ * so the only contention is between a worker and whoever is stealing
+ * from it at that moment.
+ */
+
+#define DEQUE_SIZE CONFIG_P4WQ_POOL_DEQUE_SIZE
+#define DEQUE_MASK (DEQUE_SIZE - 1)
+
+BUILD_ASSERT((DEQUE_SIZE & DEQUE_MASK) == 0,
+	     "CONFIG_P4WQ_POOL_DEQUE_SIZE must be a power of two");
+
+static bool deque_push(struct k_p4wq_pool_worker *w, struct k_p4wq_task *task)
+{
+	k_spinlock_key_t k = k_spin_lock(&w->lock);
+	bool ret = (w->tail - w->head) < DEQUE_SIZE;
+
+	if (ret) {
+		w->deque[w->tail & DEQUE_MASK] = task;
+		w->tail++;
+	}
+
+	k_spin_unlock(&w->lock, k);
+	return ret;
+}
+
+static struct k_p4wq_task *deque_pop(struct k_p4wq_pool_worker *w)
+{
+	struct k_p4wq_task *task = NULL;
+	k_spinlock_key_t k = k_spin_lock(&w->lock);
+
+	if (w->tail != w->head) {
+		w->tail--;
+		task = w->deque[w->tail & DEQUE_MASK];
+	}
+
+	k_spin_unlock(&w->lock, k);
+	return task;
+}
+
+static struct k_p4wq_task *deque_steal(struct k_p4wq_pool_worker *w)
+{
+	struct k_p4wq_task *task = NULL;
+	k_spinlock_key_t k = k_spin_lock(&w->lock);
+
+	if (w->tail != w->head) {
+		task = w->deque[w->head & DEQUE_MASK];
+		w->head++;
+	}
+
+	k_spin_unlock(&w->lock, k);
+	return task;
+}
+
+static struct k_p4wq_pool_worker *worker_self(struct k_p4wq_pool *pool)
+{
+	for (uint32_t i = 0; i < pool->n_workers; i++) {
+		if (pool->workers[i].work.thread == _current) {
+			return &pool->workers[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Own deque first, then the others starting with our right hand
+ * neighbour so that thieves spread out over the victims.
+ */
+static struct k_p4wq_task *task_next(struct k_p4wq_pool *pool,
+				     struct k_p4wq_pool_worker *self)
+{
+	struct k_p4wq_task *task = NULL;
+	uint32_t first = 0;
+
+	if (atomic_get(&pool->queued) == 0) {
+		return NULL;
+	}
+
+	if (self != NULL) {
+		task = deque_pop(self);
+		first = (self - pool->workers) + 1;
+	}
+
+	for (uint32_t i = 0; task == NULL && i < pool->n_workers; i++) {
+		struct k_p4wq_pool_worker *w =
+			&pool->workers[(first + i) % pool->n_workers];
+
+		if (w != self) {
+			task = deque_steal(w);
+		}
+	}
+
+	if (task != NULL) {
+		atomic_dec(&pool->queued);
+	}
+
+	return task;
+}
+
+static void task_run(struct k_p4wq_task *task)
+{
+	struct k_p4wq_task_group *group = task->group;
+
+	task->handler(task);
+
+	/* The waiter holds a reference of its own, so whoever drops
+	 * the last one is the only one to touch the group afterwards
+	 */
+	if (atomic_dec(&group->pending) == 1) {
+		k_sem_give(&group->done);
+	}
+}
+
+static void worker_loop(struct k_p4wq_work *work)
+{
+	struct k_p4wq_pool_worker *self =
+		CONTAINER_OF(work, struct k_p4wq_pool_worker, work);
+	struct k_p4wq_pool *pool = self->pool;
+
+	while (atomic_get(&pool->stopping) == 0) {
+		struct k_p4wq_task *task = task_next(pool, self);
+
+		if (task != NULL) {
+			task_run(task);
+			continue;
+		}
+
+		/* Announce we are going to sleep before the final check,
+		 * pairing with submitters bumping queued before they
+		 * look at idle: one of the two sees the other.
+		 */
+		atomic_inc(&pool->idle);
+		if (atomic_get(&pool->queued) == 0 &&
+		    atomic_get(&pool->stopping) == 0) {
+			k_sem_take(&pool->wake, K_FOREVER);
+		}
+		atomic_dec(&pool->idle);
+	}
+}
+
+void k_p4wq_pool_init(struct k_p4wq_pool *pool,
+		      struct k_p4wq_pool_worker *workers, uint32_t n_workers)
+{
+	__ASSERT_NO_MSG(n_workers > 0);
+
+	memset(pool, 0, sizeof(*pool));
+	memset(workers, 0, n_workers * sizeof(*workers));
+	pool->workers = workers;
+	pool->n_workers = n_workers;
+	k_sem_init(&pool->wake, 0, n_workers);
+}
+
+void k_p4wq_pool_start(struct k_p4wq_pool *pool, struct k_p4wq *queue,
+		       int32_t priority)
+{
+	atomic_clear(&pool->stopping);
+
+	for (uint32_t i = 0; i < pool->n_workers; i++) {
+		struct k_p4wq_pool_worker *w = &pool->workers[i];
+
+		w->pool = pool;
+		w->work.priority = priority;
+		w->work.deadline = 0;
+		w->work.handler = worker_loop;
+		w->work.sync = true;
+		k_p4wq_submit(queue, &w->work);
+	}
+}
+
+void k_p4wq_pool_stop(struct k_p4wq_pool *pool)
+{
+	atomic_set(&pool->stopping, 1);
+
+	for (uint32_t i = 0; i < pool->n_workers; i++) {
+		k_sem_give(&pool->wake);
+	}
+
+	for (uint32_t i = 0; i < pool->n_workers; i++) {
+		k_p4wq_wait(&pool->workers[i].work, K_FOREVER);
+	}
+}
+
+void k_p4wq_task_group_init(struct k_p4wq_task_group *group,
+			    struct k_p4wq_pool *pool)
+{
+	group->pool = pool;
+	atomic_set(&group->pending, 1);
+	k_sem_init(&group->done, 0, 1);
+}
+
+void k_p4wq_task_submit(struct k_p4wq_task_group *group,
+			struct k_p4wq_task *task)
+{
+	struct k_p4wq_pool *pool = group->pool;
+	struct k_p4wq_pool_worker *w = worker_self(pool);
+
+	task->group = group;
+	atomic_inc(&group->pending);
+
+	if (w == NULL) {
+		uint32_t n = (uint32_t)atomic_inc(&pool->next);
+
+		w = &pool->workers[n % pool->n_workers];
+	}
+
+	if (!deque_push(w, task)) {
+		task_run(task);
+		return;
+	}
+
+	atomic_inc(&pool->queued);
+	if (atomic_get(&pool->idle) != 0) {
+		k_sem_give(&pool->wake);
+	}
+}
+
+void k_p4wq_task_group_wait(struct k_p4wq_task_group *group)
+{
+	struct k_p4wq_pool *pool = group->pool;
+	struct k_p4wq_pool_worker *self = worker_self(pool);
+
+	/* Drop the waiter's reference; if that was the last one every
+	 * task is done and nobody will give the semaphore
+	 */
+	if (atomic_dec(&group->pending) == 1) {
+		return;
+	}
+
+	while (atomic_get(&group->pending) != 0) {
+		struct k_p4wq_task *task = task_next(pool, self);
+
+		if (task != NULL) {
+			task_run(task);
+		} else if (self != NULL) {
+			/* Workers keep helping: the rest of the group may
+			 * be split further by whoever is running it
+			 */
+			k_yield();
+		} else {
+			break;
+		}
+	}
+
+	k_sem_take(&group->done, K_FOREVER);
+}
+
+struct range_task {
+	struct k_p4wq_task task;
+	struct k_p4wq_pool *pool;
+	uint32_t start;
+	uint32_t end;
+	uint32_t grain;
+	k_p4wq_range_fn_t fn;
+	void *arg;
+};
+
+static void range_split(struct range_task *r);
+
+static void range_handler(struct k_p4wq_task *task)
+{
+	range_split(CONTAINER_OF(task, struct range_task, task));
+}
+
+/* Hand the upper half to the pool and carry on with the lower half
+ * ourselves, so the stack depth stays logarithmic in the range
+ */
+static void range_split(struct range_task *r)
+{
+	struct k_p4wq_task_group group;
+	struct range_task upper, lower;
+
+	if (r->end - r->start <= r->grain) {
+		r->fn(r->start, r->end, r->arg);
+		return;
+	}
+
+	upper = *r;
+	upper.task.handler = range_handler;
+	upper.start = r->start + (r->end - r->start) / 2U;
+
+	k_p4wq_task_group_init(&group, r->pool);
+	k_p4wq_task_submit(&group, &upper.task);
+
+	lower = *r;
+	lower.end = upper.start;
+	range_split(&lower);
+
+	k_p4wq_task_group_wait(&group);
+}
+
+int k_p4wq_parallel_for(struct k_p4wq_pool *pool, uint32_t start,
+			uint32_t end, uint32_t grain, k_p4wq_range_fn_t fn,
+			void *arg)
+{
+	struct range_task r = {
+		.pool = pool,
+		.start = start,
+		.end = end,
+		.grain = grain,
+		.fn = fn,
+		.arg = arg,
+	};
+
+	if (grain == 0U || end < start) {
+		return -EINVAL;
+	}
+
+	range_split(&r);
+
+	return 0;
+}
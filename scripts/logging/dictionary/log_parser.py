@@ -14,6 +14,8 @@ log data and print the log messages.
 import argparse
 import binascii
 import logging
+import re
+import socket
 import sys
 
 import parser
@@ -25,21 +27,140 @@ logger = logging.getLogger("parser")
 
 LOG_HEX_SEP = "##ZLOGV1##"
 
+HEX_PREFIX = re.compile("[0-9a-fA-F]*")
+
 
 def parse_args():
     """Parse command line arguments"""
     argparser = argparse.ArgumentParser()
 
     argparser.add_argument("dbfile", help="Dictionary Logging Database file")
-    argparser.add_argument("logfile", help="Log Data file")
+    argparser.add_argument("logfile", nargs="*",
+                           help="Log Data file(s), decoded in turn, "
+                                "'-' for standard input")
     argparser.add_argument("--hex", action="store_true",
                            help="Log Data file is in hexadecimal strings")
     argparser.add_argument("--rawhex", action="store_true",
                            help="Log file only contains hexadecimal log data")
+    argparser.add_argument("--udp", type=int, metavar="PORT",
+                           help="Receive log data sent by the networking "
+                                "backend on this UDP port")
     argparser.add_argument("--debug", action="store_true",
                            help="Print extra debugging information")
 
-    return argparser.parse_args()
+    args = argparser.parse_intermixed_args()
+
+    if bool(args.logfile) == bool(args.udp):
+        argparser.error("either log data files or --udp must be given")
+
+    return args
+
+
+def open_log_file(filename, mode):
+    """Open a log data file, or the standard input for '-'"""
+    if filename == "-":
+        return sys.stdin.buffer if "b" in mode else sys.stdin
+
+    return open(filename, mode)
+
+
+def read_hex_log_data(lines):
+    """Extract log data in hexadecimal from the lines of a file"""
+    tagged = [line.strip() for line in lines if line.startswith(LOG_HEX_SEP)]
+
+    if len(tagged) > 1:
+        # Every line of log data starts with the separator (e.g. on
+        # native_posix), the other lines are printed by something else.
+        hexdata = ''.join(HEX_PREFIX.match(line, len(LOG_HEX_SEP)).group(0)
+                          for line in tagged)
+    else:
+        hexdata = ''
+
+        for line in lines:
+            hexdata += line.strip()
+
+        if LOG_HEX_SEP not in hexdata:
+            return None
+
+        idx = hexdata.index(LOG_HEX_SEP) + len(LOG_HEX_SEP)
+        hexdata = hexdata[idx:]
+
+    if len(hexdata) % 2 != 0:
+        # Make sure there are even number of characters
+        idx = int(len(hexdata) / 2) * 2
+        hexdata = hexdata[:idx]
+
+    idx = 0
+    while idx < len(hexdata):
+        # When running QEMU via west or ninja, there may be additional
+        # strings printed by QEMU, west or ninja (for example, QEMU
+        # is terminated, or user interrupted, etc). So we need to
+        # figure out where the end of log data stream by
+        # trying to convert from hex to bin.
+        idx += 2
+
+        try:
+            binascii.unhexlify(hexdata[:idx])
+        except binascii.Error:
+            idx -= 2
+            break
+
+    return binascii.unhexlify(hexdata[:idx])
+
+
+def read_log_data(args, filename):
+    """Read the log data of a file, converted to binary if needed"""
+    if args.hex and args.rawhex and filename != "-":
+        # Simply log file with only hexadecimal data
+        return parser.utils.convert_hex_file_to_bin(filename)
+
+    if args.hex:
+        hexfile = open_log_file(filename, "r")
+        lines = hexfile.readlines()
+        hexfile.close()
+
+        if args.rawhex:
+            return binascii.unhexlify("".join(line.strip() for line in lines))
+
+        logdata = read_hex_log_data(lines)
+        if logdata is None:
+            logger.error("ERROR: Cannot find start of log data, exiting...")
+            sys.exit(1)
+
+        return logdata
+
+    logfile = open_log_file(filename, "rb")
+    logdata = logfile.read()
+    logfile.close()
+
+    return logdata
+
+
+def receive_udp(log_parser, port, debug):
+    """Decode the messages sent by the networking backend as they arrive"""
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(("", port))
+
+    # Messages larger than the output buffer of the backend are split
+    # over several datagrams, the data left is kept per sender.
+    pending = dict()
+
+    try:
+        while True:
+            data, sender = sock.recvfrom(65535)
+            logdata = pending.get(sender, b'') + data
+
+            ret = log_parser.parse_log_stream(logdata, debug=debug)
+            if ret is None:
+                logger.error("ERROR: Dropping undecodable data from %s", sender[0])
+                ret = len(logdata)
+
+            pending[sender] = logdata[ret:]
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        sock.close()
 
 
 def main():
@@ -59,72 +180,35 @@ def main():
         logger.error("ERROR: Cannot open database file: %s, exiting...", args.dbfile)
         sys.exit(1)
 
-    # Open log data file for reading
-    if args.hex:
-        if args.rawhex:
-            # Simply log file with only hexadecimal data
-            logdata = parser.utils.convert_hex_file_to_bin(args.logfile)
-        else:
-            hexdata = ''
-
-            with open(args.logfile, "r") as hexfile:
-                for line in hexfile.readlines():
-                    hexdata += line.strip()
-
-            if LOG_HEX_SEP not in hexdata:
-                logger.error("ERROR: Cannot find start of log data, exiting...")
-                sys.exit(1)
-
-            idx = hexdata.index(LOG_HEX_SEP) + len(LOG_HEX_SEP)
-            hexdata = hexdata[idx:]
-
-            if len(hexdata) % 2 != 0:
-                # Make sure there are even number of characters
-                idx = int(len(hexdata) / 2) * 2
-                hexdata = hexdata[:idx]
-
-            idx = 0
-            while idx < len(hexdata):
-                # When running QEMU via west or ninja, there may be additional
-                # strings printed by QEMU, west or ninja (for example, QEMU
-                # is terminated, or user interrupted, etc). So we need to
-                # figure out where the end of log data stream by
-                # trying to convert from hex to bin.
-                idx += 2
-
-                try:
-                    binascii.unhexlify(hexdata[:idx])
-                except binascii.Error:
-                    idx -= 2
-                    break
-
-            logdata = binascii.unhexlify(hexdata[:idx])
+    log_parser = parser.get_parser(database)
+    if log_parser is None:
+        logger.error("ERROR: Cannot find a suitable parser matching database version!")
+        sys.exit(1)
+
+    logger.debug("# Build ID: %s", database.get_build_id())
+    logger.debug("# Target: %s, %d-bit", database.get_arch(), database.get_tgt_bits())
+    if database.is_tgt_little_endian():
+        logger.debug("# Endianness: Little")
     else:
-        logfile = open(args.logfile, "rb")
-        if not logfile:
-            logger.error("ERROR: Cannot open binary log data file: %s, exiting...", args.logfile)
+        logger.debug("# Endianness: Big")
+
+    if args.udp:
+        receive_udp(log_parser, args.udp, args.debug)
+        return
+
+    # Each file starts with a message, e.g. those written by
+    # the file system backend.
+    for filename in args.logfile:
+        try:
+            logdata = read_log_data(args, filename)
+        except OSError:
+            logger.error("ERROR: Cannot open log data file: %s, exiting...", filename)
             sys.exit(1)
 
-        logdata = logfile.read()
-
-        logfile.close()
-
-    log_parser = parser.get_parser(database)
-    if log_parser is not None:
-        logger.debug("# Build ID: %s", database.get_build_id())
-        logger.debug("# Target: %s, %d-bit", database.get_arch(), database.get_tgt_bits())
-        if database.is_tgt_little_endian():
-            logger.debug("# Endianness: Little")
-        else:
-            logger.debug("# Endianness: Big")
-
         ret = log_parser.parse_log_data(logdata, debug=args.debug)
         if not ret:
             logger.error("ERROR: there were error(s) parsing log data")
             sys.exit(1)
-    else:
-        logger.error("ERROR: Cannot find a suitable parser matching database version!")
-        sys.exit(1)
 
 
 if __name__ == "__main__":
@@ -20,3 +20,10 @@ class LogParser(abc.ABC):
     def parse_log_data(self, logdata, debug=False):
         """Parse log data"""
         return None
+
+
+    @abc.abstractmethod
+    def parse_log_stream(self, logdata, debug=False):
+        """Parse the complete messages at the start of log data, and
+        return the number of bytes parsed"""
+        return None
@@ -421,30 +421,81 @@ class LogParserV1(LogParser):
         return next_msg_offset
 
 
-    def parse_log_data(self, logdata, debug=False):
-        """Parse binary log data and print the encoded log messages"""
+    def get_msg_len(self, logdata, offset):
+        """Get the length of the message at offset, or None if the log data
+        ends before the length is known"""
+        type_len = struct.calcsize(self.fmt_msg_type)
+        if offset + type_len > len(logdata):
+            return None
+
+        msg_type = struct.unpack_from(self.fmt_msg_type, logdata, offset)[0]
+
+        if msg_type == MSG_TYPE_DROPPED:
+            return type_len + struct.calcsize(self.fmt_dropped_cnt)
+
+        if msg_type != MSG_TYPE_NORMAL:
+            # Reported by parse_one_msg()
+            return type_len
+
+        hdr_len = type_len + struct.calcsize(self.fmt_msg_hdr) + \
+                  struct.calcsize(self.fmt_msg_timestamp)
+        if offset + hdr_len > len(logdata):
+            return None
+
+        log_desc = struct.unpack_from(self.fmt_msg_hdr, logdata, offset + type_len)[0]
+        pkg_len = (log_desc >> 6) & int(math.pow(2, 10) - 1)
+        data_len = (log_desc >> 16) & int(math.pow(2, 12) - 1)
+
+        return hdr_len + pkg_len + data_len
+
+
+    def parse_one_msg(self, logdata, offset):
+        """Parse the message at offset and print it, return the offset
+        of the next message or None on error"""
+        # Get message type
+        msg_type = struct.unpack_from(self.fmt_msg_type, logdata, offset)[0]
+        offset += struct.calcsize(self.fmt_msg_type)
+
+        if msg_type == MSG_TYPE_DROPPED:
+            num_dropped = struct.unpack_from(self.fmt_dropped_cnt, logdata, offset)
+            offset += struct.calcsize(self.fmt_dropped_cnt)
+
+            print("--- %d messages dropped ---" % num_dropped)
+
+            return offset
+
+        if msg_type == MSG_TYPE_NORMAL:
+            return self.parse_one_normal_msg(logdata, offset)
+
+        logger.error("------ Unknown message type: %s", msg_type)
+        return None
+
+
+    def parse_log_stream(self, logdata, debug=False):
+        """Parse the complete messages at the start of binary log data and
+        print them, return the number of bytes parsed or None on error"""
         offset = 0
 
         while offset < len(logdata):
-            # Get message type
-            msg_type = struct.unpack_from(self.fmt_msg_type, logdata, offset)[0]
-            offset += struct.calcsize(self.fmt_msg_type)
+            msg_len = self.get_msg_len(logdata, offset)
+            if msg_len is None or offset + msg_len > len(logdata):
+                break
 
-            if msg_type == MSG_TYPE_DROPPED:
-                num_dropped = struct.unpack_from(self.fmt_dropped_cnt, logdata, offset)
-                offset += struct.calcsize(self.fmt_dropped_cnt)
+            offset = self.parse_one_msg(logdata, offset)
+            if offset is None:
+                return None
 
-                print("--- %d messages dropped ---" % num_dropped)
+        return offset
 
-            elif msg_type == MSG_TYPE_NORMAL:
-                ret = self.parse_one_normal_msg(logdata, offset)
-                if ret is None:
-                    return False
 
-                offset = ret
+    def parse_log_data(self, logdata, debug=False):
+        """Parse binary log data and print the encoded log messages"""
+        offset = self.parse_log_stream(logdata, debug=debug)
+        if offset is None:
+            return False
 
-            else:
-                logger.error("------ Unknown message type: %s", msg_type)
-                return False
+        if offset < len(logdata):
+            logger.error("------ Log data ends in the middle of a message")
+            return False
 
         return True
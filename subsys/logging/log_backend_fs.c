@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include <logging/log_backend.h>
 #include <logging/log_backend_std.h>
+#include <logging/log_output_dict.h>
 #include <assert.h>
 #include <fs/fs.h>
 
@@ -436,6 +437,37 @@ static void put(const struct log_backend *const backend,
 	log_backend_std_put(&log_output, 0, msg);
 }
 
+/* Start a new file rather than split a dictionary-based message over two,
+ * so that every file can be decoded on its own, the oldest ones being
+ * deleted when the file system fills up.
+ */
+static void reserve_space(size_t len)
+{
+	int size;
+
+	if (backend_state != BACKEND_FS_OK) {
+		return;
+	}
+
+	size = fs_tell(&file);
+	if (size > 0 && (size + len) > CONFIG_LOG_BACKEND_FS_FILE_SIZE &&
+	    allocate_new_file(&file) < 0) {
+		backend_state = BACKEND_FS_CORRUPTED;
+	}
+}
+
+static void process(const struct log_backend *const backend,
+		    union log_msg2_generic *msg)
+{
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_FS_OUTPUT_DICTIONARY)) {
+		reserve_space(log_dict_output_msg2_len(&msg->log));
+		log_dict_output_msg2_process(&log_output, &msg->log, 0);
+	} else {
+		log_output_msg2_process(&log_output, &msg->log,
+					log_backend_std_get_flags());
+	}
+}
+
 static void log_backend_fs_init(void)
 {
 }
@@ -452,11 +484,16 @@ static void dropped(const struct log_backend *const backend, uint32_t cnt)
 {
 	ARG_UNUSED(backend);
 
-	log_backend_std_dropped(&log_output, cnt);
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_FS_OUTPUT_DICTIONARY)) {
+		log_dict_output_dropped_process(&log_output, cnt);
+	} else {
+		log_backend_std_dropped(&log_output, cnt);
+	}
 }
 
 static const struct log_backend_api log_backend_fs_api = {
-	.put = put,
+	.process = IS_ENABLED(CONFIG_LOG2) ? process : NULL,
+	.put = IS_ENABLED(CONFIG_LOG_MODE_DEFERRED) ? put : NULL,
 	.put_sync_string = NULL,
 	.put_sync_hexdump = NULL,
 	.panic = panic,
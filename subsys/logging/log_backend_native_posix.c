@@ -12,6 +12,7 @@
 #include <logging/log_core.h>
 #include <logging/log_msg.h>
 #include <logging/log_output.h>
+#include <logging/log_output_dict.h>
 #include <irq.h>
 #include <arch/posix/posix_trace.h>
 
@@ -45,12 +46,46 @@ static void preprint_char(int c)
 	}
 }
 
+/* Fixed size to avoid auto-added trailing '\0'.
+ * Used if CONFIG_LOG_BACKEND_NATIVE_POSIX_OUTPUT_DICTIONARY.
+ */
+static const char LOG_HEX_SEP[10] = "##ZLOGV1##";
+
+/* The trace output takes strings, dictionary-based output is written in
+ * hexadecimal on lines starting with the separator, so that the log
+ * parser can tell them from the other output.
+ */
+static void hex_line_flush(void)
+{
+	if (n_pend > 0) {
+		posix_print_trace("%.*s%s\n", (int)sizeof(LOG_HEX_SEP),
+				  LOG_HEX_SEP, stdout_buff);
+		n_pend = 0;
+		stdout_buff[0] = 0;
+	}
+}
+
+static void hex_out(uint8_t data)
+{
+	(void)hex2char(data >> 4, &stdout_buff[n_pend++]);
+	(void)hex2char(data & 0x0FU, &stdout_buff[n_pend++]);
+	stdout_buff[n_pend] = 0;
+
+	if (n_pend >= _STDOUT_BUF_SIZE - 2) {
+		hex_line_flush();
+	}
+}
+
 static uint8_t buf[_STDOUT_BUF_SIZE];
 
 static int char_out(uint8_t *data, size_t length, void *ctx)
 {
 	for (size_t i = 0; i < length; i++) {
-		preprint_char(data[i]);
+		if (IS_ENABLED(CONFIG_LOG_BACKEND_NATIVE_POSIX_OUTPUT_DICTIONARY)) {
+			hex_out(data[i]);
+		} else {
+			preprint_char(data[i]);
+		}
 	}
 
 	return length;
@@ -90,7 +125,12 @@ static void dropped(const struct log_backend *const backend, uint32_t cnt)
 {
 	ARG_UNUSED(backend);
 
-	log_output_dropped_process(&log_output_posix, cnt);
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_NATIVE_POSIX_OUTPUT_DICTIONARY)) {
+		log_dict_output_dropped_process(&log_output_posix, cnt);
+		hex_line_flush();
+	} else {
+		log_output_dropped_process(&log_output_posix, cnt);
+	}
 }
 
 static void sync_string(const struct log_backend *const backend,
@@ -140,7 +180,25 @@ static void process(const struct log_backend *const backend,
 {
 	uint32_t flags = log_backend_std_get_flags();
 
-	log_output_msg2_process(&log_output_posix, &msg->log, flags);
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_NATIVE_POSIX_OUTPUT_DICTIONARY)) {
+		/* Each message ends its line, printk() output can go in
+		 * between.
+		 */
+		log_dict_output_msg2_process(&log_output_posix,
+					     &msg->log, flags);
+		hex_line_flush();
+	} else {
+		log_output_msg2_process(&log_output_posix, &msg->log, flags);
+	}
+}
+
+static void log_backend_native_posix_init(struct log_backend const *const backend)
+{
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_NATIVE_POSIX_OUTPUT_DICTIONARY)) {
+		/* Mark the start of the log data even if nothing is logged */
+		posix_print_trace("%.*s\n", (int)sizeof(LOG_HEX_SEP),
+				  LOG_HEX_SEP);
+	}
 }
 
 const struct log_backend_api log_backend_native_posix_api = {
@@ -151,6 +209,7 @@ const struct log_backend_api log_backend_native_posix_api = {
 	.put_sync_hexdump = IS_ENABLED(CONFIG_LOG_MODE_IMMEDIATE) ?
 			sync_hexdump : NULL,
 	.panic = panic,
+	.init = log_backend_native_posix_init,
 	.dropped = IS_ENABLED(CONFIG_LOG_IMMEDIATE) ? NULL : dropped,
 };
 
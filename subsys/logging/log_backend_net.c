@@ -10,6 +10,7 @@ LOG_MODULE_REGISTER(log_backend_net, CONFIG_LOG_DEFAULT_LEVEL);
 #include <logging/log_backend.h>
 #include <logging/log_core.h>
 #include <logging/log_output.h>
+#include <logging/log_output_dict.h>
 #include <logging/log_msg.h>
 #include <net/net_pkt.h>
 #include <net/net_context.h>
@@ -194,6 +195,38 @@ static void send_output(const struct log_backend *const backend,
 	log_msg_put(msg);
 }
 
+static void process(const struct log_backend *const backend,
+		    union log_msg2_generic *msg)
+{
+	if (panic_mode) {
+		return;
+	}
+
+	if (!net_init_done && do_net_init() == 0) {
+		net_init_done = true;
+	}
+
+	/* The output is flushed once per message, which goes out in a
+	 * datagram of its own unless larger than the output buffer.
+	 */
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_NET_OUTPUT_DICTIONARY)) {
+		log_dict_output_msg2_process(&log_output_net, &msg->log, 0);
+	} else {
+		log_output_msg2_process(&log_output_net, &msg->log,
+					LOG_OUTPUT_FLAG_FORMAT_SYSLOG |
+					LOG_OUTPUT_FLAG_TIMESTAMP);
+	}
+}
+
+static void dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+	ARG_UNUSED(backend);
+
+	if (!panic_mode && net_init_done) {
+		log_dict_output_dropped_process(&log_output_net, cnt);
+	}
+}
+
 static void init_net(struct log_backend const *const backend)
 {
 	ARG_UNUSED(backend);
@@ -240,7 +273,10 @@ static void sync_string(const struct log_backend *const backend,
 const struct log_backend_api log_backend_net_api = {
 	.panic = panic,
 	.init = init_net,
-	.put = IS_ENABLED(CONFIG_LOG_IMMEDIATE) ? NULL : send_output,
+	.process = IS_ENABLED(CONFIG_LOG2) ? process : NULL,
+	.dropped = IS_ENABLED(CONFIG_LOG_BACKEND_NET_OUTPUT_DICTIONARY) ?
+			dropped : NULL,
+	.put = IS_ENABLED(CONFIG_LOG_MODE_DEFERRED) ? send_output : NULL,
 	.put_sync_string = IS_ENABLED(CONFIG_LOG_IMMEDIATE) ?
 							sync_string : NULL,
 	/* Currently we do not send hexdumps over network to remote server
@@ -8,6 +8,7 @@
 #include <logging/log_core.h>
 #include <logging/log_msg.h>
 #include <logging/log_output.h>
+#include <logging/log_output_dict.h>
 #include <logging/log_backend_std.h>
 #include <SEGGER_RTT.h>
 
@@ -272,7 +273,11 @@ static void dropped(const struct log_backend *const backend, uint32_t cnt)
 {
 	ARG_UNUSED(backend);
 
-	log_backend_std_dropped(&log_output_rtt, cnt);
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_RTT_OUTPUT_DICTIONARY)) {
+		log_dict_output_dropped_process(&log_output_rtt, cnt);
+	} else {
+		log_backend_std_dropped(&log_output_rtt, cnt);
+	}
 }
 
 static void sync_string(const struct log_backend *const backend,
@@ -302,7 +307,12 @@ static void process(const struct log_backend *const backend,
 {
 	uint32_t flags = log_backend_std_get_flags();
 
-	log_output_msg2_process(&log_output_rtt, &msg->log, flags);
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_RTT_OUTPUT_DICTIONARY)) {
+		log_dict_output_msg2_process(&log_output_rtt,
+					     &msg->log, flags);
+	} else {
+		log_output_msg2_process(&log_output_rtt, &msg->log, flags);
+	}
 }
 
 const struct log_backend_api log_backend_rtt_api = {
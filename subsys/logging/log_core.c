@@ -106,10 +106,21 @@ static const struct mpsc_pbuf_buffer_config mpsc_config = {
 	.size = ARRAY_SIZE(buf32),
 	.notify_drop = notify_drop,
 	.get_wlen = log_msg2_generic_get_wlen,
-	.flags = IS_ENABLED(CONFIG_LOG_MODE_OVERFLOW) ?
-		MPSC_PBUF_MODE_OVERWRITE : 0
+	.flags = IS_ENABLED(CONFIG_LOG_BACKEND_READERS) ?
+		MPSC_PBUF_MODE_READERS :
+		(IS_ENABLED(CONFIG_LOG_MODE_OVERFLOW) ?
+		 MPSC_PBUF_MODE_OVERWRITE : 0)
 };
 
+#if defined(CONFIG_LOG_BACKEND_READERS)
+/* Reader of each backend, indexed like the backends. Readers are only added
+ * and removed by the processing context, as a reader cannot be removed while
+ * it holds a claimed message.
+ */
+static struct mpsc_pbuf_reader backend_readers[CONFIG_MPSC_PBUF_READERS];
+static uint32_t backend_readers_added;
+#endif
+
 bool log_is_strdup(const void *buf);
 static void msg_process(union log_msgs msg, bool bypass);
 
@@ -604,6 +615,11 @@ void log_init(void)
 		return;
 	}
 
+#if defined(CONFIG_LOG_BACKEND_READERS)
+	__ASSERT(log_backend_count_get() <= CONFIG_MPSC_PBUF_READERS,
+		 "CONFIG_MPSC_PBUF_READERS lower than the number of backends");
+#endif
+
 	/* Assign ids to backends. */
 	for (i = 0; i < log_backend_count_get(); i++) {
 		const struct log_backend *backend = log_backend_get(i);
@@ -803,6 +819,105 @@ static bool next_pending(void)
 	return (log_list_head_peek(&list) != NULL);
 }
 
+#if defined(CONFIG_LOG_BACKEND_READERS)
+/* Adds the reader of an active backend, removes the one of an inactive
+ * backend. A reader starts at the oldest message still held, so a backend
+ * enabled late also gets the messages kept for the other ones.
+ */
+static bool backend_reader_sync(int idx, struct log_backend const *backend)
+{
+	bool active = log_backend_is_active(backend);
+	bool added = backend_readers_added & BIT(idx);
+
+	if (active && !added) {
+		uint32_t flags = IS_ENABLED(CONFIG_LOG_MODE_OVERFLOW) ?
+				 MPSC_PBUF_READER_MODE_OVERWRITE : 0;
+
+		if (mpsc_pbuf_reader_add(&log_buffer, &backend_readers[idx],
+					 flags) == 0) {
+			backend_readers_added |= BIT(idx);
+		}
+	} else if (!active && added) {
+		mpsc_pbuf_reader_remove(&log_buffer, &backend_readers[idx]);
+		backend_readers_added &= ~BIT(idx);
+	}
+
+	return backend_readers_added & BIT(idx);
+}
+
+static bool backend_reader_process(int idx, bool bypass)
+{
+	struct log_backend const *backend = log_backend_get(idx);
+	struct mpsc_pbuf_reader *reader = &backend_readers[idx];
+	union log_msgs msg;
+	uint32_t dropped;
+
+	if (!backend_reader_sync(idx, backend)) {
+		return false;
+	}
+
+	msg.msg2 = (union log_msg2_generic *)
+		mpsc_pbuf_reader_claim(&log_buffer, reader, K_NO_WAIT);
+	if (msg.msg2 == NULL) {
+		return false;
+	}
+
+	/* Drops happened before the claimed message was written. */
+	dropped = mpsc_pbuf_reader_dropped(&log_buffer, reader);
+	if (!bypass && dropped) {
+		log_backend_dropped(backend, dropped);
+	}
+
+	if (!bypass && msg_filter_check(backend, msg)) {
+		log_backend_msg2_process(backend, msg.msg2);
+	}
+
+	mpsc_pbuf_reader_free(&log_buffer, reader,
+			      (union mpsc_pbuf_generic *)msg.msg2);
+
+	return true;
+}
+
+/* Processes the next message of each backend. Backends are at their own
+ * position in the buffer, with LOG_MODE_OVERFLOW messages are dropped only
+ * for the ones which fell behind.
+ */
+static bool backend_readers_process(bool bypass)
+{
+	int cnt = MIN(log_backend_count_get(), CONFIG_MPSC_PBUF_READERS);
+	bool processed = false;
+	bool pending = false;
+
+	for (int i = 0; i < cnt; i++) {
+		processed |= backend_reader_process(i, bypass);
+	}
+
+	if (processed) {
+		atomic_dec(&buffered_cnt);
+	}
+
+	/* Messages which could not be allocated are lost for all backends. */
+	if (!bypass && z_log_dropped_pending()) {
+		dropped_notify();
+	}
+
+	for (int i = 0; i < cnt; i++) {
+		if ((backend_readers_added & BIT(i)) &&
+		    mpsc_pbuf_reader_is_pending(&log_buffer,
+						&backend_readers[i])) {
+			pending = true;
+		}
+	}
+
+	return pending;
+}
+#else
+static inline bool backend_readers_process(bool bypass)
+{
+	return false;
+}
+#endif /* CONFIG_LOG_BACKEND_READERS */
+
 bool z_impl_log_process(bool bypass)
 {
 	union log_msgs msg;
@@ -811,6 +926,10 @@ bool z_impl_log_process(bool bypass)
 		return false;
 	}
 
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_READERS)) {
+		return backend_readers_process(bypass);
+	}
+
 	msg = get_msg();
 	if (msg.msg) {
 		atomic_dec(&buffered_cnt);
@@ -863,7 +982,10 @@ bool z_log_dropped_pending(void)
 static void notify_drop(struct mpsc_pbuf_buffer *buffer,
 			union mpsc_pbuf_generic *item)
 {
-	z_log_dropped();
+	/* Messages dropped for some readers only are counted per reader. */
+	if (!IS_ENABLED(CONFIG_LOG_BACKEND_READERS)) {
+		z_log_dropped();
+	}
 }
 
 uint32_t log_src_cnt_get(uint32_t domain_id)
@@ -1312,6 +1434,11 @@ void log_hexdump_from_user(struct log_msg_ids src_level, const char *metadata,
 void z_log_msg2_init(void)
 {
 	mpsc_pbuf_init(&log_buffer, &mpsc_config);
+
+#if defined(CONFIG_LOG_BACKEND_READERS)
+	/* Initialization forgets the readers of the buffer. */
+	backend_readers_added = 0;
+#endif
 }
 
 static uint32_t log_diff_timestamp(void)
@@ -11,17 +11,45 @@
 #include <logging/log_output_dict.h>
 #include <sys/__assert.h>
 #include <sys/util.h>
+#include <string.h>
 
-static void buffer_write(log_output_func_t outf, uint8_t *buf, size_t len,
-			 void *ctx)
+/* Copy to the output buffer, handing it to the backend each time it
+ * fills up, so that a message goes out in as few calls as possible.
+ * In immediate mode the buffer is not used, as for text output, since
+ * messages can be output from several contexts at once.
+ */
+static void buffer_write(const struct log_output *output, const void *data,
+			 size_t len)
 {
-	int processed;
+	struct log_output_control_block *cb = output->control_block;
+	const uint8_t *pos = data;
+
+	if (IS_ENABLED(CONFIG_LOG_IMMEDIATE)) {
+		while (len > 0) {
+			int processed = output->func((uint8_t *)pos, len,
+						     cb->ctx);
+
+			pos += processed;
+			len -= processed;
+		}
+
+		return;
+	}
 
-	do {
-		processed = outf(buf, len, ctx);
-		len -= processed;
-		buf += processed;
-	} while (len != 0);
+	while (len > 0) {
+		size_t offset = atomic_get(&cb->offset);
+		size_t chunk = MIN(len, output->size - offset);
+
+		if (chunk == 0) {
+			log_output_flush(output);
+			continue;
+		}
+
+		memcpy(output->buf + offset, pos, chunk);
+		atomic_add(&cb->offset, chunk);
+		pos += chunk;
+		len -= chunk;
+	}
 }
 
 void log_dict_output_msg2_process(const struct log_output *output,
@@ -44,19 +72,18 @@ void log_dict_output_msg2_process(const struct log_output *output,
 					log_const_source_id(source)) :
 				0U;
 
-	buffer_write(output->func, (uint8_t *)&output_hdr, sizeof(output_hdr),
-		     (void *)output);
+	buffer_write(output, &output_hdr, sizeof(output_hdr));
 
 	size_t len;
 	uint8_t *data = log_msg2_get_package(msg, &len);
 
 	if (len > 0U) {
-		buffer_write(output->func, data, len, (void *)output);
+		buffer_write(output, data, len);
 	}
 
 	data = log_msg2_get_data(msg, &len);
 	if (len > 0U) {
-		buffer_write(output->func, data, len, (void *)output);
+		buffer_write(output, data, len);
 	}
 
 	log_output_flush(output);
@@ -69,6 +96,6 @@ void log_dict_output_dropped_process(const struct log_output *output, uint32_t c
 	msg.type = MSG_DROPPED_MSG;
 	msg.num_dropped_messages = MIN(cnt, 9999);
 
-	buffer_write(output->func, (uint8_t *)&msg, sizeof(msg),
-		     (void *)output);
+	buffer_write(output, &msg, sizeof(msg));
+	log_output_flush(output);
 }
@@ -221,6 +221,39 @@ static void data_unref(struct net_buf *buf, uint8_t *data)
 	pool->alloc->cb->unref(buf, data);
 }
 
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+static void pool_usage_alloc(struct net_buf_pool *pool, struct net_buf *buf)
+{
+	atomic_val_t used, max_used;
+
+	used = pool->buf_count - atomic_dec(&pool->avail_count) + 1;
+	__ASSERT_NO_MSG(used <= pool->buf_count);
+
+	do {
+		max_used = atomic_get(&pool->max_used);
+		if (used <= max_used) {
+			break;
+		}
+	} while (!atomic_cas(&pool->max_used, max_used, used));
+
+	buf->alloc_time = k_cycle_get_32();
+}
+
+static void pool_usage_free(struct net_buf_pool *pool, struct net_buf *buf)
+{
+	uint32_t held = k_cyc_to_us_floor32(k_cycle_get_32() - buf->alloc_time);
+
+	/* Concurrent frees may lose an update of the average, which does not
+	 * matter for a statistic and keeps the free path lock free.
+	 */
+	pool->hold_time_avg = pool->hold_time_avg - (pool->hold_time_avg >> 3) +
+			      (held >> 3);
+
+	atomic_inc(&pool->avail_count);
+	__ASSERT_NO_MSG(atomic_get(&pool->avail_count) <= pool->buf_count);
+}
+#endif /* CONFIG_NET_BUF_POOL_USAGE */
+
 #if defined(CONFIG_NET_BUF_LOG)
 struct net_buf *net_buf_alloc_len_debug(struct net_buf_pool *pool, size_t size,
 					k_timeout_t timeout, const char *func,
@@ -301,6 +334,9 @@ struct net_buf *net_buf_alloc_len(struct net_buf_pool *pool, size_t size,
 #endif
 	if (!buf) {
 		NET_BUF_ERR("%s():%d: Failed to get free buffer", func, line);
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+		atomic_inc(&pool->alloc_failures);
+#endif
 		return NULL;
 	}
 
@@ -326,6 +362,9 @@ success:
 		if (!buf->__buf) {
 			NET_BUF_ERR("%s():%d: Failed to allocate data",
 				    func, line);
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+			atomic_inc(&pool->alloc_failures);
+#endif
 			net_buf_destroy(buf);
 			return NULL;
 		}
@@ -342,8 +381,7 @@ success:
 	net_buf_reset(buf);
 
 #if defined(CONFIG_NET_BUF_POOL_USAGE)
-	atomic_dec(&pool->avail_count);
-	__ASSERT_NO_MSG(atomic_get(&pool->avail_count) >= 0);
+	pool_usage_alloc(pool, buf);
 #endif
 	return buf;
 }
@@ -548,8 +586,7 @@ void net_buf_unref(struct net_buf *buf)
 		pool = net_buf_pool_get(buf->pool_id);
 
 #if defined(CONFIG_NET_BUF_POOL_USAGE)
-		atomic_inc(&pool->avail_count);
-		__ASSERT_NO_MSG(atomic_get(&pool->avail_count) <= pool->buf_count);
+		pool_usage_free(pool, buf);
 #endif
 
 		if (pool->destroy) {
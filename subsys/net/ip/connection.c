@@ -54,11 +54,35 @@ LOG_MODULE_REGISTER(net_conn, CONFIG_NET_CONN_LOG_LEVEL);
 
 #define NET_CONN_RANK(_flags)		(_flags & 0x78)
 
+#if defined(CONFIG_NET_CONN_HASH_BUCKETS)
+#define CONN_HASH_BUCKETS CONFIG_NET_CONN_HASH_BUCKETS
+#else
+#define CONN_HASH_BUCKETS 1
+#endif
+
+BUILD_ASSERT((CONN_HASH_BUCKETS & (CONN_HASH_BUCKETS - 1)) == 0,
+	     "CONFIG_NET_CONN_HASH_BUCKETS must be a power of two");
+
 static struct net_conn conns[CONFIG_NET_MAX_CONN];
 
 static sys_slist_t conn_unused;
 static sys_slist_t conn_used;
 
+/* Every used handler is also on exactly one of these: IP handlers bound
+ * to a local port are hashed on it, all others are on conn_any and have
+ * to be checked for every packet.
+ */
+static sys_slist_t conn_ports[CONN_HASH_BUCKETS];
+static sys_slist_t conn_any;
+static uint32_t conn_seq;
+
+/* Handlers which may match a packet, newest first as on conn_used */
+struct conn_iter {
+	sys_snode_t *all;
+	sys_snode_t *port;
+	sys_snode_t *any;
+};
+
 #if (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG)
 static inline
 void conn_register_debug(struct net_conn *conn,
@@ -113,6 +137,82 @@ void conn_register_debug(struct net_conn *conn,
 #define conn_register_debug(...)
 #endif /* (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG) */
 
+static sys_slist_t *conn_port_bucket(uint16_t port)
+{
+	port = ntohs(port);
+
+	return &conn_ports[(port ^ (port >> 8)) & (CONN_HASH_BUCKETS - 1)];
+}
+
+/* Local port the handler is hashed on, 0 if it is on conn_any */
+static uint16_t conn_demux_port(struct net_conn *conn)
+{
+	if (conn->family == AF_PACKET || conn->family == AF_CAN) {
+		return 0U;
+	}
+
+	return net_sin(&conn->local_addr)->sin_port;
+}
+
+static sys_slist_t *conn_demux_list(struct net_conn *conn)
+{
+	uint16_t port = conn_demux_port(conn);
+
+	return port ? conn_port_bucket(port) : &conn_any;
+}
+
+/* Walk only the handlers on local port 'port' and those on no port if
+ * by_port is set, all of them otherwise.
+ */
+static void conn_iter_init(struct conn_iter *it, bool by_port, uint16_t port)
+{
+	if (by_port) {
+		it->all = NULL;
+		it->port = sys_slist_peek_head(conn_port_bucket(port));
+		it->any = sys_slist_peek_head(&conn_any);
+	} else {
+		it->all = sys_slist_peek_head(&conn_used);
+		it->port = NULL;
+		it->any = NULL;
+	}
+}
+
+static struct net_conn *conn_iter_next(struct conn_iter *it)
+{
+	struct net_conn *port_conn = NULL;
+	struct net_conn *any_conn = NULL;
+
+	if (it->all) {
+		port_conn = CONTAINER_OF(it->all, struct net_conn, node);
+		it->all = sys_slist_peek_next(it->all);
+
+		return port_conn;
+	}
+
+	if (it->port) {
+		port_conn = CONTAINER_OF(it->port, struct net_conn, demux_node);
+	}
+
+	if (it->any) {
+		any_conn = CONTAINER_OF(it->any, struct net_conn, demux_node);
+	}
+
+	/* Merge the two lists on the registration order, so that ties in
+	 * the ranking are resolved the same way as with a full scan.
+	 */
+	if (port_conn &&
+	    (!any_conn || (int32_t)(port_conn->seq - any_conn->seq) > 0)) {
+		it->port = sys_slist_peek_next(it->port);
+		return port_conn;
+	}
+
+	if (any_conn) {
+		it->any = sys_slist_peek_next(it->any);
+	}
+
+	return any_conn;
+}
+
 static struct net_conn *conn_get_unused(void)
 {
 	sys_snode_t *node;
@@ -130,8 +230,10 @@ static struct net_conn *conn_get_unused(void)
 static void conn_set_used(struct net_conn *conn)
 {
 	conn->flags |= NET_CONN_IN_USE;
+	conn->seq = ++conn_seq;
 
 	sys_slist_prepend(&conn_used, &conn->node);
+	sys_slist_prepend(conn_demux_list(conn), &conn->demux_node);
 }
 
 static void conn_set_unused(struct net_conn *conn)
@@ -148,10 +250,14 @@ static struct net_conn *conn_find_handler(uint16_t proto, uint8_t family,
 					  uint16_t remote_port,
 					  uint16_t local_port)
 {
+	struct conn_iter it;
 	struct net_conn *conn;
-	struct net_conn *tmp;
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&conn_used, conn, tmp, node) {
+	/* An identical IP handler can only be hashed on the same port */
+	conn_iter_init(&it, local_port && family != AF_PACKET &&
+		       family != AF_CAN, htons(local_port));
+
+	while ((conn = conn_iter_next(&it)) != NULL) {
 		if (conn->proto != proto) {
 			continue;
 		}
@@ -380,6 +486,7 @@ int net_conn_unregister(struct net_conn_handle *handle)
 	NET_DBG("Connection handler %p removed", conn);
 
 	sys_slist_find_and_remove(&conn_used, &conn->node);
+	sys_slist_find_and_remove(conn_demux_list(conn), &conn->demux_node);
 
 	conn_set_unused(conn);
 
@@ -558,6 +665,7 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 	bool raw_pkt_delivered = false;
 	bool raw_pkt_continue = false;
 	int16_t best_rank = -1;
+	struct conn_iter it;
 	struct net_conn *conn;
 	enum net_verdict ret;
 	uint16_t src_port;
@@ -623,7 +731,14 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		}
 	}
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
+	/* A UDP or TCP packet can only match the handlers bound to its
+	 * destination port or to no port at all.
+	 */
+	conn_iter_init(&it, (proto == IPPROTO_UDP || proto == IPPROTO_TCP) &&
+		       (net_pkt_family(pkt) == AF_INET ||
+			net_pkt_family(pkt) == AF_INET6), dst_port);
+
+	while ((conn = conn_iter_next(&it)) != NULL) {
 		if (conn->context != NULL &&
 		    net_context_is_bound_to_iface(conn->context) &&
 		    net_pkt_iface(pkt) != net_context_get_iface(conn->context)) {
@@ -855,6 +970,11 @@ void net_conn_init(void)
 
 	sys_slist_init(&conn_unused);
 	sys_slist_init(&conn_used);
+	sys_slist_init(&conn_any);
+
+	for (i = 0; i < CONN_HASH_BUCKETS; i++) {
+		sys_slist_init(&conn_ports[i]);
+	}
 
 	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
 		sys_slist_prepend(&conn_unused, &conns[i].node);
@@ -51,6 +51,9 @@ struct net_conn {
 	/** Internal slist node */
 	sys_snode_t node;
 
+	/** Node in the local port hash bucket or in the wildcard list */
+	sys_snode_t demux_node;
+
 	/** Remote IP address */
 	struct sockaddr remote_addr;
 
@@ -76,6 +79,9 @@ struct net_conn {
 
 	/** Flags for the connection */
 	uint8_t flags;
+
+	/** Registration order, newer handlers are checked first */
+	uint32_t seq;
 };
 
 /**
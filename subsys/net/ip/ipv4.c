@@ -281,7 +281,7 @@ enum net_verdict net_ipv4_input(struct net_pkt *pkt)
 		goto drop;
 	}
 
-	if (net_if_need_calc_rx_checksum(net_pkt_iface(pkt)) &&
+	if (net_pkt_need_calc_rx_checksum(pkt) &&
 	    net_calc_chksum_ipv4(pkt) != 0U) {
 		NET_DBG("DROP: invalid chksum");
 		goto drop;
@@ -301,6 +301,17 @@ enum net_verdict net_ipv4_input(struct net_pkt *pkt)
 		goto drop;
 	}
 
+	if (IS_ENABLED(CONFIG_NET_IPV4_FRAGMENT) &&
+	    ((hdr->offset[0] & 0x3f) || hdr->offset[1])) {
+		/* The reassembled packet is fed back to this function */
+		verdict = net_ipv4_handle_fragment_hdr(pkt, hdr);
+		if (verdict == NET_DROP) {
+			goto drop;
+		}
+
+		return verdict;
+	}
+
 	net_pkt_acknowledge_data(pkt, &ipv4_access);
 
 	if (opts_len) {
@@ -204,4 +204,125 @@ static inline int net_ipv4_parse_hdr_options(struct net_pkt *pkt,
 }
 #endif
 
+#if defined(CONFIG_NET_IPV4_FRAGMENT_MAX_PKT)
+#define NET_IPV4_FRAGMENTS_MAX_PKT CONFIG_NET_IPV4_FRAGMENT_MAX_PKT
+#else
+#define NET_IPV4_FRAGMENTS_MAX_PKT 2
+#endif
+
+/** Data of a pending IPv4 fragment. */
+struct net_ipv4_frag {
+	/** Buffers of the fragment payload, preceded by the IPv4 header
+	 * for the first fragment.
+	 */
+	struct net_buf *buf;
+
+	/** Offset of the fragment in the packet payload */
+	uint16_t offset;
+
+	/** Length of the fragment payload */
+	uint16_t len;
+};
+
+/** Store pending IPv4 fragment information that is needed for reassembly. */
+struct net_ipv4_reassembly {
+	/** IPv4 source address of the fragment */
+	struct in_addr src;
+
+	/** IPv4 destination address of the fragment */
+	struct in_addr dst;
+
+	/** Timeout for cancelling the reassembly. */
+	struct k_work_delayable timer;
+
+	/** Pending fragments, sorted by offset */
+	struct net_ipv4_frag frag[NET_IPV4_FRAGMENTS_MAX_PKT];
+
+	/** Number of pending fragments, the slot is unused when zero */
+	uint8_t count;
+
+	/** IPv4 header length of the first fragment */
+	uint8_t hdr_len;
+
+	/** Protocol of the fragmented packet */
+	uint8_t proto;
+
+	/** Whether the last fragment has been received */
+	bool last;
+
+	/** IPv4 fragment identification */
+	uint16_t id;
+
+	/** Payload length of the packet, known with the last fragment */
+	uint16_t len;
+
+	/** Payload bytes received so far */
+	uint16_t received;
+};
+
+/**
+ * @typedef net_ipv4_frag_cb_t
+ * @brief Callback used while iterating over pending IPv4 fragments.
+ *
+ * @param reass IPv4 fragment reassembly struct
+ * @param user_data A valid pointer on some user data or NULL
+ */
+typedef void (*net_ipv4_frag_cb_t)(struct net_ipv4_reassembly *reass,
+				   void *user_data);
+
+/**
+ * @brief Go through all the currently pending IPv4 fragments.
+ *
+ * @param cb Callback to call for each pending IPv4 fragment.
+ * @param user_data User specified data or NULL.
+ */
+void net_ipv4_frag_foreach(net_ipv4_frag_cb_t cb, void *user_data);
+
+/**
+ * @brief Handles IPv4 fragmented packets.
+ *
+ * @details The data of the fragment is kept and the packet released,
+ * until the last missing fragment is received. The packet is then
+ * reassembled and given to net_ipv4_input().
+ *
+ * @param pkt Network head packet.
+ * @param hdr The IPv4 header of the current packet
+ *
+ * @return Return verdict about the packet
+ */
+#if defined(CONFIG_NET_IPV4_FRAGMENT) && defined(CONFIG_NET_NATIVE_IPV4)
+enum net_verdict net_ipv4_handle_fragment_hdr(struct net_pkt *pkt,
+					      struct net_ipv4_hdr *hdr);
+#else
+static inline
+enum net_verdict net_ipv4_handle_fragment_hdr(struct net_pkt *pkt,
+					      struct net_ipv4_hdr *hdr)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(hdr);
+
+	return NET_DROP;
+}
+#endif /* CONFIG_NET_IPV4_FRAGMENT */
+
+/**
+ * @brief Split an IPv4 packet larger than the MTU of its interface into
+ * fragments and send them.
+ *
+ * @param pkt Network packet
+ *
+ * @return NET_OK if the packet can be sent as it is, NET_CONTINUE if its
+ * fragments were sent and the packet released, NET_DROP otherwise.
+ */
+#if defined(CONFIG_NET_IPV4_FRAGMENT) && defined(CONFIG_NET_NATIVE_IPV4)
+enum net_verdict net_ipv4_prepare_for_send(struct net_pkt *pkt);
+#else
+static inline enum net_verdict net_ipv4_prepare_for_send(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return NET_OK;
+}
+#endif /* CONFIG_NET_IPV4_FRAGMENT */
+
 #endif /* __IPV4_H */
@@ -0,0 +1,622 @@
+/** @file
+ * @brief IPv4 Fragment related functions
+ */
+
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_ipv4, CONFIG_NET_IPV4_LOG_LEVEL);
+
+#include <errno.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_stats.h>
+#include <net/net_context.h>
+#include <random/rand32.h>
+#include "net_private.h"
+#include "ipv4.h"
+#include "net_stats.h"
+
+#define IPV4_REASSEMBLY_TIMEOUT K_SECONDS(CONFIG_NET_IPV4_FRAGMENT_TIMEOUT)
+
+/* Fragment offset, in units of 8 bytes, and flags of the IPv4 header */
+#define IPV4_FRAG_OFFSET_MASK 0x1fff
+#define IPV4_FRAG_MF (NET_IPV4_MF << 13)
+#define IPV4_FRAG_DF (NET_IPV4_DF << 13)
+
+#define BUF_ALLOC_TIMEOUT K_MSEC(100)
+
+static void reassembly_timeout(struct k_work *work);
+static bool reassembly_init_done;
+
+/* The slots are shared by the RX threads and the timeouts run from the
+ * system work queue.
+ */
+static K_MUTEX_DEFINE(reassembly_lock);
+
+static struct net_ipv4_reassembly
+reassembly[CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT];
+
+static void reassembly_init(void)
+{
+	int i;
+
+	/* Static initializing does not work here because of the array
+	 * so we must do it at runtime.
+	 */
+	for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
+		k_work_init_delayable(&reassembly[i].timer,
+				      reassembly_timeout);
+	}
+
+	reassembly_init_done = true;
+}
+
+/* A slot is in use as long as it holds fragments */
+static struct net_ipv4_reassembly *reassembly_get(uint16_t id,
+						  uint8_t proto,
+						  struct in_addr *src,
+						  struct in_addr *dst)
+{
+	int i, avail = -1;
+
+	for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
+		if (reassembly[i].count &&
+		    reassembly[i].id == id &&
+		    reassembly[i].proto == proto &&
+		    net_ipv4_addr_cmp(src, &reassembly[i].src) &&
+		    net_ipv4_addr_cmp(dst, &reassembly[i].dst)) {
+			return &reassembly[i];
+		}
+
+		if (reassembly[i].count) {
+			continue;
+		}
+
+		if (avail < 0) {
+			avail = i;
+		}
+	}
+
+	if (avail < 0) {
+		return NULL;
+	}
+
+	k_work_reschedule(&reassembly[avail].timer, IPV4_REASSEMBLY_TIMEOUT);
+
+	net_ipaddr_copy(&reassembly[avail].src, src);
+	net_ipaddr_copy(&reassembly[avail].dst, dst);
+
+	reassembly[avail].id = id;
+	reassembly[avail].proto = proto;
+	reassembly[avail].len = 0U;
+	reassembly[avail].received = 0U;
+	reassembly[avail].last = false;
+
+	return &reassembly[avail];
+}
+
+static void reassembly_clear(struct net_ipv4_reassembly *reass)
+{
+	int i;
+
+	for (i = 0; i < reass->count; i++) {
+		NET_DBG("[%d] IPv4 reassembly buf %p offset %u len %u", i,
+			reass->frag[i].buf, reass->frag[i].offset,
+			reass->frag[i].len);
+
+		if (reass->frag[i].buf) {
+			net_buf_unref(reass->frag[i].buf);
+			reass->frag[i].buf = NULL;
+		}
+	}
+
+	reass->count = 0U;
+}
+
+static void reassembly_cancel(struct net_ipv4_reassembly *reass)
+{
+	NET_DBG("Cancel 0x%x", reass->id);
+
+	k_work_cancel_delayable(&reass->timer);
+
+	reassembly_clear(reass);
+}
+
+static void reassembly_info(char *str, struct net_ipv4_reassembly *reass)
+{
+	NET_DBG("%s id 0x%x src %s dst %s remain %d ms", str, reass->id,
+		log_strdup(net_sprint_ipv4_addr(&reass->src)),
+		log_strdup(net_sprint_ipv4_addr(&reass->dst)),
+		k_ticks_to_ms_ceil32(
+			k_work_delayable_remaining_get(&reass->timer)));
+}
+
+static void reassembly_timeout(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct net_ipv4_reassembly *reass =
+		CONTAINER_OF(dwork, struct net_ipv4_reassembly, timer);
+
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
+
+	/* The slot might have been completed, or even reused, while this
+	 * was waiting for the lock.
+	 */
+	if (!k_work_delayable_remaining_get(&reass->timer)) {
+		reassembly_info("Reassembly cancelled", reass);
+		reassembly_clear(reass);
+	}
+
+	k_mutex_unlock(&reassembly_lock);
+}
+
+void net_ipv4_frag_foreach(net_ipv4_frag_cb_t cb, void *user_data)
+{
+	int i;
+
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
+
+	for (i = 0; reassembly_init_done &&
+		     i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
+		if (!reassembly[i].count) {
+			continue;
+		}
+
+		cb(&reassembly[i], user_data);
+	}
+
+	k_mutex_unlock(&reassembly_lock);
+}
+
+/* Find where a fragment goes in the list sorted by offset. An exact
+ * duplicate is reported as such, a fragment overlapping the ones already
+ * received makes the whole packet to be discarded.
+ */
+static int fragment_pos(struct net_ipv4_reassembly *reass,
+			uint16_t offset, uint16_t len)
+{
+	struct net_ipv4_frag *frag = reass->frag;
+	int i;
+
+	for (i = 0; i < reass->count; i++) {
+		if (frag[i].offset >= offset) {
+			break;
+		}
+	}
+
+	if (i < reass->count &&
+	    frag[i].offset == offset && frag[i].len == len) {
+		return -EALREADY;
+	}
+
+	if ((i > 0 && frag[i - 1].offset + frag[i - 1].len > offset) ||
+	    (i < reass->count && offset + len > frag[i].offset)) {
+		return -EINVAL;
+	}
+
+	if (reass->count == NET_IPV4_FRAGMENTS_MAX_PKT) {
+		return -ENOMEM;
+	}
+
+	return i;
+}
+
+/* The end of the packet must not move once it is known */
+static bool fragment_end_ok(struct net_ipv4_reassembly *reass,
+			    uint16_t offset, uint16_t len, bool more)
+{
+	struct net_ipv4_frag *last;
+
+	if (reass->last) {
+		return more && offset + len <= reass->len;
+	}
+
+	if (more || !reass->count) {
+		return true;
+	}
+
+	last = &reass->frag[reass->count - 1];
+
+	return last->offset + last->len <= offset + len;
+}
+
+/* Remove the first bytes of a buffer chain and return its new head */
+static struct net_buf *buf_strip(struct net_buf *buf, size_t len)
+{
+	while (buf && len >= buf->len) {
+		len -= buf->len;
+		buf = net_buf_frag_del(NULL, buf);
+	}
+
+	if (buf) {
+		net_buf_pull(buf, len);
+	}
+
+	return buf;
+}
+
+/* Link the data of the fragments, in order, to the given packet. The first
+ * fragment still has the IPv4 header, the other ones only their payload.
+ */
+static void reassemble_packet(struct net_ipv4_reassembly *reass,
+			      struct net_pkt *pkt)
+{
+	struct net_buf *last = NULL;
+	int i;
+
+	k_work_cancel_delayable(&reass->timer);
+
+	NET_ASSERT(reass->frag[0].offset == 0U && !pkt->buffer);
+
+	for (i = 0; i < reass->count; i++) {
+		struct net_buf *buf = reass->frag[i].buf;
+
+		if (!buf) {
+			continue;
+		}
+
+		if (last) {
+			last->frags = buf;
+		} else {
+			pkt->buffer = buf;
+		}
+
+		last = net_buf_frag_last(buf);
+		reass->frag[i].buf = NULL;
+	}
+
+	reass->count = 0U;
+}
+
+static int reassembled_hdr_update(struct net_pkt *pkt, uint8_t hdr_len,
+				  uint16_t len)
+{
+	NET_PKT_DATA_ACCESS_CONTIGUOUS_DEFINE(ipv4_access, struct net_ipv4_hdr);
+	struct net_ipv4_hdr *hdr;
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	hdr = (struct net_ipv4_hdr *)net_pkt_get_data(pkt, &ipv4_access);
+	if (!hdr) {
+		return -ENOBUFS;
+	}
+
+	hdr->len = htons(hdr_len + len);
+	hdr->offset[0] = 0U;
+	hdr->offset[1] = 0U;
+	hdr->chksum = 0U;
+
+	if (net_pkt_set_data(pkt, &ipv4_access)) {
+		return -ENOBUFS;
+	}
+
+	net_pkt_set_ip_hdr_len(pkt, sizeof(struct net_ipv4_hdr));
+	net_pkt_set_ipv4_opts_len(pkt, hdr_len - sizeof(struct net_ipv4_hdr));
+
+	/* The device could not check the payload of the fragments */
+	net_pkt_set_chksum_done(pkt, false);
+
+	if (net_pkt_need_calc_rx_checksum(pkt)) {
+		NET_IPV4_HDR(pkt)->chksum = net_calc_chksum_ipv4(pkt);
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	return 0;
+}
+
+enum net_verdict net_ipv4_handle_fragment_hdr(struct net_pkt *pkt,
+					      struct net_ipv4_hdr *hdr)
+{
+	uint8_t hdr_len = (hdr->vhl & NET_IPV4_IHL_MASK) * 4U;
+	uint16_t flags = (hdr->offset[0] << 8) | hdr->offset[1];
+	uint16_t offset = (flags & IPV4_FRAG_OFFSET_MASK) * 8U;
+	uint16_t id = (hdr->id[0] << 8) | hdr->id[1];
+	uint16_t len = ntohs(hdr->len) - hdr_len;
+	bool more = flags & IPV4_FRAG_MF;
+	struct net_ipv4_reassembly *reass;
+	struct net_buf *buf;
+	int pos;
+
+	/* Every fragment but the last one carries a multiple of 8 bytes,
+	 * and the whole packet must fit in the largest IPv4 packet.
+	 */
+	if ((more && (!len || len % 8U)) ||
+	    (uint32_t)offset + len + hdr_len > UINT16_MAX) {
+		NET_DBG("DROP: invalid fragment offset %u len %u", offset, len);
+		return NET_DROP;
+	}
+
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
+
+	if (!reassembly_init_done) {
+		reassembly_init();
+	}
+
+	reass = reassembly_get(id, hdr->proto, &hdr->src, &hdr->dst);
+	if (!reass) {
+		NET_DBG("Cannot get reassembly slot, dropping pkt %p", pkt);
+		goto drop;
+	}
+
+	pos = fragment_pos(reass, offset, len);
+	if (pos == -EALREADY) {
+		NET_DBG("Duplicate fragment offset %u of 0x%x", offset, id);
+		goto drop;
+	}
+
+	if (pos < 0 || !fragment_end_ok(reass, offset, len, more)) {
+		/* The fragment cannot be added to the ones we saved, the
+		 * whole packet must be discarded at this point.
+		 */
+		NET_DBG("Bad fragment offset %u len %u for 0x%x (%d)",
+			offset, len, id, pos);
+		reassembly_cancel(reass);
+		goto drop;
+	}
+
+	/* The data of the fragment is kept, linked as it is, and the
+	 * packet released. The IPv4 header of the first fragment is the
+	 * one of the reassembled packet.
+	 */
+	buf = pkt->buffer;
+	pkt->buffer = NULL;
+
+	if (offset) {
+		buf = buf_strip(buf, hdr_len);
+	} else {
+		reass->hdr_len = hdr_len;
+	}
+
+	memmove(&reass->frag[pos + 1], &reass->frag[pos],
+		(reass->count - pos) * sizeof(reass->frag[0]));
+
+	reass->frag[pos].buf = buf;
+	reass->frag[pos].offset = offset;
+	reass->frag[pos].len = len;
+	reass->count++;
+	reass->received += len;
+
+	if (!more) {
+		reass->last = true;
+		reass->len = offset + len;
+	}
+
+	/* No overlap is allowed, so once all the bytes are in the whole
+	 * packet is.
+	 */
+	if (!reass->last || reass->received != reass->len) {
+		reassembly_info("Reassembly pkt", reass);
+		k_mutex_unlock(&reassembly_lock);
+
+		net_pkt_unref(pkt);
+
+		return NET_OK;
+	}
+
+	reassembly_info("Reassembly last pkt", reass);
+
+	hdr_len = reass->hdr_len;
+	len = reass->len;
+
+	reassemble_packet(reass, pkt);
+
+	k_mutex_unlock(&reassembly_lock);
+
+	if (reassembled_hdr_update(pkt, hdr_len, len) < 0) {
+		return NET_DROP;
+	}
+
+	NET_DBG("New pkt %p IPv4 len is %d bytes", pkt, hdr_len + len);
+
+	/* The reassembled packet has no link layer header anymore, so it
+	 * is handed over to IPv4 directly instead of going through the
+	 * RX queue again.
+	 */
+	return net_ipv4_input(pkt);
+
+drop:
+	k_mutex_unlock(&reassembly_lock);
+
+	return NET_DROP;
+}
+
+static int send_ipv4_fragment(struct net_pkt *pkt,
+			      uint16_t hdr_len,
+			      uint16_t fit_len,
+			      uint16_t frag_offset,
+			      bool final)
+{
+	NET_PKT_DATA_ACCESS_CONTIGUOUS_DEFINE(ipv4_access, struct net_ipv4_hdr);
+	struct net_ipv4_hdr *ipv4_hdr;
+	struct net_pkt *frag_pkt;
+	uint16_t flags;
+	int ret = -ENOBUFS;
+
+	/* Only the header is written to the buffer of the fragment, its
+	 * payload is then appended from the original packet.
+	 */
+	frag_pkt = net_pkt_alloc_with_buffer(net_pkt_iface(pkt),
+					     net_pkt_ipv4_opts_len(pkt),
+					     AF_INET, 0, BUF_ALLOC_TIMEOUT);
+	if (!frag_pkt) {
+		return -ENOMEM;
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	if (net_pkt_copy(frag_pkt, pkt, hdr_len)) {
+		goto fail;
+	}
+
+	net_pkt_trim_buffer(frag_pkt);
+
+	if (net_pkt_skip(pkt, frag_offset) ||
+	    net_pkt_append_shared(frag_pkt, pkt, fit_len, BUF_ALLOC_TIMEOUT)) {
+		goto fail;
+	}
+
+	net_pkt_set_ip_hdr_len(frag_pkt, net_pkt_ip_hdr_len(pkt));
+	net_pkt_set_ipv4_opts_len(frag_pkt, net_pkt_ipv4_opts_len(pkt));
+	net_pkt_set_priority(frag_pkt, net_pkt_priority(pkt));
+
+	net_pkt_cursor_init(frag_pkt);
+	net_pkt_set_overwrite(frag_pkt, true);
+
+	ipv4_hdr = (struct net_ipv4_hdr *)net_pkt_get_data(frag_pkt,
+							   &ipv4_access);
+	if (!ipv4_hdr) {
+		goto fail;
+	}
+
+	flags = (frag_offset / 8U) | (final ? 0 : IPV4_FRAG_MF);
+
+	ipv4_hdr->offset[0] = flags >> 8;
+	ipv4_hdr->offset[1] = flags;
+	ipv4_hdr->len = htons(hdr_len + fit_len);
+	ipv4_hdr->chksum = 0U;
+
+	if (net_if_need_calc_tx_checksum(net_pkt_iface(frag_pkt))) {
+		ipv4_hdr->chksum = net_calc_chksum_ipv4(frag_pkt);
+	}
+
+	if (net_pkt_set_data(frag_pkt, &ipv4_access)) {
+		goto fail;
+	}
+
+	/* If everything has been ok so far, we can send the packet. */
+	ret = net_send_data(frag_pkt);
+	if (ret < 0) {
+		goto fail;
+	}
+
+	return 0;
+
+fail:
+	NET_DBG("Cannot send fragment (%d)", ret);
+	net_pkt_unref(frag_pkt);
+
+	return ret;
+}
+
+static int send_fragmented_pkt(struct net_pkt *pkt, uint16_t mtu)
+{
+	NET_PKT_DATA_ACCESS_CONTIGUOUS_DEFINE(ipv4_access, struct net_ipv4_hdr);
+	uint16_t hdr_len = net_pkt_ip_hdr_len(pkt) +
+			   net_pkt_ipv4_opts_len(pkt);
+	struct net_ipv4_hdr *ipv4_hdr;
+	uint16_t frag_offset = 0U;
+	uint16_t id;
+	size_t length;
+	uint8_t proto;
+	int fit_len;
+	int ret;
+
+	/* All the fragments but the last one carry a multiple of 8 bytes */
+	fit_len = ((int)mtu - hdr_len) & ~7;
+	if (fit_len <= 0) {
+		NET_DBG("No room for IPv4 payload MTU %d hdr_len %d", mtu,
+			hdr_len);
+		return -EINVAL;
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	ipv4_hdr = (struct net_ipv4_hdr *)net_pkt_get_data(pkt, &ipv4_access);
+	if (!ipv4_hdr) {
+		return -ENOBUFS;
+	}
+
+	id = sys_rand32_get();
+
+	ipv4_hdr->id[0] = id >> 8;
+	ipv4_hdr->id[1] = id;
+	proto = ipv4_hdr->proto;
+
+	if (net_pkt_set_data(pkt, &ipv4_access)) {
+		return -ENOBUFS;
+	}
+
+	if (!net_if_need_calc_tx_checksum(net_pkt_iface(pkt))) {
+		ret = net_fragment_chksum(pkt, proto);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	length = net_pkt_get_len(pkt) - hdr_len;
+	while (length) {
+		bool final = false;
+
+		if (fit_len >= length) {
+			final = true;
+			fit_len = length;
+		}
+
+		ret = send_ipv4_fragment(pkt, hdr_len, fit_len, frag_offset,
+					 final);
+		if (ret < 0) {
+			return ret;
+		}
+
+		length -= fit_len;
+		frag_offset += fit_len;
+	}
+
+	return 0;
+}
+
+enum net_verdict net_ipv4_prepare_for_send(struct net_pkt *pkt)
+{
+	uint16_t mtu = net_if_get_mtu(net_pkt_iface(pkt));
+	struct net_ipv4_hdr *hdr;
+	uint16_t flags;
+	int ret;
+
+	NET_ASSERT(pkt && pkt->buffer);
+
+	if (!mtu || net_pkt_get_len(pkt) <= mtu) {
+		return NET_OK;
+	}
+
+	hdr = NET_IPV4_HDR(pkt);
+	flags = (hdr->offset[0] << 8) | hdr->offset[1];
+
+	if (flags & IPV4_FRAG_DF) {
+		NET_DBG("DROP: pkt %p too big and DF set", pkt);
+		return NET_DROP;
+	}
+
+	/* A packet which is already a fragment is sent as it is */
+	if (flags & (IPV4_FRAG_MF | IPV4_FRAG_OFFSET_MASK)) {
+		return NET_OK;
+	}
+
+	ret = send_fragmented_pkt(pkt, mtu);
+	if (ret < 0) {
+		NET_DBG("Cannot fragment IPv4 pkt (%d)", ret);
+		return NET_DROP;
+	}
+
+	/* We "fake" the sending of the packet here so that
+	 * tcp.c:tcp_retry_expired() will increase the ref
+	 * count when re-sending the packet.
+	 */
+	if (IS_ENABLED(CONFIG_NET_TCP)) {
+		net_pkt_set_sent(pkt, true);
+	}
+
+	/* The packet is now split and its fragments are sent separately,
+	 * so we unref it here as if it had been sent.
+	 */
+	net_pkt_unref(pkt);
+
+	return NET_CONTINUE;
+}
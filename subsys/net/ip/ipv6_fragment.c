@@ -574,7 +574,10 @@ static int send_ipv6_fragment(struct net_pkt *pkt,
 	struct net_ipv6_frag_hdr *frag_hdr;
 	struct net_pkt *frag_pkt;
 
-	frag_pkt = net_pkt_alloc_with_buffer(net_pkt_iface(pkt), fit_len +
+	/* Only the headers are written to the buffer of the fragment, its
+	 * payload is then appended from the original packet.
+	 */
+	frag_pkt = net_pkt_alloc_with_buffer(net_pkt_iface(pkt),
 					     net_pkt_ipv6_ext_len(pkt) +
 					     NET_IPV6_FRAGH_LEN,
 					     AF_INET6, 0, BUF_ALLOC_TIMEOUT);
@@ -619,11 +622,13 @@ static int send_ipv6_fragment(struct net_pkt *pkt,
 				 net_pkt_ipv6_ext_len(pkt) +
 				 sizeof(struct net_ipv6_frag_hdr));
 
-	/* Finally we copy the payload part of this fragment from
-	 * the original packet
+	/* Finally we append the payload part of this fragment, sharing
+	 * the buffers of the original packet when possible.
 	 */
+	net_pkt_trim_buffer(frag_pkt);
+
 	if (net_pkt_skip(pkt, frag_offset) ||
-	    net_pkt_copy(frag_pkt, pkt, fit_len)) {
+	    net_pkt_append_shared(frag_pkt, pkt, fit_len, BUF_ALLOC_TIMEOUT)) {
 		goto fail;
 	}
 
@@ -681,6 +686,13 @@ int net_ipv6_send_fragmented_pkt(struct net_if *iface, struct net_pkt *pkt,
 		return -ENOBUFS;
 	}
 
+	if (!net_if_need_calc_tx_checksum(iface)) {
+		ret = net_fragment_chksum(pkt, next_hdr);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
 	/* The Maximum payload can fit into each packet after IPv6 header,
 	 * Extenstion headers and Fragmentation header.
 	 */
@@ -1237,6 +1237,22 @@ static int get_context_sndtimeo(struct net_context *context,
 #endif
 }
 
+static int get_context_udp_segment(struct net_context *context,
+				   void *value, size_t *len)
+{
+#if defined(CONFIG_NET_CONTEXT_UDP_SEGMENT)
+	*((uint16_t *)value) = context->options.udp_segment;
+
+	if (len) {
+		*len = sizeof(uint16_t);
+	}
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
 /* If buf is not NULL, then use it. Otherwise read the data to be written
  * to net_pkt from msghdr.
  */
@@ -1267,6 +1283,7 @@ static int context_setup_udp_packet(struct net_context *context,
 				    const void *buf,
 				    size_t len,
 				    const struct msghdr *msg,
+				    struct net_buf *frags,
 				    const struct sockaddr *dst_addr,
 				    socklen_t addrlen)
 {
@@ -1308,6 +1325,14 @@ static int context_setup_udp_packet(struct net_context *context,
 		return ret;
 	}
 
+	if (frags) {
+		/* Link the caller's buffers in behind the headers, the
+		 * packet holds a reference of its own on them.
+		 */
+		net_pkt_append_buffer(pkt, net_buf_ref(frags));
+		return 0;
+	}
+
 	ret = context_write_data(pkt, buf, len, msg);
 	if (ret) {
 		return ret;
@@ -1334,6 +1359,45 @@ static void context_finalize_packet(struct net_context *context,
 	}
 }
 
+#if defined(CONFIG_NET_CONTEXT_UDP_SEGMENT)
+/* Write len bytes, starting offset bytes into the data of buf or msghdr */
+static int context_write_data_at(struct net_pkt *pkt, const void *buf,
+				 const struct msghdr *msghdr,
+				 size_t offset, size_t len)
+{
+	int ret;
+	int i;
+
+	if (!msghdr) {
+		return net_pkt_write(pkt, (const uint8_t *)buf + offset, len);
+	}
+
+	for (i = 0; i < msghdr->msg_iovlen && len; i++) {
+		size_t iov_len = msghdr->msg_iov[i].iov_len;
+		size_t chunk;
+
+		if (offset >= iov_len) {
+			offset -= iov_len;
+			continue;
+		}
+
+		chunk = MIN(iov_len - offset, len);
+
+		ret = net_pkt_write(pkt,
+				    (uint8_t *)msghdr->msg_iov[i].iov_base +
+				    offset, chunk);
+		if (ret < 0) {
+			return ret;
+		}
+
+		offset = 0;
+		len -= chunk;
+	}
+
+	return 0;
+}
+#endif /* CONFIG_NET_CONTEXT_UDP_SEGMENT */
+
 static struct net_pkt *context_alloc_pkt(struct net_context *context,
 					 size_t len, k_timeout_t timeout)
 {
@@ -1388,9 +1452,102 @@ static void set_pkt_txtime(struct net_pkt *pkt, const struct msghdr *msghdr)
 	}
 }
 
+#if defined(CONFIG_NET_CONTEXT_UDP_SEGMENT)
+/* Split a send into datagrams of options.udp_segment bytes of payload.
+ * The headers are built once, in a packet which is not sent, and the
+ * datagrams are started from a copy of them.
+ */
+static int context_sendto_udp_segments(struct net_context *context,
+				       const void *buf,
+				       size_t len,
+				       const struct msghdr *msghdr,
+				       const struct sockaddr *dst_addr,
+				       socklen_t addrlen)
+{
+	size_t segment = context->options.udp_segment;
+	struct net_pkt *hdr_pkt;
+	struct net_pkt *pkt;
+	size_t sent = 0;
+	size_t mtu;
+	int ret;
+
+	hdr_pkt = context_alloc_pkt(context, 0, PKT_WAIT_TIME);
+	if (!hdr_pkt) {
+		return -ENOBUFS;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_CONTEXT_PRIORITY)) {
+		uint8_t priority;
+
+		get_context_priority(context, &priority, NULL);
+		net_pkt_set_priority(hdr_pkt, priority);
+	}
+
+	ret = context_setup_udp_packet(context, hdr_pkt, NULL, 0, NULL, NULL,
+				       dst_addr, addrlen);
+	if (ret < 0) {
+		goto out;
+	}
+
+	/* Same limit as for the allocation of the packet buffers */
+	mtu = MAX(net_if_get_mtu(net_pkt_iface(hdr_pkt)),
+		  net_pkt_family(hdr_pkt) == AF_INET6 ?
+		  NET_IPV6_MTU : NET_IPV4_MTU);
+	if (net_pkt_get_len(hdr_pkt) + segment > mtu) {
+		ret = -EINVAL;
+		goto out;
+	}
+
+	while (sent < len) {
+		size_t seg_len = MIN(segment, len - sent);
+
+		pkt = net_udp_segment(hdr_pkt, seg_len, PKT_WAIT_TIME);
+		if (!pkt) {
+			ret = -ENOBUFS;
+			break;
+		}
+
+		if (IS_ENABLED(CONFIG_NET_CONTEXT_TXTIME) && msghdr &&
+		    msghdr->msg_control && msghdr->msg_controllen) {
+			bool is_txtime;
+
+			get_context_txtime(context, &is_txtime, NULL);
+			if (is_txtime) {
+				set_pkt_txtime(pkt, msghdr);
+			}
+		}
+
+		ret = context_write_data_at(pkt, buf, msghdr, sent, seg_len);
+		if (ret < 0) {
+			net_pkt_unref(pkt);
+			break;
+		}
+
+		context_finalize_packet(context, pkt);
+
+		ret = net_send_data(pkt);
+		if (ret < 0) {
+			net_pkt_unref(pkt);
+			break;
+		}
+
+		sent += seg_len;
+	}
+
+out:
+	net_pkt_unref(hdr_pkt);
+
+	/* Like a short write, what was sent is reported and the error
+	 * shows up on the next call.
+	 */
+	return sent ? sent : ret;
+}
+#endif /* CONFIG_NET_CONTEXT_UDP_SEGMENT */
+
 static int context_sendto(struct net_context *context,
 			  const void *buf,
 			  size_t len,
+			  struct net_buf *frags,
 			  const struct sockaddr *dst_addr,
 			  socklen_t addrlen,
 			  net_context_send_cb_t cb,
@@ -1606,15 +1763,50 @@ static int context_sendto(struct net_context *context,
 		return -ENETDOWN;
 	}
 
-	pkt = context_alloc_pkt(context, len, PKT_WAIT_TIME);
+	if (frags) {
+		if ((IS_ENABLED(CONFIG_NET_OFFLOAD) &&
+		     net_if_is_ip_offloaded(iface)) ||
+		    (net_context_get_family(context) != AF_INET &&
+		     net_context_get_family(context) != AF_INET6)) {
+			return -EOPNOTSUPP;
+		}
+
+		len = net_buf_frags_len(frags);
+	}
+
+#if defined(CONFIG_NET_CONTEXT_UDP_SEGMENT)
+	if (!frags && context->options.udp_segment &&
+	    len > context->options.udp_segment &&
+	    net_context_get_ip_proto(context) == IPPROTO_UDP &&
+	    !(IS_ENABLED(CONFIG_NET_OFFLOAD) &&
+	      net_if_is_ip_offloaded(iface))) {
+		context->send_cb = cb;
+		context->user_data = user_data;
+
+		return context_sendto_udp_segments(context, buf, len, msghdr,
+						   dst_addr, addrlen);
+	}
+#endif
+
+	/* With caller provided buffers only the headers need room */
+	pkt = context_alloc_pkt(context, frags ? 0 : len, PKT_WAIT_TIME);
 	if (!pkt) {
 		return -ENOBUFS;
 	}
 
-	tmp_len = net_pkt_available_payload_buffer(
+	if (!frags) {
+		tmp_len = net_pkt_available_payload_buffer(
 				pkt, net_context_get_ip_proto(context));
-	if (tmp_len < len) {
-		len = tmp_len;
+		if (tmp_len < len) {
+			len = tmp_len;
+		}
+	} else if (net_context_get_ip_proto(context) == IPPROTO_UDP &&
+		   net_pkt_max_payload_len(pkt, len, IPPROTO_UDP) < len) {
+		/* Copied data would be cut to that size, but the caller's
+		 * datagram goes whole or not at all.
+		 */
+		net_pkt_unref(pkt);
+		return -EMSGSIZE;
 	}
 
 	context->send_cb = cb;
@@ -1661,7 +1853,7 @@ static int context_sendto(struct net_context *context,
 	} else if (IS_ENABLED(CONFIG_NET_UDP) &&
 	    net_context_get_ip_proto(context) == IPPROTO_UDP) {
 		ret = context_setup_udp_packet(context, pkt, buf, len, msghdr,
-					       dst_addr, addrlen);
+					       frags, dst_addr, addrlen);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1672,9 +1864,21 @@ static int context_sendto(struct net_context *context,
 	} else if (IS_ENABLED(CONFIG_NET_TCP) &&
 		   net_context_get_ip_proto(context) == IPPROTO_TCP) {
 
-		ret = context_write_data(pkt, buf, len, msghdr);
-		if (ret < 0) {
-			goto fail;
+		if (frags) {
+			/* Only the payload is queued, segments get their
+			 * headers when they are sent.
+			 */
+			if (pkt->buffer) {
+				net_buf_unref(pkt->buffer);
+				pkt->buffer = NULL;
+			}
+
+			net_pkt_append_buffer(pkt, net_buf_ref(frags));
+		} else {
+			ret = context_write_data(pkt, buf, len, msghdr);
+			if (ret < 0) {
+				goto fail;
+			}
 		}
 
 		net_pkt_cursor_init(pkt);
@@ -1720,6 +1924,11 @@ static int context_sendto(struct net_context *context,
 		goto fail;
 	}
 
+	if (frags) {
+		/* The stack owns the buffers now */
+		net_buf_unref(frags);
+	}
+
 	return len;
 fail:
 	net_pkt_unref(pkt);
@@ -1762,7 +1971,7 @@ int net_context_send(struct net_context *context,
 		addrlen = 0;
 	}
 
-	ret = context_sendto(context, buf, len, &context->remote,
+	ret = context_sendto(context, buf, len, NULL, &context->remote,
 			     addrlen, cb, timeout, user_data, false);
 unlock:
 	k_mutex_unlock(&context->lock);
@@ -1781,7 +1990,7 @@ int net_context_sendmsg(struct net_context *context,
 
 	k_mutex_lock(&context->lock, K_FOREVER);
 
-	ret = context_sendto(context, msghdr, 0, NULL, 0,
+	ret = context_sendto(context, msghdr, 0, NULL, NULL, 0,
 			     cb, timeout, user_data, true);
 
 	k_mutex_unlock(&context->lock);
@@ -1802,7 +2011,7 @@ int net_context_sendto(struct net_context *context,
 
 	k_mutex_lock(&context->lock, K_FOREVER);
 
-	ret = context_sendto(context, buf, len, dst_addr, addrlen,
+	ret = context_sendto(context, buf, len, NULL, dst_addr, addrlen,
 			     cb, timeout, user_data, true);
 
 	k_mutex_unlock(&context->lock);
@@ -1810,6 +2019,42 @@ int net_context_sendto(struct net_context *context,
 	return ret;
 }
 
+int net_context_send_buf(struct net_context *context,
+			 struct net_buf *frags,
+			 const struct sockaddr *dst_addr,
+			 socklen_t addrlen,
+			 net_context_send_cb_t cb,
+			 k_timeout_t timeout,
+			 void *user_data)
+{
+	int ret;
+
+	if (!frags) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&context->lock, K_FOREVER);
+
+	if (!dst_addr) {
+		if (!(context->flags & NET_CONTEXT_REMOTE_ADDR_SET) ||
+		    !net_sin(&context->remote)->sin_port) {
+			ret = -EDESTADDRREQ;
+			goto unlock;
+		}
+
+		dst_addr = &context->remote;
+		addrlen = net_context_get_family(context) == AF_INET6 ?
+			sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in);
+	}
+
+	ret = context_sendto(context, NULL, 0, frags, dst_addr, addrlen,
+			     cb, timeout, user_data, true);
+unlock:
+	k_mutex_unlock(&context->lock);
+
+	return ret;
+}
+
 enum net_verdict net_context_packet_received(struct net_conn *conn,
 					     struct net_pkt *pkt,
 					     union net_ip_header *ip_hdr,
@@ -2198,6 +2443,26 @@ static int set_context_sndtimeo(struct net_context *context,
 #endif
 }
 
+static int set_context_udp_segment(struct net_context *context,
+				   const void *value, size_t len)
+{
+#if defined(CONFIG_NET_CONTEXT_UDP_SEGMENT)
+	if (len != sizeof(uint16_t)) {
+		return -EINVAL;
+	}
+
+	if (net_context_get_ip_proto(context) != IPPROTO_UDP) {
+		return -EOPNOTSUPP;
+	}
+
+	context->options.udp_segment = *((uint16_t *)value);
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
 int net_context_set_option(struct net_context *context,
 			   enum net_context_option option,
 			   const void *value, size_t len)
@@ -2228,6 +2493,9 @@ int net_context_set_option(struct net_context *context,
 	case NET_OPT_SNDTIMEO:
 		ret = set_context_sndtimeo(context, value, len);
 		break;
+	case NET_OPT_UDP_SEGMENT:
+		ret = set_context_udp_segment(context, value, len);
+		break;
 	}
 
 	k_mutex_unlock(&context->lock);
@@ -2265,6 +2533,9 @@ int net_context_get_option(struct net_context *context,
 	case NET_OPT_SNDTIMEO:
 		ret = get_context_sndtimeo(context, value, len);
 		break;
+	case NET_OPT_UDP_SEGMENT:
+		ret = get_context_udp_segment(context, value, len);
+		break;
 	}
 
 	k_mutex_unlock(&context->lock);
@@ -22,6 +22,7 @@ LOG_MODULE_REGISTER(net_if, CONFIG_NET_IF_LOG_LEVEL);
 #include <net/virtual.h>
 
 #include "net_private.h"
+#include "ipv4.h"
 #include "ipv6.h"
 #include "ipv4_autoconf_internal.h"
 
@@ -459,6 +460,17 @@ enum net_verdict net_if_send_data(struct net_if *iface, struct net_pkt *pkt)
 		net_pkt_lladdr_src(pkt)->len = net_pkt_lladdr_if(pkt)->len;
 	}
 
+	/* IPv4 packets larger than the MTU are sent as fragments, which
+	 * applies to the loopback interface too.
+	 */
+	if (IS_ENABLED(CONFIG_NET_IPV4_FRAGMENT) &&
+	    net_pkt_family(pkt) == AF_INET) {
+		verdict = net_ipv4_prepare_for_send(pkt);
+		if (verdict != NET_OK) {
+			goto done;
+		}
+	}
+
 #if defined(CONFIG_NET_LOOPBACK)
 	/* If the packet is destined back to us, then there is no need to do
 	 * additional checks, so let the packet through.
@@ -35,6 +35,7 @@ LOG_MODULE_REGISTER(net_pkt, CONFIG_NET_PKT_LOG_LEVEL);
 #include <net/net_ip.h>
 #include <net/buf.h>
 #include <net/net_pkt.h>
+#include <net/net_stats.h>
 #include <net/ethernet.h>
 #include <net/udp.h>
 
@@ -128,6 +129,74 @@ NET_BUF_POOL_VAR_DEFINE(tx_bufs, CONFIG_NET_BUF_TX_COUNT,
 
 #endif /* CONFIG_NET_BUF_FIXED_DATA_SIZE */
 
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+/* Usage of the packet slabs, the data pools keep theirs in net_buf */
+struct pkt_slab_usage {
+	atomic_t max_used;
+	atomic_t alloc_failures;
+	uint32_t hold_time_avg;
+};
+
+static struct pkt_slab_usage rx_pkts_usage;
+static struct pkt_slab_usage tx_pkts_usage;
+
+static struct pkt_slab_usage *slab_usage(struct k_mem_slab *slab)
+{
+	if (slab == &rx_pkts) {
+		return &rx_pkts_usage;
+	}
+
+	if (slab == &tx_pkts) {
+		return &tx_pkts_usage;
+	}
+
+	/* Slabs of the contexts are not accounted for */
+	return NULL;
+}
+
+static void slab_usage_alloc(struct k_mem_slab *slab, struct net_pkt *pkt)
+{
+	struct pkt_slab_usage *usage = slab_usage(slab);
+	atomic_val_t used, max_used;
+
+	if (!usage) {
+		return;
+	}
+
+	if (!pkt) {
+		atomic_inc(&usage->alloc_failures);
+		return;
+	}
+
+	used = k_mem_slab_num_used_get(slab);
+
+	do {
+		max_used = atomic_get(&usage->max_used);
+		if (used <= max_used) {
+			break;
+		}
+	} while (!atomic_cas(&usage->max_used, max_used, used));
+
+	pkt->alloc_time = k_cycle_get_32();
+}
+
+static void slab_usage_free(struct net_pkt *pkt)
+{
+	struct pkt_slab_usage *usage = slab_usage(pkt->slab);
+	uint32_t held;
+
+	if (!usage) {
+		return;
+	}
+
+	held = k_cyc_to_us_floor32(k_cycle_get_32() - pkt->alloc_time);
+
+	/* Same lock free moving average as for the net_buf pools */
+	usage->hold_time_avg = usage->hold_time_avg -
+			       (usage->hold_time_avg >> 3) + (held >> 3);
+}
+#endif /* CONFIG_NET_BUF_POOL_USAGE */
+
 /* Allocation tracking is only available if separately enabled */
 #if defined(CONFIG_NET_DEBUG_NET_PKT_ALLOC)
 struct net_pkt_alloc {
@@ -591,6 +660,10 @@ done:
 		net_pkt_cursor_init(pkt);
 	}
 
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+	slab_usage_free(pkt);
+#endif
+
 	k_mem_slab_free(pkt->slab, (void **)&pkt);
 }
 
@@ -834,6 +907,38 @@ void net_pkt_get_info(struct k_mem_slab **rx,
 	}
 }
 
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+static void get_slab_stats(struct k_mem_slab *slab,
+			   struct net_stats_mem_pool *stats)
+{
+	struct pkt_slab_usage *usage = slab_usage(slab);
+
+	stats->count = slab->num_blocks;
+	stats->used = k_mem_slab_num_used_get(slab);
+	stats->max_used = atomic_get(&usage->max_used);
+	stats->alloc_failures = atomic_get(&usage->alloc_failures);
+	stats->hold_time_avg = usage->hold_time_avg;
+}
+
+static void get_pool_stats(struct net_buf_pool *pool,
+			   struct net_stats_mem_pool *stats)
+{
+	stats->count = pool->buf_count;
+	stats->used = pool->buf_count - atomic_get(&pool->avail_count);
+	stats->max_used = atomic_get(&pool->max_used);
+	stats->alloc_failures = atomic_get(&pool->alloc_failures);
+	stats->hold_time_avg = pool->hold_time_avg;
+}
+
+void net_pkt_get_mem_stats(struct net_stats_mem *stats)
+{
+	get_slab_stats(&rx_pkts, &stats->rx_pkts);
+	get_slab_stats(&tx_pkts, &stats->tx_pkts);
+	get_pool_stats(&rx_bufs, &stats->rx_bufs);
+	get_pool_stats(&tx_bufs, &stats->tx_bufs);
+}
+#endif /* CONFIG_NET_BUF_POOL_USAGE */
+
 #if defined(CONFIG_NET_DEBUG_NET_PKT_ALLOC)
 void net_pkt_print(void)
 {
@@ -846,7 +951,105 @@ void net_pkt_print(void)
 
 /* New allocator and API starts here */
 
-#if defined(CONFIG_NET_BUF_FIXED_DATA_SIZE)
+#if defined(CONFIG_NET_BUF_VARIABLE_DATA_SIZE_ADAPTIVE)
+/* Histogram of the data sizes requested from a pool. Bucket i counts
+ * the requests up to NET_PKT_SIZE_HIST_MIN << i bytes, the last one all
+ * the larger requests. The counts are halved every PKT_SIZE_DECAY
+ * requests so that the buffer size follows the traffic.
+ */
+#define PKT_SIZE_MIN NET_PKT_SIZE_HIST_MIN
+#define PKT_SIZE_BUCKETS NET_PKT_SIZE_HIST_BUCKETS
+#define PKT_SIZE_DECAY 256U
+
+struct pkt_size_hist {
+	struct k_spinlock lock;
+	uint16_t count[PKT_SIZE_BUCKETS];
+	uint16_t total;
+	uint16_t buf_size;
+};
+
+static struct pkt_size_hist rx_sizes;
+static struct pkt_size_hist tx_sizes;
+
+static struct pkt_size_hist *pool_size_hist(struct net_buf_pool *pool)
+{
+	return pool == &rx_bufs ? &rx_sizes : &tx_sizes;
+}
+
+/* Smallest bucket size covering CONFIG_NET_BUF_DATA_SIZE_COVERAGE percent
+ * of the requests.
+ */
+static uint16_t pkt_size_hist_buf_size(struct pkt_size_hist *hist)
+{
+	uint32_t covered = 0U;
+	int i;
+
+	for (i = 0; i < PKT_SIZE_BUCKETS - 1; i++) {
+		covered += hist->count[i];
+		if (covered * 100U >=
+		    (uint32_t)hist->total * CONFIG_NET_BUF_DATA_SIZE_COVERAGE) {
+			break;
+		}
+	}
+
+	return PKT_SIZE_MIN << i;
+}
+
+/* Account for a request and return the size of the buffers to split it in,
+ * 0 meaning that it is allocated in one buffer.
+ */
+static size_t pkt_size_learn(struct net_buf_pool *pool, size_t size)
+{
+	struct pkt_size_hist *hist = pool_size_hist(pool);
+	k_spinlock_key_t key;
+	size_t buf_size;
+	int i;
+
+	for (i = 0; i < PKT_SIZE_BUCKETS - 1; i++) {
+		if (size <= (PKT_SIZE_MIN << i)) {
+			break;
+		}
+	}
+
+	key = k_spin_lock(&hist->lock);
+
+	hist->count[i]++;
+
+	if (++hist->total >= PKT_SIZE_DECAY) {
+		hist->total = 0U;
+
+		for (i = 0; i < PKT_SIZE_BUCKETS; i++) {
+			hist->count[i] /= 2U;
+			hist->total += hist->count[i];
+		}
+
+		hist->buf_size = pkt_size_hist_buf_size(hist);
+	}
+
+	buf_size = hist->buf_size;
+
+	k_spin_unlock(&hist->lock, key);
+
+	return buf_size;
+}
+
+void net_pkt_get_size_hist(bool tx, uint16_t count[NET_PKT_SIZE_HIST_BUCKETS],
+			   size_t *buf_size)
+{
+	struct pkt_size_hist *hist = tx ? &tx_sizes : &rx_sizes;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&hist->lock);
+
+	memcpy(count, hist->count, sizeof(hist->count));
+	*buf_size = hist->buf_size;
+
+	k_spin_unlock(&hist->lock, key);
+}
+#endif /* CONFIG_NET_BUF_VARIABLE_DATA_SIZE_ADAPTIVE */
+
+#if defined(CONFIG_NET_BUF_FIXED_DATA_SIZE) || \
+	defined(CONFIG_NET_BUF_VARIABLE_DATA_SIZE_ADAPTIVE)
 
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
 static struct net_buf *pkt_alloc_buffer(struct net_buf_pool *pool,
@@ -860,11 +1063,19 @@ static struct net_buf *pkt_alloc_buffer(struct net_buf_pool *pool,
 	uint64_t end = sys_clock_timeout_end_calc(timeout);
 	struct net_buf *first = NULL;
 	struct net_buf *current = NULL;
+#if defined(CONFIG_NET_BUF_VARIABLE_DATA_SIZE_ADAPTIVE)
+	size_t buf_size = pkt_size_learn(pool, size);
+#endif
 
 	while (size) {
 		struct net_buf *new;
 
+#if defined(CONFIG_NET_BUF_FIXED_DATA_SIZE)
 		new = net_buf_alloc_fixed(pool, timeout);
+#else
+		new = net_buf_alloc_len(pool, buf_size ? MIN(size, buf_size) :
+					size, timeout);
+#endif
 		if (!new) {
 			goto error;
 		}
@@ -913,7 +1124,8 @@ error:
 	return NULL;
 }
 
-#else /* !CONFIG_NET_BUF_FIXED_DATA_SIZE */
+#else /* !CONFIG_NET_BUF_FIXED_DATA_SIZE &&
+	 !CONFIG_NET_BUF_VARIABLE_DATA_SIZE_ADAPTIVE */
 
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
 static struct net_buf *pkt_alloc_buffer(struct net_buf_pool *pool,
@@ -941,7 +1153,8 @@ static struct net_buf *pkt_alloc_buffer(struct net_buf_pool *pool,
 	return buf;
 }
 
-#endif /* CONFIG_NET_BUF_FIXED_DATA_SIZE */
+#endif /* CONFIG_NET_BUF_FIXED_DATA_SIZE ||
+	  CONFIG_NET_BUF_VARIABLE_DATA_SIZE_ADAPTIVE */
 
 static size_t pkt_buffer_length(struct net_pkt *pkt,
 				size_t size,
@@ -968,6 +1181,13 @@ static size_t pkt_buffer_length(struct net_pkt *pkt,
 
 		max_len = MAX(max_len, NET_IPV6_MTU);
 	} else if (IS_ENABLED(CONFIG_NET_IPV4) && family == AF_INET) {
+		if (IS_ENABLED(CONFIG_NET_IPV4_FRAGMENT) && (size > max_len)) {
+			/* We support larger packets if IPv4 fragmentation is
+			 * enabled, up to the largest IPv4 datagram.
+			 */
+			max_len = MIN(size, UINT16_MAX);
+		}
+
 		max_len = MAX(max_len, NET_IPV4_MTU);
 	} else { /* family == AF_UNSPEC */
 #if defined (CONFIG_NET_L2_ETHERNET)
@@ -1062,6 +1282,20 @@ size_t net_pkt_available_payload_buffer(struct net_pkt *pkt,
 	return len;
 }
 
+size_t net_pkt_max_payload_len(struct net_pkt *pkt, size_t size,
+			       enum net_ip_protocol proto)
+{
+	size_t hdr_len;
+
+	if (!pkt) {
+		return 0;
+	}
+
+	hdr_len = pkt_estimate_headers_length(pkt, net_pkt_family(pkt), proto);
+
+	return pkt_buffer_length(pkt, size + hdr_len, proto, 0) - hdr_len;
+}
+
 void net_pkt_trim_buffer(struct net_pkt *pkt)
 {
 	struct net_buf *buf, *prev;
@@ -1198,6 +1432,9 @@ static struct net_pkt *pkt_alloc(struct k_mem_slab *slab, k_timeout_t timeout)
 
 	ret = k_mem_slab_alloc(slab, (void **)&pkt, timeout);
 	if (ret) {
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+		slab_usage_alloc(slab, NULL);
+#endif
 		return NULL;
 	}
 
@@ -1235,6 +1472,10 @@ static struct net_pkt *pkt_alloc(struct k_mem_slab *slab, k_timeout_t timeout)
 
 	net_pkt_set_vlan_tag(pkt, NET_VLAN_TAG_UNSPEC);
 
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+	slab_usage_alloc(slab, pkt);
+#endif
+
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
 	net_pkt_alloc_add(pkt, true, caller, line);
 #endif
@@ -1729,6 +1970,63 @@ int net_pkt_copy(struct net_pkt *pkt_dst,
 	return 0;
 }
 
+int net_pkt_append_shared(struct net_pkt *pkt,
+			  struct net_pkt *pkt_src,
+			  size_t length,
+			  k_timeout_t timeout)
+{
+	struct net_pkt_cursor *c_src = &pkt_src->cursor;
+	struct net_buf *last = pkt->buffer ?
+		net_buf_frag_last(pkt->buffer) : NULL;
+
+	while (c_src->buf && length) {
+		struct net_buf *clone;
+		size_t offset, len;
+
+		pkt_cursor_advance(pkt_src, false);
+
+		if (!c_src->buf) {
+			break;
+		}
+
+		offset = c_src->pos - c_src->buf->data;
+		len = MIN(length, c_src->buf->len - offset);
+		if (!len) {
+			break;
+		}
+
+		/* The clone refers to the data of the buffer when its pool
+		 * allows it, and gets a copy of it otherwise.
+		 */
+		clone = net_buf_clone(c_src->buf, timeout);
+		if (!clone) {
+			return -ENOBUFS;
+		}
+
+		net_buf_pull(clone, offset);
+		clone->len = len;
+
+		if (last) {
+			net_buf_frag_insert(last, clone);
+		} else {
+			pkt->buffer = clone;
+		}
+
+		last = clone;
+
+		pkt_cursor_update(pkt_src, len, false);
+
+		length -= len;
+	}
+
+	if (length) {
+		NET_DBG("Still some length to go %zu", length);
+		return -ENOBUFS;
+	}
+
+	return 0;
+}
+
 static void clone_pkt_attributes(struct net_pkt *pkt, struct net_pkt *clone_pkt)
 {
 	net_pkt_set_family(clone_pkt, net_pkt_family(pkt));
@@ -1739,6 +2037,7 @@ static void clone_pkt_attributes(struct net_pkt *pkt, struct net_pkt *clone_pkt)
 	net_pkt_set_priority(clone_pkt, net_pkt_priority(pkt));
 	net_pkt_set_orig_iface(clone_pkt, net_pkt_orig_iface(pkt));
 	net_pkt_set_captured(clone_pkt, net_pkt_is_captured(pkt));
+	net_pkt_set_chksum_done(clone_pkt, net_pkt_is_chksum_done(pkt));
 
 	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
 		net_pkt_set_ipv4_ttl(clone_pkt, net_pkt_ipv4_ttl(pkt));
@@ -143,6 +143,7 @@ extern char *net_byte_to_hex(char *ptr, uint8_t byte, char base, bool pad);
 extern char *net_sprint_ll_addr_buf(const uint8_t *ll, uint8_t ll_len,
 				    char *buf, int buflen);
 extern uint16_t net_calc_chksum(struct net_pkt *pkt, uint8_t proto);
+extern int net_fragment_chksum(struct net_pkt *pkt, uint8_t proto);
 
 /**
  * @brief Deliver the incoming packet through the recv_cb of the net_context
@@ -203,6 +204,15 @@ static inline uint16_t net_calc_chksum_tcp(struct net_pkt *pkt)
 	return net_calc_chksum(pkt, IPPROTO_TCP);
 }
 
+/* The checksums of an incoming packet are checked by the stack unless the
+ * interface verifies them all, or its device did it for this packet.
+ */
+static inline bool net_pkt_need_calc_rx_checksum(struct net_pkt *pkt)
+{
+	return net_if_need_calc_rx_checksum(net_pkt_iface(pkt)) &&
+	       !net_pkt_is_chksum_done(pkt);
+}
+
 static inline char *net_sprint_ll_addr(const uint8_t *ll, uint8_t ll_len)
 {
 	static char buf[sizeof("xx:xx:xx:xx:xx:xx:xx:xx")];
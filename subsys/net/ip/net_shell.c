@@ -37,6 +37,7 @@ LOG_MODULE_REGISTER(net_shell, LOG_LEVEL_DBG);
 #include <sys/slist.h>
 #endif
 
+#include "ipv4.h"
 #include "ipv6.h"
 
 #if defined(CONFIG_NET_ARP)
@@ -1597,6 +1598,49 @@ static void ipv6_frag_cb(struct net_ipv6_reassembly *reass,
 }
 #endif /* CONFIG_NET_IPV6_FRAGMENT */
 
+#if defined(CONFIG_NET_IPV4_FRAGMENT)
+static void ipv4_frag_cb(struct net_ipv4_reassembly *reass,
+			 void *user_data)
+{
+	struct net_shell_user_data *data = user_data;
+	const struct shell *shell = data->shell;
+	int *count = data->user_data;
+	char src[ADDR_LEN];
+	int i;
+
+	if (!*count) {
+		PR("\nIPv4 reassembly Id     Remain "
+		   "Src             \tDst\n");
+	}
+
+	snprintk(src, ADDR_LEN, "%s", net_sprint_ipv4_addr(&reass->src));
+
+	PR("%p      0x%04x  %5d %16s\t%16s\n", reass, reass->id,
+	   k_ticks_to_ms_ceil32(k_work_delayable_remaining_get(&reass->timer)),
+	   src, net_sprint_ipv4_addr(&reass->dst));
+
+	for (i = 0; i < reass->count; i++) {
+		struct net_buf *frag = reass->frag[i].buf;
+
+		PR("[%d] offset %5u len %5u ", i, reass->frag[i].offset,
+		   reass->frag[i].len);
+
+		while (frag) {
+			PR("%p", frag);
+
+			frag = frag->frags;
+			if (frag) {
+				PR("->");
+			}
+		}
+
+		PR("\n");
+	}
+
+	(*count)++;
+}
+#endif /* CONFIG_NET_IPV4_FRAGMENT */
+
 #if defined(CONFIG_NET_DEBUG_NET_PKT_ALLOC)
 static void allocs_cb(struct net_pkt *pkt,
 		      struct net_buf *buf,
@@ -2071,6 +2115,15 @@ static int cmd_net_conn(const struct shell *shell, size_t argc, char *argv[])
 	/* Do not print anything if no fragments are pending atm */
 #endif
 
+#if defined(CONFIG_NET_IPV4_FRAGMENT)
+	count = 0;
+	user_data.user_data = &count;
+
+	net_ipv4_frag_foreach(ipv4_frag_cb, &user_data);
+
+	/* Do not print anything if no fragments are pending atm */
+#endif
+
 #else
 	PR_INFO("Set %s to enable %s support.\n",
 		"CONFIG_NET_OFFLOAD or CONFIG_NET_NATIVE",
@@ -3644,6 +3697,31 @@ static void context_info(struct net_context *context, void *user_data)
 }
 #endif /* CONFIG_NET_OFFLOAD || CONFIG_NET_NATIVE */
 
+#if defined(CONFIG_NET_BUF_VARIABLE_DATA_SIZE_ADAPTIVE)
+static void print_size_hist(const struct shell *shell, bool tx)
+{
+	uint16_t count[NET_PKT_SIZE_HIST_BUCKETS];
+	size_t buf_size;
+	int i;
+
+	net_pkt_get_size_hist(tx, count, &buf_size);
+
+	PR("\n%s DATA request sizes:\n", tx ? "TX" : "RX");
+
+	for (i = 0; i < NET_PKT_SIZE_HIST_BUCKETS - 1; i++) {
+		PR("<= %u\t%u\n", NET_PKT_SIZE_HIST_MIN << i, count[i]);
+	}
+
+	PR(" > %u\t%u\n", NET_PKT_SIZE_HIST_MIN << (i - 1), count[i]);
+
+	if (buf_size) {
+		PR("Buffer size %zu bytes\n", buf_size);
+	} else {
+		PR("Buffer size not learned yet\n");
+	}
+}
+#endif /* CONFIG_NET_BUF_VARIABLE_DATA_SIZE_ADAPTIVE */
+
 static int cmd_net_mem(const struct shell *shell, size_t argc, char *argv[])
 {
 	ARG_UNUSED(argc);
@@ -3660,21 +3738,29 @@ static int cmd_net_mem(const struct shell *shell, size_t argc, char *argv[])
 	PR("Network buffer pools:\n");
 
 #if defined(CONFIG_NET_BUF_POOL_USAGE)
-	PR("Address\t\tTotal\tAvail\tName\n");
+	struct net_stats_mem mem;
+
+	net_pkt_get_mem_stats(&mem);
 
-	PR("%p\t%d\t%u\tRX\n",
-	       rx, rx->num_blocks, k_mem_slab_num_free_get(rx));
+	PR("Address\t\tTotal\tAvail\tPeak\tFail\tHeld us\tName\n");
 
-	PR("%p\t%d\t%u\tTX\n",
-	       tx, tx->num_blocks, k_mem_slab_num_free_get(tx));
+	PR("%p\t%u\t%u\t%u\t%u\t%u\tRX\n", rx, mem.rx_pkts.count,
+	   mem.rx_pkts.count - mem.rx_pkts.used, mem.rx_pkts.max_used,
+	   mem.rx_pkts.alloc_failures, mem.rx_pkts.hold_time_avg);
 
-	PR("%p\t%d\t%d\tRX DATA (%s)\n",
-	       rx_data, rx_data->buf_count,
-	       atomic_get(&rx_data->avail_count), rx_data->name);
+	PR("%p\t%u\t%u\t%u\t%u\t%u\tTX\n", tx, mem.tx_pkts.count,
+	   mem.tx_pkts.count - mem.tx_pkts.used, mem.tx_pkts.max_used,
+	   mem.tx_pkts.alloc_failures, mem.tx_pkts.hold_time_avg);
 
-	PR("%p\t%d\t%d\tTX DATA (%s)\n",
-	       tx_data, tx_data->buf_count,
-	       atomic_get(&tx_data->avail_count), tx_data->name);
+	PR("%p\t%u\t%u\t%u\t%u\t%u\tRX DATA (%s)\n", rx_data,
+	   mem.rx_bufs.count, mem.rx_bufs.count - mem.rx_bufs.used,
+	   mem.rx_bufs.max_used, mem.rx_bufs.alloc_failures,
+	   mem.rx_bufs.hold_time_avg, rx_data->name);
+
+	PR("%p\t%u\t%u\t%u\t%u\t%u\tTX DATA (%s)\n", tx_data,
+	   mem.tx_bufs.count, mem.tx_bufs.count - mem.tx_bufs.used,
+	   mem.tx_bufs.max_used, mem.tx_bufs.alloc_failures,
+	   mem.tx_bufs.hold_time_avg, tx_data->name);
 #else
 	PR("Address\t\tTotal\tName\n");
 
@@ -3686,6 +3772,11 @@ static int cmd_net_mem(const struct shell *shell, size_t argc, char *argv[])
 		"CONFIG_NET_BUF_POOL_USAGE", "net_buf allocation");
 #endif /* CONFIG_NET_BUF_POOL_USAGE */
 
+#if defined(CONFIG_NET_BUF_VARIABLE_DATA_SIZE_ADAPTIVE)
+	print_size_hist(shell, false);
+	print_size_hist(shell, true);
+#endif
+
 	if (IS_ENABLED(CONFIG_NET_CONTEXT_NET_PKT_POOL)) {
 		struct net_shell_user_data user_data;
 		struct ctx_info info;
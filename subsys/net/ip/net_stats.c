@@ -302,6 +302,16 @@ static int net_stats_get(uint32_t mgmt_request, struct net_if *iface,
 		len_chk = sizeof(struct net_stats_pm);
 		src = GET_STAT_ADDR(iface, pm);
 		break;
+#endif
+#if defined(CONFIG_NET_STATISTICS_MEMORY)
+	case NET_REQUEST_STATS_CMD_GET_MEM:
+		/* The pools are shared by all the interfaces */
+		if (len != sizeof(struct net_stats_mem)) {
+			return -EINVAL;
+		}
+
+		net_pkt_get_mem_stats(data);
+		return 0;
 #endif
 	}
 
@@ -361,6 +371,11 @@ NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PM,
 				  net_stats_get);
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_MEMORY)
+NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_STATS_GET_MEM,
+				  net_stats_get);
+#endif
+
 #endif /* CONFIG_NET_STATISTICS_USER_API */
 
 void net_stats_reset(struct net_if *iface)
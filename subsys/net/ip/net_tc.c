@@ -13,31 +13,47 @@ LOG_MODULE_REGISTER(net_tc, CONFIG_NET_TC_LOG_LEVEL);
 #include <net/net_core.h>
 #include <net/net_pkt.h>
 #include <net/net_stats.h>
+#include <net/ethernet.h>
 
 #include "net_private.h"
 #include "net_stats.h"
 #include "net_tc_mapping.h"
 
+#if defined(CONFIG_NET_TC_TX_QUEUES)
+#define NET_TC_TX_QUEUES CONFIG_NET_TC_TX_QUEUES
+#else
+#define NET_TC_TX_QUEUES 1
+#endif
+
+#if defined(CONFIG_NET_TC_RX_QUEUES)
+#define NET_TC_RX_QUEUES CONFIG_NET_TC_RX_QUEUES
+#else
+#define NET_TC_RX_QUEUES 1
+#endif
+
 /* Template for thread name. The "xx" is either "TX" denoting transmit thread,
  * or "RX" denoting receive thread. The "q[y]" denotes the traffic class queue
  * where y indicates the traffic class id. The value of y can be from 0 to 7.
+ * If a traffic class has several queues, the name is "q[y.z]" where z is the
+ * queue of the class, from 0 to 7.
  */
-#define MAX_NAME_LEN sizeof("xx_q[y]")
+#define MAX_NAME_LEN sizeof("xx_q[y.z]")
 
 /* Stacks for TX work queue */
-K_KERNEL_STACK_ARRAY_DEFINE(tx_stack, NET_TC_TX_COUNT,
+K_KERNEL_STACK_ARRAY_DEFINE(tx_stack, NET_TC_TX_COUNT * NET_TC_TX_QUEUES,
 			    CONFIG_NET_TX_STACK_SIZE);
 
 /* Stacks for RX work queue */
-K_KERNEL_STACK_ARRAY_DEFINE(rx_stack, NET_TC_RX_COUNT,
+K_KERNEL_STACK_ARRAY_DEFINE(rx_stack, NET_TC_RX_COUNT * NET_TC_RX_QUEUES,
 			    CONFIG_NET_RX_STACK_SIZE);
 
+/* The queues of traffic class tc are at index tc * NET_TC_xX_QUEUES onwards */
 #if NET_TC_TX_COUNT > 0
-static struct net_traffic_class tx_classes[NET_TC_TX_COUNT];
+static struct net_traffic_class tx_classes[NET_TC_TX_COUNT * NET_TC_TX_QUEUES];
 #endif
 
 #if NET_TC_RX_COUNT > 0
-static struct net_traffic_class rx_classes[NET_TC_RX_COUNT];
+static struct net_traffic_class rx_classes[NET_TC_RX_COUNT * NET_TC_RX_QUEUES];
 #endif
 
 #if NET_TC_RX_COUNT > 0 || NET_TC_TX_COUNT > 0
@@ -47,12 +63,167 @@ static void submit_to_queue(struct k_fifo *queue, struct net_pkt *pkt)
 }
 #endif
 
+#if (NET_TC_TX_COUNT > 0 && NET_TC_TX_QUEUES > 1) || \
+	(NET_TC_RX_COUNT > 0 && NET_TC_RX_QUEUES > 1)
+static inline uint32_t flow_hash_mix(uint32_t hash, const uint8_t *data,
+				     size_t len)
+{
+	for (; len >= sizeof(uint32_t); len -= sizeof(uint32_t)) {
+		hash = (hash ^ UNALIGNED_GET((uint32_t *)data)) * 0x9e3779b1U;
+		data += sizeof(uint32_t);
+	}
+
+	return hash;
+}
+
+/* Hash the addresses, the protocol and the ports of the IP packet at the
+ * cursor, so that all the packets of a flow get the same value. Fragments
+ * are hashed without the ports which only the first one carries, as are
+ * the packets whose transport header follows IPv6 extension headers.
+ */
+static uint32_t flow_hash_ip(struct net_pkt *pkt)
+{
+	union {
+		struct net_ipv4_hdr ipv4;
+		struct net_ipv6_hdr ipv6;
+	} hdr;
+	const uint8_t *addr;
+	size_t addr_len, opts_len = 0;
+	bool has_ports = true;
+	uint32_t ports = 0U;
+	uint8_t proto;
+
+	if (net_pkt_read_u8(pkt, &hdr.ipv4.vhl)) {
+		return 0U;
+	}
+
+	switch (hdr.ipv4.vhl >> 4) {
+	case 4:
+		if (net_pkt_read(pkt, (uint8_t *)&hdr.ipv4 + 1,
+				 sizeof(hdr.ipv4) - 1)) {
+			return 0U;
+		}
+
+		proto = hdr.ipv4.proto;
+		addr = (const uint8_t *)&hdr.ipv4.src;
+		addr_len = 2 * sizeof(struct in_addr);
+		opts_len = (hdr.ipv4.vhl & 0x0f) * 4U - sizeof(hdr.ipv4);
+		has_ports = !(hdr.ipv4.offset[0] & 0x3f) &&
+			    !hdr.ipv4.offset[1];
+		break;
+	case 6:
+		if (net_pkt_read(pkt, (uint8_t *)&hdr.ipv6 + 1,
+				 sizeof(hdr.ipv6) - 1)) {
+			return 0U;
+		}
+
+		proto = hdr.ipv6.nexthdr;
+		addr = (const uint8_t *)&hdr.ipv6.src;
+		addr_len = 2 * sizeof(struct in6_addr);
+		break;
+	default:
+		return 0U;
+	}
+
+	if (has_ports && (proto == IPPROTO_UDP || proto == IPPROTO_TCP) &&
+	    !net_pkt_skip(pkt, opts_len)) {
+		(void)net_pkt_read_be32(pkt, &ports);
+	}
+
+	return flow_hash_mix(proto ^ ports, addr, addr_len);
+}
+
+/* Pick the queue of a traffic class for a packet. The cursor of the packet
+ * is left untouched.
+ */
+static int flow_queue(struct net_pkt *pkt, int queues,
+		      uint32_t (*flow_hash)(struct net_pkt *pkt))
+{
+	bool overwrite = net_pkt_is_being_overwritten(pkt);
+	struct net_pkt_cursor backup;
+	uint32_t hash;
+
+	net_pkt_cursor_backup(pkt, &backup);
+	net_pkt_set_overwrite(pkt, true);
+	net_pkt_cursor_init(pkt);
+
+	hash = flow_hash(pkt);
+
+	net_pkt_cursor_restore(pkt, &backup);
+	net_pkt_set_overwrite(pkt, overwrite);
+
+	return (hash ^ (hash >> 16)) % queues;
+}
+#endif
+
+#if NET_TC_TX_COUNT > 0 && NET_TC_TX_QUEUES > 1
+/* The link layer header is only added once the packet leaves its queue */
+static uint32_t tx_flow_hash(struct net_pkt *pkt)
+{
+	if (net_pkt_family(pkt) != AF_INET && net_pkt_family(pkt) != AF_INET6) {
+		return 0U;
+	}
+
+	return flow_hash_ip(pkt);
+}
+#endif
+
+#if NET_TC_RX_COUNT > 0 && NET_TC_RX_QUEUES > 1
+/* Received packets still have their link layer header. Only the links
+ * whose header does not vary within a flow are looked into, the others
+ * are handled by the first queue of the class.
+ */
+static uint32_t rx_flow_hash(struct net_pkt *pkt)
+{
+	const struct net_l2 *l2 = net_if_l2(net_pkt_iface(pkt));
+
+#if defined(CONFIG_NET_L2_DUMMY)
+	if (l2 == &NET_L2_GET_NAME(DUMMY)) {
+		return flow_hash_ip(pkt);
+	}
+#endif
+
+#if defined(CONFIG_NET_L2_ETHERNET)
+	if (l2 == &NET_L2_GET_NAME(ETHERNET)) {
+		uint16_t type;
+
+		if (net_pkt_skip(pkt, 2 * sizeof(struct net_eth_addr)) ||
+		    net_pkt_read_be16(pkt, &type)) {
+			return 0U;
+		}
+
+		if (type == NET_ETH_PTYPE_VLAN &&
+		    (net_pkt_skip(pkt, sizeof(uint16_t)) ||
+		     net_pkt_read_be16(pkt, &type))) {
+			return 0U;
+		}
+
+		if (type != NET_ETH_PTYPE_IP && type != NET_ETH_PTYPE_IPV6) {
+			return 0U;
+		}
+
+		return flow_hash_ip(pkt);
+	}
+#endif
+
+	ARG_UNUSED(l2);
+
+	return 0U;
+}
+#endif
+
 bool net_tc_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt)
 {
 #if NET_TC_TX_COUNT > 0
+	int queue = tc * NET_TC_TX_QUEUES;
+
+#if NET_TC_TX_QUEUES > 1
+	queue += flow_queue(pkt, NET_TC_TX_QUEUES, tx_flow_hash);
+#endif
+
 	net_pkt_set_tx_stats_tick(pkt, k_cycle_get_32());
 
-	submit_to_queue(&tx_classes[tc].fifo, pkt);
+	submit_to_queue(&tx_classes[queue].fifo, pkt);
 #else
 	ARG_UNUSED(tc);
 	ARG_UNUSED(pkt);
@@ -63,9 +234,15 @@ bool net_tc_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt)
 void net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt)
 {
 #if NET_TC_RX_COUNT > 0
+	int queue = tc * NET_TC_RX_QUEUES;
+
+#if NET_TC_RX_QUEUES > 1
+	queue += flow_queue(pkt, NET_TC_RX_QUEUES, rx_flow_hash);
+#endif
+
 	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
 
-	submit_to_queue(&rx_classes[tc].fifo, pkt);
+	submit_to_queue(&rx_classes[queue].fifo, pkt);
 #else
 	ARG_UNUSED(tc);
 	ARG_UNUSED(pkt);
@@ -268,8 +445,24 @@ static void tc_tx_handler(struct k_fifo *fifo)
 }
 #endif
 
-/* Create a fifo for each traffic class we are using. All the network
- * traffic goes through these classes.
+#if NET_TC_RX_COUNT > 0 || NET_TC_TX_COUNT > 0
+/* Spread the queues of a traffic class over the CPUs, so that the flows
+ * hashed onto different queues are processed in parallel.
+ */
+static void pin_queue(k_tid_t tid, int queue)
+{
+#if defined(CONFIG_NET_TC_QUEUE_CPU_PIN)
+	(void)k_thread_cpu_mask_clear(tid);
+	(void)k_thread_cpu_mask_enable(tid, queue % CONFIG_MP_NUM_CPUS);
+#else
+	ARG_UNUSED(tid);
+	ARG_UNUSED(queue);
+#endif
+}
+#endif
+
+/* Create a fifo for each queue of the traffic classes we are using. All the
+ * network traffic goes through these classes.
  */
 void net_tc_tx_init(void)
 {
@@ -285,12 +478,13 @@ void net_tc_tx_init(void)
 	net_if_foreach(net_tc_tx_stats_priority_setup, NULL);
 #endif
 
-	for (i = 0; i < NET_TC_TX_COUNT; i++) {
+	for (i = 0; i < NET_TC_TX_COUNT * NET_TC_TX_QUEUES; i++) {
+		int tc = i / NET_TC_TX_QUEUES;
 		uint8_t thread_priority;
 		int priority;
 		k_tid_t tid;
 
-		thread_priority = tx_tc2thread(i);
+		thread_priority = tx_tc2thread(tc);
 
 		priority = IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE) ?
 			K_PRIO_COOP(thread_priority) :
@@ -320,10 +514,18 @@ void net_tc_tx_init(void)
 		if (IS_ENABLED(CONFIG_THREAD_NAME)) {
 			char name[MAX_NAME_LEN];
 
-			snprintk(name, sizeof(name), "tx_q[%d]", i);
+			if (NET_TC_TX_QUEUES > 1) {
+				snprintk(name, sizeof(name), "tx_q[%d.%d]", tc,
+					 i % NET_TC_TX_QUEUES);
+			} else {
+				snprintk(name, sizeof(name), "tx_q[%d]", tc);
+			}
+
 			k_thread_name_set(tid, name);
 		}
 
+		pin_queue(tid, i % NET_TC_TX_QUEUES);
+
 		k_thread_start(tid);
 	}
 #endif
@@ -343,12 +545,13 @@ void net_tc_rx_init(void)
 	net_if_foreach(net_tc_rx_stats_priority_setup, NULL);
 #endif
 
-	for (i = 0; i < NET_TC_RX_COUNT; i++) {
+	for (i = 0; i < NET_TC_RX_COUNT * NET_TC_RX_QUEUES; i++) {
+		int tc = i / NET_TC_RX_QUEUES;
 		uint8_t thread_priority;
 		int priority;
 		k_tid_t tid;
 
-		thread_priority = rx_tc2thread(i);
+		thread_priority = rx_tc2thread(tc);
 
 		priority = IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE) ?
 			K_PRIO_COOP(thread_priority) :
@@ -378,10 +581,18 @@ void net_tc_rx_init(void)
 		if (IS_ENABLED(CONFIG_THREAD_NAME)) {
 			char name[MAX_NAME_LEN];
 
-			snprintk(name, sizeof(name), "rx_q[%d]", i);
+			if (NET_TC_RX_QUEUES > 1) {
+				snprintk(name, sizeof(name), "rx_q[%d.%d]", tc,
+					 i % NET_TC_RX_QUEUES);
+			} else {
+				snprintk(name, sizeof(name), "rx_q[%d]", tc);
+			}
+
 			k_thread_name_set(tid, name);
 		}
 
+		pin_queue(tid, i % NET_TC_RX_QUEUES);
+
 		k_thread_start(tid);
 	}
 #endif
@@ -25,6 +25,7 @@ LOG_MODULE_REGISTER(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
 #include "net_stats.h"
 #include "net_private.h"
 #include "tcp2_priv.h"
+#include "tcp2_cc.h"
 
 #define ACK_TIMEOUT_MS CONFIG_NET_TCP_ACK_TIMEOUT
 #define ACK_TIMEOUT K_MSEC(ACK_TIMEOUT_MS)
@@ -33,12 +34,31 @@ LOG_MODULE_REGISTER(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
 
 static int tcp_rto = CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
 static int tcp_retries = CONFIG_NET_TCP_RETRY_COUNT;
-static int tcp_window = NET_IPV6_MTU;
+static int tcp_window = CONFIG_NET_TCP_MAX_RECV_WINDOW_SIZE ?
+	CONFIG_NET_TCP_MAX_RECV_WINDOW_SIZE : NET_IPV6_MTU;
+
+/* Duplicate ACKs that trigger a fast retransmit, RFC 5681 */
+#define TCP_DUPACK_THRESH 3
 
 static sys_slist_t tcp_conns = SYS_SLIST_STATIC_INIT(&tcp_conns);
 
+/* Protects tcp_conns only.  Connection state is protected by the
+ * connection's own lock, conn->lock, and segments find their connection
+ * through tcp_hash, which has a lock per bucket.
+ */
 static K_MUTEX_DEFINE(tcp_lock);
 
+#define TCP_HASH_BUCKETS CONFIG_NET_TCP_HASH_BUCKETS
+
+BUILD_ASSERT((TCP_HASH_BUCKETS & (TCP_HASH_BUCKETS - 1)) == 0,
+	     "CONFIG_NET_TCP_HASH_BUCKETS must be a power of two");
+
+/* Connections with both endpoints set, hashed on the 4-tuple */
+static struct tcp_hash_bucket {
+	struct k_spinlock lock;
+	sys_slist_t conns;
+} tcp_hash[TCP_HASH_BUCKETS];
+
 static K_MEM_SLAB_DEFINE(tcp_conns_slab, sizeof(struct tcp),
 				CONFIG_NET_MAX_CONTEXTS, 4);
 
@@ -352,40 +372,92 @@ static void tcp_send_queue_flush(struct tcp *conn)
 	}
 }
 
-#if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
-#define tcp_conn_unref(conn)				\
-	tcp_conn_unref_debug(conn, __func__, __LINE__)
+static uint32_t tcp_endpoint_hash(uint32_t h, const union tcp_endpoint *ep)
+{
+	const uint8_t *addr;
+	uint16_t port;
+	size_t len;
 
-static int tcp_conn_unref_debug(struct tcp *conn, const char *caller, int line)
-#else
-static int tcp_conn_unref(struct tcp *conn)
-#endif
+	if (ep->sa.sa_family == AF_INET) {
+		addr = (const uint8_t *)&ep->sin.sin_addr;
+		len = sizeof(struct in_addr);
+		port = ep->sin.sin_port;
+	} else {
+		addr = (const uint8_t *)&ep->sin6.sin6_addr;
+		len = sizeof(struct in6_addr);
+		port = ep->sin6.sin6_port;
+	}
+
+	h = (h ^ port) * 0x9e3779b1U;
+
+	for (size_t i = 0; i < len; i += sizeof(uint32_t)) {
+		h = (h ^ UNALIGNED_GET((const uint32_t *)(addr + i))) *
+			0x9e3779b1U;
+	}
+
+	return h ^ (h >> 16);
+}
+
+static uint32_t tcp_conn_hash(const union tcp_endpoint *src,
+			      const union tcp_endpoint *dst)
 {
-	int ref_count = atomic_get(&conn->ref_count);
-	struct net_pkt *pkt;
+	return tcp_endpoint_hash(tcp_endpoint_hash(0U, src), dst);
+}
 
-#if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
-	NET_DBG("conn: %p, ref_count=%d (%s():%d)", conn, ref_count,
-		caller, line);
-#endif
+static struct tcp_hash_bucket *tcp_hash_bucket_get(uint32_t hash)
+{
+	return &tcp_hash[hash & (TCP_HASH_BUCKETS - 1)];
+}
 
-#if !defined(CONFIG_NET_TEST_PROTOCOL)
-	if (conn->in_connect) {
-		NET_DBG("conn: %p is waiting on connect semaphore", conn);
-		tcp_send_queue_flush(conn);
-		goto out;
+static void tcp_conn_hash_del(struct tcp *conn)
+{
+	struct tcp_hash_bucket *b;
+	k_spinlock_key_t key;
+
+	if (!conn->in_hash) {
+		return;
 	}
-#endif /* CONFIG_NET_TEST_PROTOCOL */
 
-	k_mutex_lock(&tcp_lock, K_FOREVER);
+	b = tcp_hash_bucket_get(conn->hash);
+	key = k_spin_lock(&b->lock);
+	sys_slist_find_and_remove(&b->conns, &conn->hash_next);
+	conn->in_hash = false;
+	k_spin_unlock(&b->lock, key);
+}
+
+/* Must be called whenever conn->src and conn->dst have been (re)set */
+static void tcp_conn_hash_add(struct tcp *conn)
+{
+	struct tcp_hash_bucket *b;
+	k_spinlock_key_t key;
+
+	tcp_conn_hash_del(conn);
+
+	conn->hash = tcp_conn_hash(&conn->src, &conn->dst);
+
+	b = tcp_hash_bucket_get(conn->hash);
+	key = k_spin_lock(&b->lock);
+	sys_slist_prepend(&b->conns, &conn->hash_next);
+	conn->in_hash = true;
+	k_spin_unlock(&b->lock, key);
+}
+
+/* Drop a reference, freeing the connection with the last one */
+static int tcp_conn_release(struct tcp *conn)
+{
+	int ref_count;
+	struct net_pkt *pkt;
 
 	ref_count = atomic_dec(&conn->ref_count) - 1;
 	if (ref_count) {
 		tp_out(net_context_get_family(conn->context), conn->iface,
 		       "TP_TRACE", "event", "CONN_DELETE");
-		goto unlock;
+		goto out;
 	}
 
+	/* Incoming segments can no longer find the connection */
+	tcp_conn_hash_del(conn);
+
 	/* If there is any pending data, pass that to application */
 	while ((pkt = k_fifo_get(&conn->recv_data, K_NO_WAIT)) != NULL) {
 		if (net_context_packet_received(
@@ -423,18 +495,42 @@ static int tcp_conn_unref(struct tcp *conn)
 	k_work_cancel_delayable(&conn->timewait_timer);
 	k_work_cancel_delayable(&conn->fin_timer);
 
+	k_mutex_lock(&tcp_lock, K_FOREVER);
 	sys_slist_find_and_remove(&tcp_conns, &conn->next);
+	k_mutex_unlock(&tcp_lock);
 
 	memset(conn, 0, sizeof(*conn));
 
 	k_mem_slab_free(&tcp_conns_slab, (void **)&conn);
-
-unlock:
-	k_mutex_unlock(&tcp_lock);
 out:
 	return ref_count;
 }
 
+#if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
+#define tcp_conn_unref(conn)				\
+	tcp_conn_unref_debug(conn, __func__, __LINE__)
+
+static int tcp_conn_unref_debug(struct tcp *conn, const char *caller, int line)
+#else
+static int tcp_conn_unref(struct tcp *conn)
+#endif
+{
+#if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
+	NET_DBG("conn: %p, ref_count=%d (%s():%d)", conn,
+		(int)atomic_get(&conn->ref_count), caller, line);
+#endif
+
+#if !defined(CONFIG_NET_TEST_PROTOCOL)
+	if (conn->in_connect) {
+		NET_DBG("conn: %p is waiting on connect semaphore", conn);
+		tcp_send_queue_flush(conn);
+		return atomic_get(&conn->ref_count);
+	}
+#endif /* CONFIG_NET_TEST_PROTOCOL */
+
+	return tcp_conn_release(conn);
+}
+
 int net_tcp_unref(struct net_context *context)
 {
 	int ref_count = 0;
@@ -613,8 +709,9 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 
 	NET_DBG("len=%zd", len);
 
-	recv_options->mss_found = false;
-	recv_options->wnd_found = false;
+	/* MSS, window scale and SACK permitted only come with the SYN, so
+	 * what was found is kept for the whole connection.
+	 */
 
 	for ( ; options && len >= 1; options += opt_len, len -= opt_len) {
 		opt = options[0];
@@ -658,9 +755,35 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 				goto end;
 			}
 
-			recv_options->window = opt;
+			recv_options->window = MIN(options[2], TCP_WSCALE_MAX);
 			recv_options->wnd_found = true;
 			break;
+		case TCPOPT_SACK_PERM:
+			if (opt_len != 2) {
+				result = false;
+				goto end;
+			}
+
+			recv_options->sack_perm_found = true;
+			break;
+		case TCPOPT_SACK:
+			if ((opt_len - 2) % 8 != 0 ||
+			    (opt_len - 2) / 8 > TCP_SACK_BLOCKS) {
+				result = false;
+				goto end;
+			}
+
+			for (int i = 0; i < (opt_len - 2) / 8; i++) {
+				struct tcp_sack_block *b = &recv_options->sack[i];
+
+				b->start = ntohl(UNALIGNED_GET(
+					(uint32_t *)(options + 2 + i * 8)));
+				b->end = ntohl(UNALIGNED_GET(
+					(uint32_t *)(options + 6 + i * 8)));
+			}
+
+			recv_options->sack_count = (opt_len - 2) / 8;
+			break;
 		default:
 			continue;
 		}
@@ -686,15 +809,28 @@ static size_t tcp_check_pending_data(struct tcp *conn, struct net_pkt *pkt,
 
 		pending_seq = tcp_get_seq(conn->queue_recv_data->buffer);
 		if (pending_seq == expected_seq) {
-			pending_len = net_pkt_get_len(conn->queue_recv_data);
+			struct net_buf *first = conn->queue_recv_data->buffer;
+			struct net_buf *last = first;
+			uint32_t end = pending_seq + last->len;
+
+			/* Only the first run of the queue is in order now */
+			while (last->frags && tcp_get_seq(last->frags) == end) {
+				last = last->frags;
+				end += last->len;
+			}
+
+			pending_len = end - pending_seq;
 
 			NET_DBG("Found pending data seq %u len %zd",
 				pending_seq, pending_len);
-			net_buf_frag_add(pkt->buffer,
-					 conn->queue_recv_data->buffer);
-			conn->queue_recv_data->buffer = NULL;
+			conn->queue_recv_data->buffer = last->frags;
+			last->frags = NULL;
+			net_buf_frag_add(pkt->buffer, first);
 
-			k_work_cancel_delayable(&conn->recv_queue_timer);
+			if (net_pkt_is_empty(conn->queue_recv_data)) {
+				k_work_cancel_delayable(
+					&conn->recv_queue_timer);
+			}
 		}
 	}
 
@@ -755,11 +891,118 @@ static int tcp_finalize_pkt(struct net_pkt *pkt)
 	return -EINVAL;
 }
 
+/* Longest option list we send: SACK with all blocks, padded */
+#define TCP_OPTS_MAX (4 + 8 * TCP_SACK_BLOCKS)
+
+/* A block per contiguous run of the out-of-order queue. The run holding
+ * the data queued last goes first, RFC 2018 section 4.
+ */
+static int tcp_sack_blocks_get(struct tcp *conn,
+			       struct tcp_sack_block *blocks)
+{
+	struct net_buf *buf = conn->queue_recv_data->buffer;
+	int count = 0;
+
+	while (buf) {
+		struct tcp_sack_block b;
+
+		b.start = tcp_get_seq(buf);
+		b.end = b.start + buf->len;
+
+		for (buf = buf->frags; buf && tcp_get_seq(buf) == b.end;
+		     buf = buf->frags) {
+			b.end += buf->len;
+		}
+
+		if (b.start == b.end) {
+			continue;
+		}
+
+		if (net_tcp_seq_cmp(b.start, conn->sack_recent) <= 0 &&
+		    net_tcp_seq_cmp(b.end, conn->sack_recent) > 0) {
+			count = MIN(count, TCP_SACK_BLOCKS - 1);
+			memmove(&blocks[1], &blocks[0], count * sizeof(b));
+			blocks[0] = b;
+			count++;
+		} else if (count < TCP_SACK_BLOCKS) {
+			blocks[count++] = b;
+		}
+	}
+
+	return count;
+}
+
+static size_t tcp_options_build(struct tcp *conn, uint8_t flags,
+				uint8_t *opts)
+{
+	size_t len = 0;
+
+	if (flags & SYN) {
+		/* A SYN-ACK only carries what the peer offered */
+		bool syn_ack = flags & ACK;
+
+		if (IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALING) &&
+		    (!syn_ack || conn->wscale_ok)) {
+			opts[len++] = TCPOPT_NOP;
+			opts[len++] = TCPOPT_WINDOW;
+			opts[len++] = 3;
+			opts[len++] = conn->rcv_wscale;
+		}
+
+		if (IS_ENABLED(CONFIG_NET_TCP_SACK) &&
+		    (!syn_ack || conn->sack_ok)) {
+			opts[len++] = TCPOPT_NOP;
+			opts[len++] = TCPOPT_NOP;
+			opts[len++] = TCPOPT_SACK_PERM;
+			opts[len++] = 2;
+		}
+	} else if ((flags & ACK) && conn->sack_ok &&
+		   CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT &&
+		   !net_pkt_is_empty(conn->queue_recv_data)) {
+		/* Report the out-of-order data we hold */
+		struct tcp_sack_block blocks[TCP_SACK_BLOCKS];
+		int count = tcp_sack_blocks_get(conn, blocks);
+
+		if (count == 0) {
+			return 0;
+		}
+
+		opts[len++] = TCPOPT_NOP;
+		opts[len++] = TCPOPT_NOP;
+		opts[len++] = TCPOPT_SACK;
+		opts[len++] = 2 + count * 8;
+
+		for (int i = 0; i < count; i++) {
+			UNALIGNED_PUT(htonl(blocks[i].start),
+				      (uint32_t *)&opts[len]);
+			len += sizeof(uint32_t);
+			UNALIGNED_PUT(htonl(blocks[i].end),
+				      (uint32_t *)&opts[len]);
+			len += sizeof(uint32_t);
+		}
+	}
+
+	return len;
+}
+
+static uint16_t tcp_adv_win(struct tcp *conn, uint8_t flags)
+{
+	uint32_t win = conn->recv_win;
+
+	/* The window in a SYN is never scaled */
+	if (conn->wscale_ok && !(flags & SYN)) {
+		win >>= conn->rcv_wscale;
+	}
+
+	return MIN(win, UINT16_MAX);
+}
+
 static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
-			  uint32_t seq)
+			  uint32_t seq, const uint8_t *opts, size_t opts_len)
 {
 	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
 	struct tcphdr *th;
+	int ret;
 
 	th = (struct tcphdr *)net_pkt_get_data(pkt, &tcp_access);
 	if (!th) {
@@ -770,16 +1013,21 @@ static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
 
 	UNALIGNED_PUT(conn->src.sin.sin_port, &th->th_sport);
 	UNALIGNED_PUT(conn->dst.sin.sin_port, &th->th_dport);
-	th->th_off = 5;
+	th->th_off = 5 + opts_len / 4;
 	UNALIGNED_PUT(flags, &th->th_flags);
-	UNALIGNED_PUT(htons(conn->recv_win), &th->th_win);
+	UNALIGNED_PUT(htons(tcp_adv_win(conn, flags)), &th->th_win);
 	UNALIGNED_PUT(htonl(seq), &th->th_seq);
 
 	if (ACK & flags) {
 		UNALIGNED_PUT(htonl(conn->ack), &th->th_ack);
 	}
 
-	return net_pkt_set_data(pkt, &tcp_access);
+	ret = net_pkt_set_data(pkt, &tcp_access);
+	if (ret < 0 || opts_len == 0) {
+		return ret;
+	}
+
+	return net_pkt_write(pkt, opts, opts_len);
 }
 
 static int ip_header_add(struct tcp *conn, struct net_pkt *pkt)
@@ -802,10 +1050,12 @@ static int ip_header_add(struct tcp *conn, struct net_pkt *pkt)
 static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		       uint32_t seq)
 {
+	uint8_t opts[TCP_OPTS_MAX];
+	size_t opts_len = tcp_options_build(conn, flags, opts);
 	struct net_pkt *pkt;
 	int ret = 0;
 
-	pkt = tcp_pkt_alloc(conn, sizeof(struct tcphdr));
+	pkt = tcp_pkt_alloc(conn, sizeof(struct tcphdr) + opts_len);
 	if (!pkt) {
 		ret = -ENOBUFS;
 		goto out;
@@ -823,7 +1073,7 @@ static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		goto out;
 	}
 
-	ret = tcp_header_add(conn, pkt, flags, seq);
+	ret = tcp_header_add(conn, pkt, flags, seq, opts, opts_len);
 	if (ret < 0) {
 		tcp_pkt_unref(pkt);
 		goto out;
@@ -888,9 +1138,269 @@ static int tcp_pkt_peek(struct net_pkt *to, struct net_pkt *from, size_t pos,
 	return net_pkt_copy(to, from, len);
 }
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+static const struct tcp_cc *tcp_cc_find(const char *name)
+{
+	Z_STRUCT_SECTION_FOREACH(tcp_cc, cc) {
+		if (is(cc->name, name)) {
+			return cc;
+		}
+	}
+
+	return NULL;
+}
+
+static const struct tcp_cc *tcp_cc_default(void)
+{
+	const struct tcp_cc *cc =
+		tcp_cc_find(CONFIG_NET_TCP_CONGESTION_CONTROL_DEFAULT);
+
+	if (cc == NULL) {
+		cc = tcp_cc_find("newreno");
+	}
+
+	return cc;
+}
+#else
+static const struct tcp_cc *tcp_cc_default(void)
+{
+	return NULL;
+}
+#endif /* CONFIG_NET_TCP_CONGESTION_CONTROL */
+
+static void tcp_cc_init(struct tcp *conn)
+{
+	uint32_t mss = conn_mss(conn);
+
+	if (conn->cc == NULL) {
+		return;
+	}
+
+	/* Initial window from RFC 6928 */
+	conn->cwnd = MIN(10U * mss, MAX(2U * mss, 14600U));
+	conn->ssthresh = UINT32_MAX;
+	conn->recover = conn->seq - 1;
+	conn->dup_acks = 0U;
+	conn->in_recovery = false;
+	memset(conn->cc_priv, 0, sizeof(conn->cc_priv));
+
+	if (conn->cc->init) {
+		conn->cc->init(conn);
+	}
+}
+
+/* New data was acknowledged. Returns true on a partial ACK during fast
+ * recovery, the next hole should then be retransmitted right away.
+ */
+static bool tcp_cc_ack(struct tcp *conn, uint32_t acked)
+{
+	uint32_t mss = conn_mss(conn);
+
+	if (conn->cc == NULL) {
+		return false;
+	}
+
+	conn->dup_acks = 0U;
+
+	if (conn->in_recovery) {
+		if (net_tcp_seq_cmp(conn->seq, conn->recover) > 0) {
+			/* Full ACK, deflate the window and leave recovery */
+			conn->cwnd = MIN(conn->ssthresh,
+					 MAX(conn->unacked_len, 0) + mss);
+			conn->in_recovery = false;
+			return false;
+		}
+
+		/* Partial ACK, RFC 6582 */
+		conn->cwnd -= MIN(conn->cwnd, acked);
+		conn->cwnd += mss;
+		return true;
+	}
+
+	if (conn->cwnd < conn->ssthresh) {
+		/* Slow start */
+		conn->cwnd += MIN(acked, mss);
+	} else {
+		conn->cc->cong_avoid(conn, acked);
+	}
+
+	conn->cwnd = MIN(conn->cwnd, (uint32_t)UINT16_MAX << TCP_WSCALE_MAX);
+
+	return false;
+}
+
+/* Returns true when the first unacknowledged segment should be
+ * retransmitted (fast retransmit).
+ */
+static bool tcp_cc_dup_ack(struct tcp *conn)
+{
+	uint32_t mss = conn_mss(conn);
+
+	if (conn->cc == NULL) {
+		return false;
+	}
+
+	if (conn->in_recovery) {
+		/* Every duplicate ACK means a segment has left the network */
+		conn->cwnd += mss;
+		return false;
+	}
+
+	/* Do not react twice to losses from the same window */
+	if (++conn->dup_acks < TCP_DUPACK_THRESH ||
+	    net_tcp_seq_cmp(conn->seq, conn->recover) <= 0) {
+		return false;
+	}
+
+	conn->ssthresh = conn->cc->ssthresh(conn);
+	conn->cwnd = conn->ssthresh + TCP_DUPACK_THRESH * mss;
+	conn->recover = conn->seq + conn->unacked_len - 1;
+	conn->in_recovery = true;
+	conn->dup_acks = 0U;
+
+	return true;
+}
+
+static void tcp_cc_timeout(struct tcp *conn)
+{
+	if (conn->cc == NULL) {
+		return;
+	}
+
+	conn->ssthresh = conn->cc->ssthresh(conn);
+	conn->cwnd = conn_mss(conn);
+	conn->recover = conn->seq + conn->unacked_len - 1;
+	conn->in_recovery = false;
+	conn->dup_acks = 0U;
+}
+
+/* Merge the SACK blocks of the segment just received into the
+ * scoreboard and drop what the cumulative ACK has covered.
+ */
+static void tcp_sack_update(struct tcp *conn)
+{
+	uint32_t una = conn->seq;
+	uint32_t end = conn->seq + conn->send_data_total;
+	uint8_t n = 0U;
+
+	for (uint8_t i = 0U; i < conn->sacked_count; i++) {
+		struct tcp_sack_block b = conn->sacked[i];
+
+		if (net_tcp_seq_cmp(b.end, una) <= 0) {
+			continue;
+		}
+
+		if (net_tcp_seq_cmp(b.start, una) < 0) {
+			b.start = una;
+		}
+
+		conn->sacked[n++] = b;
+	}
+
+	conn->sacked_count = n;
+
+	for (uint8_t i = 0U; i < conn->recv_options.sack_count; i++) {
+		struct tcp_sack_block b = conn->recv_options.sack[i];
+		uint8_t j, k;
+
+		/* Ignore blocks outside of the data in flight */
+		if (net_tcp_seq_cmp(b.start, una) <= 0 ||
+		    net_tcp_seq_cmp(b.end, end) > 0 ||
+		    net_tcp_seq_cmp(b.start, b.end) >= 0) {
+			continue;
+		}
+
+		/* Swallow every block the new one overlaps or touches */
+		for (j = 0U; j < conn->sacked_count; ) {
+			struct tcp_sack_block *o = &conn->sacked[j];
+
+			if (net_tcp_seq_cmp(o->start, b.end) > 0 ||
+			    net_tcp_seq_cmp(o->end, b.start) < 0) {
+				j++;
+				continue;
+			}
+
+			if (net_tcp_seq_cmp(o->start, b.start) < 0) {
+				b.start = o->start;
+			}
+
+			if (net_tcp_seq_cmp(o->end, b.end) > 0) {
+				b.end = o->end;
+			}
+
+			for (k = j; k + 1U < conn->sacked_count; k++) {
+				conn->sacked[k] = conn->sacked[k + 1U];
+			}
+
+			conn->sacked_count--;
+		}
+
+		/* Insert sorted, a full scoreboard forgets the highest
+		 * block, which at worst gets retransmitted needlessly
+		 */
+		for (j = conn->sacked_count; j > 0U; j--) {
+			if (net_tcp_seq_cmp(conn->sacked[j - 1].start,
+					    b.start) < 0) {
+				break;
+			}
+
+			if (j < TCP_SACK_BLOCKS) {
+				conn->sacked[j] = conn->sacked[j - 1];
+			}
+		}
+
+		if (j < TCP_SACK_BLOCKS) {
+			conn->sacked[j] = b;
+			conn->sacked_count = MIN(conn->sacked_count + 1,
+						 TCP_SACK_BLOCKS);
+		}
+	}
+}
+
+/* Move the send position past data the peer already holds */
+static void tcp_sack_skip(struct tcp *conn)
+{
+	for (uint8_t i = 0U; i < conn->sacked_count; i++) {
+		uint32_t pos = conn->seq + conn->unacked_len;
+		struct tcp_sack_block *b = &conn->sacked[i];
+
+		if (net_tcp_seq_cmp(b->start, pos) <= 0 &&
+		    net_tcp_seq_cmp(b->end, pos) > 0) {
+			conn->unacked_len = MIN(b->end - conn->seq,
+						conn->send_data_total);
+		}
+	}
+}
+
+/* Bytes that can be sent from offset pos before reaching SACKed data */
+static int tcp_sack_room(struct tcp *conn, int pos)
+{
+	for (uint8_t i = 0U; i < conn->sacked_count; i++) {
+		int32_t room = conn->sacked[i].start - (conn->seq + pos);
+
+		if (room > 0) {
+			return room;
+		}
+	}
+
+	return conn->send_data_total - pos;
+}
+
+/* The usable window, the smaller of what the receiver advertised and
+ * the congestion window
+ */
+static uint32_t tcp_send_wnd(struct tcp *conn)
+{
+	if (conn->cc != NULL) {
+		return MIN(conn->send_win, conn->cwnd);
+	}
+
+	return conn->send_win;
+}
+
 static bool tcp_window_full(struct tcp *conn)
 {
-	bool window_full = !(conn->unacked_len < conn->send_win);
+	bool window_full = !(conn->unacked_len < (int)tcp_send_wnd(conn));
 
 	NET_DBG("conn: %p window_full=%hu", conn, window_full);
 
@@ -915,17 +1425,12 @@ static int tcp_unsent_len(struct tcp *conn)
 	return unsent_len;
 }
 
-static int tcp_send_data(struct tcp *conn)
+/* Send len bytes of the send queue starting pos bytes after seq */
+static int tcp_send_segment(struct tcp *conn, int pos, int len, bool resend)
 {
 	int ret = 0;
-	int pos, len;
 	struct net_pkt *pkt;
 
-	pos = conn->unacked_len;
-	len = MIN3(conn->send_data_total - conn->unacked_len,
-		   conn->send_win - conn->unacked_len,
-		   conn_mss(conn));
-
 	pkt = tcp_pkt_alloc(conn, len);
 	if (!pkt) {
 		NET_ERR("conn: %p packet allocation failed, len=%d", conn, len);
@@ -940,11 +1445,9 @@ static int tcp_send_data(struct tcp *conn)
 		goto out;
 	}
 
-	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + conn->unacked_len);
+	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + pos);
 	if (ret == 0) {
-		conn->unacked_len += len;
-
-		if (conn->data_mode == TCP_DATA_MODE_RESEND) {
+		if (resend) {
 			net_stats_update_tcp_resent(conn->iface, len);
 			net_stats_update_tcp_seg_rexmit(conn->iface);
 		} else {
@@ -959,12 +1462,46 @@ static int tcp_send_data(struct tcp *conn)
 	 */
 	tcp_pkt_unref(pkt);
 
+ out:
+	return ret;
+}
+
+static int tcp_send_data(struct tcp *conn)
+{
+	int ret;
+	int len;
+
+	len = MIN3(conn->send_data_total - conn->unacked_len,
+		   (int)tcp_send_wnd(conn) - conn->unacked_len,
+		   conn_mss(conn));
+	len = MIN(len, tcp_sack_room(conn, conn->unacked_len));
+
+	ret = tcp_send_segment(conn, conn->unacked_len, len,
+			       conn->data_mode == TCP_DATA_MODE_RESEND);
+	if (ret == 0) {
+		conn->unacked_len += len;
+	}
+
 	conn_send_data_dump(conn);
 
- out:
 	return ret;
 }
 
+/* Fast retransmit the first unacknowledged segment */
+static int tcp_send_hole(struct tcp *conn)
+{
+	int len = MIN3(conn->unacked_len, conn_mss(conn),
+		       tcp_sack_room(conn, 0));
+
+	if (len <= 0) {
+		return 0;
+	}
+
+	NET_DBG("conn: %p retransmit seq %u len %d", conn, conn->seq, len);
+
+	return tcp_send_segment(conn, 0, len, true);
+}
+
 /* Send all queued but unsent data from the send_data packet by packet
  * until the receiver's window is full. */
 static int tcp_send_queued_data(struct tcp *conn)
@@ -976,7 +1513,12 @@ static int tcp_send_queued_data(struct tcp *conn)
 		goto out;
 	}
 
-	while (tcp_unsent_len(conn) > 0) {
+	while (true) {
+		tcp_sack_skip(conn);
+
+		if (tcp_unsent_len(conn) <= 0) {
+			break;
+		}
 
 		if (tcp_window_full(conn)) {
 			subscribe = true;
@@ -1046,6 +1588,17 @@ static void tcp_resend_data(struct k_work *work)
 		goto out;
 	}
 
+	/* Only the first timeout of a series is a congestion signal */
+	if (conn->data_mode == TCP_DATA_MODE_SEND) {
+		tcp_cc_timeout(conn);
+	}
+
+	/* The receiver may have dropped data it reported with SACK, so
+	 * after a timeout everything from the first unacknowledged byte
+	 * is sent again, RFC 2018 section 8.
+	 */
+	conn->sacked_count = 0U;
+
 	conn->data_mode = TCP_DATA_MODE_RESEND;
 	conn->unacked_len = 0;
 
@@ -1159,6 +1712,14 @@ static struct tcp *tcp_conn_alloc(void)
 	conn->in_connect = false;
 	conn->state = TCP_LISTEN;
 	conn->recv_win = tcp_window;
+	conn->cc = tcp_cc_default();
+
+	/* Smallest shift that lets us advertise the whole window */
+	while (IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALING) &&
+	       (conn->recv_win >> conn->rcv_wscale) > UINT16_MAX &&
+	       conn->rcv_wscale < TCP_WSCALE_MAX) {
+		conn->rcv_wscale++;
+	}
 
 	/* The ISN value will be set when we get the connection attempt or
 	 * when trying to create a connection.
@@ -1213,39 +1774,61 @@ out:
 	return ret;
 }
 
-static bool tcp_endpoint_cmp(union tcp_endpoint *ep, struct net_pkt *pkt,
-			     enum pkt_addr which)
+/* Take a reference unless the last one is already gone and the
+ * connection is being freed
+ */
+static bool tcp_conn_ref_get(struct tcp *conn)
 {
-	union tcp_endpoint ep_tmp;
-
-	if (tcp_endpoint_set(&ep_tmp, pkt, which) < 0) {
-		return false;
-	}
+	atomic_val_t ref_count;
 
-	return !memcmp(ep, &ep_tmp, tcp_endpoint_len(ep->sa.sa_family));
-}
+	do {
+		ref_count = atomic_get(&conn->ref_count);
+		if (ref_count == 0) {
+			return false;
+		}
+	} while (!atomic_cas(&conn->ref_count, ref_count, ref_count + 1));
 
-static bool tcp_conn_cmp(struct tcp *conn, struct net_pkt *pkt)
-{
-	return tcp_endpoint_cmp(&conn->src, pkt, TCP_EP_DST) &&
-		tcp_endpoint_cmp(&conn->dst, pkt, TCP_EP_SRC);
+	return true;
 }
 
+/* Returns the connection with a reference held, to be dropped with
+ * tcp_conn_release() once done with it.  The reference is taken in the
+ * bucket lock, so that the connection cannot be freed in between.
+ */
 static struct tcp *tcp_conn_search(struct net_pkt *pkt)
 {
-	bool found = false;
-	struct tcp *conn;
-	struct tcp *tmp;
+	union tcp_endpoint src, dst;
+	struct tcp_hash_bucket *b;
+	struct tcp *conn, *found = NULL;
+	k_spinlock_key_t key;
+	uint32_t hash;
+	size_t len;
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp_conns, conn, tmp, next) {
+	/* Our source is the destination of the packet and vice versa */
+	if (tcp_endpoint_set(&src, pkt, TCP_EP_DST) < 0 ||
+	    tcp_endpoint_set(&dst, pkt, TCP_EP_SRC) < 0) {
+		return NULL;
+	}
 
-		found = tcp_conn_cmp(conn, pkt);
-		if (found) {
+	len = tcp_endpoint_len(src.sa.sa_family);
+	hash = tcp_conn_hash(&src, &dst);
+	b = tcp_hash_bucket_get(hash);
+
+	key = k_spin_lock(&b->lock);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&b->conns, conn, hash_next) {
+		if (conn->hash == hash &&
+		    !memcmp(&conn->src, &src, len) &&
+		    !memcmp(&conn->dst, &dst, len) &&
+		    tcp_conn_ref_get(conn)) {
+			found = conn;
 			break;
 		}
 	}
 
-	return found ? conn : NULL;
+	k_spin_unlock(&b->lock, key);
+
+	return found;
 }
 
 static struct tcp *tcp_conn_new(struct net_pkt *pkt);
@@ -1264,7 +1847,10 @@ static enum net_verdict tcp_recv(struct net_conn *net_conn,
 
 	conn = tcp_conn_search(pkt);
 	if (conn) {
-		goto in;
+		tcp_in(conn, pkt);
+		tcp_conn_release(conn);
+
+		return NET_DROP;
 	}
 
 	th = th_get(pkt);
@@ -1422,6 +2008,8 @@ static struct tcp *tcp_conn_new(struct net_pkt *pkt)
 		goto err;
 	}
 
+	tcp_conn_hash_add(conn);
+
 	NET_DBG("conn: src: %s, dst: %s",
 		log_strdup(net_sprint_addr(conn->src.sa.sa_family,
 				(const void *)&conn->src.sin.sin_addr)),
@@ -1537,29 +2125,31 @@ static void tcp_queue_recv_data(struct tcp *conn, struct net_pkt *pkt,
 	}
 
 	if (!net_pkt_is_empty(conn->queue_recv_data)) {
-		/* Place the data to correct place in the list. If the data
-		 * would not be sequential, then drop this packet.
+		/* Place the data to correct place in the list, which is
+		 * sorted but may have holes. If the data overlaps data
+		 * already queued, then drop this packet.
 		 */
-		uint32_t pending_seq;
+		struct net_buf *prev = NULL;
+		struct net_buf *next = conn->queue_recv_data->buffer;
 
-		pending_seq = tcp_get_seq(conn->queue_recv_data->buffer);
-		if (pending_seq == seq) {
-			/* Put new data before the pending data */
-			net_buf_frag_add(pkt->buffer,
-					 conn->queue_recv_data->buffer);
-			conn->queue_recv_data->buffer = pkt->buffer;
-			inserted = true;
-		} else {
-			struct net_buf *last;
+		while (next &&
+		       net_tcp_seq_cmp(tcp_get_seq(next), seq_start) < 0) {
+			prev = next;
+			next = next->frags;
+		}
 
-			last = net_buf_frag_last(conn->queue_recv_data->buffer);
-			pending_seq = tcp_get_seq(last);
+		if ((!prev || net_tcp_seq_cmp(tcp_get_seq(prev) + prev->len,
+					      seq_start) <= 0) &&
+		    (!next || net_tcp_seq_cmp(tcp_get_seq(next), seq) >= 0)) {
+			net_buf_frag_last(pkt->buffer)->frags = next;
 
-			if ((pending_seq + last->len) == seq_start) {
-				/* Put new data after pending data */
-				last->frags = pkt->buffer;
-				inserted = true;
+			if (prev) {
+				prev->frags = pkt->buffer;
+			} else {
+				conn->queue_recv_data->buffer = pkt->buffer;
 			}
+
+			inserted = true;
 		}
 
 		if (IS_ENABLED(CONFIG_NET_TCP_LOG_LEVEL_DBG)) {
@@ -1576,6 +2166,8 @@ static void tcp_queue_recv_data(struct tcp *conn, struct net_pkt *pkt,
 	}
 
 	if (inserted) {
+		conn->sack_recent = seq_start;
+
 		/* We need to keep the received data but free the pkt */
 		pkt->buffer = NULL;
 
@@ -1618,6 +2210,28 @@ static void tcp_out_of_order_data(struct tcp *conn, struct net_pkt *pkt,
 	tcp_queue_recv_data(conn, pkt, data_len, seq);
 }
 
+/* Settle on the options both sides offered in their SYNs */
+static void tcp_options_negotiate(struct tcp *conn)
+{
+	conn->wscale_ok = IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALING) &&
+			  conn->recv_options.wnd_found;
+	conn->sack_ok = IS_ENABLED(CONFIG_NET_TCP_SACK) &&
+			conn->recv_options.sack_perm_found;
+
+	if (conn->wscale_ok) {
+		conn->snd_wscale = conn->recv_options.window;
+	} else {
+		conn->snd_wscale = 0U;
+		conn->rcv_wscale = 0U;
+		/* Only accept what the unscaled window field advertised */
+		conn->recv_win = MIN(conn->recv_win, UINT16_MAX);
+	}
+
+	NET_DBG("conn: %p wscale %s (%u/%u) sack %s", conn,
+		conn->wscale_ok ? "on" : "off", conn->snd_wscale,
+		conn->rcv_wscale, conn->sack_ok ? "on" : "off");
+}
+
 /* TCP state machine, everything happens here */
 static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 {
@@ -1630,6 +2244,7 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 	struct net_pkt *recv_pkt;
 	void *recv_user_data;
 	struct k_fifo *recv_data_fifo;
+	uint32_t prev_send_win = 0U;
 	size_t len;
 	int ret;
 
@@ -1661,6 +2276,8 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 		goto next_state;
 	}
 
+	conn->recv_options.sack_count = 0U;
+
 	if (tcp_options_len && !tcp_options_check(&conn->recv_options, pkt,
 						  tcp_options_len)) {
 		NET_DBG("DROP: Invalid TCP option list");
@@ -1672,8 +2289,13 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 	if (th) {
 		size_t max_win;
 
+		prev_send_win = conn->send_win;
 		conn->send_win = ntohs(th_win(th));
 
+		if (conn->wscale_ok && !(th_flags(th) & SYN)) {
+			conn->send_win <<= conn->snd_wscale;
+		}
+
 #if defined(CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE)
 		if (CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE) {
 			max_win = CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE;
@@ -1703,6 +2325,7 @@ next_state:
 	case TCP_LISTEN:
 		if (FL(&fl, ==, SYN)) {
 			conn_ack(conn, th_seq(th) + 1); /* capture peer's isn */
+			tcp_options_negotiate(conn);
 			tcp_out(conn, SYN | ACK);
 			conn_seq(conn, + 1);
 			next = TCP_SYN_RECEIVED;
@@ -1723,6 +2346,7 @@ next_state:
 				th_seq(th) == conn->ack)) {
 			k_work_cancel_delayable(&conn->establish_timer);
 			tcp_send_timer_cancel(conn);
+			tcp_cc_init(conn);
 			next = TCP_ESTABLISHED;
 			net_context_set_state(conn->context,
 					      NET_CONTEXT_CONNECTED);
@@ -1756,6 +2380,8 @@ next_state:
 		if (FL(&fl, &, SYN | ACK, th && th_ack(th) == conn->seq)) {
 			tcp_send_timer_cancel(conn);
 			conn_ack(conn, th_seq(th) + 1);
+			tcp_options_negotiate(conn);
+			tcp_cc_init(conn);
 			if (len) {
 				if (tcp_data_get(conn, pkt, &len) < 0) {
 					break;
@@ -1833,6 +2459,13 @@ next_state:
 
 			conn_send_data_dump(conn);
 
+			tcp_sack_update(conn);
+
+			if (tcp_cc_ack(conn, len_acked) &&
+			    conn->data_mode == TCP_DATA_MODE_SEND) {
+				(void)tcp_send_hole(conn);
+			}
+
 			if (!k_work_delayable_remaining_get(
 				    &conn->send_data_timer)) {
 				NET_DBG("conn: %p, Missing a subscription "
@@ -1862,6 +2495,19 @@ next_state:
 				conn_state(conn, TCP_CLOSED);
 				break;
 			}
+		} else if (th && len == 0 && th_ack(th) == conn->seq &&
+			   conn->send_win == prev_send_win &&
+			   conn->unacked_len > 0 &&
+			   conn->data_mode == TCP_DATA_MODE_SEND) {
+			/* Duplicate ACK, RFC 5681 chapter 2 */
+			tcp_sack_update(conn);
+
+			if (tcp_cc_dup_ack(conn)) {
+				(void)tcp_send_hole(conn);
+			}
+
+			/* An inflated window may let new data out */
+			(void)tcp_send_queued_data(conn);
 		}
 
 		if (th && len) {
@@ -1876,6 +2522,13 @@ next_state:
 			} else if (CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT) {
 				tcp_out_of_order_data(conn, pkt, len,
 						      th_seq(th));
+
+				/* With SACK the peer learns right away what
+				 * arrived and what is missing
+				 */
+				if (conn->sack_ok) {
+					tcp_out(conn, ACK);
+				}
 			}
 		}
 		break;
@@ -2234,6 +2887,10 @@ int net_tcp_connect(struct net_context *context,
 		ret = -EPROTONOSUPPORT;
 	}
 
+	if (ret == 0) {
+		tcp_conn_hash_add(conn);
+	}
+
 	if (!(IS_ENABLED(CONFIG_NET_TEST_PROTOCOL) ||
 	      IS_ENABLED(CONFIG_NET_TEST))) {
 		conn->seq = tcp_init_isn(&conn->src.sa, &conn->dst.sa);
@@ -2396,7 +3053,7 @@ struct net_tcp_hdr *net_tcp_input(struct net_pkt *pkt,
 	struct net_tcp_hdr *tcp_hdr;
 
 	if (IS_ENABLED(CONFIG_NET_TCP_CHECKSUM) &&
-			net_if_need_calc_rx_checksum(net_pkt_iface(pkt)) &&
+			net_pkt_need_calc_rx_checksum(pkt) &&
 			net_calc_chksum_tcp(pkt) != 0U) {
 		NET_DBG("DROP: checksum mismatch");
 		goto drop;
@@ -2424,7 +3081,15 @@ static enum net_verdict tcp_input(struct net_conn *net_conn,
 	if (th) {
 		struct tcp *conn = tcp_conn_search(pkt);
 
-		if (conn == NULL && SYN == th_flags(th)) {
+		if (conn) {
+			conn->iface = pkt->iface;
+			tcp_in(conn, pkt);
+			tcp_conn_release(conn);
+
+			return NET_DROP;
+		}
+
+		if (SYN == th_flags(th)) {
 			struct net_context *context =
 				tcp_calloc(1, sizeof(struct net_context));
 			net_tcp_get(context);
@@ -2432,6 +3097,7 @@ static enum net_verdict tcp_input(struct net_conn *net_conn,
 			conn = context->tcp;
 			tcp_endpoint_set(&conn->dst, pkt, TCP_EP_SRC);
 			tcp_endpoint_set(&conn->src, pkt, TCP_EP_DST);
+			tcp_conn_hash_add(conn);
 			/* Make an extra reference, the sanity check suite
 			 * will delete the connection explicitly
 			 */
@@ -2502,7 +3168,7 @@ enum net_verdict tp_input(struct net_conn *net_conn,
 {
 	struct net_udp_hdr *uh = net_udp_get_hdr(pkt, NULL);
 	size_t data_len = ntohs(uh->len) - sizeof(*uh);
-	struct tcp *conn = tcp_conn_search(pkt);
+	struct tcp *conn;
 	size_t json_len = 0;
 	struct tp *tp;
 	struct tp_new *tp_new;
@@ -2585,7 +3251,11 @@ enum net_verdict tp_input(struct net_conn *net_conn,
 			char hexstr[HEXSTR_SIZE];
 			ssize_t len = tp_tcp_recv(0, buf, sizeof(buf), 0);
 
+			conn = tcp_conn_search(pkt);
 			tp_init(conn, tp);
+			if (conn) {
+				tcp_conn_release(conn);
+			}
 			bin2hex(buf, len, hexstr, HEXSTR_SIZE);
 			tp->data = hexstr;
 			NET_DBG("%zd = tcp_recv(\"%s\")", len, tp->data);
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ * @brief Pluggable TCP congestion control
+ *
+ * The generic part in tcp2.c does slow start, fast retransmit and
+ * fast recovery (RFC 5681, RFC 6582) and the reaction to retransmission
+ * timeouts.  An algorithm only decides how far the window is cut on a
+ * loss and how it grows in congestion avoidance.
+ */
+
+#ifndef __TCP2_CC_H
+#define __TCP2_CC_H
+
+#include <sys/util.h>
+#include <toolchain.h>
+
+struct tcp;
+
+struct tcp_cc {
+	/** Name used to select the algorithm */
+	const char *name;
+
+	/** Optional, set up the private state in conn->cc_priv, which
+	 *  is zeroed before the call.  Called when the connection gets
+	 *  established or the algorithm is changed.
+	 */
+	void (*init)(struct tcp *conn);
+
+	/** Return the new slow start threshold after a loss, conn->cwnd
+	 *  still holds the window the loss happened at.
+	 */
+	uint32_t (*ssthresh)(struct tcp *conn);
+
+	/** Grow conn->cwnd in congestion avoidance, @p acked bytes were
+	 *  newly acknowledged.
+	 */
+	void (*cong_avoid)(struct tcp *conn, uint32_t acked);
+};
+
+/** Register a congestion control algorithm */
+#define TCP_CC_DEFINE(_id, _name, _init, _ssthresh, _cong_avoid)	\
+	static const Z_STRUCT_SECTION_ITERABLE(tcp_cc, _id) = {		\
+		.name = _name,						\
+		.init = _init,						\
+		.ssthresh = _ssthresh,					\
+		.cong_avoid = _cong_avoid,				\
+	}
+
+/** Access the private state of an algorithm as a struct of its own */
+#define TCP_CC_PRIV(_conn, _type)					\
+	({								\
+		BUILD_ASSERT(sizeof(_type) <= sizeof((_conn)->cc_priv),	\
+			     "congestion control state too big");	\
+		(_type *)(_conn)->cc_priv;				\
+	})
+
+#endif /* __TCP2_CC_H */
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* CUBIC congestion control (RFC 8312) in integer arithmetic.
+ *
+ * After a loss the window follows W(t) = C * (t - K)^3 + W_max with
+ * C = 0.4 segments/s^3, so it climbs back quickly to where the loss
+ * happened, stays flat around it and then probes beyond.  Times are
+ * in milliseconds and windows in bytes.  The Reno friendly estimate
+ * is advanced per acknowledged byte instead of per RTT, as no RTT
+ * samples are taken, and t is not offset by the RTT for the same
+ * reason.
+ */
+
+#include <zephyr.h>
+#include "tcp_internal.h"
+#include "tcp2_cc.h"
+
+/* beta = 7/10, C = 4/10 */
+#define BETA_NUM 7U
+#define BETA_DEN 10U
+
+/* Largest |t - K| in ms the cubic term is evaluated for, keeps the
+ * arithmetic within 64 bits
+ */
+#define T_MAX_MS (1 << 18)
+
+struct cubic {
+	uint32_t w_max;
+	uint32_t origin;
+	uint32_t w_est;
+	uint32_t k;
+	uint32_t epoch_start;
+	bool in_epoch;
+};
+
+static uint32_t cubic_root(uint64_t a)
+{
+	uint32_t lo = 0U, hi = (1U << 21) - 1U;
+
+	while (lo < hi) {
+		uint64_t mid = (lo + hi + 1U) / 2U;
+
+		if (mid * mid * mid <= a) {
+			lo = mid;
+		} else {
+			hi = mid - 1U;
+		}
+	}
+
+	return lo;
+}
+
+static void cubic_epoch_start(struct tcp *conn, struct cubic *c)
+{
+	uint32_t mss = conn_mss(conn);
+
+	c->epoch_start = k_uptime_get_32();
+	c->in_epoch = true;
+	c->w_est = conn->cwnd;
+
+	if (conn->cwnd < c->w_max) {
+		/* K^3 = (W_max - cwnd) / C, in ms^3 */
+		c->k = cubic_root((uint64_t)(c->w_max - conn->cwnd) *
+				  2500000000ULL / mss);
+		c->origin = c->w_max;
+	} else {
+		c->k = 0U;
+		c->origin = conn->cwnd;
+	}
+}
+
+static uint32_t cubic_ssthresh(struct tcp *conn)
+{
+	struct cubic *c = TCP_CC_PRIV(conn, struct cubic);
+
+	c->in_epoch = false;
+
+	/* Fast convergence: release bandwidth to newer flows when the
+	 * window did not get back to where it was at the previous loss
+	 */
+	if (conn->cwnd < c->w_max) {
+		c->w_max = (uint64_t)conn->cwnd * (BETA_DEN + BETA_NUM) /
+			   (2U * BETA_DEN);
+	} else {
+		c->w_max = conn->cwnd;
+	}
+
+	return MAX((uint64_t)conn->cwnd * BETA_NUM / BETA_DEN,
+		   2U * conn_mss(conn));
+}
+
+static void cubic_cong_avoid(struct tcp *conn, uint32_t acked)
+{
+	struct cubic *c = TCP_CC_PRIV(conn, struct cubic);
+	uint32_t mss = conn_mss(conn);
+	int64_t d, target;
+	uint32_t inc;
+
+	if (!c->in_epoch) {
+		cubic_epoch_start(conn, c);
+	}
+
+	d = (int64_t)(k_uptime_get_32() - c->epoch_start) - c->k;
+	d = CLAMP(d, -T_MAX_MS, T_MAX_MS);
+
+	/* C * d^3 in millionths of a segment, then in bytes */
+	target = c->origin + 4 * d * d * d / 10000 * mss / 1000000;
+
+	/* Never grow slower than Reno would: 3 (1 - beta) / (1 + beta)
+	 * segments per window acknowledged
+	 */
+	c->w_est += (uint64_t)acked * mss * 529U / (1000ULL * conn->cwnd);
+	target = MAX(target, (int64_t)c->w_est);
+
+	if (target <= conn->cwnd) {
+		return;
+	}
+
+	/* Close the gap over one window worth of ACKs, but grow by at
+	 * most half the data acknowledged (1.5 times per RTT)
+	 */
+	inc = MIN((uint64_t)(target - conn->cwnd) * acked / conn->cwnd,
+		  acked / 2U);
+	conn->cwnd += inc;
+}
+
+TCP_CC_DEFINE(tcp_cc_cubic, "cubic", NULL, cubic_ssthresh, cubic_cong_avoid);
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* NewReno congestion avoidance (RFC 5681), the window grows by one
+ * segment per window worth of acknowledged data and is halved on loss.
+ */
+
+#include <zephyr.h>
+#include "tcp_internal.h"
+#include "tcp2_cc.h"
+
+struct newreno {
+	/* Bytes acknowledged since the window last grew */
+	uint32_t bytes_acked;
+};
+
+static uint32_t newreno_ssthresh(struct tcp *conn)
+{
+	uint32_t flight = MAX(conn->unacked_len, 0);
+
+	TCP_CC_PRIV(conn, struct newreno)->bytes_acked = 0U;
+
+	return MAX(flight / 2U, 2U * conn_mss(conn));
+}
+
+static void newreno_cong_avoid(struct tcp *conn, uint32_t acked)
+{
+	struct newreno *nr = TCP_CC_PRIV(conn, struct newreno);
+
+	/* Appropriate byte counting, RFC 3465 */
+	nr->bytes_acked += acked;
+	if (nr->bytes_acked >= conn->cwnd) {
+		nr->bytes_acked -= conn->cwnd;
+		conn->cwnd += conn_mss(conn);
+	}
+}
+
+TCP_CC_DEFINE(tcp_cc_newreno, "newreno", NULL, newreno_ssthresh,
+	      newreno_cong_avoid);
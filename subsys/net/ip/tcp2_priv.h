@@ -125,7 +125,7 @@
 #define conn_send_data_dump(_conn)                                             \
 	({                                                                     \
 		NET_DBG("conn: %p total=%zd, unacked_len=%d, "                 \
-			"send_win=%hu, mss=%hu",                               \
+			"send_win=%u, mss=%hu",                                \
 			(_conn), net_pkt_get_len((_conn)->send_data),          \
 			conn->unacked_len, conn->send_win,                     \
 			(uint16_t)conn_mss((_conn)));                          \
@@ -141,6 +141,19 @@
 #define TCPOPT_NOP	1
 #define TCPOPT_MAXSEG	2
 #define TCPOPT_WINDOW	3
+#define TCPOPT_SACK_PERM	4
+#define TCPOPT_SACK	5
+
+/* Largest window shift allowed by RFC 7323 */
+#define TCP_WSCALE_MAX	14
+
+/* SACK blocks kept per connection, also the most one option can carry */
+#define TCP_SACK_BLOCKS	4
+
+/* Words of per connection state reserved for the congestion control
+ * algorithm
+ */
+#define TCP_CC_PRIV_WORDS 6
 
 enum pkt_addr {
 	TCP_EP_SRC = 1,
@@ -202,15 +215,27 @@ union tcp_endpoint {
 	struct sockaddr_in6 sin6;
 };
 
+struct tcp_sack_block {
+	uint32_t start;
+	uint32_t end;
+};
+
 struct tcp_options {
+	/* SACK blocks of the last segment received, not sticky */
+	struct tcp_sack_block sack[TCP_SACK_BLOCKS];
+	uint8_t sack_count;
 	uint16_t mss;
-	uint16_t window;
+	uint16_t window; /* window shift count */
 	bool mss_found : 1;
 	bool wnd_found : 1;
+	bool sack_perm_found : 1;
 };
 
+struct tcp_cc;
+
 struct tcp { /* TCP connection */
 	sys_snode_t next;
+	sys_snode_t hash_next;
 	struct net_context *context;
 	struct net_pkt *send_data;
 	struct net_pkt *queue_recv_data;
@@ -247,12 +272,31 @@ struct tcp { /* TCP connection */
 	enum tcp_data_mode data_mode;
 	uint32_t seq;
 	uint32_t ack;
-	uint16_t recv_win;
-	uint16_t send_win;
+	uint32_t hash;
+	uint32_t recv_win;
+	uint32_t send_win;
+	/* Congestion control, see tcp2_cc.h */
+	const struct tcp_cc *cc;
+	uint32_t cwnd;
+	uint32_t ssthresh;
+	uint32_t recover;
+	uint32_t cc_priv[TCP_CC_PRIV_WORDS];
+	/* Start of the out-of-order data queued last, reported first */
+	uint32_t sack_recent;
+	/* Ranges above seq the peer has selectively acknowledged, sorted */
+	struct tcp_sack_block sacked[TCP_SACK_BLOCKS];
+	uint8_t sacked_count;
+	uint8_t dup_acks;
+	uint8_t snd_wscale;
+	uint8_t rcv_wscale;
 	uint8_t send_data_retries;
 	bool in_retransmission : 1;
 	bool in_connect : 1;
 	bool in_close : 1;
+	bool in_hash : 1;
+	bool in_recovery : 1;
+	bool wscale_ok : 1;
+	bool sack_ok : 1;
 };
 
 #define _flags(_fl, _op, _mask, _cond)					\
@@ -58,6 +58,32 @@ int net_udp_finalize(struct net_pkt *pkt)
 	return net_pkt_set_data(pkt, &udp_access);
 }
 
+#if defined(CONFIG_NET_CONTEXT_UDP_SEGMENT)
+struct net_pkt *net_udp_segment(struct net_pkt *hdr_pkt, size_t len,
+				k_timeout_t timeout)
+{
+	struct net_pkt *pkt;
+
+	/* The clone gets the headers and the metadata describing them,
+	 * its cursor is left behind the UDP header.
+	 */
+	pkt = net_pkt_clone(hdr_pkt, timeout);
+	if (!pkt) {
+		return NULL;
+	}
+
+	if (net_pkt_alloc_buffer(pkt, len, IPPROTO_UDP, timeout) ||
+	    net_pkt_available_buffer(pkt) < len) {
+		net_pkt_unref(pkt);
+		return NULL;
+	}
+
+	net_pkt_set_overwrite(pkt, false);
+
+	return pkt;
+}
+#endif /* CONFIG_NET_CONTEXT_UDP_SEGMENT */
+
 struct net_udp_hdr *net_udp_get_hdr(struct net_pkt *pkt,
 				    struct net_udp_hdr *hdr)
 {
@@ -163,7 +189,7 @@ struct net_udp_hdr *net_udp_input(struct net_pkt *pkt,
 	}
 
 	if (IS_ENABLED(CONFIG_NET_UDP_CHECKSUM) &&
-	    net_if_need_calc_rx_checksum(net_pkt_iface(pkt))) {
+	    net_pkt_need_calc_rx_checksum(pkt)) {
 		if (!udp_hdr->chksum) {
 			if (IS_ENABLED(CONFIG_NET_UDP_MISSING_CHECKSUM) &&
 			    net_pkt_family(pkt) == AF_INET) {
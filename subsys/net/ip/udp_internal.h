@@ -73,6 +73,26 @@ static inline int net_udp_finalize(struct net_pkt *pkt)
 }
 #endif
 
+/**
+ * @brief Start a datagram from the headers of another one
+ *
+ * Note: used to split a large send, the headers are built once in
+ *       @p hdr_pkt and copied from there, only the lengths and the
+ *       checksums differ and are set when the packet is finalized.
+ *
+ * @param hdr_pkt Network packet holding IP and UDP headers only, not
+ *        finalized yet
+ * @param len Payload length of the new datagram
+ * @param timeout Allocation timeout
+ *
+ * @return Network packet with the cursor after the UDP header, NULL if
+ *         it could not be allocated.
+ */
+#if defined(CONFIG_NET_CONTEXT_UDP_SEGMENT)
+struct net_pkt *net_udp_segment(struct net_pkt *hdr_pkt, size_t len,
+				k_timeout_t timeout);
+#endif
+
 /**
  * @brief Get pointer to UDP header in net_pkt
  *
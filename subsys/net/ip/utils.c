@@ -487,29 +487,51 @@ int z_vrfy_net_addr_pton(sa_family_t family, const char *src,
 #include <syscalls/net_addr_pton_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+/* The Internet checksum does not depend on the byte order (RFC 1071):
+ * the data is summed in native 32-bit words, the carries piling up in
+ * the upper half of the accumulator, and the result is folded to 16 bits
+ * and converted to network order only once at the end.
+ */
 static uint16_t calc_chksum(uint16_t sum, const uint8_t *data, size_t len)
 {
-	const uint8_t *end;
+	const uint32_t *w = (const uint32_t *)data;
+	uint64_t acc = 0U;
 	uint16_t tmp;
 
-	end = data + len - 1;
+	for (; len >= 16; len -= 16, w += 4) {
+		acc += UNALIGNED_GET(&w[0]);
+		acc += UNALIGNED_GET(&w[1]);
+		acc += UNALIGNED_GET(&w[2]);
+		acc += UNALIGNED_GET(&w[3]);
+	}
 
-	while (data < end) {
-		tmp = (data[0] << 8) + data[1];
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+	for (; len >= 4; len -= 4, w++) {
+		acc += UNALIGNED_GET(w);
+	}
 
+	data = (const uint8_t *)w;
+
+	if (len >= 2) {
+		acc += UNALIGNED_GET((const uint16_t *)data);
 		data += 2;
+		len -= 2;
 	}
 
-	if (data == end) {
-		tmp = data[0] << 8;
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+	if (len) {
+		/* The last byte is the high one of a zero padded word */
+		acc += sys_cpu_to_be16(data[0] << 8);
+	}
+
+	acc = (acc & 0xffffffff) + (acc >> 32);
+	acc = (acc & 0xffffffff) + (acc >> 32);
+	acc = (acc & 0xffff) + (acc >> 16);
+	acc = (acc & 0xffff) + (acc >> 16);
+
+	tmp = sys_be16_to_cpu((uint16_t)acc);
+
+	sum += tmp;
+	if (sum < tmp) {
+		sum++;
 	}
 
 	return sum;
@@ -600,6 +622,48 @@ uint16_t net_calc_chksum(struct net_pkt *pkt, uint8_t proto)
 	return ~sum;
 }
 
+/* A device offloading the checksums only sees one fragment at a time,
+ * so the UDP or TCP checksum of the whole payload is computed here.
+ */
+int net_fragment_chksum(struct net_pkt *pkt, uint8_t proto)
+{
+	struct net_pkt_cursor backup;
+	size_t hdr_len = net_pkt_ip_hdr_len(pkt);
+	uint16_t chksum;
+	size_t offset;
+	int ret = 0;
+
+	if (proto == IPPROTO_UDP) {
+		chksum = net_calc_chksum(pkt, IPPROTO_UDP);
+		chksum = chksum == 0U ? 0xffff : chksum;
+		offset = offsetof(struct net_udp_hdr, chksum);
+	} else if (proto == IPPROTO_TCP) {
+		chksum = net_calc_chksum(pkt, IPPROTO_TCP);
+		offset = offsetof(struct net_tcp_hdr, chksum);
+	} else {
+		return 0;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
+		hdr_len += net_pkt_ipv4_opts_len(pkt);
+	} else {
+		hdr_len += net_pkt_ipv6_ext_len(pkt);
+	}
+
+	net_pkt_cursor_backup(pkt, &backup);
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	if (net_pkt_skip(pkt, hdr_len + offset) ||
+	    net_pkt_write(pkt, &chksum, sizeof(chksum))) {
+		ret = -ENOBUFS;
+	}
+
+	net_pkt_cursor_restore(pkt, &backup);
+
+	return ret;
+}
+
 #if defined(CONFIG_NET_IPV4)
 uint16_t net_calc_chksum_ipv4(struct net_pkt *pkt)
 {
@@ -127,6 +127,16 @@ static int fifo_wait_non_empty(struct k_fifo *fifo, k_timeout_t timeout)
 	return k_poll(events, ARRAY_SIZE(events), timeout);
 }
 
+/* Tell the epoll instances watching the socket that it may have
+ * become ready, called with the descriptor lock held.
+ */
+static inline void sock_notify(struct net_context *ctx, uint32_t events)
+{
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+	z_fd_watch_notify(&ctx->watches, events);
+#endif
+}
+
 static void zsock_flush_queue(struct net_context *ctx)
 {
 	bool is_listen = net_context_get_state(ctx) == NET_CONTEXT_LISTENING;
@@ -257,6 +267,11 @@ int zsock_close_ctx(struct net_context *ctx)
 
 	zsock_flush_queue(ctx);
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+	sock_notify(ctx, ZSOCK_POLLNVAL);
+	sys_slist_init(&ctx->watches);
+#endif
+
 	SET_ERRNO(net_context_put(ctx));
 
 	return 0;
@@ -333,6 +348,12 @@ static void zsock_accepted_cb(struct net_context *new_ctx,
 		k_condvar_init(&new_ctx->cond.recv);
 
 		k_fifo_put(&parent->accept_q, new_ctx);
+
+		if (IS_ENABLED(CONFIG_NET_SOCKETS_EPOLL) && parent->cond.lock) {
+			(void)k_mutex_lock(parent->cond.lock, K_FOREVER);
+			sock_notify(parent, ZSOCK_POLLIN);
+			(void)k_mutex_unlock(parent->cond.lock);
+		}
 	}
 }
 
@@ -367,6 +388,7 @@ static void zsock_received_cb(struct net_context *ctx,
 			NET_DBG("Set EOF flag on pkt %p", last_pkt);
 		}
 
+		sock_notify(ctx, ZSOCK_POLLIN);
 		goto unlock;
 	}
 
@@ -380,6 +402,7 @@ static void zsock_received_cb(struct net_context *ctx,
 	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
 
 	k_fifo_put(&ctx->recv_q, pkt);
+	sock_notify(ctx, ZSOCK_POLLIN);
 
 unlock:
 	if (ctx->cond.lock) {
@@ -617,9 +640,10 @@ static inline int z_vrfy_zsock_accept(int sock, struct sockaddr *addr,
 #define WAIT_BUFS K_MSEC(100)
 #define MAX_WAIT_BUFS K_SECONDS(10)
 
-ssize_t zsock_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
-			 int flags,
-			 const struct sockaddr *dest_addr, socklen_t addrlen)
+/* Data comes either from buf or, for the zero-copy variant, from frags */
+static ssize_t sock_sendto(struct net_context *ctx, const void *buf,
+			   size_t len, struct net_buf *frags, int flags,
+			   const struct sockaddr *dest_addr, socklen_t addrlen)
 {
 	k_timeout_t timeout = K_FOREVER;
 	uint64_t buf_timeout = 0;
@@ -643,7 +667,11 @@ ssize_t zsock_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
 	}
 
 	while (1) {
-		if (dest_addr) {
+		if (frags) {
+			status = net_context_send_buf(ctx, frags, dest_addr,
+						      addrlen, NULL, timeout,
+						      ctx->user_data);
+		} else if (dest_addr) {
 			status = net_context_sendto(ctx, buf, len, dest_addr,
 						    addrlen, NULL, timeout,
 						    ctx->user_data);
@@ -688,6 +716,13 @@ ssize_t zsock_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
 	return status;
 }
 
+ssize_t zsock_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
+			 int flags,
+			 const struct sockaddr *dest_addr, socklen_t addrlen)
+{
+	return sock_sendto(ctx, buf, len, NULL, flags, dest_addr, addrlen);
+}
+
 ssize_t z_impl_zsock_sendto(int sock, const void *buf, size_t len, int flags,
 			   const struct sockaddr *dest_addr, socklen_t addrlen)
 {
@@ -829,6 +864,64 @@ fail:
 #include <syscalls/zsock_sendmsg_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+int z_impl_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	struct k_mutex *lock;
+	ssize_t ret = 0;
+	unsigned int i;
+	void *obj;
+
+	obj = get_sock_vtable(sock, &vtable, &lock);
+	if (obj == NULL || vtable->sendmsg == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	/* The socket is looked up and locked once for the whole batch */
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	for (i = 0; i < vlen; i++) {
+		ret = vtable->sendmsg(obj, &msgvec[i].msg_hdr, flags);
+		if (ret < 0) {
+			break;
+		}
+
+		msgvec[i].msg_len = ret;
+	}
+
+	k_mutex_unlock(lock);
+
+	/* Once some messages went out the error is left for the next
+	 * call to report, as with a short write.
+	 */
+	return (i > 0 || ret >= 0) ? i : -1;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	ssize_t ret = 0;
+	unsigned int len;
+	unsigned int i;
+
+	for (i = 0; i < vlen; i++) {
+		ret = z_vrfy_zsock_sendmsg(sock, &msgvec[i].msg_hdr, flags);
+		if (ret < 0) {
+			break;
+		}
+
+		len = ret;
+		Z_OOPS(z_user_to_copy(&msgvec[i].msg_len, &len, sizeof(len)));
+	}
+
+	return (i > 0 || ret >= 0) ? i : -1;
+}
+#include <syscalls/zsock_sendmmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
 static int sock_get_pkt_src_addr(struct net_pkt *pkt,
 				 enum net_ip_protocol proto,
 				 struct sockaddr *addr,
@@ -983,6 +1076,49 @@ static int wait_data(struct net_context *ctx, k_timeout_t *timeout)
 	return 0;
 }
 
+/* Fill in the source address of a received datagram */
+static int sock_pkt_src_addr(struct net_context *ctx, struct net_pkt *pkt,
+			     struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
+	    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
+		/*
+		 * Packets from offloaded IP stack do not have IP
+		 * headers, so src address cannot be figured out at this
+		 * point. The best we can do is returning remote address
+		 * if that was set using connect() call.
+		 */
+		if (ctx->flags & NET_CONTEXT_REMOTE_ADDR_SET) {
+			memcpy(src_addr, &ctx->remote,
+			       MIN(*addrlen, sizeof(ctx->remote)));
+		} else {
+			return -ENOTSUP;
+		}
+	} else {
+		int rv;
+
+		rv = sock_get_pkt_src_addr(pkt, net_context_get_ip_proto(ctx),
+					   src_addr, *addrlen);
+		if (rv < 0) {
+			LOG_ERR("sock_get_pkt_src_addr %d", rv);
+			return rv;
+		}
+	}
+
+	/* addrlen is a value-result argument, set to actual
+	 * size of source address
+	 */
+	if (src_addr->sa_family == AF_INET) {
+		*addrlen = sizeof(struct sockaddr_in);
+	} else if (src_addr->sa_family == AF_INET6) {
+		*addrlen = sizeof(struct sockaddr_in6);
+	} else {
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
 static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 				       void *buf,
 				       size_t max_len,
@@ -1033,42 +1169,11 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 	net_pkt_cursor_backup(pkt, &backup);
 
 	if (src_addr && addrlen) {
-		if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
-		    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
-			/*
-			 * Packets from offloaded IP stack do not have IP
-			 * headers, so src address cannot be figured out at this
-			 * point. The best we can do is returning remote address
-			 * if that was set using connect() call.
-			 */
-			if (ctx->flags & NET_CONTEXT_REMOTE_ADDR_SET) {
-				memcpy(src_addr, &ctx->remote,
-				       MIN(*addrlen, sizeof(ctx->remote)));
-			} else {
-				errno = ENOTSUP;
-				goto fail;
-			}
-		} else {
-			int rv;
-
-			rv = sock_get_pkt_src_addr(pkt, net_context_get_ip_proto(ctx),
-						   src_addr, *addrlen);
-			if (rv < 0) {
-				errno = -rv;
-				LOG_ERR("sock_get_pkt_src_addr %d", rv);
-				goto fail;
-			}
-		}
+		int rv;
 
-		/* addrlen is a value-result argument, set to actual
-		 * size of source address
-		 */
-		if (src_addr->sa_family == AF_INET) {
-			*addrlen = sizeof(struct sockaddr_in);
-		} else if (src_addr->sa_family == AF_INET6) {
-			*addrlen = sizeof(struct sockaddr_in6);
-		} else {
-			errno = ENOTSUP;
+		rv = sock_pkt_src_addr(ctx, pkt, src_addr, addrlen);
+		if (rv < 0) {
+			errno = -rv;
 			goto fail;
 		}
 	}
@@ -1283,6 +1388,271 @@ ssize_t z_vrfy_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 #include <syscalls/zsock_recvfrom_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+int z_impl_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	struct k_mutex *lock;
+	ssize_t ret = 0;
+	unsigned int i;
+	void *obj;
+
+	obj = get_sock_vtable(sock, &vtable, &lock);
+	if (obj == NULL || vtable->recvfrom == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	for (i = 0; i < vlen; i++) {
+		struct msghdr *msg = &msgvec[i].msg_hdr;
+
+		if (msg->msg_iovlen != 1) {
+			errno = EINVAL;
+			ret = -1;
+			break;
+		}
+
+		ret = vtable->recvfrom(obj, msg->msg_iov[0].iov_base,
+				       msg->msg_iov[0].iov_len, flags,
+				       msg->msg_name,
+				       msg->msg_name ? &msg->msg_namelen : NULL);
+		if (ret < 0) {
+			break;
+		}
+
+		msg->msg_flags = 0;
+		msgvec[i].msg_len = ret;
+
+		/* Only the first message waits for data */
+		flags |= ZSOCK_MSG_DONTWAIT;
+	}
+
+	k_mutex_unlock(lock);
+
+	return (i > 0 || ret >= 0) ? i : -1;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	struct mmsghdr mmsg;
+	struct iovec iov;
+	ssize_t ret = 0;
+	unsigned int i;
+
+	for (i = 0; i < vlen; i++) {
+		struct msghdr *msg = &mmsg.msg_hdr;
+
+		Z_OOPS(z_user_from_copy(&mmsg, &msgvec[i], sizeof(mmsg)));
+
+		if (msg->msg_iovlen != 1) {
+			errno = EINVAL;
+			ret = -1;
+			break;
+		}
+
+		Z_OOPS(z_user_from_copy(&iov, msg->msg_iov, sizeof(iov)));
+		Z_OOPS(Z_SYSCALL_MEMORY_WRITE(iov.iov_base, iov.iov_len));
+		Z_OOPS(msg->msg_name &&
+		       Z_SYSCALL_MEMORY_WRITE(msg->msg_name, msg->msg_namelen));
+
+		ret = z_impl_zsock_recvfrom(sock, iov.iov_base, iov.iov_len,
+					    flags, msg->msg_name,
+					    msg->msg_name ?
+					    &msg->msg_namelen : NULL);
+		if (ret < 0) {
+			break;
+		}
+
+		msg->msg_flags = 0;
+		mmsg.msg_len = ret;
+
+		Z_OOPS(z_user_to_copy(&msgvec[i], &mmsg, sizeof(mmsg)));
+
+		flags |= ZSOCK_MSG_DONTWAIT;
+	}
+
+	return (i > 0 || ret >= 0) ? i : -1;
+}
+#include <syscalls/zsock_recvmmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+/* Hand the payload of a received packet over as a buffer chain: the
+ * fragments holding nothing but headers are released and the first
+ * one left is pulled up to where the cursor stands.
+ */
+static struct net_buf *sock_pkt_detach_payload(struct net_pkt *pkt)
+{
+	struct net_buf *frags = pkt->cursor.buf;
+
+	while (pkt->buffer != frags) {
+		pkt->buffer = net_buf_frag_del(NULL, pkt->buffer);
+	}
+
+	if (frags) {
+		net_buf_pull(frags, pkt->cursor.pos - frags->data);
+	}
+
+	pkt->buffer = NULL;
+
+	return frags;
+}
+
+static ssize_t zsock_recv_buf_ctx(struct net_context *ctx,
+				  struct net_buf **frags, int flags,
+				  struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	enum net_sock_type sock_type = net_context_get_type(ctx);
+	k_timeout_t timeout = K_FOREVER;
+	struct net_pkt *pkt;
+	size_t len;
+	int ret;
+
+	*frags = NULL;
+
+	if (flags & ~ZSOCK_MSG_DONTWAIT) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (sock_type == SOCK_STREAM) {
+		if (net_context_get_state(ctx) != NET_CONTEXT_CONNECTED) {
+			errno = ENOTCONN;
+			return -1;
+		}
+
+		if (sock_is_eof(ctx)) {
+			return 0;
+		}
+	}
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else {
+		net_context_get_option(ctx, NET_OPT_RCVTIMEO, &timeout, NULL);
+
+		ret = wait_data(ctx, &timeout);
+		if (ret < 0) {
+			errno = -ret;
+			return -1;
+		}
+	}
+
+	pkt = k_fifo_get(&ctx->recv_q, K_NO_WAIT);
+	if (!pkt) {
+		if (sock_type == SOCK_STREAM && sock_is_eof(ctx)) {
+			return 0;
+		}
+
+		errno = EAGAIN;
+		return -1;
+	}
+
+	if (sock_type == SOCK_DGRAM && src_addr && addrlen) {
+		ret = sock_pkt_src_addr(ctx, pkt, src_addr, addrlen);
+		if (ret < 0) {
+			net_pkt_unref(pkt);
+			errno = -ret;
+			return -1;
+		}
+	}
+
+	if (sock_type == SOCK_STREAM && net_pkt_eof(pkt)) {
+		sock_set_eof(ctx);
+	}
+
+	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS)) {
+		net_socket_update_tc_rx_time(pkt, k_cycle_get_32());
+	}
+
+	len = net_pkt_remaining_data(pkt);
+	if (len) {
+		*frags = sock_pkt_detach_payload(pkt);
+	}
+
+	net_pkt_unref(pkt);
+
+	if (sock_type == SOCK_STREAM) {
+		net_context_update_recv_wnd(ctx, len);
+
+		/* An empty packet only carries the end of stream */
+		if (!len && !sock_is_eof(ctx)) {
+			errno = EAGAIN;
+			return -1;
+		}
+	}
+
+	return len;
+}
+
+/* The zero-copy calls work on the net_context directly, so they are
+ * limited to the native sockets, not the ones layered on top of them.
+ */
+static struct net_context *get_native_sock(int sock, struct k_mutex **lock)
+{
+	const struct socket_op_vtable *vtable;
+	struct net_context *ctx;
+
+	ctx = get_sock_vtable(sock, &vtable, lock);
+	if (ctx == NULL) {
+		errno = EBADF;
+		return NULL;
+	}
+
+	if (vtable != &sock_fd_op_vtable) {
+		errno = EOPNOTSUPP;
+		return NULL;
+	}
+
+	return ctx;
+}
+
+ssize_t zsock_send_buf(int sock, struct net_buf *frags, int flags,
+		       const struct sockaddr *dest_addr, socklen_t addrlen)
+{
+	struct net_context *ctx;
+	struct k_mutex *lock;
+	ssize_t ret;
+
+	if (frags == NULL || (flags & ~ZSOCK_MSG_DONTWAIT)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	ctx = get_native_sock(sock, &lock);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+	ret = sock_sendto(ctx, NULL, 0, frags, flags, dest_addr, addrlen);
+	k_mutex_unlock(lock);
+
+	return ret;
+}
+
+ssize_t zsock_recv_buf(int sock, struct net_buf **frags, int flags,
+		       struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	struct net_context *ctx;
+	struct k_mutex *lock;
+	ssize_t ret;
+
+	ctx = get_native_sock(sock, &lock);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+	ret = zsock_recv_buf_ctx(ctx, frags, flags, src_addr, addrlen);
+	k_mutex_unlock(lock);
+
+	return ret;
+}
+
 /* As this is limited function, we don't follow POSIX signature, with
  * "..." instead of last arg.
  */
@@ -1671,6 +2041,35 @@ int zsock_getsockopt_ctx(struct net_context *ctx, int level, int optname,
 		}
 		}
 
+		break;
+
+	case IPPROTO_UDP:
+		switch (optname) {
+		case UDP_SEGMENT:
+			if (IS_ENABLED(CONFIG_NET_CONTEXT_UDP_SEGMENT)) {
+				uint16_t segment;
+
+				if (*optlen != sizeof(int)) {
+					errno = EINVAL;
+					return -1;
+				}
+
+				ret = net_context_get_option(ctx,
+							     NET_OPT_UDP_SEGMENT,
+							     &segment, NULL);
+				if (ret < 0) {
+					errno = -ret;
+					return -1;
+				}
+
+				*(int *)optval = segment;
+
+				return 0;
+			}
+
+			break;
+		}
+
 		break;
 	}
 
@@ -1896,6 +2295,37 @@ int zsock_setsockopt_ctx(struct net_context *ctx, int level, int optname,
 		}
 		break;
 
+	case IPPROTO_UDP:
+		switch (optname) {
+		case UDP_SEGMENT:
+			if (IS_ENABLED(CONFIG_NET_CONTEXT_UDP_SEGMENT)) {
+				uint16_t segment;
+
+				if (optlen != sizeof(int) ||
+				    *(int *)optval < 0 ||
+				    *(int *)optval > UINT16_MAX) {
+					errno = EINVAL;
+					return -1;
+				}
+
+				segment = *(int *)optval;
+
+				ret = net_context_set_option(ctx,
+							     NET_OPT_UDP_SEGMENT,
+							     &segment,
+							     sizeof(segment));
+				if (ret < 0) {
+					errno = -ret;
+					return -1;
+				}
+
+				return 0;
+			}
+
+			break;
+		}
+		break;
+
 	case IPPROTO_IPV6:
 		switch (optname) {
 		case IPV6_V6ONLY:
@@ -2104,6 +2534,36 @@ static int sock_ioctl_vmeth(void *obj, unsigned int request, va_list args)
 		return 0;
 	}
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+	case ZFD_IOCTL_WATCH_ADD: {
+		struct net_context *ctx = obj;
+
+		sys_slist_append(&ctx->watches,
+				 &va_arg(args, struct z_fd_watch *)->node);
+		return 0;
+	}
+
+	case ZFD_IOCTL_WATCH_DEL: {
+		struct net_context *ctx = obj;
+
+		(void)sys_slist_find_and_remove(
+			&ctx->watches, &va_arg(args, struct z_fd_watch *)->node);
+		return 0;
+	}
+
+	case ZFD_IOCTL_WATCH_EVENTS: {
+		struct net_context *ctx = obj;
+		int events = ZSOCK_POLLOUT;
+
+		/* Same readiness as reported by zsock_poll() */
+		if (!k_fifo_is_empty(&ctx->recv_q) || sock_is_eof(ctx)) {
+			events |= ZSOCK_POLLIN;
+		}
+
+		return events;
+	}
+#endif /* CONFIG_NET_SOCKETS_EPOLL */
+
 	default:
 		errno = EOPNOTSUPP;
 		return -1;
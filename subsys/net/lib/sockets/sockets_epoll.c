@@ -0,0 +1,496 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_sock_epoll, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <kernel.h>
+#include <net/socket.h>
+#include <sys/fdtable.h>
+
+/* Each instance has one item per descriptor number.  A watched object
+ * calls epoll_notify() through its z_fd_watch when it may have become
+ * ready, which queues the item on the ready list, so waiting only ever
+ * looks at the descriptors that had something happen to them.  Whether
+ * they are really ready is asked from the object when the item is
+ * taken off the list; level-triggered items that are go back on it.
+ *
+ * Lock order is the instance mutex, then the descriptor lock of a
+ * watched object, then the instance spinlock.  Objects call back with
+ * their descriptor lock held, so the callback only takes the spinlock,
+ * which protects the ready list and the in_use/queued state of items.
+ */
+
+struct epoll;
+
+struct epoll_item {
+	struct z_fd_watch watch;
+	sys_dnode_t ready_node;
+	struct epoll *ep;
+	zsock_epoll_data_t data;
+	uint32_t events;
+	bool in_use;
+	bool queued;
+};
+
+struct epoll {
+	struct epoll_item items[CONFIG_POSIX_MAX_FDS];
+	sys_dlist_t ready;
+	struct k_spinlock lock;
+	struct k_mutex mtx;
+	struct k_sem wake;
+	bool in_use;
+};
+
+static K_MUTEX_DEFINE(epoll_alloc_mtx);
+static struct epoll epolls[CONFIG_NET_SOCKETS_EPOLL_MAX];
+
+static const struct fd_op_vtable epoll_fd_vtable;
+
+/* Called with ep->lock held */
+static bool epoll_queue(struct epoll *ep, struct epoll_item *item)
+{
+	if (item->queued ||
+	    !(item->events & (ZSOCK_EPOLLIN | ZSOCK_EPOLLOUT))) {
+		return false;
+	}
+
+	sys_dlist_append(&ep->ready, &item->ready_node);
+	item->queued = true;
+
+	return true;
+}
+
+/* Called with ep->lock held */
+static void epoll_forget(struct epoll_item *item)
+{
+	if (item->queued) {
+		sys_dlist_remove(&item->ready_node);
+		item->queued = false;
+	}
+
+	item->in_use = false;
+}
+
+static void epoll_notify(struct z_fd_watch *watch, uint32_t events)
+{
+	struct epoll_item *item = CONTAINER_OF(watch, struct epoll_item, watch);
+	struct epoll *ep = item->ep;
+	k_spinlock_key_t key;
+	bool wake = false;
+
+	key = k_spin_lock(&ep->lock);
+
+	if (events & ZSOCK_POLLNVAL) {
+		/* The descriptor is being closed */
+		epoll_forget(item);
+	} else if (item->events & events) {
+		wake = epoll_queue(ep, item);
+	}
+
+	k_spin_unlock(&ep->lock, key);
+
+	if (wake) {
+		k_sem_give(&ep->wake);
+	}
+}
+
+static int epoll_fd_call(int fd, unsigned long request, void *arg)
+{
+	const struct fd_op_vtable *vtable;
+	struct k_mutex *lock;
+	void *obj;
+	int ret;
+
+	obj = z_get_fd_obj_and_vtable(fd, &vtable, &lock);
+	if (obj == NULL) {
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+	ret = z_fdtable_call_ioctl(vtable, obj, request, arg);
+	k_mutex_unlock(lock);
+
+	return ret;
+}
+
+static int epoll_fd_events(int fd)
+{
+	const struct fd_op_vtable *vtable;
+	struct k_mutex *lock;
+	void *obj;
+	int ret;
+
+	obj = z_get_fd_obj_and_vtable(fd, &vtable, &lock);
+	if (obj == NULL) {
+		return 0;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+	ret = z_fdtable_call_ioctl(vtable, obj, ZFD_IOCTL_WATCH_EVENTS);
+	k_mutex_unlock(lock);
+
+	return MAX(ret, 0);
+}
+
+/* Drop the watch an object holds on an item, unless the object is
+ * already gone, which a close under the descriptor lock would show.
+ */
+static void epoll_detach(struct epoll *ep, struct epoll_item *item)
+{
+	int fd = item - ep->items;
+	const struct fd_op_vtable *vtable;
+	struct k_mutex *lock;
+	k_spinlock_key_t key;
+	bool attached;
+	void *obj;
+
+	obj = z_get_fd_obj_and_vtable(fd, &vtable, &lock);
+
+	if (obj != NULL) {
+		(void)k_mutex_lock(lock, K_FOREVER);
+	}
+
+	key = k_spin_lock(&ep->lock);
+	attached = item->in_use;
+	epoll_forget(item);
+	k_spin_unlock(&ep->lock, key);
+
+	if (obj != NULL) {
+		if (attached) {
+			(void)z_fdtable_call_ioctl(vtable, obj,
+						   ZFD_IOCTL_WATCH_DEL,
+						   &item->watch);
+		}
+
+		k_mutex_unlock(lock);
+	}
+}
+
+static int epoll_add(struct epoll *ep, int fd, struct zsock_epoll_event *event)
+{
+	struct epoll_item *item = &ep->items[fd];
+	k_spinlock_key_t key;
+
+	if (item->in_use) {
+		errno = EEXIST;
+		return -1;
+	}
+
+	item->ep = ep;
+	item->watch.notify = epoll_notify;
+	item->events = event->events;
+	item->data = event->data;
+	item->queued = false;
+	item->in_use = true;
+
+	if (epoll_fd_call(fd, ZFD_IOCTL_WATCH_ADD, &item->watch) < 0) {
+		item->in_use = false;
+		if (errno == EOPNOTSUPP) {
+			errno = EPERM;
+		}
+
+		return -1;
+	}
+
+	/* The descriptor may be ready already */
+	key = k_spin_lock(&ep->lock);
+	(void)epoll_queue(ep, item);
+	k_spin_unlock(&ep->lock, key);
+
+	return 0;
+}
+
+static int epoll_mod(struct epoll *ep, int fd, struct zsock_epoll_event *event)
+{
+	struct epoll_item *item = &ep->items[fd];
+	k_spinlock_key_t key;
+	int ret = 0;
+
+	key = k_spin_lock(&ep->lock);
+
+	if (item->in_use) {
+		item->events = event->events;
+		item->data = event->data;
+		(void)epoll_queue(ep, item);
+	} else {
+		ret = -ENOENT;
+	}
+
+	k_spin_unlock(&ep->lock, key);
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	return 0;
+}
+
+static struct epoll *epoll_get(int epfd)
+{
+	return z_get_fd_obj(epfd, &epoll_fd_vtable, EINVAL);
+}
+
+int zsock_epoll_create1(int flags)
+{
+	struct epoll *ep = NULL;
+	int fd = -1;
+
+	if (flags != 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	k_mutex_lock(&epoll_alloc_mtx, K_FOREVER);
+
+	for (int i = 0; i < ARRAY_SIZE(epolls); i++) {
+		if (!epolls[i].in_use) {
+			ep = &epolls[i];
+			break;
+		}
+	}
+
+	if (ep == NULL) {
+		errno = ENOMEM;
+		goto unlock;
+	}
+
+	fd = z_reserve_fd();
+	if (fd < 0) {
+		goto unlock;
+	}
+
+	memset(ep->items, 0, sizeof(ep->items));
+	sys_dlist_init(&ep->ready);
+	k_mutex_init(&ep->mtx);
+	k_sem_init(&ep->wake, 0, 1);
+	ep->in_use = true;
+
+	z_finalize_fd(fd, ep, &epoll_fd_vtable);
+
+unlock:
+	k_mutex_unlock(&epoll_alloc_mtx);
+
+	return fd;
+}
+
+int zsock_epoll_ctl(int epfd, int op, int fd, struct zsock_epoll_event *event)
+{
+	struct epoll *ep;
+	int ret;
+
+	ep = epoll_get(epfd);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	if (fd < 0 || fd >= ARRAY_SIZE(ep->items) || fd == epfd) {
+		errno = fd == epfd ? EINVAL : EBADF;
+		return -1;
+	}
+
+	if (op != ZSOCK_EPOLL_CTL_DEL && event == NULL) {
+		errno = EFAULT;
+		return -1;
+	}
+
+	k_mutex_lock(&ep->mtx, K_FOREVER);
+
+	switch (op) {
+	case ZSOCK_EPOLL_CTL_ADD:
+		ret = epoll_add(ep, fd, event);
+		break;
+
+	case ZSOCK_EPOLL_CTL_MOD:
+		ret = epoll_mod(ep, fd, event);
+		break;
+
+	case ZSOCK_EPOLL_CTL_DEL:
+		if (ep->items[fd].in_use) {
+			epoll_detach(ep, &ep->items[fd]);
+			ret = 0;
+		} else {
+			errno = ENOENT;
+			ret = -1;
+		}
+		break;
+
+	default:
+		errno = EINVAL;
+		ret = -1;
+		break;
+	}
+
+	k_mutex_unlock(&ep->mtx);
+
+	return ret;
+}
+
+/* Take the queued items off the ready list and report the ones which
+ * are ready, called with ep->mtx held.
+ */
+static int epoll_collect(struct epoll *ep, struct zsock_epoll_event *events,
+			 int maxevents)
+{
+	sys_dlist_t again;
+	sys_dnode_t *node;
+	k_spinlock_key_t key;
+	int count = 0;
+
+	sys_dlist_init(&again);
+
+	while (count < maxevents) {
+		struct epoll_item *item;
+		uint32_t ready;
+
+		key = k_spin_lock(&ep->lock);
+		node = sys_dlist_get(&ep->ready);
+		if (node == NULL) {
+			k_spin_unlock(&ep->lock, key);
+			break;
+		}
+
+		item = CONTAINER_OF(node, struct epoll_item, ready_node);
+		item->queued = false;
+		k_spin_unlock(&ep->lock, key);
+
+		/* The item cannot be reused while ep->mtx is held, only
+		 * forgotten if the descriptor is closed meanwhile.
+		 */
+		ready = epoll_fd_events(item - ep->items);
+
+		key = k_spin_lock(&ep->lock);
+
+		ready &= item->events | ZSOCK_EPOLLERR | ZSOCK_EPOLLHUP;
+		if (!item->in_use || ready == 0U) {
+			k_spin_unlock(&ep->lock, key);
+			continue;
+		}
+
+		events[count].events = ready;
+		events[count].data = item->data;
+		count++;
+
+		if (item->events & ZSOCK_EPOLLONESHOT) {
+			item->events = 0U;
+		} else if (!(item->events & ZSOCK_EPOLLET) && !item->queued) {
+			/* Level-triggered, look at it again next time */
+			sys_dlist_append(&again, &item->ready_node);
+			item->queued = true;
+		}
+
+		k_spin_unlock(&ep->lock, key);
+	}
+
+	key = k_spin_lock(&ep->lock);
+	while ((node = sys_dlist_get(&again)) != NULL) {
+		sys_dlist_append(&ep->ready, node);
+	}
+	k_spin_unlock(&ep->lock, key);
+
+	return count;
+}
+
+int zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+		     int maxevents, int timeout)
+{
+	k_timeout_t wait = timeout < 0 ? K_FOREVER : K_MSEC(timeout);
+	uint64_t end = sys_clock_timeout_end_calc(wait);
+	struct epoll *ep;
+	int count;
+
+	ep = epoll_get(epfd);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	if (maxevents <= 0 || events == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	k_mutex_lock(&ep->mtx, K_FOREVER);
+
+	for (;;) {
+		count = epoll_collect(ep, events, maxevents);
+		if (count > 0 || K_TIMEOUT_EQ(wait, K_NO_WAIT)) {
+			break;
+		}
+
+		/* Wait without the mutex so that the set can be changed
+		 * from other threads meanwhile
+		 */
+		k_mutex_unlock(&ep->mtx);
+
+		if (k_sem_take(&ep->wake, wait) != 0) {
+			wait = K_NO_WAIT;
+		} else if (!K_TIMEOUT_EQ(wait, K_FOREVER)) {
+			int64_t remaining = end - sys_clock_tick_get();
+
+			wait = remaining <= 0 ? K_NO_WAIT :
+					       Z_TIMEOUT_TICKS(remaining);
+		}
+
+		k_mutex_lock(&ep->mtx, K_FOREVER);
+	}
+
+	k_mutex_unlock(&ep->mtx);
+
+	return count;
+}
+
+static ssize_t epoll_read_vmeth(void *obj, void *buffer, size_t count)
+{
+	errno = EINVAL;
+	return -1;
+}
+
+static ssize_t epoll_write_vmeth(void *obj, const void *buffer, size_t count)
+{
+	errno = EINVAL;
+	return -1;
+}
+
+static int epoll_close_vmeth(void *obj)
+{
+	struct epoll *ep = obj;
+
+	k_mutex_lock(&ep->mtx, K_FOREVER);
+
+	for (int fd = 0; fd < ARRAY_SIZE(ep->items); fd++) {
+		if (ep->items[fd].in_use) {
+			epoll_detach(ep, &ep->items[fd]);
+		}
+	}
+
+	k_mutex_unlock(&ep->mtx);
+
+	k_mutex_lock(&epoll_alloc_mtx, K_FOREVER);
+	ep->in_use = false;
+	k_mutex_unlock(&epoll_alloc_mtx);
+
+	return 0;
+}
+
+static int epoll_ioctl_vmeth(void *obj, unsigned int request, va_list args)
+{
+	switch (request) {
+	case ZFD_IOCTL_SET_LOCK:
+		return 0;
+
+	default:
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+}
+
+static const struct fd_op_vtable epoll_fd_vtable = {
+	.read = epoll_read_vmeth,
+	.write = epoll_write_vmeth,
+	.close = epoll_close_vmeth,
+	.ioctl = epoll_ioctl_vmeth,
+};
@@ -214,6 +214,106 @@ static int cmd_kernel_stacks(const struct shell *shell,
 }
 #endif
 
+#if defined(CONFIG_SCHED_STATS)
+static void shell_sched_hist_print(const struct shell *shell, const char *name,
+				   const uint32_t *hist)
+{
+	char line[16 * CONFIG_SCHED_STATS_BUCKETS];
+	int pos = 0;
+
+	for (int b = 0; b < CONFIG_SCHED_STATS_BUCKETS; b++) {
+		pos += snprintk(line + pos, sizeof(line) - pos, " %u",
+				hist[b]);
+	}
+
+	shell_print(shell, "\t%-13s%s", name, line);
+}
+
+static void shell_sched_stats_print(const struct shell *shell,
+				    const k_thread_sched_stats_t *stats)
+{
+	shell_sched_hist_print(shell, "wake latency:", stats->wake_latency);
+	shell_sched_hist_print(shell, "run slice:", stats->run_slice);
+}
+
+#if defined(CONFIG_THREAD_MONITOR)
+static void shell_sched_stats_dump(const struct k_thread *cthread,
+				   void *user_data)
+{
+	struct k_thread *thread = (struct k_thread *)cthread;
+	const struct shell *shell = (const struct shell *)user_data;
+	k_thread_sched_stats_t stats;
+	const char *tname;
+
+	if (k_thread_sched_stats_get(thread, &stats) != 0) {
+		return;
+	}
+
+	tname = k_thread_name_get(thread);
+	shell_print(shell, "%p %-10s", thread, tname ? tname : "NA");
+	shell_sched_stats_print(shell, &stats);
+}
+#endif
+
+static int cmd_kernel_sched_stats(const struct shell *shell,
+				  size_t argc, char **argv)
+{
+	k_thread_sched_stats_t stats;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_print(shell, "Histograms: bucket 0 < %u cycles, each next "
+		    "bucket 2x wider, last bucket unbounded",
+		    1U << CONFIG_SCHED_STATS_SHIFT);
+
+	if (k_sched_stats_all_get(&stats) == 0) {
+		shell_print(shell, "All threads");
+		shell_sched_stats_print(shell, &stats);
+	}
+
+#if defined(CONFIG_THREAD_MONITOR)
+	k_thread_foreach(shell_sched_stats_dump, (void *)shell);
+#endif
+
+	return 0;
+}
+#endif
+
+#if defined(CONFIG_SYS_HEAP_RUNTIME_STATS)
+static int cmd_kernel_heaps(const struct shell *shell,
+			    size_t argc, char **argv)
+{
+	struct sys_heap_runtime_stats stats;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	Z_STRUCT_SECTION_FOREACH(k_heap, h) {
+		char line[16 * SYS_HEAP_RUNTIME_STATS_BUCKETS];
+		int pos = 0;
+
+		if (k_heap_runtime_stats_get(h, &stats) != 0) {
+			continue;
+		}
+
+		shell_print(shell, "%p used %zu/%zu peak %zu allocs %u "
+			    "largest free %zu", h, stats.allocated_bytes,
+			    stats.allocated_bytes + stats.free_bytes,
+			    stats.max_allocated_bytes, stats.alloc_count,
+			    stats.largest_free_bytes);
+
+		for (int b = 0; b < stats.nb_buckets; b++) {
+			pos += snprintk(line + pos, sizeof(line) - pos, " %u",
+					stats.free_chunks[b]);
+		}
+		shell_print(shell, "\tfree chunks per bucket:%s", line);
+	}
+
+	return 0;
+}
+#endif
+
 #if defined(CONFIG_REBOOT)
 static int cmd_kernel_reboot_warm(const struct shell *shell,
 				  size_t argc, char **argv)
@@ -248,9 +348,17 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel_reboot,
 
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel,
 	SHELL_CMD(cycles, NULL, "Kernel cycles.", cmd_kernel_cycles),
+#if defined(CONFIG_SYS_HEAP_RUNTIME_STATS)
+	SHELL_CMD(heaps, NULL, "Heap usage and free chunk histograms.",
+		  cmd_kernel_heaps),
+#endif
 #if defined(CONFIG_REBOOT)
 	SHELL_CMD(reboot, &sub_kernel_reboot, "Reboot.", NULL),
 #endif
+#if defined(CONFIG_SCHED_STATS)
+	SHELL_CMD(sched-stats, NULL, "Scheduler latency histograms.",
+		  cmd_kernel_sched_stats),
+#endif
 #if defined(CONFIG_INIT_STACKS) && defined(CONFIG_THREAD_STACK_INFO) && \
 		defined(CONFIG_THREAD_MONITOR)
 	SHELL_CMD(stacks, NULL, "List threads stack usage.", cmd_kernel_stacks),
@@ -21,6 +21,9 @@
 /* flag for performing the FIFO benchmark */
 #define FIFO_BENCH
 
+/* flag for performing the lock-free FIFO benchmark */
+#define MPSC_FIFO_BENCH
+
 /* flag for performing the Mutex benchmark */
 #define MUTEX_BENCH
 
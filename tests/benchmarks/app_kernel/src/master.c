@@ -44,6 +44,9 @@ K_MSGQ_DEFINE(DEMOQX4, 4, 500, 4);
 K_MSGQ_DEFINE(MB_COMM, 12, 1, 4);
 K_MSGQ_DEFINE(CH_COMM, 12, 1, 4);
 
+K_MPSC_MSGQ_DEFINE(MPSCQX1, 1, 512, K_MPSC_MSGQ_FLAG_SPSC);
+K_MPSC_MSGQ_DEFINE(MPSCQX4, 4, 512, K_MPSC_MSGQ_FLAG_SPSC);
+
 K_MEM_SLAB_DEFINE(MAP1, 16, 2, 4);
 
 K_SEM_DEFINE(SEM0, 0, 1);
@@ -129,6 +132,7 @@ void main(void)
 					 output_file);
 		PRINT_STRING(dashline, output_file);
 		queue_test();
+		mpsc_queue_test();
 		sema_test();
 		mutex_test();
 		memorymap_test();
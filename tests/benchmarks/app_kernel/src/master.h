@@ -98,6 +98,12 @@ extern void queue_test(void);
 #define queue_test dummy_test
 #endif
 
+#ifdef MPSC_FIFO_BENCH
+extern void mpsc_queue_test(void);
+#else
+#define mpsc_queue_test dummy_test
+#endif
+
 #ifdef MUTEX_BENCH
 extern void mutex_test(void);
 #else
@@ -137,6 +143,9 @@ extern struct k_msgq DEMOQX4;
 extern struct k_msgq MB_COMM;
 extern struct k_msgq CH_COMM;
 
+extern struct k_mpsc_msgq MPSCQX1;
+extern struct k_mpsc_msgq MPSCQX4;
+
 extern struct k_mbox MAILB1;
 
 
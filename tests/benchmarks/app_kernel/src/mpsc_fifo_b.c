@@ -0,0 +1,92 @@
+/* mpsc_fifo_b.c */
+
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "master.h"
+
+#ifdef MPSC_FIFO_BENCH
+
+/**
+ *
+ * @brief Lock-free queue transfer speed test
+ *
+ * Same sequence as queue_test(), on k_mpsc_msgq objects, so that the
+ * two sets of numbers can be compared line by line.
+ *
+ * @return N/A
+ */
+void mpsc_queue_test(void)
+{
+	uint32_t et; /* elapsed time */
+	int i;
+
+	PRINT_STRING(dashline, output_file);
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		k_mpsc_msgq_put(&MPSCQX1, data_bench);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+
+	PRINT_F(output_file, FORMAT, "enqueue 1 byte msg in MPSC FIFO",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		k_mpsc_msgq_get(&MPSCQX1, data_bench, K_FOREVER);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT, "dequeue 1 byte msg in MPSC FIFO",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		k_mpsc_msgq_put(&MPSCQX4, data_bench);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT, "enqueue 4 bytes msg in MPSC FIFO",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		k_mpsc_msgq_get(&MPSCQX4, data_bench, K_FOREVER);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT, "dequeue 4 bytes msg in MPSC FIFO",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+
+	k_sem_give(&STARTRCV);
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		k_mpsc_msgq_put(&MPSCQX1, data_bench);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT,
+			"enqueue 1 byte msg in MPSC FIFO to a waiting higher priority task",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		k_mpsc_msgq_put(&MPSCQX4, data_bench);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT,
+			"enqueue 4 bytes in MPSC FIFO to a waiting higher priority task",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+}
+
+#endif /* MPSC_FIFO_BENCH */
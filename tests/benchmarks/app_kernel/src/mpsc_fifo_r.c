@@ -0,0 +1,34 @@
+/* mpsc_fifo_r.c */
+
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "receiver.h"
+#include "master.h"
+
+#ifdef MPSC_FIFO_BENCH
+
+/* lock-free queue transfer speed test */
+/**
+ *
+ * @brief Data receive task
+ *
+ * @return N/A
+ */
+void mpsc_dequtask(void)
+{
+	int x, i;
+
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		k_mpsc_msgq_get(&MPSCQX1, &x, K_FOREVER);
+	}
+
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		k_mpsc_msgq_get(&MPSCQX4, &x, K_FOREVER);
+	}
+}
+
+#endif /* MPSC_FIFO_BENCH */
@@ -20,6 +20,7 @@
 char data_recv[MESSAGE_SIZE] = { 0 };
 
 void dequtask(void);
+void mpsc_dequtask(void);
 void waittask(void);
 void mailrecvtask(void);
 void piperecvtask(void);
@@ -37,6 +38,10 @@ void recvtask(void *p1, void *p2, void *p3)
 	k_sem_take(&STARTRCV, K_FOREVER);
 	dequtask();
 #endif
+#ifdef MPSC_FIFO_BENCH
+	k_sem_take(&STARTRCV, K_FOREVER);
+	mpsc_dequtask();
+#endif
 #ifdef SEMA_BENCH
 	k_sem_take(&STARTRCV, K_FOREVER);
 	waittask();
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/crc.h>
+#include <random/rand32.h>
+
+/* Time spent in the CRC functions on buffers of various sizes, with
+ * the table option the benchmark is built with.  Every size is run
+ * for the same amount of data, and the result of the last call is
+ * kept so that the calls cannot be optimized out.
+ */
+
+#define TOTAL_BYTES (1024U * 1024U)
+#define MAX_LEN 4096U
+
+static const uint16_t buf_len[] = { 16, 256, MAX_LEN };
+
+static uint8_t buf[MAX_LEN];
+static volatile uint32_t sink;
+
+static uint32_t bench_crc8_ccitt(const uint8_t *data, size_t len)
+{
+	return crc8_ccitt(CRC8_CCITT_INITIAL_VALUE, data, len);
+}
+
+static uint32_t bench_crc16_ccitt(const uint8_t *data, size_t len)
+{
+	return crc16_ccitt(0, data, len);
+}
+
+static uint32_t bench_crc16_itu_t(const uint8_t *data, size_t len)
+{
+	return crc16_itu_t(0, data, len);
+}
+
+static uint32_t bench_crc32_ieee(const uint8_t *data, size_t len)
+{
+	return crc32_ieee(data, len);
+}
+
+static uint32_t bench_crc32_c(const uint8_t *data, size_t len)
+{
+	return crc32_c(0, data, len, true, true);
+}
+
+static const struct {
+	const char *name;
+	uint32_t (*crc)(const uint8_t *data, size_t len);
+	/* CRC of "123456789" */
+	uint32_t check;
+} algos[] = {
+	{ "crc8_ccitt", bench_crc8_ccitt, 0xfb },
+	{ "crc16_ccitt", bench_crc16_ccitt, 0x2189 },
+	{ "crc16_itu_t", bench_crc16_itu_t, 0x31c3 },
+	{ "crc32_ieee", bench_crc32_ieee, 0xcbf43926 },
+	{ "crc32_c", bench_crc32_c, 0xe3069283 },
+};
+
+static void run(int algo, uint16_t len)
+{
+	static const uint8_t check[] = "123456789";
+	uint32_t rounds = TOTAL_BYTES / len;
+	uint32_t start, cycles;
+	uint64_t ns;
+	bool ok;
+
+	ok = algos[algo].crc(check, sizeof(check) - 1) == algos[algo].check;
+
+	start = k_cycle_get_32();
+
+	for (uint32_t i = 0; i < rounds; i++) {
+		sink = algos[algo].crc(buf, len);
+	}
+
+	cycles = k_cycle_get_32() - start;
+	ns = MAX(k_cyc_to_ns_floor64(cycles), 1);
+
+	printk("%s bytes %u ns/call %u MB/s %u %s\n", algos[algo].name, len,
+	       (uint32_t)(ns / rounds),
+	       (uint32_t)((uint64_t)len * rounds * 1000U / ns),
+	       ok ? "ok" : "bad");
+}
+
+void main(void)
+{
+	sys_rand_get(buf, sizeof(buf));
+
+	for (int i = 0; i < ARRAY_SIZE(algos); i++) {
+		for (int j = 0; j < ARRAY_SIZE(buf_len); j++) {
+			run(i, buf_len[j]);
+		}
+	}
+
+	printk("fin\n");
+}
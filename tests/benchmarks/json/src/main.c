@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <sys/printk.h>
+#include <data/json.h>
+
+/* Time spent encoding, parsing and tokenizing JSON payloads shaped
+ * like those of a Redfish service and of a LwM2M client.  Every
+ * operation is run for the same amount of JSON text, and its result
+ * is checked: the callback encoder must produce the same text as the
+ * buffer one, the parsed value must encode back to the same text, and
+ * the tokenizer must reach the end of the value.
+ */
+
+#define TOTAL_BYTES (1024U * 1024U)
+#define MAX_JSON_LEN (20U * 1024U)
+#define SENSORS 64
+#define RECORDS 128
+
+struct status {
+	const char *state;
+	const char *health;
+};
+
+struct sensor {
+	const char *odata_id;
+	const char *id;
+	const char *name;
+	struct json_obj_token reading;
+	const char *units;
+	bool enabled;
+	struct status status;
+	int64_t timestamp;
+};
+
+struct sensor_collection {
+	const char *odata_id;
+	const char *name;
+	int count;
+	struct sensor members[SENSORS];
+	size_t members_len;
+};
+
+static const struct json_obj_descr status_descr[] = {
+	JSON_OBJ_DESCR_PRIM_NAMED(struct status, "State", state,
+				  JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM_NAMED(struct status, "Health", health,
+				  JSON_TOK_STRING),
+};
+
+static const struct json_obj_descr sensor_descr[] = {
+	JSON_OBJ_DESCR_PRIM_NAMED(struct sensor, "@odata.id", odata_id,
+				  JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM_NAMED(struct sensor, "Id", id, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM_NAMED(struct sensor, "Name", name,
+				  JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM_NAMED(struct sensor, "Reading", reading,
+				  JSON_TOK_FLOAT),
+	JSON_OBJ_DESCR_PRIM_NAMED(struct sensor, "ReadingUnits", units,
+				  JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM_NAMED(struct sensor, "Enabled", enabled,
+				  JSON_TOK_TRUE),
+	JSON_OBJ_DESCR_OBJECT_NAMED(struct sensor, "Status", status,
+				    status_descr),
+	JSON_OBJ_DESCR_PRIM_NAMED(struct sensor, "Timestamp", timestamp,
+				  JSON_TOK_INT64),
+};
+
+static const struct json_obj_descr sensor_collection_descr[] = {
+	JSON_OBJ_DESCR_PRIM_NAMED(struct sensor_collection, "@odata.id",
+				  odata_id, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM_NAMED(struct sensor_collection, "Name", name,
+				  JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM_NAMED(struct sensor_collection,
+				  "Members@odata.count", count,
+				  JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_OBJ_ARRAY_NAMED(struct sensor_collection, "Members",
+				       members, SENSORS, members_len,
+				       sensor_descr,
+				       ARRAY_SIZE(sensor_descr)),
+};
+
+struct lwm2m_record {
+	const char *name;
+	struct json_obj_token value;
+	int64_t time;
+};
+
+struct lwm2m_object {
+	const char *base_name;
+	struct lwm2m_record records[RECORDS];
+	size_t records_len;
+};
+
+static const struct json_obj_descr lwm2m_record_descr[] = {
+	JSON_OBJ_DESCR_PRIM_NAMED(struct lwm2m_record, "n", name,
+				  JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM_NAMED(struct lwm2m_record, "v", value,
+				  JSON_TOK_FLOAT),
+	JSON_OBJ_DESCR_PRIM_NAMED(struct lwm2m_record, "t", time,
+				  JSON_TOK_INT64),
+};
+
+static const struct json_obj_descr lwm2m_object_descr[] = {
+	JSON_OBJ_DESCR_PRIM_NAMED(struct lwm2m_object, "bn", base_name,
+				  JSON_TOK_STRING),
+	JSON_OBJ_DESCR_OBJ_ARRAY_NAMED(struct lwm2m_object, "e", records,
+				       RECORDS, records_len,
+				       lwm2m_record_descr,
+				       ARRAY_SIZE(lwm2m_record_descr)),
+};
+
+static struct sensor_collection sensors, sensors_parsed;
+static struct lwm2m_object lwm2m, lwm2m_parsed;
+
+/* Text of the values, written once */
+static char sensor_text[SENSORS][3][48];
+static char sensor_reading[SENSORS][12];
+static char record_name[RECORDS][12];
+static char record_value[RECORDS][12];
+
+static const struct payload {
+	const char *name;
+	const struct json_obj_descr *descr;
+	size_t descr_len;
+	void *val;
+	void *parsed;
+} payloads[] = {
+	{ "redfish", sensor_collection_descr,
+	  ARRAY_SIZE(sensor_collection_descr), &sensors, &sensors_parsed },
+	{ "lwm2m", lwm2m_object_descr, ARRAY_SIZE(lwm2m_object_descr),
+	  &lwm2m, &lwm2m_parsed },
+};
+
+static const size_t chunk_len[] = { 64, 1460 };
+
+static char json[MAX_JSON_LEN];
+static char work[MAX_JSON_LEN];
+static char check[MAX_JSON_LEN];
+static size_t work_len;
+
+static void set_token(struct json_obj_token *token, char *text)
+{
+	token->start = text;
+	token->length = strlen(text);
+}
+
+static void fill_values(void)
+{
+	sensors.odata_id = "/redfish/v1/Chassis/1/Sensors";
+	sensors.name = "Chassis sensors";
+	sensors.count = SENSORS;
+	sensors.members_len = SENSORS;
+
+	for (int i = 0; i < SENSORS; i++) {
+		struct sensor *sensor = &sensors.members[i];
+
+		snprintk(sensor_text[i][0], sizeof(sensor_text[i][0]),
+			 "/redfish/v1/Chassis/1/Sensors/Temp%d", i);
+		snprintk(sensor_text[i][1], sizeof(sensor_text[i][1]),
+			 "Temp%d", i);
+		snprintk(sensor_text[i][2], sizeof(sensor_text[i][2]),
+			 "CPU %d package temperature", i);
+		snprintk(sensor_reading[i], sizeof(sensor_reading[i]),
+			 "%d.%03d", 30 + i % 50, (i * 137) % 1000);
+
+		sensor->odata_id = sensor_text[i][0];
+		sensor->id = sensor_text[i][1];
+		sensor->name = sensor_text[i][2];
+		set_token(&sensor->reading, sensor_reading[i]);
+		sensor->units = "Cel";
+		sensor->enabled = i % 8 != 0;
+		sensor->status.state = sensor->enabled ? "Enabled" :
+				       "Disabled";
+		sensor->status.health = "OK";
+		sensor->timestamp = 1634515200000LL + i * 1000LL;
+	}
+
+	lwm2m.base_name = "/3303/";
+	lwm2m.records_len = RECORDS;
+
+	for (int i = 0; i < RECORDS; i++) {
+		struct lwm2m_record *record = &lwm2m.records[i];
+
+		snprintk(record_name[i], sizeof(record_name[i]), "%d/5700",
+			 i);
+		snprintk(record_value[i], sizeof(record_value[i]),
+			 "-%d.%d", i % 40, i % 10);
+
+		record->name = record_name[i];
+		set_token(&record->value, record_value[i]);
+		record->time = 1634515200LL + i;
+	}
+}
+
+static int append_to_work(const char *bytes, size_t len, void *data)
+{
+	if (len > sizeof(work) - work_len) {
+		return -ENOMEM;
+	}
+
+	memcpy(work + work_len, bytes, len);
+	work_len += len;
+
+	return 0;
+}
+
+static int bench_encode_buf(const struct payload *p, size_t len)
+{
+	return json_obj_encode_buf(p->descr, p->descr_len, p->val, work,
+				   sizeof(work));
+}
+
+static int bench_encode_cb(const struct payload *p, size_t len)
+{
+	work_len = 0;
+
+	return json_obj_encode(p->descr, p->descr_len, p->val,
+			       append_to_work, NULL);
+}
+
+static int bench_parse(const struct payload *p, size_t len)
+{
+	/* Parsing writes into the text, it needs a fresh copy each time */
+	memcpy(work, json, len);
+
+	return json_obj_parse(work, len, p->descr, p->descr_len, p->parsed);
+}
+
+static int tokenize(size_t len, size_t chunk)
+{
+	struct json_tokenizer tok;
+	struct json_token token;
+	size_t fed = 0;
+	int ret;
+
+	json_tokenizer_init(&tok, work, sizeof(work));
+
+	for (;;) {
+		ret = json_tokenizer_next(&tok, &token);
+		if (ret == -EAGAIN) {
+			size_t n = MIN(chunk, len - fed);
+
+			json_tokenizer_feed(&tok, json + fed, n,
+					    fed + n == len);
+			fed += n;
+			continue;
+		}
+
+		if (ret < 0) {
+			return ret;
+		}
+
+		if (token.type == JSON_TOK_EOF) {
+			return 0;
+		}
+	}
+}
+
+static int bench_tokens_64(const struct payload *p, size_t len)
+{
+	return tokenize(len, chunk_len[0]);
+}
+
+static int bench_tokens_1460(const struct payload *p, size_t len)
+{
+	return tokenize(len, chunk_len[1]);
+}
+
+static bool check_encoded(const struct payload *p, size_t len, int ret)
+{
+	return ret == 0 && strlen(work) == len && !memcmp(work, json, len);
+}
+
+static bool check_encoded_cb(const struct payload *p, size_t len, int ret)
+{
+	return ret == 0 && work_len == len && !memcmp(work, json, len);
+}
+
+static bool check_parsed(const struct payload *p, size_t len, int ret)
+{
+	if (ret != BIT_MASK(p->descr_len)) {
+		return false;
+	}
+
+	ret = json_obj_encode_buf(p->descr, p->descr_len, p->parsed, check,
+				  sizeof(check));
+
+	return ret == 0 && strlen(check) == len && !memcmp(check, json, len);
+}
+
+static bool check_tokens(const struct payload *p, size_t len, int ret)
+{
+	return ret == 0;
+}
+
+static const struct {
+	const char *name;
+	int (*run)(const struct payload *p, size_t len);
+	bool (*check)(const struct payload *p, size_t len, int ret);
+} ops[] = {
+	{ "encode_buf", bench_encode_buf, check_encoded },
+	{ "encode_cb", bench_encode_cb, check_encoded_cb },
+	{ "parse", bench_parse, check_parsed },
+	{ "tokens/64", bench_tokens_64, check_tokens },
+	{ "tokens/1460", bench_tokens_1460, check_tokens },
+};
+
+static void run(const struct payload *p, int op, size_t len)
+{
+	uint32_t rounds = MAX(TOTAL_BYTES / len, 1);
+	uint32_t start, cycles;
+	uint64_t ns;
+	int ret = 0;
+
+	start = k_cycle_get_32();
+
+	for (uint32_t i = 0; i < rounds; i++) {
+		ret = ops[op].run(p, len);
+	}
+
+	cycles = k_cycle_get_32() - start;
+	ns = MAX(k_cyc_to_ns_floor64(cycles), 1);
+
+	printk("%s %s bytes %zu ns/op %u KB/s %u %s\n", p->name, ops[op].name,
+	       len, (uint32_t)(ns / rounds),
+	       (uint32_t)((uint64_t)len * rounds * 1000000000U / 1024U / ns),
+	       ops[op].check(p, len, ret) ? "ok" : "bad");
+}
+
+void main(void)
+{
+	fill_values();
+
+	for (int i = 0; i < ARRAY_SIZE(payloads); i++) {
+		const struct payload *p = &payloads[i];
+		int ret;
+
+		ret = json_obj_encode_buf(p->descr, p->descr_len, p->val, json,
+					  sizeof(json));
+		if (ret < 0) {
+			printk("Cannot encode %s payload (%d)\n", p->name, ret);
+			return;
+		}
+
+		for (int j = 0; j < ARRAY_SIZE(ops); j++) {
+			run(p, j, strlen(json));
+		}
+	}
+
+	printk("fin\n");
+}
@@ -28,6 +28,8 @@ extern int sema_test(void);
 extern int sema_context_switch(void);
 extern int suspend_resume(void);
 extern void heap_malloc_free(void);
+extern void syscall_user(void);
+extern void sys_mutex_user(void);
 
 void test_thread(void *arg1, void *arg2, void *arg3)
 {
@@ -60,6 +62,10 @@ void test_thread(void *arg1, void *arg2, void *arg3)
 
 	heap_malloc_free();
 
+	syscall_user();
+
+	sys_mutex_user();
+
 	TC_END_REPORT(error_count);
 }
 
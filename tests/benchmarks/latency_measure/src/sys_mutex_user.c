@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * Measure sys_mutex lock/unlock pairs made from user mode threads, both
+ * uncontended and with a higher priority thread waiting on every unlock.
+ * Build with and without CONFIG_SYS_MUTEX_FAST_PATH to compare the
+ * system call and the atomic fast path implementations.
+ *
+ * As in syscall_user.c, the time is taken around the lifetime of the user
+ * threads and the same run without the mutex operations is subtracted.
+ */
+
+#include <zephyr.h>
+#include <sys/mutex.h>
+#include <app_memory/app_memdomain.h>
+#include <timing/timing.h>
+#include "utils.h"
+
+#ifdef CONFIG_USERSPACE
+
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define NUM_ITER 1000
+
+K_APPMEM_PARTITION_DEFINE(mutex_part);
+K_APP_BMEM(mutex_part) static SYS_MUTEX_DEFINE(bench_mutex);
+static struct k_mem_domain mutex_domain;
+
+K_THREAD_STACK_DEFINE(high_stack, STACK_SIZE);
+K_THREAD_STACK_DEFINE(low_stack, STACK_SIZE);
+static struct k_thread high_thread;
+static struct k_thread low_thread;
+
+K_SEM_DEFINE(handoff_sem, 0, 1);
+
+static void uncontended(void *p1, void *p2, void *p3)
+{
+	uint32_t count = (uint32_t)(uintptr_t)p1;
+	bool use_mutex = (bool)(uintptr_t)p2;
+
+	ARG_UNUSED(p3);
+
+	for (uint32_t i = 0; i < count; i++) {
+		if (use_mutex) {
+			sys_mutex_lock(&bench_mutex, K_FOREVER);
+			sys_mutex_unlock(&bench_mutex);
+		}
+	}
+}
+
+/* Woken by the low priority thread while it holds the mutex, so every
+ * lock blocks and every unlock by the low priority thread hands over.
+ */
+static void contended_high(void *p1, void *p2, void *p3)
+{
+	uint32_t count = (uint32_t)(uintptr_t)p1;
+	bool use_mutex = (bool)(uintptr_t)p2;
+
+	ARG_UNUSED(p3);
+
+	for (uint32_t i = 0; i < count; i++) {
+		k_sem_take(&handoff_sem, K_FOREVER);
+		if (use_mutex) {
+			sys_mutex_lock(&bench_mutex, K_FOREVER);
+			sys_mutex_unlock(&bench_mutex);
+		}
+	}
+}
+
+static void contended_low(void *p1, void *p2, void *p3)
+{
+	uint32_t count = (uint32_t)(uintptr_t)p1;
+	bool use_mutex = (bool)(uintptr_t)p2;
+
+	ARG_UNUSED(p3);
+
+	for (uint32_t i = 0; i < count; i++) {
+		if (use_mutex) {
+			sys_mutex_lock(&bench_mutex, K_FOREVER);
+		}
+		k_sem_give(&handoff_sem);
+		if (use_mutex) {
+			sys_mutex_unlock(&bench_mutex);
+		}
+	}
+}
+
+static k_tid_t user_thread_start(struct k_thread *thread,
+				 k_thread_stack_t *stack,
+				 k_thread_entry_t entry, int prio,
+				 bool use_mutex)
+{
+	k_tid_t tid;
+
+	tid = k_thread_create(thread, stack, STACK_SIZE, entry,
+			      (void *)(uintptr_t)NUM_ITER,
+			      (void *)(uintptr_t)use_mutex, NULL,
+			      prio, K_USER | K_INHERIT_PERMS, K_FOREVER);
+	k_mem_domain_add_thread(&mutex_domain, tid);
+	k_thread_start(tid);
+
+	return tid;
+}
+
+static uint32_t run_uncontended(bool use_mutex)
+{
+	timing_t start_time, end_time;
+
+	start_time = timing_counter_get();
+
+	user_thread_start(&low_thread, low_stack, uncontended,
+			  K_PRIO_PREEMPT(5), use_mutex);
+	k_thread_join(&low_thread, K_FOREVER);
+
+	end_time = timing_counter_get();
+
+	return timing_cycles_get(&start_time, &end_time);
+}
+
+static uint32_t run_contended(bool use_mutex)
+{
+	timing_t start_time, end_time;
+
+	k_sem_reset(&handoff_sem);
+
+	start_time = timing_counter_get();
+
+	/* The high priority thread runs first and waits for the semaphore */
+	user_thread_start(&high_thread, high_stack, contended_high,
+			  K_PRIO_PREEMPT(5), use_mutex);
+	user_thread_start(&low_thread, low_stack, contended_low,
+			  K_PRIO_PREEMPT(7), use_mutex);
+	k_thread_join(&low_thread, K_FOREVER);
+	k_thread_join(&high_thread, K_FOREVER);
+
+	end_time = timing_counter_get();
+
+	return timing_cycles_get(&start_time, &end_time);
+}
+
+static uint32_t diff(uint32_t total, uint32_t base)
+{
+	return (total > base) ? (total - base) : 0U;
+}
+
+void sys_mutex_user(void)
+{
+	struct k_mem_partition *parts[] = { &mutex_part };
+	uint32_t base, total;
+
+	k_mem_domain_init(&mutex_domain, ARRAY_SIZE(parts), parts);
+	k_object_access_grant(&handoff_sem, k_current_get());
+
+	timing_start();
+
+	base = run_uncontended(false);
+	total = run_uncontended(true);
+	PRINT_STATS_AVG("Average user sys_mutex lock/unlock (uncontended)",
+			diff(total, base), NUM_ITER);
+
+	base = run_contended(false);
+	total = run_contended(true);
+	PRINT_STATS_AVG("Average user sys_mutex lock/unlock (contended)",
+			diff(total, base), NUM_ITER);
+
+	timing_stop();
+}
+
+#else
+
+void sys_mutex_user(void)
+{
+}
+
+#endif /* CONFIG_USERSPACE */
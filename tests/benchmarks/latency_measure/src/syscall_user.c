@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * Measure the cost of a system call made from a user mode thread, once on
+ * a statically defined kernel object and once on a dynamically allocated
+ * one while many other dynamic objects exist.  Both have to be found and
+ * validated by the kernel before the call proceeds.
+ *
+ * User threads may not be able to read the timing counter, so the time
+ * is taken around the whole lifetime of a user thread making the calls,
+ * and the lifetime of one making no calls at all is subtracted.
+ */
+
+#include <zephyr.h>
+#include <timing/timing.h>
+#include "utils.h"
+
+#ifdef CONFIG_USERSPACE
+
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define NUM_CALLS 1000
+#define NUM_DYN_OBJS 256
+
+K_THREAD_STACK_DEFINE(user_stack, STACK_SIZE);
+static struct k_thread user_thread;
+
+K_SEM_DEFINE(static_sem, 0, 1);
+
+static void user_sem_give(void *p1, void *p2, void *p3)
+{
+	struct k_sem *sem = p1;
+	uint32_t count = (uint32_t)(uintptr_t)p2;
+
+	ARG_UNUSED(p3);
+
+	for (uint32_t i = 0; i < count; i++) {
+		k_sem_give(sem);
+	}
+}
+
+static uint32_t user_run(struct k_sem *sem, uint32_t count)
+{
+	timing_t start_time, end_time;
+
+	start_time = timing_counter_get();
+
+	k_thread_create(&user_thread, user_stack, STACK_SIZE,
+			user_sem_give, sem, (void *)(uintptr_t)count, NULL,
+			K_PRIO_PREEMPT(5), K_USER | K_INHERIT_PERMS, K_NO_WAIT);
+	k_thread_join(&user_thread, K_FOREVER);
+
+	end_time = timing_counter_get();
+
+	return timing_cycles_get(&start_time, &end_time);
+}
+
+static uint32_t user_calls(struct k_sem *sem)
+{
+	uint32_t base = user_run(sem, 0);
+	uint32_t total = user_run(sem, NUM_CALLS);
+
+	return (total > base) ? (total - base) : 0U;
+}
+
+#ifdef CONFIG_DYNAMIC_OBJECTS
+static struct k_sem *dyn_sems[NUM_DYN_OBJS];
+
+static void dyn_syscall(void)
+{
+	struct k_sem *sem;
+	uint32_t sum;
+	int i;
+
+	for (i = 0; i < NUM_DYN_OBJS; i++) {
+		dyn_sems[i] = k_object_alloc(K_OBJ_SEM);
+		if (dyn_sems[i] == NULL) {
+			printk("Failed to allocate dynamic object %d\n", i);
+			error_count++;
+			break;
+		}
+		k_sem_init(dyn_sems[i], 0, 1);
+	}
+
+	if (i == NUM_DYN_OBJS) {
+		/* Allocated somewhere in the middle of the others */
+		sem = dyn_sems[NUM_DYN_OBJS / 2];
+
+		sum = user_calls(sem);
+		PRINT_STATS_AVG("Average user syscall on a dynamic object",
+				sum, NUM_CALLS);
+	}
+
+	while (i-- > 0) {
+		k_object_free(dyn_sems[i]);
+	}
+}
+#endif /* CONFIG_DYNAMIC_OBJECTS */
+
+void syscall_user(void)
+{
+	uint32_t sum;
+
+	timing_start();
+
+	k_thread_system_pool_assign(k_current_get());
+	k_object_access_grant(&static_sem, k_current_get());
+
+	sum = user_calls(&static_sem);
+	PRINT_STATS_AVG("Average user syscall on a static object", sum,
+			NUM_CALLS);
+
+#ifdef CONFIG_DYNAMIC_OBJECTS
+	dyn_syscall();
+#endif
+
+	timing_stop();
+}
+
+#else
+
+void syscall_user(void)
+{
+}
+
+#endif /* CONFIG_USERSPACE */
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <logging/log.h>
+#include <logging/log_ctrl.h>
+#include <logging/log_backend.h>
+#include <logging/log_backend_std.h>
+#include <logging/log_output.h>
+#include <logging/log_output_dict.h>
+
+LOG_MODULE_REGISTER(bench, LOG_LEVEL_INF);
+
+/* Messages logged and processed in text and in dictionary mode, by a
+ * backend which only counts the bytes of the output.  Logging a message
+ * costs the same in both modes, processing it differs: text mode
+ * formats the string on the target, dictionary mode copies the package
+ * out as it is.
+ */
+
+#define BATCH 64
+#define BATCHES 64
+#define UART_BAUD 115200U
+
+/* Start, 8 data bits and stop bit */
+#define UART_BITS_PER_BYTE 10U
+
+static const char *const links[] = { "eth0", "wlan0", "ppp0", "lo" };
+static const uint8_t frame[16] = {
+	0x45, 0x00, 0x00, 0x54, 0x12, 0x34, 0x40, 0x00,
+	0x40, 0x01, 0xb7, 0x2c, 0xc0, 0x00, 0x02, 0x01,
+};
+
+static bool dict_mode;
+static uint8_t out_buf[256];
+static size_t out_bytes;
+static uint32_t out_msgs;
+static uint32_t bad_msgs;
+static uint32_t dropped_msgs;
+
+static int out_func(uint8_t *data, size_t length, void *ctx)
+{
+	out_bytes += length;
+
+	return length;
+}
+
+LOG_OUTPUT_DEFINE(bench_output, out_func, out_buf, sizeof(out_buf));
+
+static void process(const struct log_backend *const backend,
+		    union log_msg2_generic *msg)
+{
+	uint32_t flags = log_backend_std_get_flags();
+	size_t before = out_bytes;
+
+	if (dict_mode) {
+		log_dict_output_msg2_process(&bench_output, &msg->log, flags);
+		if (out_bytes - before != log_dict_output_msg2_len(&msg->log)) {
+			bad_msgs++;
+		}
+	} else {
+		log_output_msg2_process(&bench_output, &msg->log, flags);
+		if (out_bytes == before) {
+			bad_msgs++;
+		}
+	}
+
+	out_msgs++;
+}
+
+static void dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+	dropped_msgs += cnt;
+}
+
+static void panic(const struct log_backend *const backend)
+{
+}
+
+static const struct log_backend_api bench_backend_api = {
+	.process = process,
+	.dropped = dropped,
+	.panic = panic,
+};
+
+LOG_BACKEND_DEFINE(bench_backend, bench_backend_api, true);
+
+static void log_one(int i)
+{
+	switch (i % 4) {
+	case 0:
+		LOG_INF("sensor %d reading %d mV", i, 3300 - i);
+		break;
+	case 1:
+		LOG_WRN("link %s state %d", links[i % ARRAY_SIZE(links)],
+			i & 1);
+		break;
+	case 2:
+		LOG_ERR("timeout %u after %u ms", i, i * 10);
+		break;
+	default:
+		LOG_HEXDUMP_INF(frame, sizeof(frame), "frame");
+		break;
+	}
+}
+
+static void run(bool dict)
+{
+	uint32_t msgs = BATCH * BATCHES;
+	uint32_t log_cycles = 0U, process_cycles = 0U;
+	uint32_t start;
+	uint64_t ns, process_ns;
+	size_t bytes;
+
+	dict_mode = dict;
+	out_bytes = 0;
+	out_msgs = 0U;
+	bad_msgs = 0U;
+	dropped_msgs = 0U;
+
+	for (int b = 0; b < BATCHES; b++) {
+		start = k_cycle_get_32();
+		for (int i = 0; i < BATCH; i++) {
+			log_one(b * BATCH + i);
+		}
+		log_cycles += k_cycle_get_32() - start;
+
+		start = k_cycle_get_32();
+		while (log_process(false)) {
+		}
+		process_cycles += k_cycle_get_32() - start;
+	}
+
+	ns = MAX(k_cyc_to_ns_floor64(log_cycles + process_cycles), 1);
+	process_ns = k_cyc_to_ns_floor64(process_cycles);
+	bytes = MAX(out_bytes / MAX(out_msgs, 1), 1);
+
+	printk("%s msgs %u msgs/s %u process ns/msg %u bytes/msg %u "
+	       "uart115200 msgs/s %u %s\n", dict ? "dict" : "text", out_msgs,
+	       (uint32_t)((uint64_t)out_msgs * 1000000000U / ns),
+	       (uint32_t)(process_ns / MAX(out_msgs, 1)), (uint32_t)bytes,
+	       (uint32_t)(UART_BAUD / UART_BITS_PER_BYTE / bytes),
+	       out_msgs == msgs && bad_msgs == 0U && dropped_msgs == 0U ?
+	       "ok" : "bad");
+}
+
+void main(void)
+{
+	run(false);
+	run(true);
+
+	printk("fin\n");
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/ring_buffer.h>
+#include <sys/mpsc_ring_buffer.h>
+
+/* Message throughput from several producers to one consumer.  Each
+ * producer writes numbered messages as fast as it can, retrying when the
+ * buffer is full, and the consumer reads them and checks the number
+ * of each producer's messages.  With the ring buffer, every producer
+ * takes the same spinlock to write; with the multi producer ring
+ * buffer, they only contend on the atomic reservation of space.
+ */
+
+#define PRODUCERS MAX(CONFIG_MP_NUM_CPUS - 1, 1)
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define RUN_MS 2000
+#define N_SETTLE_MS 100
+#define MSG_LEN 4
+#define POW 10
+
+RING_BUF_ITEM_DECLARE_POW2(locked_buf, POW);
+MPSC_RING_BUF_ITEM_DECLARE_POW2(mpsc_buf, POW);
+
+static struct k_spinlock lock;
+
+static K_THREAD_STACK_ARRAY_DEFINE(producer_stacks, PRODUCERS, STACK_SIZE);
+static K_THREAD_STACK_DEFINE(consumer_stack, STACK_SIZE);
+static struct k_thread producer_threads[PRODUCERS];
+static struct k_thread consumer_thread;
+
+static volatile bool stop;
+/* Messages read, only written by the consumer */
+static volatile uint32_t count;
+static volatile uint32_t bad;
+
+static int locked_put(uint16_t id, uint32_t *msg)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	int ret = ring_buf_item_put(&locked_buf, id, 0, msg, MSG_LEN);
+
+	k_spin_unlock(&lock, key);
+
+	return ret;
+}
+
+/* A single consumer does not need the producers' lock */
+static int locked_get(uint16_t *id, uint32_t *msg, uint8_t *len)
+{
+	uint8_t value;
+
+	return ring_buf_item_get(&locked_buf, id, &value, msg, len);
+}
+
+static int mpsc_put(uint16_t id, uint32_t *msg)
+{
+	return mpsc_ring_buf_item_put(&mpsc_buf, id, 0, msg, MSG_LEN);
+}
+
+static int mpsc_get(uint16_t *id, uint32_t *msg, uint8_t *len)
+{
+	uint8_t value;
+
+	return mpsc_ring_buf_item_get(&mpsc_buf, id, &value, msg, len);
+}
+
+static const struct {
+	const char *name;
+	int (*put)(uint16_t id, uint32_t *msg);
+	int (*get)(uint16_t *id, uint32_t *msg, uint8_t *len);
+} modes[] = {
+	{ "spinlock", locked_put, locked_get },
+	{ "mpsc", mpsc_put, mpsc_get },
+};
+
+static void producer_fn(void *arg1, void *arg2, void *arg3)
+{
+	int mode = POINTER_TO_INT(arg1);
+	uint16_t id = POINTER_TO_UINT(arg2);
+	uint32_t msg[MSG_LEN] = { 0 };
+
+	ARG_UNUSED(arg3);
+
+	while (!stop) {
+		if (modes[mode].put(id, msg) == 0) {
+			msg[0]++;
+		} else {
+			k_yield();
+		}
+	}
+}
+
+static void consumer_fn(void *arg1, void *arg2, void *arg3)
+{
+	int mode = POINTER_TO_INT(arg1);
+	uint32_t next[PRODUCERS] = { 0 };
+	uint32_t msg[MSG_LEN];
+	uint16_t id;
+	uint8_t len;
+
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	while (!stop) {
+		len = MSG_LEN;
+		if (modes[mode].get(&id, msg, &len) != 0) {
+			k_yield();
+			continue;
+		}
+
+		if (id >= PRODUCERS || len != MSG_LEN || msg[0] != next[id]) {
+			bad++;
+		} else {
+			next[id]++;
+		}
+
+		count++;
+	}
+}
+
+static void run(int mode)
+{
+	/* Workers run below main so it can always preempt them to
+	 * take its samples
+	 */
+	int prio = k_thread_priority_get(k_current_get()) + 1;
+
+	stop = false;
+	count = 0U;
+	bad = 0U;
+
+	k_thread_create(&consumer_thread, consumer_stack, STACK_SIZE,
+			consumer_fn, INT_TO_POINTER(mode), NULL, NULL,
+			prio, 0, K_NO_WAIT);
+
+	for (int i = 0; i < PRODUCERS; i++) {
+		k_thread_create(&producer_threads[i], producer_stacks[i],
+				STACK_SIZE, producer_fn, INT_TO_POINTER(mode),
+				UINT_TO_POINTER(i), NULL, prio, 0, K_NO_WAIT);
+	}
+
+	/* Let startup and cache effects settle before measuring */
+	k_msleep(N_SETTLE_MS);
+
+	uint32_t start = count;
+	int64_t t0 = k_uptime_get();
+
+	k_msleep(RUN_MS);
+
+	uint32_t end = count;
+	int64_t elapsed = k_uptime_get() - t0;
+
+	stop = true;
+	k_thread_join(&consumer_thread, K_FOREVER);
+	for (int i = 0; i < PRODUCERS; i++) {
+		k_thread_join(&producer_threads[i], K_FOREVER);
+	}
+
+	printk("%s cpus %d producers %d msgs/s %u %s\n", modes[mode].name,
+	       CONFIG_MP_NUM_CPUS, PRODUCERS,
+	       (uint32_t)((uint64_t)(end - start) * 1000U / elapsed),
+	       bad == 0U ? "ok" : "bad");
+}
+
+void main(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(modes); i++) {
+		run(i);
+	}
+
+	printk("fin\n");
+}
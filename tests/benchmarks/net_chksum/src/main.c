@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_chksum_bench, LOG_LEVEL_NONE);
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <random/rand32.h>
+#include <net/net_core.h>
+#include <net/net_if.h>
+#include <net/net_ip.h>
+#include <net/net_pkt.h>
+
+#include "net_private.h"
+
+/* Time spent in net_calc_chksum() on UDP packets of various sizes.  The
+ * packets are built in memory with random payloads, and computing the
+ * checksum does not change them, so the same one is summed again and
+ * again.
+ */
+
+#define ROUNDS 10000U
+
+static const uint16_t payload_len[] = { 64, 256, 1024, 1460 };
+
+static struct net_pkt *build_pkt(uint16_t len)
+{
+	struct net_ipv4_hdr ipv4 = { .vhl = 0x45, .ttl = 64,
+				     .proto = IPPROTO_UDP };
+	struct net_udp_hdr udp = { .src_port = htons(4242),
+				   .dst_port = htons(4242) };
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc_with_buffer(net_if_get_default(),
+					sizeof(udp) + len, AF_INET,
+					IPPROTO_UDP, K_NO_WAIT);
+	if (!pkt) {
+		return NULL;
+	}
+
+	net_addr_pton(AF_INET, "198.51.100.1", &ipv4.src);
+	net_addr_pton(AF_INET, "192.0.2.1", &ipv4.dst);
+	ipv4.len = htons(sizeof(ipv4) + sizeof(udp) + len);
+	udp.len = htons(sizeof(udp) + len);
+
+	if (net_pkt_write(pkt, &ipv4, sizeof(ipv4)) ||
+	    net_pkt_write(pkt, &udp, sizeof(udp))) {
+		goto fail;
+	}
+
+	for (uint16_t i = 0; i < len; i += sizeof(uint32_t)) {
+		uint32_t word = sys_rand32_get();
+
+		if (net_pkt_write(pkt, &word, MIN(sizeof(word), len - i))) {
+			goto fail;
+		}
+	}
+
+	net_pkt_set_ip_hdr_len(pkt, sizeof(ipv4));
+	net_pkt_cursor_init(pkt);
+
+	return pkt;
+
+fail:
+	net_pkt_unref(pkt);
+	return NULL;
+}
+
+/* The UDP checksum of the packet with its own checksum in must be zero */
+static bool verify(struct net_pkt *pkt, uint16_t chksum)
+{
+	NET_PKT_DATA_ACCESS_DEFINE(udp_access, struct net_udp_hdr);
+	struct net_udp_hdr *udp;
+
+	net_pkt_set_overwrite(pkt, true);
+	net_pkt_cursor_init(pkt);
+	net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt));
+
+	udp = (struct net_udp_hdr *)net_pkt_get_data(pkt, &udp_access);
+	if (!udp) {
+		return false;
+	}
+
+	udp->chksum = chksum;
+	net_pkt_set_data(pkt, &udp_access);
+
+	return net_calc_verify_chksum_udp(pkt) == 0U;
+}
+
+static int run(uint16_t len)
+{
+	uint32_t start, cycles;
+	struct net_pkt *pkt;
+	uint16_t chksum = 0U;
+	uint64_t ns;
+
+	pkt = build_pkt(len);
+	if (!pkt) {
+		printk("Cannot build a packet of %u bytes\n", len);
+		return -1;
+	}
+
+	start = k_cycle_get_32();
+
+	for (uint32_t i = 0; i < ROUNDS; i++) {
+		chksum = net_calc_chksum_udp(pkt);
+	}
+
+	cycles = k_cycle_get_32() - start;
+	ns = MAX(k_cyc_to_ns_floor64(cycles), 1);
+
+	printk("chksum bytes %u ns/pkt %u MB/s %u %s\n", len,
+	       (uint32_t)(ns / ROUNDS),
+	       (uint32_t)((uint64_t)len * ROUNDS * 1000U / ns),
+	       verify(pkt, chksum) ? "ok" : "bad");
+
+	net_pkt_unref(pkt);
+
+	return 0;
+}
+
+void main(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(payload_len); i++) {
+		if (run(payload_len[i]) < 0) {
+			return;
+		}
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_core.h>
+#include <net/net_if.h>
+#include <net/net_ip.h>
+#include <net/net_pkt.h>
+
+#include "connection.h"
+
+/* Time spent in net_conn_input() to find the handler of a UDP packet
+ * with few and with many handlers registered.  The headers are built
+ * in memory and the packet is not consumed by the handler, so that
+ * the same one can be fed again and again.
+ */
+
+#define LOOKUPS 100000U
+#define BASE_PORT 10000U
+#define PORT_HANDLERS 128U
+#define ANY_HANDLERS 4U
+
+static struct net_conn_handle *handles[PORT_HANDLERS + ANY_HANDLERS];
+static uint32_t hits;
+
+static enum net_verdict count_cb(struct net_conn *conn, struct net_pkt *pkt,
+				 union net_ip_header *ip_hdr,
+				 union net_proto_header *proto_hdr,
+				 void *user_data)
+{
+	hits++;
+
+	return NET_OK;
+}
+
+static int register_handlers(unsigned int port_handlers,
+			     unsigned int any_handlers)
+{
+	unsigned int n = 0U;
+	int ret;
+
+	for (unsigned int i = 0; i < port_handlers; i++) {
+		ret = net_conn_register(IPPROTO_UDP, AF_INET, NULL, NULL, 0,
+					BASE_PORT + i, NULL, count_cb, NULL,
+					&handles[n++]);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	/* Bound to a remote port only, never matching the packets */
+	for (unsigned int i = 0; i < any_handlers; i++) {
+		ret = net_conn_register(IPPROTO_UDP, AF_INET, NULL, NULL,
+					1 + i, 0, NULL, count_cb, NULL,
+					&handles[n++]);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return n;
+}
+
+static int run(unsigned int port_handlers, unsigned int any_handlers)
+{
+	struct net_ipv4_hdr ipv4 = { .vhl = 0x45, .ttl = 64,
+				     .proto = IPPROTO_UDP };
+	struct net_udp_hdr udp = { .src_port = htons(4242) };
+	union net_ip_header ip_hdr = { .ipv4 = &ipv4 };
+	union net_proto_header proto_hdr = { .udp = &udp };
+	struct net_pkt *pkt;
+	uint32_t start, cycles;
+	int n;
+
+	net_addr_pton(AF_INET, "198.51.100.1", &ipv4.src);
+	net_addr_pton(AF_INET, "192.0.2.1", &ipv4.dst);
+
+	pkt = net_pkt_alloc_on_iface(net_if_get_default(), K_NO_WAIT);
+	if (!pkt) {
+		printk("Cannot allocate packet\n");
+		return -1;
+	}
+
+	net_pkt_set_family(pkt, AF_INET);
+
+	n = register_handlers(port_handlers, any_handlers);
+	if (n < 0) {
+		printk("Cannot register handlers (%d)\n", n);
+		return -1;
+	}
+
+	hits = 0U;
+	start = k_cycle_get_32();
+
+	for (uint32_t i = 0; i < LOOKUPS; i++) {
+		udp.dst_port = htons(BASE_PORT + i % port_handlers);
+		(void)net_conn_input(pkt, &ip_hdr, IPPROTO_UDP, &proto_hdr);
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	while (n-- > 0) {
+		net_conn_unregister(handles[n]);
+	}
+
+	net_pkt_unref(pkt);
+
+	printk("demux handlers %u lookups %u ns/pkt %u %s\n",
+	       port_handlers + any_handlers, LOOKUPS,
+	       (uint32_t)(k_cyc_to_ns_floor64(cycles) / LOOKUPS),
+	       hits == LOOKUPS ? "ok" : "miss");
+
+	return 0;
+}
+
+void main(void)
+{
+	if (run(1, 0) < 0 || run(PORT_HANDLERS, ANY_HANDLERS) < 0) {
+		return;
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_if.h>
+#include <net/socket.h>
+
+/* Large UDP datagrams over the loopback interface, fragmented by the
+ * IPv4 layer on their way out and reassembled on their way in.  The
+ * peer address is not ours, so that the datagrams do go through the
+ * interface, the loopback driver swapping the addresses back.  Every
+ * datagram carries its sequence number, the receiver checks that they
+ * all arrive in order and whole.
+ */
+
+#define SERVER_PORT 4242
+#define CLIENT_PORT 4243
+#define PEER_ADDR "192.0.2.2"
+#define LOOPBACK_MTU 1500
+#define TOTAL_BYTES (2U * 1024U * 1024U)
+
+/* The largest one fills an IPv4 datagram */
+#define MAX_DGRAM_LEN (UINT16_MAX - NET_IPV4H_LEN - NET_UDPH_LEN)
+
+static const uint16_t dgram_len[] = { 8192, 16384, 32768, MAX_DGRAM_LEN };
+
+static uint8_t tx_buf[MAX_DGRAM_LEN];
+static uint8_t rx_buf[MAX_DGRAM_LEN];
+static int client;
+static int sender_err;
+
+K_THREAD_STACK_DEFINE(sender_stack, 2048);
+static struct k_thread sender_thread;
+
+static void sender(void *p1, void *p2, void *p3)
+{
+	uint16_t len = POINTER_TO_UINT(p1);
+	uint32_t count = POINTER_TO_UINT(p2);
+
+	for (uint32_t seq = 0; seq < count; seq++) {
+		memcpy(tx_buf, &seq, sizeof(seq));
+
+		if (send(client, tx_buf, len, 0) < 0) {
+			sender_err = errno;
+			break;
+		}
+	}
+
+	close(client);
+}
+
+static void start_sender(uint16_t len, uint32_t count)
+{
+	sender_err = 0;
+	k_thread_create(&sender_thread, sender_stack,
+			K_THREAD_STACK_SIZEOF(sender_stack), sender,
+			UINT_TO_POINTER(len), UINT_TO_POINTER(count), NULL,
+			K_PRIO_PREEMPT(8), 0, K_NO_WAIT);
+}
+
+static void make_addr(struct sockaddr_in *addr, const char *ip,
+		      uint16_t port)
+{
+	addr->sin_family = AF_INET;
+	addr->sin_port = htons(port);
+	inet_pton(AF_INET, ip, &addr->sin_addr);
+}
+
+static int run(int idx)
+{
+	struct sockaddr_in server_addr, client_addr, peer_addr;
+	struct timeval tv = { .tv_usec = 500000 };
+	uint16_t len = dgram_len[idx];
+	uint32_t count = TOTAL_BYTES / len;
+	uint32_t got = 0U;
+	bool in_order = true;
+	int64_t t0, last;
+	int server;
+
+	make_addr(&server_addr, CONFIG_NET_CONFIG_MY_IPV4_ADDR,
+		  SERVER_PORT + 2 * idx);
+	make_addr(&client_addr, CONFIG_NET_CONFIG_MY_IPV4_ADDR,
+		  CLIENT_PORT + 2 * idx);
+	make_addr(&peer_addr, PEER_ADDR, SERVER_PORT + 2 * idx);
+
+	server = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	client = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (server < 0 || client < 0 ||
+	    bind(server, (struct sockaddr *)&server_addr,
+		 sizeof(server_addr)) < 0 ||
+	    bind(client, (struct sockaddr *)&client_addr,
+		 sizeof(client_addr)) < 0 ||
+	    connect(client, (struct sockaddr *)&peer_addr,
+		    sizeof(peer_addr)) < 0 ||
+	    setsockopt(server, SOL_SOCKET, SO_RCVTIMEO, &tv,
+		       sizeof(tv)) < 0) {
+		printk("Cannot set up UDP sockets (%d)\n", errno);
+		return -1;
+	}
+
+	t0 = last = k_uptime_get();
+	start_sender(len, count);
+
+	/* Datagrams dropped on the way are detected by the receive
+	 * timing out, the time it waited is not accounted for.
+	 */
+	while (got < count) {
+		ssize_t ret = recv(server, rx_buf, sizeof(rx_buf), 0);
+		uint32_t seq;
+
+		if (ret < 0) {
+			if (errno == EAGAIN) {
+				break;
+			}
+
+			printk("Receive failed after %u datagrams (%d)\n", got,
+			       errno);
+			return -1;
+		}
+
+		memcpy(&seq, rx_buf, sizeof(seq));
+		if (seq != got || ret != len) {
+			in_order = false;
+		}
+
+		got++;
+		last = k_uptime_get();
+	}
+
+	k_thread_join(&sender_thread, K_FOREVER);
+	close(server);
+
+	if (sender_err) {
+		printk("Send failed (%d)\n", sender_err);
+		return -1;
+	}
+
+	last = MAX(last - t0, 1);
+
+	printk("frag bytes %u datagrams %u ms %u KB/s %u %s\n", len, got,
+	       (uint32_t)last,
+	       (uint32_t)((uint64_t)got * len * 1000U / 1024U / last),
+	       got == count && in_order ? "ok" : "lost");
+
+	return 0;
+}
+
+void main(void)
+{
+	net_if_set_mtu(net_if_get_default(), LOOPBACK_MTU);
+
+	for (int i = 0; i < ARRAY_SIZE(dgram_len); i++) {
+		if (run(i) < 0) {
+			return;
+		}
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+
+/* Small UDP datagrams over the loopback interface, sent and received
+ * one call per datagram, in batches with sendmmsg()/recvmmsg(), and
+ * with UDP_SEGMENT splitting one large send in the stack.  Every
+ * datagram carries its sequence number, the receiver checks that they
+ * all arrive in order.
+ */
+
+#define SERVER_PORT 4242
+#define CLIENT_PORT 4243
+#define DGRAMS 4096U
+#define DGRAM_LEN 256U
+#define BATCH 16U
+
+enum mode {
+	MODE_SINGLE,
+	MODE_MMSG,
+	MODE_SEGMENT,
+};
+
+static const char *const mode_name[] = { "single", "mmsg", "segment" };
+
+static uint8_t tx_buf[BATCH][DGRAM_LEN];
+static uint8_t rx_buf[BATCH][DGRAM_LEN];
+static struct iovec tx_iov[BATCH];
+static struct iovec rx_iov[BATCH];
+static struct mmsghdr tx_msg[BATCH];
+static struct mmsghdr rx_msg[BATCH];
+static int client;
+static int sender_err;
+
+K_THREAD_STACK_DEFINE(sender_stack, 2048);
+static struct k_thread sender_thread;
+
+static void produce(uint32_t seq, unsigned int count)
+{
+	for (unsigned int i = 0; i < count; i++) {
+		uint32_t n = seq + i;
+
+		memcpy(tx_buf[i], &n, sizeof(n));
+	}
+}
+
+static int send_batch(enum mode mode, uint32_t seq, unsigned int count)
+{
+	int ret;
+
+	produce(seq, count);
+
+	switch (mode) {
+	case MODE_SINGLE:
+		for (unsigned int i = 0; i < count; i++) {
+			if (send(client, tx_buf[i], DGRAM_LEN, 0) < 0) {
+				return -1;
+			}
+		}
+
+		return count;
+
+	case MODE_MMSG:
+		return sendmmsg(client, tx_msg, count, 0);
+
+	case MODE_SEGMENT:
+		/* tx_buf is contiguous, the stack cuts it into datagrams */
+		ret = send(client, tx_buf, count * DGRAM_LEN, 0);
+		return ret < 0 ? ret : ret / DGRAM_LEN;
+	}
+
+	return -1;
+}
+
+static int recv_batch(int sock, enum mode mode)
+{
+	ssize_t ret;
+
+	if (mode == MODE_SINGLE) {
+		ret = recv(sock, rx_buf[0], DGRAM_LEN, 0);
+		if (ret < 0) {
+			return ret;
+		}
+
+		rx_msg[0].msg_len = ret;
+
+		return 1;
+	}
+
+	return recvmmsg(sock, rx_msg, BATCH, 0);
+}
+
+static void sender(void *p1, void *p2, void *p3)
+{
+	enum mode mode = POINTER_TO_INT(p1);
+	uint32_t sent = 0U;
+
+	while (sent < DGRAMS) {
+		int ret = send_batch(mode, sent, MIN(BATCH, DGRAMS - sent));
+
+		if (ret < 0) {
+			sender_err = errno;
+			break;
+		}
+		sent += ret;
+	}
+
+	close(client);
+}
+
+static void start_sender(enum mode mode)
+{
+	sender_err = 0;
+	k_thread_create(&sender_thread, sender_stack,
+			K_THREAD_STACK_SIZEOF(sender_stack), sender,
+			INT_TO_POINTER(mode), NULL, NULL, K_PRIO_PREEMPT(8), 0,
+			K_NO_WAIT);
+}
+
+static void make_addr(struct sockaddr_in *addr, uint16_t port)
+{
+	addr->sin_family = AF_INET;
+	addr->sin_port = htons(port);
+	inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR, &addr->sin_addr);
+}
+
+static void init_msgs(void)
+{
+	for (unsigned int i = 0; i < BATCH; i++) {
+		tx_iov[i].iov_base = tx_buf[i];
+		tx_iov[i].iov_len = DGRAM_LEN;
+		tx_msg[i].msg_hdr.msg_iov = &tx_iov[i];
+		tx_msg[i].msg_hdr.msg_iovlen = 1;
+
+		rx_iov[i].iov_base = rx_buf[i];
+		rx_iov[i].iov_len = DGRAM_LEN;
+		rx_msg[i].msg_hdr.msg_iov = &rx_iov[i];
+		rx_msg[i].msg_hdr.msg_iovlen = 1;
+	}
+}
+
+static int run(enum mode mode)
+{
+	struct sockaddr_in server_addr, client_addr;
+	struct timeval tv = { .tv_usec = 500000 };
+	uint32_t got = 0U;
+	bool in_order = true;
+	int64_t t0, last;
+	int server;
+
+	make_addr(&server_addr, SERVER_PORT + 2 * mode);
+	make_addr(&client_addr, CLIENT_PORT + 2 * mode);
+
+	server = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	client = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (server < 0 || client < 0 ||
+	    bind(server, (struct sockaddr *)&server_addr,
+		 sizeof(server_addr)) < 0 ||
+	    bind(client, (struct sockaddr *)&client_addr,
+		 sizeof(client_addr)) < 0 ||
+	    connect(client, (struct sockaddr *)&server_addr,
+		    sizeof(server_addr)) < 0 ||
+	    setsockopt(server, SOL_SOCKET, SO_RCVTIMEO, &tv,
+		       sizeof(tv)) < 0) {
+		printk("Cannot set up UDP sockets (%d)\n", errno);
+		return -1;
+	}
+
+	if (mode == MODE_SEGMENT) {
+		int segment = DGRAM_LEN;
+
+		if (setsockopt(client, IPPROTO_UDP, UDP_SEGMENT, &segment,
+			       sizeof(segment)) < 0) {
+			printk("Cannot set UDP_SEGMENT (%d)\n", errno);
+			return -1;
+		}
+	}
+
+	t0 = last = k_uptime_get();
+	start_sender(mode);
+
+	/* Datagrams dropped on the way are detected by the receive
+	 * timing out, the time it waited is not accounted for.
+	 */
+	while (got < DGRAMS) {
+		int ret = recv_batch(server, mode);
+
+		if (ret < 0) {
+			if (errno == EAGAIN) {
+				break;
+			}
+
+			printk("Receive failed after %u datagrams (%d)\n", got,
+			       errno);
+			return -1;
+		}
+
+		for (int i = 0; i < ret; i++) {
+			uint32_t seq;
+
+			memcpy(&seq, rx_buf[i], sizeof(seq));
+			if (seq != got + i || rx_msg[i].msg_len != DGRAM_LEN) {
+				in_order = false;
+			}
+		}
+
+		got += ret;
+		last = k_uptime_get();
+	}
+
+	k_thread_join(&sender_thread, K_FOREVER);
+	close(server);
+
+	if (sender_err) {
+		printk("Send failed (%d)\n", sender_err);
+		return -1;
+	}
+
+	last = MAX(last - t0, 1);
+
+	printk("%s datagrams %u ms %u pps %u %s\n", mode_name[mode], got,
+	       (uint32_t)last, (uint32_t)((uint64_t)got * 1000U / last),
+	       got == DGRAMS && in_order ? "ok" : "lost");
+
+	return 0;
+}
+
+void main(void)
+{
+	init_msgs();
+
+	if (run(MODE_SINGLE) < 0 || run(MODE_MMSG) < 0 ||
+	    run(MODE_SEGMENT) < 0) {
+		return;
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+#include <net/buf.h>
+
+/* Bulk transfer over the loopback interface with the copying socket
+ * calls and with zsock_send_buf()/zsock_recv_buf().  A sender thread
+ * generates the data, in the zero-copy mode straight into network
+ * buffers, and the main thread receives it and checksums it.
+ */
+
+#define SERVER_PORT 4242
+#define CLIENT_PORT 4243
+#define TOTAL_BYTES (1024U * 1024U)
+#define CHUNK 1024U
+#define TX_BUFS 48
+
+/* Sum of all bytes of the pattern generated by produce() */
+#define EXPECTED_SUM (TOTAL_BYTES / 256U * (255U * 256U / 2U))
+
+enum mode {
+	MODE_COPY,
+	MODE_ZEROCOPY,
+};
+
+static const char *const mode_name[] = { "copy", "zerocopy" };
+
+NET_BUF_POOL_DEFINE(tx_pool, TX_BUFS, CHUNK, 0, NULL);
+
+static uint8_t tx_buf[CHUNK];
+static uint8_t rx_buf[CHUNK];
+static int client;
+static int sender_err;
+
+K_THREAD_STACK_DEFINE(sender_stack, 2048);
+static struct k_thread sender_thread;
+
+static void produce(uint8_t *p, size_t len, uint32_t off)
+{
+	for (size_t i = 0; i < len; i++) {
+		p[i] = off + i;
+	}
+}
+
+static uint32_t consume(const uint8_t *p, size_t len, uint32_t sum)
+{
+	for (size_t i = 0; i < len; i++) {
+		sum += p[i];
+	}
+
+	return sum;
+}
+
+static ssize_t send_chunk(enum mode mode, uint32_t off, size_t len)
+{
+	struct net_buf *buf;
+	ssize_t ret;
+
+	if (mode == MODE_COPY) {
+		produce(tx_buf, len, off);
+		return send(client, tx_buf, len, 0);
+	}
+
+	buf = net_buf_alloc(&tx_pool, K_FOREVER);
+	produce(net_buf_add(buf, len), len, off);
+
+	ret = zsock_send_buf(client, buf, 0, NULL, 0);
+	if (ret < 0) {
+		net_buf_unref(buf);
+	}
+
+	return ret;
+}
+
+static ssize_t recv_chunk(int sock, enum mode mode, uint32_t *sum)
+{
+	struct net_buf *frags, *frag;
+	ssize_t ret;
+
+	if (mode == MODE_COPY) {
+		ret = recv(sock, rx_buf, sizeof(rx_buf), 0);
+		if (ret > 0) {
+			*sum = consume(rx_buf, ret, *sum);
+		}
+
+		return ret;
+	}
+
+	ret = zsock_recv_buf(sock, &frags, 0, NULL, NULL);
+	for (frag = frags; frag; frag = frag->frags) {
+		*sum = consume(frag->data, frag->len, *sum);
+	}
+
+	if (frags) {
+		net_buf_unref(frags);
+	}
+
+	return ret;
+}
+
+static void sender(void *p1, void *p2, void *p3)
+{
+	enum mode mode = POINTER_TO_INT(p1);
+	uint32_t sent = 0U;
+
+	while (sent < TOTAL_BYTES) {
+		ssize_t ret = send_chunk(mode, sent,
+					 MIN(CHUNK, TOTAL_BYTES - sent));
+
+		if (ret < 0) {
+			sender_err = errno;
+			break;
+		}
+		sent += ret;
+	}
+
+	close(client);
+}
+
+static void start_sender(enum mode mode)
+{
+	sender_err = 0;
+	k_thread_create(&sender_thread, sender_stack,
+			K_THREAD_STACK_SIZEOF(sender_stack), sender,
+			INT_TO_POINTER(mode), NULL, NULL, K_PRIO_PREEMPT(8), 0,
+			K_NO_WAIT);
+}
+
+static void report(const char *proto, enum mode mode, uint32_t got,
+		   uint32_t sum, int64_t elapsed)
+{
+	elapsed = MAX(elapsed, 1);
+
+	k_thread_join(&sender_thread, K_FOREVER);
+	if (sender_err) {
+		printk("Send failed (%d)\n", sender_err);
+		return;
+	}
+
+	printk("%s %s bytes %u ms %u kbps %u %s\n", proto, mode_name[mode],
+	       got, (uint32_t)elapsed, (uint32_t)((uint64_t)got * 8U / elapsed),
+	       got == TOTAL_BYTES && sum == EXPECTED_SUM ? "ok" : "lost");
+}
+
+static void make_addr(struct sockaddr_in *addr, uint16_t port)
+{
+	addr->sin_family = AF_INET;
+	addr->sin_port = htons(port);
+	inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR, &addr->sin_addr);
+}
+
+static int run_tcp(enum mode mode)
+{
+	struct sockaddr_in addr;
+	uint32_t got = 0U, sum = 0U;
+	int listener, server;
+	int64_t t0;
+
+	make_addr(&addr, SERVER_PORT + 2 * mode);
+
+	listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (listener < 0 ||
+	    bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    listen(listener, 1) < 0) {
+		printk("Cannot set up listener (%d)\n", errno);
+		return -1;
+	}
+
+	client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (client < 0 ||
+	    connect(client, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		printk("Cannot connect (%d)\n", errno);
+		return -1;
+	}
+
+	server = accept(listener, NULL, NULL);
+	if (server < 0) {
+		printk("Cannot accept (%d)\n", errno);
+		return -1;
+	}
+
+	close(listener);
+
+	t0 = k_uptime_get();
+	start_sender(mode);
+
+	while (got < TOTAL_BYTES) {
+		ssize_t ret = recv_chunk(server, mode, &sum);
+
+		if (ret <= 0) {
+			printk("Receive failed after %u bytes (%d)\n", got,
+			       errno);
+			return -1;
+		}
+		got += ret;
+	}
+
+	report("tcp", mode, got, sum, k_uptime_get() - t0);
+	close(server);
+
+	return 0;
+}
+
+static int run_udp(enum mode mode)
+{
+	struct sockaddr_in server_addr, client_addr;
+	struct timeval tv = { .tv_usec = 500000 };
+	uint32_t got = 0U, sum = 0U;
+	int64_t t0, last;
+	int server;
+
+	make_addr(&server_addr, SERVER_PORT + 2 * mode);
+	make_addr(&client_addr, CLIENT_PORT + 2 * mode);
+
+	server = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	client = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (server < 0 || client < 0 ||
+	    bind(server, (struct sockaddr *)&server_addr,
+		 sizeof(server_addr)) < 0 ||
+	    bind(client, (struct sockaddr *)&client_addr,
+		 sizeof(client_addr)) < 0 ||
+	    connect(client, (struct sockaddr *)&server_addr,
+		    sizeof(server_addr)) < 0 ||
+	    setsockopt(server, SOL_SOCKET, SO_RCVTIMEO, &tv,
+		       sizeof(tv)) < 0) {
+		printk("Cannot set up UDP sockets (%d)\n", errno);
+		return -1;
+	}
+
+	t0 = last = k_uptime_get();
+	start_sender(mode);
+
+	/* Datagrams dropped on the way are detected by the receive
+	 * timing out, the time it waited is not accounted for.
+	 */
+	while (got < TOTAL_BYTES) {
+		ssize_t ret = recv_chunk(server, mode, &sum);
+
+		if (ret < 0) {
+			if (errno == EAGAIN) {
+				break;
+			}
+
+			printk("Receive failed after %u bytes (%d)\n", got,
+			       errno);
+			return -1;
+		}
+		got += ret;
+		last = k_uptime_get();
+	}
+
+	report("udp", mode, got, sum, last - t0);
+	close(server);
+
+	return 0;
+}
+
+void main(void)
+{
+	if (run_tcp(MODE_COPY) < 0 || run_tcp(MODE_ZEROCOPY) < 0 ||
+	    run_udp(MODE_COPY) < 0 || run_udp(MODE_ZEROCOPY) < 0) {
+		return;
+	}
+
+	printk("fin\n");
+}
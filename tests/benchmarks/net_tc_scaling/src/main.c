@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_core.h>
+#include <net/net_if.h>
+#include <net/net_ip.h>
+#include <net/net_pkt.h>
+#include <net/net_context.h>
+#include <net/ethernet.h>
+
+#include "ipv4.h"
+#include "udp_internal.h"
+
+/* Received UDP packets per second for a few flows, with the receive
+ * traffic class handled by one queue or by one queue per CPU.  The
+ * frames are built before each burst is handed to the stack, so only
+ * the processing of the stack is measured.
+ */
+
+#define FLOWS 8U
+#define BURST 128U
+#define PACKETS 4096U
+#define DGRAM_LEN 128U
+#define BASE_PORT 5000U
+#define PEER_PORT 40000U
+
+static struct net_if *iface;
+static struct net_context *contexts[FLOWS];
+static struct net_pkt *burst[BURST];
+static uint32_t tx_seq[FLOWS];
+static uint32_t rx_seq[FLOWS];
+static atomic_t received;
+static atomic_t expected;
+static bool in_order = true;
+
+static K_SEM_DEFINE(burst_done, 0, 1);
+
+static void udp_received(struct net_context *context, struct net_pkt *pkt,
+			 union net_ip_header *ip_hdr,
+			 union net_proto_header *proto_hdr, int status,
+			 void *user_data)
+{
+	int flow = POINTER_TO_INT(user_data);
+	uint32_t seq;
+
+	if (!pkt) {
+		return;
+	}
+
+	/* A flow is only ever handled by one queue */
+	if (net_pkt_read_be32(pkt, &seq) || seq != rx_seq[flow]) {
+		in_order = false;
+	}
+
+	rx_seq[flow] = seq + 1;
+	net_pkt_unref(pkt);
+
+	if (atomic_inc(&received) + 1 == atomic_get(&expected)) {
+		k_sem_give(&burst_done);
+	}
+}
+
+static int bind_flows(void)
+{
+	for (int i = 0; i < FLOWS; i++) {
+		struct sockaddr_in addr = {
+			.sin_family = AF_INET,
+			.sin_port = htons(BASE_PORT + i),
+		};
+		int ret;
+
+		ret = net_context_get(AF_INET, SOCK_DGRAM, IPPROTO_UDP,
+				      &contexts[i]);
+		if (ret < 0) {
+			return ret;
+		}
+
+		ret = net_context_bind(contexts[i], (struct sockaddr *)&addr,
+				       sizeof(addr));
+		if (ret < 0) {
+			return ret;
+		}
+
+		ret = net_context_recv(contexts[i], udp_received, K_NO_WAIT,
+				       INT_TO_POINTER(i));
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+static struct net_pkt *build_frame(int flow)
+{
+	struct net_linkaddr *lladdr = net_if_get_link_addr(iface);
+	struct net_eth_hdr eth = {
+		.src = { { 0x02, 0x00, 0x5e, 0x00, 0x53, 0x01 } },
+		.type = htons(NET_ETH_PTYPE_IP),
+	};
+	struct in_addr src, dst;
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+
+	memcpy(eth.dst.addr, lladdr->addr, sizeof(eth.dst.addr));
+	net_addr_pton(AF_INET, CONFIG_NET_CONFIG_PEER_IPV4_ADDR, &src);
+	net_addr_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR, &dst);
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface, DGRAM_LEN, AF_INET,
+					   IPPROTO_UDP, K_NO_WAIT);
+	if (!pkt) {
+		return NULL;
+	}
+
+	if (net_ipv4_create(pkt, &src, &dst) ||
+	    net_udp_create(pkt, htons(PEER_PORT + flow),
+			   htons(BASE_PORT + flow)) ||
+	    net_pkt_write_be32(pkt, tx_seq[flow]) ||
+	    net_pkt_memset(pkt, 0, DGRAM_LEN - sizeof(uint32_t))) {
+		goto fail;
+	}
+
+	net_pkt_cursor_init(pkt);
+	if (net_ipv4_finalize(pkt, IPPROTO_UDP)) {
+		goto fail;
+	}
+
+	frag = net_pkt_get_frag(pkt, K_NO_WAIT);
+	if (!frag) {
+		goto fail;
+	}
+
+	net_buf_add_mem(frag, &eth, sizeof(eth));
+	net_pkt_frag_insert(pkt, frag);
+
+	tx_seq[flow]++;
+
+	return pkt;
+
+fail:
+	net_pkt_unref(pkt);
+
+	return NULL;
+}
+
+static int run_burst(uint64_t *cycles)
+{
+	uint32_t start;
+
+	for (int i = 0; i < BURST; i++) {
+		burst[i] = build_frame(i % FLOWS);
+		if (!burst[i]) {
+			printk("Cannot build frame %d\n", i);
+			return -1;
+		}
+	}
+
+	atomic_set(&received, 0);
+	atomic_set(&expected, BURST);
+
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < BURST; i++) {
+		if (net_recv_data(iface, burst[i]) < 0) {
+			net_pkt_unref(burst[i]);
+			atomic_dec(&expected);
+		}
+	}
+
+	if (k_sem_take(&burst_done, K_SECONDS(1))) {
+		return -1;
+	}
+
+	*cycles += k_cycle_get_32() - start;
+
+	return 0;
+}
+
+void main(void)
+{
+	uint32_t packets = 0U;
+	uint64_t cycles = 0U;
+	uint32_t us;
+
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(ETHERNET));
+	if (!iface) {
+		printk("No Ethernet interface\n");
+		return;
+	}
+
+	if (bind_flows() < 0) {
+		printk("Cannot bind UDP contexts\n");
+		return;
+	}
+
+	while (packets < PACKETS) {
+		if (run_burst(&cycles) < 0) {
+			break;
+		}
+
+		packets += BURST;
+	}
+
+	us = MAX(k_cyc_to_us_floor64(cycles), 1);
+
+	printk("rx queues %d flows %u packets %u us %u pps %u %s\n",
+	       CONFIG_NET_TC_RX_QUEUES, FLOWS, packets, us,
+	       (uint32_t)((uint64_t)packets * USEC_PER_SEC / us),
+	       packets == PACKETS && in_order ? "ok" : "lost");
+
+	printk("fin\n");
+}
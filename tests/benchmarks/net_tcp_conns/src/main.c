@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+
+/* TCP segment throughput with many open connections.  N connections
+ * are opened over the loopback interface, then a small message is
+ * sent and received on each of them in turn for a fixed period.  Each
+ * message is one data segment (plus its ACK) that the stack has to
+ * match to its connection, so the cost of the connection lookup shows
+ * up directly as N grows.  N follows from CONFIG_NET_MAX_CONTEXTS,
+ * two contexts per connection plus one for the listener.
+ */
+
+#define N_CONNS ((CONFIG_NET_MAX_CONTEXTS - 1) / 2)
+#define SERVER_PORT 4242
+#define MSG_SIZE 64
+#define RUN_MS 2000
+
+static int clients[N_CONNS];
+static int servers[N_CONNS];
+static uint8_t buf[MSG_SIZE];
+
+static int open_conns(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+	int listener;
+
+	inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR, &addr.sin_addr);
+
+	listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (listener < 0 ||
+	    bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    listen(listener, N_CONNS) < 0) {
+		printk("Cannot set up listener (%d)\n", errno);
+		return -1;
+	}
+
+	for (int i = 0; i < N_CONNS; i++) {
+		clients[i] = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		if (clients[i] < 0 ||
+		    connect(clients[i], (struct sockaddr *)&addr,
+			    sizeof(addr)) < 0) {
+			printk("Cannot connect %d (%d)\n", i, errno);
+			return -1;
+		}
+
+		servers[i] = accept(listener, NULL, NULL);
+		if (servers[i] < 0) {
+			printk("Cannot accept %d (%d)\n", i, errno);
+			return -1;
+		}
+	}
+
+	close(listener);
+
+	return 0;
+}
+
+static bool transfer(int i)
+{
+	size_t got = 0;
+
+	if (send(clients[i], buf, sizeof(buf), 0) != sizeof(buf)) {
+		return false;
+	}
+
+	while (got < sizeof(buf)) {
+		ssize_t ret = recv(servers[i], buf + got, sizeof(buf) - got, 0);
+
+		if (ret <= 0) {
+			return false;
+		}
+		got += ret;
+	}
+
+	return true;
+}
+
+void main(void)
+{
+	uint32_t segments = 0U;
+	int64_t t0, elapsed;
+
+	if (open_conns() < 0) {
+		return;
+	}
+
+	t0 = k_uptime_get();
+
+	do {
+		for (int i = 0; i < N_CONNS; i++) {
+			if (!transfer(i)) {
+				printk("Transfer failed on %d (%d)\n", i, errno);
+				return;
+			}
+		}
+		segments += N_CONNS;
+		elapsed = k_uptime_get() - t0;
+	} while (elapsed < RUN_MS);
+
+	printk("conns %d segments %u segments/s %u\n", N_CONNS, segments,
+	       (uint32_t)((uint64_t)segments * 1000U / elapsed));
+
+	for (int i = 0; i < N_CONNS; i++) {
+		close(clients[i]);
+		close(servers[i]);
+	}
+
+	printk("fin\n");
+}
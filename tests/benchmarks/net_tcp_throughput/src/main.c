@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+
+/* Bulk TCP transfer over the loopback interface, which is configured
+ * to delay every packet and, in some variants of testcase.yaml, to
+ * drop a share of them.  A sender thread writes TOTAL_BYTES to one end
+ * of a connection while the main thread reads them from the other,
+ * and the time the whole transfer took is reported.
+ */
+
+#define SERVER_PORT 4242
+#define TOTAL_BYTES (1024U * 1024U)
+#define CHUNK 1024
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+#define CC_NAME CONFIG_NET_TCP_CONGESTION_CONTROL_DEFAULT
+#else
+#define CC_NAME "none"
+#endif
+
+static uint8_t tx_buf[CHUNK];
+static uint8_t rx_buf[CHUNK];
+static int client;
+static int sender_err;
+
+static void sender(void *p1, void *p2, void *p3)
+{
+	uint32_t sent = 0U;
+
+	while (sent < TOTAL_BYTES) {
+		ssize_t ret = send(client, tx_buf,
+				   MIN(sizeof(tx_buf), TOTAL_BYTES - sent), 0);
+
+		if (ret < 0) {
+			sender_err = errno;
+			break;
+		}
+		sent += ret;
+	}
+
+	close(client);
+}
+
+K_THREAD_STACK_DEFINE(sender_stack, 2048);
+static struct k_thread sender_thread;
+
+static int open_conn(int *server)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+	int listener;
+
+	inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR, &addr.sin_addr);
+
+	listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (listener < 0 ||
+	    bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    listen(listener, 1) < 0) {
+		printk("Cannot set up listener (%d)\n", errno);
+		return -1;
+	}
+
+	client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (client < 0 ||
+	    connect(client, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		printk("Cannot connect (%d)\n", errno);
+		return -1;
+	}
+
+	*server = accept(listener, NULL, NULL);
+	if (*server < 0) {
+		printk("Cannot accept (%d)\n", errno);
+		return -1;
+	}
+
+	close(listener);
+
+	return 0;
+}
+
+void main(void)
+{
+	uint32_t got = 0U;
+	int64_t t0, elapsed;
+	int server;
+
+	for (int i = 0; i < sizeof(tx_buf); i++) {
+		tx_buf[i] = i;
+	}
+
+	if (open_conn(&server) < 0) {
+		return;
+	}
+
+	t0 = k_uptime_get();
+
+	k_thread_create(&sender_thread, sender_stack,
+			K_THREAD_STACK_SIZEOF(sender_stack), sender,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(8), 0, K_NO_WAIT);
+
+	while (got < TOTAL_BYTES) {
+		ssize_t ret = recv(server, rx_buf, sizeof(rx_buf), 0);
+
+		if (ret <= 0) {
+			printk("Receive failed after %u bytes (%d)\n", got,
+			       errno);
+			return;
+		}
+		got += ret;
+	}
+
+	elapsed = MAX(k_uptime_get() - t0, 1);
+
+	k_thread_join(&sender_thread, K_FOREVER);
+	if (sender_err) {
+		printk("Send failed (%d)\n", sender_err);
+		return;
+	}
+
+	printk("cc %s loss %d delay %d bytes %u ms %u kbps %u\n", CC_NAME,
+	       CONFIG_NET_LOOPBACK_LOSS_PERMILLE, CONFIG_NET_LOOPBACK_DELAY,
+	       got, (uint32_t)elapsed,
+	       (uint32_t)((uint64_t)got * 8U / elapsed));
+
+	close(server);
+
+	printk("fin\n");
+}
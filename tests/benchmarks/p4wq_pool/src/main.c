@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <sys/crc.h>
+#include <sys/p4wq_pool.h>
+
+/* Scaling benchmark for the work-stealing task pool.  A buffer is
+ * split into blocks and the CRC-32 of every block is computed, first
+ * by the main thread alone and then with k_p4wq_parallel_for() on a
+ * pool with one worker per CPU, in which the main thread takes part
+ * as well.  The ratio of the two times is the speedup; run it with
+ * different values of CONFIG_MP_NUM_CPUS to see how it scales.
+ */
+
+#define N_WORKERS CONFIG_MP_NUM_CPUS
+#define STACK_SIZE (2048 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define BLOCK_SIZE 1024
+#define N_BLOCKS 128
+#define GRAIN 2
+#define N_RUNS 10
+
+K_P4WQ_DEFINE(bench_wq, N_WORKERS, STACK_SIZE);
+K_P4WQ_POOL_DEFINE(bench_pool, N_WORKERS);
+
+static uint8_t buf[N_BLOCKS][BLOCK_SIZE];
+static uint32_t serial_crcs[N_BLOCKS];
+static uint32_t parallel_crcs[N_BLOCKS];
+
+static void crc_blocks(uint32_t start, uint32_t end, void *arg)
+{
+	uint32_t *crcs = arg;
+
+	for (uint32_t i = start; i < end; i++) {
+		crcs[i] = crc32_ieee(buf[i], BLOCK_SIZE);
+	}
+}
+
+static uint64_t run_us(bool parallel)
+{
+	uint32_t start = k_cycle_get_32();
+
+	for (int run = 0; run < N_RUNS; run++) {
+		if (parallel) {
+			k_p4wq_parallel_for(&bench_pool, 0, N_BLOCKS, GRAIN,
+					    crc_blocks, parallel_crcs);
+		} else {
+			crc_blocks(0, N_BLOCKS, serial_crcs);
+		}
+	}
+
+	return k_cyc_to_us_floor64(k_cycle_get_32() - start);
+}
+
+void main(void)
+{
+	int prio = k_thread_priority_get(k_current_get());
+	uint64_t serial_us, parallel_us;
+
+	for (int i = 0; i < N_BLOCKS; i++) {
+		for (int j = 0; j < BLOCK_SIZE; j++) {
+			buf[i][j] = (uint8_t)(i * 31 + j);
+		}
+	}
+
+	/* Workers run at the same priority as main so that neither
+	 * starves the other of a CPU
+	 */
+	k_p4wq_pool_start(&bench_pool, &bench_wq, prio);
+
+	/* Warm up caches and the workers */
+	(void)run_us(false);
+	(void)run_us(true);
+
+	serial_us = run_us(false);
+	parallel_us = run_us(true);
+
+	k_p4wq_pool_stop(&bench_pool);
+
+	if (memcmp(serial_crcs, parallel_crcs, sizeof(serial_crcs)) != 0) {
+		printk("CRC mismatch\n");
+		return;
+	}
+
+	uint32_t speedup = (uint32_t)(serial_us * 100U / MAX(parallel_us, 1U));
+
+	printk("cpus %d workers %d serial_us %u parallel_us %u speedup %u.%02u\n",
+	       CONFIG_MP_NUM_CPUS, N_WORKERS, (uint32_t)serial_us,
+	       (uint32_t)parallel_us, speedup / 100U, speedup % 100U);
+
+	printk("fin\n");
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* This is a scheduler throughput benchmark for SMP.  One pair of
+ * threads per CPU bounces control back and forth through a pair of
+ * semaphores:
+ *
+ * 1. The "ping" thread gives the pong semaphore and takes the ping
+ *    semaphore (pending itself).
+ * 2. The "pong" thread wakes up, gives the ping semaphore and takes
+ *    the pong semaphore again.
+ *
+ * Every half iteration therefore readies one thread and pends
+ * another, which is a full trip through the run queue.  The pairs
+ * are independent of each other, so any loss of scaling as CPUs are
+ * added comes from the scheduler itself.
+ */
+
+#define N_PAIRS CONFIG_MP_NUM_CPUS
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define RUN_MS 2000
+#define N_SETTLE_MS 100
+
+struct pair {
+	struct k_sem ping;
+	struct k_sem pong;
+	/* Round trips, only written by the ping thread */
+	volatile uint32_t count;
+};
+
+static struct pair pairs[N_PAIRS];
+
+static K_THREAD_STACK_ARRAY_DEFINE(ping_stacks, N_PAIRS, STACK_SIZE);
+static K_THREAD_STACK_ARRAY_DEFINE(pong_stacks, N_PAIRS, STACK_SIZE);
+static struct k_thread ping_threads[N_PAIRS];
+static struct k_thread pong_threads[N_PAIRS];
+
+static void ping_fn(void *arg1, void *arg2, void *arg3)
+{
+	struct pair *p = arg1;
+
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	while (true) {
+		k_sem_give(&p->pong);
+		k_sem_take(&p->ping, K_FOREVER);
+		p->count++;
+	}
+}
+
+static void pong_fn(void *arg1, void *arg2, void *arg3)
+{
+	struct pair *p = arg1;
+
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	while (true) {
+		k_sem_take(&p->pong, K_FOREVER);
+		k_sem_give(&p->ping);
+	}
+}
+
+static uint32_t total_count(void)
+{
+	uint32_t sum = 0U;
+
+	for (int i = 0; i < N_PAIRS; i++) {
+		sum += pairs[i].count;
+	}
+	return sum;
+}
+
+void main(void)
+{
+	/* Workers run below main so it can always preempt them to
+	 * take its samples
+	 */
+	int prio = k_thread_priority_get(k_current_get()) + 1;
+
+	for (int i = 0; i < N_PAIRS; i++) {
+		k_sem_init(&pairs[i].ping, 0, 1);
+		k_sem_init(&pairs[i].pong, 0, 1);
+
+		k_thread_create(&pong_threads[i], pong_stacks[i], STACK_SIZE,
+				pong_fn, &pairs[i], NULL, NULL,
+				prio, 0, K_NO_WAIT);
+		k_thread_create(&ping_threads[i], ping_stacks[i], STACK_SIZE,
+				ping_fn, &pairs[i], NULL, NULL,
+				prio, 0, K_NO_WAIT);
+	}
+
+	/* Let startup and cache effects settle before measuring */
+	k_msleep(N_SETTLE_MS);
+
+	uint32_t start = total_count();
+	int64_t t0 = k_uptime_get();
+
+	k_msleep(RUN_MS);
+
+	uint32_t end = total_count();
+	int64_t elapsed = k_uptime_get() - t0;
+
+	/* Two context switches per round trip */
+	uint64_t switches = 2ULL * (end - start);
+
+	printk("cpus %d pairs %d switches/s %u\n", CONFIG_MP_NUM_CPUS,
+	       N_PAIRS, (uint32_t)(switches * 1000U / elapsed));
+
+	for (int i = 0; i < N_PAIRS; i++) {
+		k_thread_abort(&ping_threads[i]);
+		k_thread_abort(&pong_threads[i]);
+	}
+
+	printk("fin\n");
+}
@@ -11,6 +11,8 @@ extern void test_k_heap_alloc_fail(void);
 extern void test_k_heap_free(void);
 extern void test_kheap_alloc_in_isr_nowait(void);
 extern void test_k_heap_alloc_pending(void);
+extern void test_k_heap_slab_churn(void);
+extern void test_k_heap_slab_pending(void);
 
 /**
  * @brief k heap api tests
@@ -30,6 +32,8 @@ void test_main(void)
 			 ztest_unit_test(test_k_heap_alloc_fail),
 			 ztest_unit_test(test_k_heap_free),
 			 ztest_unit_test(test_kheap_alloc_in_isr_nowait),
-			 ztest_unit_test(test_k_heap_alloc_pending));
+			 ztest_unit_test(test_k_heap_alloc_pending),
+			 ztest_unit_test(test_k_heap_slab_churn),
+			 ztest_unit_test(test_k_heap_slab_pending));
 	ztest_run_test_suite(k_heap_api);
 }
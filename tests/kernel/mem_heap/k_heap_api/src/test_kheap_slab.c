@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include "test_kheap.h"
+
+#define SLAB_HEAP_SIZE 8192
+#define SLAB_STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define CHURN_THREADS 4
+#define CHURN_LOOPS 500
+#define CHURN_OBJS 4
+#define SMALL_SIZE 32
+
+K_HEAP_DEFINE(slab_heap, SLAB_HEAP_SIZE);
+
+static K_THREAD_STACK_ARRAY_DEFINE(slab_stack, CHURN_THREADS,
+				   SLAB_STACK_SIZE);
+static struct k_thread slab_thread[CHURN_THREADS];
+
+static volatile int churn_errors;
+static void *small_objs[SLAB_HEAP_SIZE / SMALL_SIZE];
+
+static void churn(void *p1, void *p2, void *p3)
+{
+	uint8_t tag = POINTER_TO_UINT(p1) + 1;
+	uint8_t *objs[CHURN_OBJS] = { 0 };
+	size_t sizes[CHURN_OBJS];
+
+	for (int i = 0; i < CHURN_LOOPS; i++) {
+		int n = i % CHURN_OBJS;
+
+		if (objs[n] != NULL) {
+			for (size_t j = 0; j < sizes[n]; j++) {
+				if (objs[n][j] != tag) {
+					churn_errors++;
+					break;
+				}
+			}
+			k_heap_free(&slab_heap, objs[n]);
+		}
+
+		/* Sizes of every slab class, plus some served by the heap.
+		 * The heap may run out while other threads hold memory.
+		 */
+		sizes[n] = 8 + (i * 37) % 264;
+		objs[n] = k_heap_alloc(&slab_heap, sizes[n], K_NO_WAIT);
+		if (objs[n] == NULL) {
+			continue;
+		}
+		memset(objs[n], tag, sizes[n]);
+
+		if (i % 16 == 0) {
+			k_yield();
+		}
+	}
+
+	for (int n = 0; n < CHURN_OBJS; n++) {
+		k_heap_free(&slab_heap, objs[n]);
+	}
+}
+
+/**
+ * @brief Test allocation churn on a k_heap with the slab front end
+ *
+ * @details Threads, on all CPUs when SMP is enabled, allocate, fill,
+ * check and free objects of all slab classes and larger ones.  No
+ * object may be handed out twice, and once everything is freed, the
+ * objects cached per CPU must not keep a large allocation from
+ * succeeding.
+ *
+ * @ingroup kernel_heap_tests
+ */
+void test_k_heap_slab_churn(void)
+{
+	void *p;
+
+	zassert_equal(k_heap_slab_init(&slab_heap), 0, NULL);
+
+	churn_errors = 0;
+	for (int i = 0; i < CHURN_THREADS; i++) {
+		k_thread_create(&slab_thread[i], slab_stack[i],
+				SLAB_STACK_SIZE, churn, UINT_TO_POINTER(i),
+				NULL, NULL, K_PRIO_PREEMPT(5), 0, K_NO_WAIT);
+	}
+
+	for (int i = 0; i < CHURN_THREADS; i++) {
+		k_thread_join(&slab_thread[i], K_FOREVER);
+	}
+
+	zassert_equal(churn_errors, 0, "%d bad allocations", churn_errors);
+
+	p = k_heap_alloc(&slab_heap, SLAB_HEAP_SIZE / 2, K_NO_WAIT);
+	zassert_not_null(p, "Freed objects not returned to the heap");
+	k_heap_free(&slab_heap, p);
+}
+
+static void alloc_small(void *p1, void *p2, void *p3)
+{
+	void **ret = p1;
+
+	*ret = k_heap_alloc(&slab_heap, SMALL_SIZE, K_MSEC(TIMEOUT));
+}
+
+/**
+ * @brief Test a blocked slab allocation woken by a free
+ *
+ * @details Fill the heap with small objects, then have a thread wait
+ * for one more.  Freeing a single object from another thread must wake
+ * it up with memory, wherever the freed object was cached.
+ *
+ * @ingroup kernel_heap_tests
+ */
+void test_k_heap_slab_pending(void)
+{
+	void *ret = NULL;
+	int n = 0;
+
+	while (n < ARRAY_SIZE(small_objs)) {
+		small_objs[n] = k_heap_alloc(&slab_heap, SMALL_SIZE,
+					     K_NO_WAIT);
+		if (small_objs[n] == NULL) {
+			break;
+		}
+		n++;
+	}
+	zassert_true(n > 0 && n < ARRAY_SIZE(small_objs), NULL);
+
+	k_thread_create(&slab_thread[0], slab_stack[0], SLAB_STACK_SIZE,
+			alloc_small, &ret, NULL, NULL, K_PRIO_PREEMPT(5), 0,
+			K_NO_WAIT);
+
+	/* Let the thread find the heap exhausted and pend */
+	k_msleep(10);
+	k_heap_free(&slab_heap, small_objs[--n]);
+
+	k_thread_join(&slab_thread[0], K_FOREVER);
+	zassert_not_null(ret, "Allocation not woken by the free");
+
+	k_heap_free(&slab_heap, ret);
+	while (n > 0) {
+		k_heap_free(&slab_heap, small_objs[--n]);
+	}
+}
@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @defgroup kernel_mpsc_message_queue_tests Lock-free Message Queue
+ * @ingroup all_tests
+ * @{
+ * @}
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define MSGQ_LEN 8
+#define PRODUCERS 4
+#define ITEMS 500
+#define TIMEOUT_MS 50
+
+struct msg {
+	uint32_t id;
+	uint32_t seq;
+};
+
+K_MPSC_MSGQ_DEFINE(kmsgq, sizeof(struct msg), MSGQ_LEN, 0);
+K_MPSC_MSGQ_DEFINE(kmsgq_spsc, sizeof(struct msg), MSGQ_LEN,
+		   K_MPSC_MSGQ_FLAG_SPSC);
+
+static struct k_mpsc_msgq msgq;
+static atomic_t msgq_buf[K_MPSC_MSGQ_BUF_SIZE(sizeof(struct msg), 2) /
+			 sizeof(atomic_t)];
+
+static K_THREAD_STACK_ARRAY_DEFINE(tstack, PRODUCERS, STACK_SIZE);
+static struct k_thread tdata[PRODUCERS];
+
+static struct k_timer put_timer;
+static volatile int isr_ret;
+
+static void drain(struct k_mpsc_msgq *q)
+{
+	struct msg m;
+
+	while (k_mpsc_msgq_get(q, &m, K_NO_WAIT) == 0) {
+	}
+}
+
+/**
+ * @brief Test initialization of a lock-free message queue
+ *
+ * @details Sizes which are not a power of two, or hold a single
+ * message, are rejected.
+ *
+ * @ingroup kernel_mpsc_message_queue_tests
+ */
+void test_mpsc_msgq_init(void)
+{
+	zassert_equal(k_mpsc_msgq_init(&msgq, msgq_buf, sizeof(struct msg),
+				       1, 0), -EINVAL, NULL);
+	zassert_equal(k_mpsc_msgq_init(&msgq, msgq_buf, sizeof(struct msg),
+				       3, 0), -EINVAL, NULL);
+	zassert_equal(k_mpsc_msgq_init(&msgq, msgq_buf, sizeof(struct msg),
+				       2, 0), 0, NULL);
+	zassert_equal(k_mpsc_msgq_num_used_get(&msgq), 0, NULL);
+}
+
+static void put_get(struct k_mpsc_msgq *q, uint32_t len, uint32_t laps)
+{
+	struct msg m;
+
+	for (uint32_t seq = 0; seq < len * laps; seq += len) {
+		for (uint32_t i = 0; i < len; i++) {
+			m.id = 0;
+			m.seq = seq + i;
+			zassert_equal(k_mpsc_msgq_put(q, &m), 0, NULL);
+			zassert_equal(k_mpsc_msgq_num_used_get(q), i + 1, NULL);
+		}
+
+		for (uint32_t i = 0; i < len; i++) {
+			zassert_equal(k_mpsc_msgq_get(q, &m, K_NO_WAIT), 0,
+				      NULL);
+			zassert_equal(m.seq, seq + i, "Out of order");
+		}
+
+		zassert_equal(k_mpsc_msgq_num_used_get(q), 0, NULL);
+	}
+}
+
+/**
+ * @brief Test a lock-free message queue with a single producer
+ *
+ * @details Messages come out in the order they went in, over several
+ * laps of the ring, with and without K_MPSC_MSGQ_FLAG_SPSC and with
+ * the smallest ring allowed.
+ *
+ * @ingroup kernel_mpsc_message_queue_tests
+ */
+void test_mpsc_msgq_single_producer(void)
+{
+	put_get(&kmsgq_spsc, MSGQ_LEN, 4);
+	put_get(&kmsgq, MSGQ_LEN, 4);
+
+	zassert_equal(k_mpsc_msgq_init(&msgq, msgq_buf, sizeof(struct msg),
+				       2, 0), 0, NULL);
+	put_get(&msgq, 2, 8);
+}
+
+/**
+ * @brief Test a full lock-free message queue
+ *
+ * @details Puts fail once the queue holds its maximum number of
+ * messages, without overwriting any, and succeed again once a message
+ * is taken.  Gets without waiting fail on an empty queue.
+ *
+ * @ingroup kernel_mpsc_message_queue_tests
+ */
+void test_mpsc_msgq_full(void)
+{
+	struct msg m = { 0 };
+
+	zassert_equal(k_mpsc_msgq_init(&msgq, msgq_buf, sizeof(struct msg),
+				       2, 0), 0, NULL);
+	zassert_equal(k_mpsc_msgq_get(&msgq, &m, K_NO_WAIT), -ENOMSG, NULL);
+
+	for (int lap = 0; lap < 3; lap++) {
+		m.seq = 1;
+		zassert_equal(k_mpsc_msgq_put(&msgq, &m), 0, NULL);
+		m.seq = 2;
+		zassert_equal(k_mpsc_msgq_put(&msgq, &m), 0, NULL);
+		m.seq = 3;
+		zassert_equal(k_mpsc_msgq_put(&msgq, &m), -ENOMSG, NULL);
+		zassert_equal(k_mpsc_msgq_num_used_get(&msgq), 2, NULL);
+
+		zassert_equal(k_mpsc_msgq_get(&msgq, &m, K_NO_WAIT), 0, NULL);
+		zassert_equal(m.seq, 1, NULL);
+
+		m.seq = 4;
+		zassert_equal(k_mpsc_msgq_put(&msgq, &m), 0, NULL);
+		zassert_equal(k_mpsc_msgq_put(&msgq, &m), -ENOMSG, NULL);
+
+		zassert_equal(k_mpsc_msgq_get(&msgq, &m, K_NO_WAIT), 0, NULL);
+		zassert_equal(m.seq, 2, "Message overwritten");
+		zassert_equal(k_mpsc_msgq_get(&msgq, &m, K_NO_WAIT), 0, NULL);
+		zassert_equal(m.seq, 4, NULL);
+		zassert_equal(k_mpsc_msgq_get(&msgq, &m, K_NO_WAIT), -ENOMSG,
+			      NULL);
+	}
+}
+
+static void producer(void *p1, void *p2, void *p3)
+{
+	struct msg m = { .id = POINTER_TO_UINT(p1) };
+
+	for (m.seq = 0; m.seq < ITEMS; m.seq++) {
+		while (k_mpsc_msgq_put(&kmsgq, &m) != 0) {
+			k_yield();
+		}
+	}
+}
+
+/**
+ * @brief Test a lock-free message queue with several producers
+ *
+ * @details Producer threads, on all CPUs when SMP is enabled, fill a
+ * small queue while a blocking consumer drains it.  Every message
+ * arrives once and each producer's messages arrive in order.
+ *
+ * @ingroup kernel_mpsc_message_queue_tests
+ */
+void test_mpsc_msgq_multi_producer(void)
+{
+	uint32_t next[PRODUCERS] = { 0 };
+	struct msg m;
+
+	drain(&kmsgq);
+
+	for (int i = 0; i < PRODUCERS; i++) {
+		k_thread_create(&tdata[i], tstack[i], STACK_SIZE, producer,
+				UINT_TO_POINTER(i), NULL, NULL,
+				K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	}
+
+	for (int i = 0; i < PRODUCERS * ITEMS; i++) {
+		zassert_equal(k_mpsc_msgq_get(&kmsgq, &m, K_FOREVER), 0, NULL);
+		zassert_true(m.id < PRODUCERS, "Bad producer %u", m.id);
+		zassert_equal(m.seq, next[m.id], "Message of %u out of order",
+			      m.id);
+		next[m.id]++;
+	}
+
+	for (int i = 0; i < PRODUCERS; i++) {
+		k_thread_join(&tdata[i], K_FOREVER);
+		zassert_equal(next[i], ITEMS, NULL);
+	}
+
+	zassert_equal(k_mpsc_msgq_get(&kmsgq, &m, K_NO_WAIT), -ENOMSG, NULL);
+}
+
+static void delayed_put(void *p1, void *p2, void *p3)
+{
+	struct msg m = { .seq = 42 };
+
+	k_msleep(TIMEOUT_MS / 5);
+	zassert_equal(k_mpsc_msgq_put(&kmsgq, &m), 0, NULL);
+}
+
+/**
+ * @brief Test blocking gets from a lock-free message queue
+ *
+ * @details A get on an empty queue times out after its waiting period,
+ * and a pended get is woken by a put from another thread.
+ *
+ * @ingroup kernel_mpsc_message_queue_tests
+ */
+void test_mpsc_msgq_get_timeout(void)
+{
+	struct msg m;
+	int64_t start;
+
+	drain(&kmsgq);
+
+	start = k_uptime_get();
+	zassert_equal(k_mpsc_msgq_get(&kmsgq, &m, K_MSEC(TIMEOUT_MS)),
+		      -EAGAIN, NULL);
+	zassert_true(k_uptime_get() - start >= TIMEOUT_MS, "Returned early");
+
+	k_thread_create(&tdata[0], tstack[0], STACK_SIZE, delayed_put,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+
+	zassert_equal(k_mpsc_msgq_get(&kmsgq, &m, K_MSEC(TIMEOUT_MS * 10)), 0,
+		      NULL);
+	zassert_equal(m.seq, 42, NULL);
+
+	k_thread_join(&tdata[0], K_FOREVER);
+}
+
+static void isr_put(const void *param)
+{
+	struct msg m = { .seq = POINTER_TO_UINT(param) };
+
+	isr_ret = k_mpsc_msgq_put(&kmsgq, &m);
+}
+
+static void timer_put(struct k_timer *timer)
+{
+	isr_put(UINT_TO_POINTER(7));
+}
+
+/**
+ * @brief Test puts from an ISR to a lock-free message queue
+ *
+ * @details A message put from an ISR is received, and a put from a
+ * timer ISR wakes a consumer pended on the queue.
+ *
+ * @ingroup kernel_mpsc_message_queue_tests
+ */
+void test_mpsc_msgq_isr(void)
+{
+	struct msg m;
+
+	drain(&kmsgq);
+
+	irq_offload(isr_put, UINT_TO_POINTER(3));
+	zassert_equal(isr_ret, 0, NULL);
+	zassert_equal(k_mpsc_msgq_get(&kmsgq, &m, K_NO_WAIT), 0, NULL);
+	zassert_equal(m.seq, 3, NULL);
+
+	isr_ret = -1;
+	k_timer_init(&put_timer, timer_put, NULL);
+	k_timer_start(&put_timer, K_MSEC(TIMEOUT_MS / 5), K_NO_WAIT);
+
+	zassert_equal(k_mpsc_msgq_get(&kmsgq, &m, K_FOREVER), 0, NULL);
+	zassert_equal(isr_ret, 0, NULL);
+	zassert_equal(m.seq, 7, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(mpsc_msgq_api,
+			 ztest_unit_test(test_mpsc_msgq_init),
+			 ztest_unit_test(test_mpsc_msgq_single_producer),
+			 ztest_unit_test(test_mpsc_msgq_full),
+			 ztest_unit_test(test_mpsc_msgq_multi_producer),
+			 ztest_unit_test(test_mpsc_msgq_get_timeout),
+			 ztest_unit_test(test_mpsc_msgq_isr));
+	ztest_run_test_suite(mpsc_msgq_api);
+}
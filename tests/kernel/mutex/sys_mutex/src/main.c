@@ -389,15 +389,82 @@ void test_user_access(void)
 #ifdef CONFIG_USERSPACE
 	int rv;
 
+#ifdef CONFIG_SYS_MUTEX_FAST_PATH
+	/* The fast path would fault on the mutex, the kernel still has to
+	 * refuse it
+	 */
+	rv = z_sys_mutex_kernel_lock(&no_access_mutex, K_NO_WAIT);
+	zassert_true(rv == -EACCES, "accessed mutex not in memory domain");
+	rv = z_sys_mutex_kernel_unlock(&no_access_mutex);
+	zassert_true(rv == -EACCES, "accessed mutex not in memory domain");
+#else
 	rv = sys_mutex_lock(&no_access_mutex, K_NO_WAIT);
 	zassert_true(rv == -EACCES, "accessed mutex not in memory domain");
 	rv = sys_mutex_unlock(&no_access_mutex);
 	zassert_true(rv == -EACCES, "accessed mutex not in memory domain");
+#endif
+	rv = sys_mutex_lock((struct sys_mutex *)NULL, K_NO_WAIT);
+	zassert_true(rv == -EACCES, "accepted bad mutex pointer");
+	rv = sys_mutex_unlock((struct sys_mutex *)NULL);
+	zassert_true(rv == -EACCES, "accepted bad mutex pointer");
 #else
 	ztest_test_skip();
 #endif /* CONFIG_USERSPACE */
 }
 
+#ifdef CONFIG_SYS_MUTEX_FAST_PATH
+static ZTEST_BMEM SYS_MUTEX_DEFINE(forged_mutex);
+static K_THREAD_STACK_DEFINE(forged_check_stack, STACKSIZE);
+static struct k_thread forged_check_thread;
+static int forged_prio;
+
+static void victim(void)
+{
+}
+
+K_THREAD_DEFINE(VICTIM, STACKSIZE, victim, NULL, NULL, NULL,
+		12, 0, SYS_FOREVER_MS);
+
+static void forged_check(void *p1, void *p2, void *p3)
+{
+	forged_prio = k_thread_priority_get(VICTIM);
+}
+#endif
+
+void test_forged_owner(void)
+{
+#ifdef CONFIG_SYS_MUTEX_FAST_PATH
+	int rv;
+
+	/* Publish a thread we were not granted access to as the owner: it
+	 * must not be boosted while we wait.  The check thread only runs
+	 * once we pend.
+	 */
+	forged_mutex.owner = VICTIM;
+	forged_mutex.lock_count = 1U;
+	atomic_set(&forged_mutex.val, Z_SYS_MUTEX_LOCKED);
+
+	k_thread_create(&forged_check_thread, forged_check_stack, STACKSIZE,
+			forged_check, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(14), 0, K_NO_WAIT);
+
+	rv = sys_mutex_lock(&forged_mutex, K_MSEC(500));
+	zassert_equal(rv, -EAGAIN, "Locked a mutex held by another thread");
+
+	k_thread_join(&forged_check_thread, K_FOREVER);
+	zassert_equal(forged_prio, 12, "Published owner boosted to %d",
+		      forged_prio);
+	zassert_equal(k_thread_priority_get(VICTIM), 12,
+		      "Published owner priority changed");
+
+	forged_mutex.owner = NULL;
+	forged_mutex.lock_count = 0U;
+	atomic_set(&forged_mutex.val, Z_SYS_MUTEX_UNLOCKED);
+#else
+	ztest_test_skip();
+#endif
+}
+
 K_THREAD_DEFINE(THREAD_05, STACKSIZE, thread_05, NULL, NULL, NULL,
 		5, K_USER, 0);
 
@@ -440,7 +507,8 @@ void test_main(void)
 	ztest_test_suite(mutex_complex,
 			 ztest_user_unit_test(test_mutex),
 			 ztest_user_unit_test(test_user_access),
-			 ztest_unit_test(test_supervisor_access));
+			 ztest_unit_test(test_supervisor_access),
+			 ztest_unit_test(test_forged_owner));
 
 	ztest_run_test_suite(mutex_complex);
 #else
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief Tests for pipe scatter-gather and claim/finish operations
+ * @ingroup kernel_pipe_tests
+ * @{
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE	(1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define VEC_PIPE_LEN	16
+
+K_PIPE_DEFINE(vec_pipe, VEC_PIPE_LEN, 4);
+
+extern struct k_thread tdata;
+K_THREAD_STACK_EXTERN(tstack);
+
+static const char vec_data[] = "0123456789abcdefghijklmnopqrstuv";
+
+/**
+ * @brief Test k_pipe_putv() and k_pipe_getv() through a wrapping buffer
+ *
+ * @see k_pipe_putv(), k_pipe_getv()
+ */
+void test_pipe_putv_getv(void)
+{
+	char out[VEC_PIPE_LEN];
+	size_t xferred;
+	struct k_pipe_iovec put_iov[] = {
+		{ .data = (void *)&vec_data[0], .len = 3 },
+		{ .data = (void *)&vec_data[3], .len = 0 },
+		{ .data = (void *)&vec_data[3], .len = 7 },
+	};
+	struct k_pipe_iovec get_iov[] = {
+		{ .data = &out[0], .len = 6 },
+		{ .data = &out[6], .len = 4 },
+	};
+
+	for (int i = 0; i < 4; i++) {
+		/* 10 bytes per round in a 16 byte pipe, so the ring wraps */
+		(void)memset(out, 0, sizeof(out));
+
+		zassert_equal(k_pipe_putv(&vec_pipe, put_iov,
+					  ARRAY_SIZE(put_iov), &xferred,
+					  10, K_NO_WAIT), 0, NULL);
+		zassert_equal(xferred, 10, NULL);
+
+		zassert_equal(k_pipe_getv(&vec_pipe, get_iov,
+					  ARRAY_SIZE(get_iov), &xferred,
+					  10, K_NO_WAIT), 0, NULL);
+		zassert_equal(xferred, 10, NULL);
+		zassert_mem_equal(out, vec_data, 10, NULL);
+	}
+
+	/* Short of space or data without waiting */
+	zassert_equal(k_pipe_putv(&vec_pipe, put_iov, ARRAY_SIZE(put_iov),
+				  &xferred, 10, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_pipe_putv(&vec_pipe, put_iov, ARRAY_SIZE(put_iov),
+				  &xferred, 10, K_NO_WAIT), -EIO, NULL);
+	zassert_equal(xferred, 0, NULL);
+	zassert_equal(k_pipe_putv(&vec_pipe, put_iov, ARRAY_SIZE(put_iov),
+				  &xferred, 0, K_NO_WAIT), 0, NULL);
+	zassert_equal(xferred, VEC_PIPE_LEN - 10, NULL);
+
+	zassert_equal(k_pipe_getv(&vec_pipe, get_iov, ARRAY_SIZE(get_iov),
+				  &xferred, 10, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_pipe_getv(&vec_pipe, get_iov, ARRAY_SIZE(get_iov),
+				  &xferred, 10, K_NO_WAIT), -EIO, NULL);
+	zassert_equal(k_pipe_getv(&vec_pipe, get_iov, ARRAY_SIZE(get_iov),
+				  &xferred, 0, K_NO_WAIT), 0, NULL);
+	zassert_equal(xferred, VEC_PIPE_LEN - 10, NULL);
+	zassert_equal(k_pipe_read_avail(&vec_pipe), 0, NULL);
+
+	zassert_equal(k_pipe_putv(&vec_pipe, put_iov, ARRAY_SIZE(put_iov),
+				  &xferred, 11, K_NO_WAIT), -EINVAL, NULL);
+}
+
+static void tvec_reader(void *p1, void *p2, void *p3)
+{
+	char out[8];
+	size_t got;
+
+	zassert_equal(k_pipe_get(&vec_pipe, out, sizeof(out), &got,
+				 sizeof(out), K_FOREVER), 0, NULL);
+	zassert_equal(got, sizeof(out), NULL);
+	zassert_mem_equal(out, vec_data, sizeof(out), NULL);
+}
+
+/**
+ * @brief Test filling a pipe in place with claim/finish
+ *
+ * A reader waiting on the empty pipe must receive the data committed
+ * with k_pipe_put_finish(), and k_pipe_get_claim() must expose the
+ * committed data where it was written.
+ *
+ * @see k_pipe_put_claim(), k_pipe_put_finish(),
+ * k_pipe_get_claim(), k_pipe_get_finish()
+ */
+void test_pipe_claim_finish(void)
+{
+	uint8_t *wr, *rd;
+	size_t n;
+
+	k_tid_t tid = k_thread_create(&tdata, tstack, STACK_SIZE,
+				      tvec_reader, NULL, NULL, NULL,
+				      K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+
+	/* Let the reader pend on the empty pipe */
+	k_msleep(10);
+
+	n = k_pipe_put_claim(&vec_pipe, &wr, 8);
+	zassert_equal(n, 8, NULL);
+	(void)memcpy(wr, vec_data, n);
+	zassert_equal(k_pipe_put_finish(&vec_pipe, n), 0, NULL);
+
+	k_thread_join(tid, K_FOREVER);
+	zassert_equal(k_pipe_read_avail(&vec_pipe), 0, NULL);
+
+	/* Nobody waiting: committed data stays in the ring */
+	n = k_pipe_put_claim(&vec_pipe, &wr, VEC_PIPE_LEN);
+	zassert_true(n > 0 && n <= VEC_PIPE_LEN, NULL);
+	(void)memcpy(wr, vec_data, n);
+	zassert_equal(k_pipe_put_finish(&vec_pipe, n), 0, NULL);
+	zassert_equal(k_pipe_put_finish(&vec_pipe, VEC_PIPE_LEN + 1), -EINVAL,
+		      NULL);
+
+	zassert_equal(k_pipe_get_claim(&vec_pipe, &rd, VEC_PIPE_LEN), n,
+		      NULL);
+	zassert_equal(rd, wr, NULL);
+	zassert_mem_equal(rd, vec_data, n, NULL);
+	zassert_equal(k_pipe_get_finish(&vec_pipe, n), 0, NULL);
+	zassert_equal(k_pipe_get_finish(&vec_pipe, 1), -EINVAL, NULL);
+	zassert_equal(k_pipe_read_avail(&vec_pipe), 0, NULL);
+}
+
+/**
+ * @}
+ */
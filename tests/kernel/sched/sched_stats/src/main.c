@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <zephyr.h>
+#include <ztest.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define N_WAKEUPS 20
+
+static K_THREAD_STACK_DEFINE(partner_stack, STACK_SIZE);
+static struct k_thread partner_thread;
+static K_SEM_DEFINE(wake_sem, 0, 1);
+static K_SEM_DEFINE(done_sem, 0, 1);
+
+static uint32_t hist_sum(const uint32_t *hist)
+{
+	uint32_t sum = 0U;
+
+	for (int b = 0; b < CONFIG_SCHED_STATS_BUCKETS; b++) {
+		sum += hist[b];
+	}
+	return sum;
+}
+
+static void partner_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (int i = 0; i < N_WAKEUPS; i++) {
+		k_sem_take(&wake_sem, K_FOREVER);
+		k_sem_give(&done_sem);
+	}
+}
+
+/**
+ * @brief Test that wakeups and run slices are recorded per thread
+ *
+ * @details A higher priority partner thread is woken up N_WAKEUPS
+ * times.  Each wakeup must land in its wake latency histogram, each
+ * time it ran in its run slice histogram, and the system wide
+ * histograms must account for at least as much.
+ *
+ * @ingroup kernel_sched_tests
+ */
+void test_sched_stats_wakeups(void)
+{
+	k_thread_sched_stats_t stats, all;
+	int prio = k_thread_priority_get(k_current_get()) - 1;
+
+	zassert_equal(k_thread_sched_stats_get(NULL, &stats), -EINVAL, NULL);
+	zassert_equal(k_thread_sched_stats_get(k_current_get(), NULL),
+		      -EINVAL, NULL);
+	zassert_equal(k_sched_stats_all_get(NULL), -EINVAL, NULL);
+
+	k_thread_create(&partner_thread, partner_stack, STACK_SIZE,
+			partner_fn, NULL, NULL, NULL, prio, 0, K_NO_WAIT);
+
+	for (int i = 0; i < N_WAKEUPS; i++) {
+		k_sem_give(&wake_sem);
+		k_sem_take(&done_sem, K_FOREVER);
+	}
+	k_thread_join(&partner_thread, K_FOREVER);
+
+	zassert_ok(k_thread_sched_stats_get(&partner_thread, &stats), NULL);
+	zassert_ok(k_sched_stats_all_get(&all), NULL);
+
+	/* Started once plus woken up by every give */
+	zassert_true(hist_sum(stats.wake_latency) >= N_WAKEUPS, NULL);
+	zassert_true(hist_sum(stats.run_slice) >= N_WAKEUPS, NULL);
+
+	zassert_true(hist_sum(all.wake_latency) >=
+		     hist_sum(stats.wake_latency), NULL);
+	zassert_true(hist_sum(all.run_slice) >= hist_sum(stats.run_slice),
+		     NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(sched_stats,
+			 ztest_unit_test(test_sched_stats_wakeups));
+	ztest_run_test_suite(sched_stats);
+}
@@ -948,6 +948,183 @@ void test_inc_concurrency(void)
 			"total count %d is wrong(M)", global_cnt);
 }
 
+static volatile int pinned_misplaced;
+
+static void pinned_fn(void *a, void *b, void *c)
+{
+	ARG_UNUSED(a);
+	ARG_UNUSED(b);
+	ARG_UNUSED(c);
+
+	for (int i = 0; i < 20; i++) {
+		if (curr_cpu() != 1) {
+			pinned_misplaced++;
+		}
+
+		k_busy_wait(DELAY_US / 50);
+		k_yield();
+	}
+}
+
+/**
+ * @brief Verify that threads pinned to one CPU stay on it
+ *
+ * @ingroup kernel_smp_tests
+ *
+ * @details Several threads are pinned to CPU 1 while the main thread
+ * waits for them, leaving the other CPUs idle.  With per-CPU run
+ * queues, an idle CPU steals threads queued on busy ones, and must
+ * leave alone those whose mask excludes it.
+ */
+void test_cpu_mask_pinned_threads(void)
+{
+#ifdef CONFIG_SCHED_CPU_MASK
+	int ret;
+
+	pinned_misplaced = 0;
+
+	for (int i = 0; i < THREADS_NUM; i++) {
+		tinfo[i].tid = k_thread_create(&tthread[i], tstack[i],
+					       STACK_SIZE, pinned_fn,
+					       NULL, NULL, NULL,
+					       K_PRIO_PREEMPT(1), 0,
+					       K_FOREVER);
+
+		ret = k_thread_cpu_mask_clear(tinfo[i].tid);
+		zassert_equal(ret, 0, "");
+		ret = k_thread_cpu_mask_enable(tinfo[i].tid, 1);
+		zassert_equal(ret, 0, "");
+	}
+
+	for (int i = 0; i < THREADS_NUM; i++) {
+		k_thread_start(tinfo[i].tid);
+	}
+
+	for (int i = 0; i < THREADS_NUM; i++) {
+		k_thread_join(tinfo[i].tid, K_FOREVER);
+	}
+
+	zassert_equal(pinned_misplaced, 0,
+		      "pinned threads ran on another CPU %d times",
+		      pinned_misplaced);
+#else
+	ztest_test_skip();
+#endif
+}
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+static struct k_thread steal_spinner[THREADS_NUM - 1];
+static K_THREAD_STACK_ARRAY_DEFINE(steal_spinner_stack, THREADS_NUM - 1,
+				   STACK_SIZE);
+static atomic_t spinners_running;
+static atomic_t workers_done;
+static volatile bool steal_release;
+static volatile bool steal_done;
+static volatile int worker_cpu[THREADS_NUM];
+
+static void steal_spinner_fn(void *a, void *b, void *c)
+{
+	int cpu = curr_cpu();
+
+	ARG_UNUSED(a);
+	ARG_UNUSED(b);
+	ARG_UNUSED(c);
+
+	atomic_inc(&spinners_running);
+
+	/* The spinner on CPU 0 keeps it busy until the end */
+	while (!steal_release || (cpu == 0 && !steal_done)) {
+	}
+}
+
+static void steal_worker_fn(void *a, void *b, void *c)
+{
+	ARG_UNUSED(b);
+	ARG_UNUSED(c);
+
+	worker_cpu[POINTER_TO_INT(a)] = curr_cpu();
+	atomic_inc(&workers_done);
+}
+#endif
+
+/**
+ * @brief Verify that idle CPUs steal threads queued on a busy one
+ *
+ * @ingroup kernel_smp_tests
+ *
+ * @details With every CPU kept busy by a cooperative thread, new
+ * threads are queued on CPU 0, the default run queue of a thread that
+ * never ran.  The busy threads on the other CPUs then exit while CPU 0
+ * stays busy, so the queued threads can only run if those CPUs take
+ * them from the queue of CPU 0.
+ */
+void test_work_stealing(void)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	int main_cpu = curr_cpu();
+
+	atomic_clear(&spinners_running);
+	atomic_clear(&workers_done);
+	steal_release = false;
+	steal_done = false;
+
+	/* The (cooperative) test thread busies its own CPU, a spinner
+	 * busies each of the others
+	 */
+	for (int i = 0; i < THREADS_NUM - 1; i++) {
+		k_thread_create(&steal_spinner[i], steal_spinner_stack[i],
+				STACK_SIZE, steal_spinner_fn, NULL, NULL, NULL,
+				K_PRIO_COOP(2), 0, K_NO_WAIT);
+	}
+
+	for (int i = 0; i < TIMEOUT &&
+	     atomic_get(&spinners_running) < THREADS_NUM - 1; i++) {
+		k_busy_wait(1000);
+	}
+	zassert_equal(atomic_get(&spinners_running), THREADS_NUM - 1,
+		      "spinners did not start on all CPUs");
+
+	for (int i = 0; i < THREADS_NUM; i++) {
+		worker_cpu[i] = -1;
+		tinfo[i].tid = k_thread_create(&tthread[i], tstack[i],
+					       STACK_SIZE, steal_worker_fn,
+					       INT_TO_POINTER(i), NULL, NULL,
+					       K_PRIO_PREEMPT(1), 0,
+					       K_NO_WAIT);
+	}
+
+	steal_release = true;
+
+	/* Never give up CPU 0 while the workers may still be queued */
+	for (int i = 0; i < TIMEOUT &&
+	     atomic_get(&workers_done) < THREADS_NUM; i++) {
+		if (main_cpu == 0) {
+			k_busy_wait(1000);
+		} else {
+			k_sleep(K_MSEC(1));
+		}
+	}
+
+	steal_done = true;
+
+	for (int i = 0; i < THREADS_NUM - 1; i++) {
+		k_thread_join(&steal_spinner[i], K_FOREVER);
+	}
+
+	for (int i = 0; i < THREADS_NUM; i++) {
+		k_thread_join(tinfo[i].tid, K_FOREVER);
+	}
+
+	/* A worker that was not stolen only ran once CPU 0 was freed */
+	for (int i = 0; i < THREADS_NUM; i++) {
+		zassert_not_equal(worker_cpu[i], 0,
+				  "thread %d was not stolen from CPU 0", i);
+	}
+#else
+	ztest_test_skip();
+#endif
+}
+
 void test_main(void)
 {
 	/* Sleep a bit to guarantee that both CPUs enter an idle
@@ -969,7 +1146,9 @@ void test_main(void)
 			 ztest_unit_test(test_fatal_on_smp),
 			 ztest_unit_test(test_workq_on_smp),
 			 ztest_unit_test(test_smp_release_global_lock),
-			 ztest_unit_test(test_inc_concurrency)
+			 ztest_unit_test(test_inc_concurrency),
+			 ztest_unit_test(test_cpu_mask_pinned_threads),
+			 ztest_unit_test(test_work_stealing)
 			 );
 	ztest_run_test_suite(smp);
 }
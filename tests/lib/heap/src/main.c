@@ -323,13 +323,75 @@ static void test_realloc(void)
 		     "Realloc should have moved %p", p2);
 }
 
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+static void test_runtime_stats(void)
+{
+	struct sys_heap heap;
+	struct sys_heap_runtime_stats stats;
+	size_t total, peak;
+	void *p1, *p2;
+
+	sys_heap_init(&heap, heapmem, SMALL_HEAP_SZ);
+
+	zassert_equal(sys_heap_runtime_stats_get(&heap, &stats), 0, "");
+	zassert_equal(stats.allocated_bytes, 0, "");
+	zassert_equal(stats.alloc_count, 0, "");
+	zassert_true(stats.largest_free_bytes > 0, "");
+	total = stats.free_bytes;
+
+	p1 = sys_heap_alloc(&heap, 100);
+	p2 = sys_heap_alloc(&heap, 200);
+	zassert_not_null(p1, "");
+	zassert_not_null(p2, "");
+
+	sys_heap_runtime_stats_get(&heap, &stats);
+	zassert_equal(stats.alloc_count, 2, "");
+	zassert_true(stats.allocated_bytes >= 300, "");
+	zassert_equal(stats.allocated_bytes + stats.free_bytes, total, "");
+	peak = stats.allocated_bytes;
+
+	p1 = sys_heap_realloc(&heap, p1, 40);
+	sys_heap_runtime_stats_get(&heap, &stats);
+	zassert_equal(stats.alloc_count, 2, "");
+	zassert_true(stats.allocated_bytes < peak, "");
+	zassert_equal(stats.max_allocated_bytes, peak, "");
+	zassert_equal(stats.allocated_bytes + stats.free_bytes, total, "");
+
+	sys_heap_free(&heap, p1);
+	sys_heap_free(&heap, p2);
+	sys_heap_runtime_stats_get(&heap, &stats);
+	zassert_equal(stats.alloc_count, 0, "");
+	zassert_equal(stats.allocated_bytes, 0, "");
+	zassert_equal(stats.free_bytes, total, "");
+	zassert_equal(stats.max_allocated_bytes, peak, "");
+
+	/* Everything merged back into one free chunk */
+	uint32_t chunks = 0;
+
+	for (int b = 0; b < stats.nb_buckets; b++) {
+		chunks += stats.free_chunks[b];
+	}
+	zassert_equal(chunks, 1, "");
+
+	sys_heap_runtime_stats_reset_max(&heap);
+	sys_heap_runtime_stats_get(&heap, &stats);
+	zassert_equal(stats.max_allocated_bytes, 0, "");
+}
+#else
+static void test_runtime_stats(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 void test_main(void)
 {
 	ztest_test_suite(lib_heap_test,
 			 ztest_unit_test(test_realloc),
 			 ztest_unit_test(test_small_heap),
 			 ztest_unit_test(test_fragmentation),
-			 ztest_unit_test(test_big_heap)
+			 ztest_unit_test(test_big_heap),
+			 ztest_unit_test(test_runtime_stats)
 			 );
 
 	ztest_run_test_suite(lib_heap_test);
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/sys_heap.h>
+
+#define HEAP_SZ (32 * 1024)
+#define N_LIVE 64
+#define N_OPS 20000
+#define N_FILL 1024
+
+static uint8_t __aligned(8) heap_mem[2][HEAP_SZ];
+static struct sys_heap heaps[2];
+static const char *const names[2] = { "plain", "slab " };
+
+static void *blocks[N_FILL];
+static size_t sizes[N_FILL];
+
+static uint32_t rand_state = 12345;
+
+/* Small LCG, so both heaps see the same request sequence */
+static uint32_t next_rand(void)
+{
+	rand_state = rand_state * 1103515245U + 12345U;
+	return rand_state >> 8;
+}
+
+/* Mostly small requests, the kind net_buf metadata and JSON parsing
+ * make, with the odd larger one.
+ */
+static size_t small_size(void)
+{
+	return 8U + (next_rand() % 249U);
+}
+
+static size_t large_size(void)
+{
+	return 512U + (next_rand() % 1024U);
+}
+
+static uint32_t throughput(struct sys_heap *h)
+{
+	uint64_t cyc = 0U;
+	int ops = 0;
+
+	rand_state = 12345U;
+
+	for (int i = 0; i < N_LIVE; i++) {
+		blocks[i] = sys_heap_alloc(h, small_size());
+	}
+
+	for (int i = 0; i < N_OPS; i++) {
+		int slot = next_rand() % N_LIVE;
+		size_t sz = small_size();
+		uint32_t t0 = k_cycle_get_32();
+
+		sys_heap_free(h, blocks[slot]);
+		blocks[slot] = sys_heap_alloc(h, sz);
+
+		cyc += k_cycle_get_32() - t0;
+		ops += (blocks[slot] != NULL) ? 1 : 0;
+	}
+
+	for (int i = 0; i < N_LIVE; i++) {
+		sys_heap_free(h, blocks[i]);
+		blocks[i] = NULL;
+	}
+
+	if (ops != N_OPS) {
+		printk("%d allocations failed\n", N_OPS - ops);
+	}
+
+	return (uint32_t)k_cyc_to_ns_floor64(cyc / N_OPS);
+}
+
+static size_t largest_free(struct sys_heap *h)
+{
+	size_t lo = 0, hi = HEAP_SZ;
+
+	while (hi - lo > 8) {
+		size_t mid = (lo + hi) / 2;
+		void *p = sys_heap_alloc(h, mid);
+
+		if (p != NULL) {
+			sys_heap_free(h, p);
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+static void fragmentation(struct sys_heap *h, const char *name)
+{
+	size_t live = 0;
+	int n = 0;
+
+	rand_state = 54321U;
+
+	/* Fill with a 3:1 mix of small and large blocks... */
+	while (n < N_FILL) {
+		sizes[n] = ((next_rand() % 4U) == 0U) ? large_size()
+						      : small_size();
+		blocks[n] = sys_heap_alloc(h, sizes[n]);
+		if (blocks[n] == NULL) {
+			break;
+		}
+		n++;
+	}
+
+	/* ...punch holes in it... */
+	for (int i = 0; i < n; i += 2) {
+		sys_heap_free(h, blocks[i]);
+		blocks[i] = NULL;
+	}
+
+	/* ...and refill the holes with large blocks while they fit */
+	for (int i = 0; i < n; i += 2) {
+		sizes[i] = large_size();
+		blocks[i] = sys_heap_alloc(h, sizes[i]);
+		if (blocks[i] == NULL) {
+			break;
+		}
+	}
+
+	for (int i = 0; i < n; i++) {
+		if (blocks[i] != NULL) {
+			live += sizes[i];
+		}
+	}
+
+	/* Note that on the slab heap the failing probes of largest_free()
+	 * give empty slab pages back first.
+	 */
+	printk("%s fill %3u%% largest %6u\n", name,
+	       (unsigned int)(100U * live / HEAP_SZ),
+	       (unsigned int)largest_free(h));
+
+	for (int i = 0; i < n; i++) {
+		sys_heap_free(h, blocks[i]);
+		blocks[i] = NULL;
+	}
+}
+
+void main(void)
+{
+	for (int i = 0; i < 2; i++) {
+		sys_heap_init(&heaps[i], heap_mem[i], HEAP_SZ);
+	}
+
+	if (sys_heap_slab_init(&heaps[1]) != 0) {
+		printk("slab init failed\n");
+		return;
+	}
+
+	for (int i = 0; i < 2; i++) {
+		printk("%s alloc/free %6u ns\n", names[i],
+		       throughput(&heaps[i]));
+	}
+
+	for (int i = 0; i < 2; i++) {
+		fragmentation(&heaps[i], names[i]);
+	}
+
+	printk("fin\n");
+}
@@ -397,6 +397,10 @@ static void test_json_invalid_number(void)
 {
 	struct encoding_test encoded[] = {
 		{ "{\"some_int\":xxx }", -EINVAL},
+		{ "{\"some_int\":01}", -EINVAL},
+		{ "{\"some_int\":1-2}", -EINVAL},
+		{ "{\"some_int\":--1}", -EINVAL},
+		{ "{\"some_int\":1.2.3}", -EINVAL},
 	};
 
 	parse_harness(encoded, ARRAY_SIZE(encoded));
@@ -551,6 +555,331 @@ static void test_json_encode_bounds_check(void)
 	zassert_equal(ret, -ENOMEM, "Bounds check rejected");
 }
 
+struct test_wide {
+	int64_t counter;
+	struct json_obj_token reading;
+	struct json_obj_token blob;
+};
+
+static const struct json_obj_descr wide_descr[] = {
+	JSON_OBJ_DESCR_PRIM(struct test_wide, counter, JSON_TOK_INT64),
+	JSON_OBJ_DESCR_PRIM(struct test_wide, reading, JSON_TOK_FLOAT),
+	JSON_OBJ_DESCR_PRIM(struct test_wide, blob, JSON_TOK_OPAQUE),
+};
+
+static void test_json_wide_types(void)
+{
+	char encoded[] = "{\"counter\":-9223372036854775808,"
+		"\"reading\":-12.5e+3,\"blob\":\"a\\\"b\\u00e9\"}";
+	char buffer[sizeof(encoded)];
+	char bad_number[] = "1.2.3";
+	struct test_wide tw;
+	int ret;
+
+	ret = json_obj_parse(encoded, sizeof(encoded) - 1, wide_descr,
+			     ARRAY_SIZE(wide_descr), &tw);
+	zassert_equal(ret, (1 << ARRAY_SIZE(wide_descr)) - 1,
+		      "All fields decoded correctly");
+	zassert_equal(tw.counter, INT64_MIN, "64-bit integer decoded");
+	zassert_equal(tw.reading.length, strlen("-12.5e+3"),
+		      "Number text length");
+	zassert_true(!strncmp(tw.reading.start, "-12.5e+3",
+			      tw.reading.length), "Number text kept");
+	zassert_equal(tw.blob.length, strlen("a\\\"b\\u00e9"),
+		      "Opaque string length");
+
+	/* The raw values are written back as they are */
+	ret = json_obj_encode_buf(wide_descr, ARRAY_SIZE(wide_descr), &tw,
+				  buffer, sizeof(buffer));
+	zassert_equal(ret, 0, "Encoding function returned no errors");
+	zassert_true(!strcmp(buffer, "{\"counter\":-9223372036854775808,"
+			     "\"reading\":-12.5e+3,\"blob\":\"a\\\"b\\u00e9\"}"),
+		     "Encoded contents consistent");
+
+	/* But only if they are numbers */
+	tw.reading.start = bad_number;
+	tw.reading.length = strlen(bad_number);
+	ret = json_obj_encode_buf(wide_descr, ARRAY_SIZE(wide_descr), &tw,
+				  buffer, sizeof(buffer));
+	zassert_equal(ret, -EINVAL, "Malformed number encoded");
+}
+
+static void test_json_int_range(void)
+{
+	struct encoding_test encoded[] = {
+		{ "{\"some_int\":2147483647}", 2 },
+		{ "{\"some_int\":-2147483648}", 2 },
+		{ "{\"some_int\":2147483648}", -ERANGE },
+		{ "{\"some_int\":-2147483649}", -ERANGE },
+		{ "{\"some_int\":1.5}", -EINVAL },
+		{ "{\"some_int\":-}", -EINVAL },
+	};
+	struct test_wide tw;
+	char big[] = "{\"counter\":9223372036854775808}";
+	int ret;
+
+	parse_harness(encoded, ARRAY_SIZE(encoded));
+
+	ret = json_obj_parse(big, sizeof(big) - 1, wide_descr,
+			     ARRAY_SIZE(wide_descr), &tw);
+	zassert_equal(ret, -ERANGE, "64-bit overflow rejected");
+}
+
+struct chunk_sink {
+	char buffer[512];
+	size_t len;
+	int calls;
+};
+
+static int append_to_sink(const char *bytes, size_t len, void *data)
+{
+	struct chunk_sink *sink = data;
+
+	zassert_true(sink->len + len <= sizeof(sink->buffer), "Sink overflow");
+
+	memcpy(sink->buffer + sink->len, bytes, len);
+	sink->len += len;
+	sink->calls++;
+
+	return 0;
+}
+
+static void test_json_encode_chunks(void)
+{
+	struct obj_array oa = {
+		.elements = {
+			[0] = { .name = "Simón Bolívar", .height = 168 },
+			[1] = { .name = "Muggsy Bogues", .height = 160 },
+			[2] = { .name = "Pelé",          .height = 173 },
+			[3] = { .name = "Hakeem Olajuwon", .height = 213 },
+			[4] = { .name = "Alex Honnold",  .height = 180 },
+		},
+		.num_elements = 5,
+	};
+	struct chunk_sink sink = { 0 };
+	char buffer[512];
+	ssize_t len;
+	int ret;
+
+	ret = json_obj_encode_buf(obj_array_descr, ARRAY_SIZE(obj_array_descr),
+				  &oa, buffer, sizeof(buffer));
+	zassert_equal(ret, 0, "Encoding to a buffer succeeded");
+
+	ret = json_obj_encode(obj_array_descr, ARRAY_SIZE(obj_array_descr),
+			      &oa, append_to_sink, &sink);
+	zassert_equal(ret, 0, "Encoding with a callback succeeded");
+	zassert_equal(sink.len, strlen(buffer), "Same length");
+	zassert_true(!memcmp(sink.buffer, buffer, sink.len), "Same contents");
+
+	/* The output comes in chunks, not byte by byte */
+	zassert_true(sink.calls <= sink.len / (CONFIG_JSON_ENCODE_BUF_SIZE / 2)
+		     + 1, "Output handed over in %d calls", sink.calls);
+
+	len = json_calc_encoded_len(obj_array_descr,
+				    ARRAY_SIZE(obj_array_descr), &oa);
+	zassert_equal(len, sink.len, "Calculated length consistent");
+}
+
+struct tokenizer_test {
+	enum json_tokens type;
+	const char *text;
+};
+
+static const char streamed[] = "{\"name\":\"Foo \\\"bar\\\" \\u0041\","
+	" \"ids\":[1,-22,3.5e-7],\"on\":true,\"off\":false,"
+	"\"none\":null,\"nested\":{\"empty\":[],\"obj\":{}}}";
+
+static const struct tokenizer_test streamed_tokens[] = {
+	{ JSON_TOK_OBJECT_START, "{" },
+	{ JSON_TOK_STRING, "name" },
+	{ JSON_TOK_COLON, ":" },
+	{ JSON_TOK_STRING, "Foo \\\"bar\\\" \\u0041" },
+	{ JSON_TOK_COMMA, "," },
+	{ JSON_TOK_STRING, "ids" },
+	{ JSON_TOK_COLON, ":" },
+	{ JSON_TOK_LIST_START, "[" },
+	{ JSON_TOK_NUMBER, "1" },
+	{ JSON_TOK_COMMA, "," },
+	{ JSON_TOK_NUMBER, "-22" },
+	{ JSON_TOK_COMMA, "," },
+	{ JSON_TOK_NUMBER, "3.5e-7" },
+	{ JSON_TOK_LIST_END, "]" },
+	{ JSON_TOK_COMMA, "," },
+	{ JSON_TOK_STRING, "on" },
+	{ JSON_TOK_COLON, ":" },
+	{ JSON_TOK_TRUE, "true" },
+	{ JSON_TOK_COMMA, "," },
+	{ JSON_TOK_STRING, "off" },
+	{ JSON_TOK_COLON, ":" },
+	{ JSON_TOK_FALSE, "false" },
+	{ JSON_TOK_COMMA, "," },
+	{ JSON_TOK_STRING, "none" },
+	{ JSON_TOK_COLON, ":" },
+	{ JSON_TOK_NULL, "null" },
+	{ JSON_TOK_COMMA, "," },
+	{ JSON_TOK_STRING, "nested" },
+	{ JSON_TOK_COLON, ":" },
+	{ JSON_TOK_OBJECT_START, "{" },
+	{ JSON_TOK_STRING, "empty" },
+	{ JSON_TOK_COLON, ":" },
+	{ JSON_TOK_LIST_START, "[" },
+	{ JSON_TOK_LIST_END, "]" },
+	{ JSON_TOK_COMMA, "," },
+	{ JSON_TOK_STRING, "obj" },
+	{ JSON_TOK_COLON, ":" },
+	{ JSON_TOK_OBJECT_START, "{" },
+	{ JSON_TOK_OBJECT_END, "}" },
+	{ JSON_TOK_OBJECT_END, "}" },
+	{ JSON_TOK_OBJECT_END, "}" },
+	{ JSON_TOK_EOF, "" },
+};
+
+/* Feed the text in two chunks split at @a split, and return the first
+ * error or the number of tokens matching the expected ones, if any.
+ */
+static int tokenize_split(const char *text, size_t split,
+			  const struct tokenizer_test *expected,
+			  size_t n_expected)
+{
+	size_t len = strlen(text);
+	struct json_tokenizer tok;
+	struct json_token token;
+	char scratch[32];
+	size_t n = 0;
+	int ret;
+
+	json_tokenizer_init(&tok, scratch, sizeof(scratch));
+	json_tokenizer_feed(&tok, text, split, split == len);
+
+	do {
+		ret = json_tokenizer_next(&tok, &token);
+		if (ret == -EAGAIN) {
+			json_tokenizer_feed(&tok, text + split, len - split,
+					    true);
+			continue;
+		}
+
+		if (ret < 0) {
+			return ret;
+		}
+
+		if (!expected) {
+			continue;
+		}
+
+		if (n == n_expected || token.type != expected[n].type ||
+		    token.length != strlen(expected[n].text) ||
+		    memcmp(token.start, expected[n].text, token.length)) {
+			return n;
+		}
+
+		n++;
+	} while (ret == -EAGAIN || token.type != JSON_TOK_EOF);
+
+	return n;
+}
+
+static void test_json_tokenizer(void)
+{
+	size_t len = strlen(streamed);
+	int ret;
+
+	for (size_t split = 0; split <= len; split++) {
+		ret = tokenize_split(streamed, split, streamed_tokens,
+				     ARRAY_SIZE(streamed_tokens));
+		zassert_equal(ret, ARRAY_SIZE(streamed_tokens),
+			      "Split at %zu: token %d wrong", split, ret);
+	}
+}
+
+static void test_json_tokenizer_single_bytes(void)
+{
+	size_t len = strlen(streamed);
+	struct json_tokenizer tok;
+	struct json_token token;
+	char scratch[32];
+	size_t fed = 0;
+	size_t n = 0;
+	int ret;
+
+	json_tokenizer_init(&tok, scratch, sizeof(scratch));
+
+	for (;;) {
+		ret = json_tokenizer_next(&tok, &token);
+		if (ret == -EAGAIN) {
+			zassert_true(fed < len, "Asked for more than the value");
+			json_tokenizer_feed(&tok, streamed + fed, 1,
+					    fed + 1 == len);
+			fed++;
+			continue;
+		}
+
+		zassert_equal(ret, 0, "Token %zu failed (%d)", n, ret);
+		zassert_equal(token.type, streamed_tokens[n].type,
+			      "Token %zu type", n);
+		zassert_equal(token.length, strlen(streamed_tokens[n].text),
+			      "Token %zu length", n);
+		zassert_true(!memcmp(token.start, streamed_tokens[n].text,
+				     token.length), "Token %zu text", n);
+
+		if (token.type == JSON_TOK_EOF) {
+			break;
+		}
+
+		n++;
+	}
+}
+
+static void test_json_tokenizer_errors(void)
+{
+	static const struct {
+		const char *text;
+		int result;
+	} invalid[] = {
+		{ "{\"a\" 1}", -EINVAL },
+		{ "{\"a\":1,}", -EINVAL },
+		{ "[1,]", -EINVAL },
+		{ "[1 2]", -EINVAL },
+		{ "{1:2}", -EINVAL },
+		{ "[}", -EINVAL },
+		{ "{]", -EINVAL },
+		{ "]", -EINVAL },
+		{ "[tru]", -EINVAL },
+		{ "nul", -EINVAL },
+		{ "\"\\x\"", -EINVAL },
+		{ "\"\\u12g4\"", -EINVAL },
+		{ "\"a\tb\"", -EINVAL },
+		{ "\"open", -EINVAL },
+		{ "[1", -EINVAL },
+		{ "1 2", -EINVAL },
+		{ "-", -EINVAL },
+		{ "1-2", -EINVAL },
+		{ "--1", -EINVAL },
+		{ "1.2.3", -EINVAL },
+		{ "01", -EINVAL },
+		{ "[1.]", -EINVAL },
+		{ "[1e+]", -EINVAL },
+		{ "1e", -EINVAL },
+		{ "", -EINVAL },
+		{ "\"a string much longer than the scratch buffer\"",
+		  -ENOSPC },
+		{ "[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[", -E2BIG },
+	};
+	int ret;
+
+	for (size_t i = 0; i < ARRAY_SIZE(invalid); i++) {
+		size_t len = strlen(invalid[i].text);
+
+		/* Errors are found whole or split, but the scratch buffer
+		 * is only needed when split.
+		 */
+		ret = tokenize_split(invalid[i].text, len / 2, NULL, 0);
+		zassert_equal(ret, invalid[i].result,
+			      "Tokenizing '%s' result %d, expected %d",
+			      invalid[i].text, ret, invalid[i].result);
+	}
+}
+
 void test_main(void)
 {
 	ztest_test_suite(lib_json_test,
@@ -572,7 +901,13 @@ void test_main(void)
 			 ztest_unit_test(test_json_escape_empty),
 			 ztest_unit_test(test_json_escape_no_op),
 			 ztest_unit_test(test_json_escape_bounds_check),
-			 ztest_unit_test(test_json_encode_bounds_check)
+			 ztest_unit_test(test_json_encode_bounds_check),
+			 ztest_unit_test(test_json_wide_types),
+			 ztest_unit_test(test_json_int_range),
+			 ztest_unit_test(test_json_encode_chunks),
+			 ztest_unit_test(test_json_tokenizer),
+			 ztest_unit_test(test_json_tokenizer_single_bytes),
+			 ztest_unit_test(test_json_tokenizer_errors)
 			 );
 
 	ztest_run_test_suite(lib_json_test);
@@ -1026,6 +1026,296 @@ void test_pending_alloc(void)
 	k_thread_priority_set(k_current_get(), prio);
 }
 
+static uint32_t readers_drop_cnt;
+
+static void readers_drop(struct mpsc_pbuf_buffer *buffer,
+			 union mpsc_pbuf_generic *item)
+{
+	readers_drop_cnt++;
+}
+
+static void init_readers(struct mpsc_pbuf_buffer *buffer, bool pow2)
+{
+	struct mpsc_pbuf_buffer_config readers_cfg = {
+		.buf = buf32,
+		.size = ARRAY_SIZE(buf32) - (pow2 ? 0 : 1),
+		.notify_drop = readers_drop,
+		.get_wlen = get_wlen,
+		.flags = MPSC_PBUF_MODE_READERS
+	};
+
+	readers_drop_cnt = 0;
+	mpsc_pbuf_init(buffer, &readers_cfg);
+}
+
+static bool reader_put(struct mpsc_pbuf_buffer *buffer, uint32_t len,
+		       uint32_t data)
+{
+	struct test_data_var *packet;
+
+	packet = (struct test_data_var *)mpsc_pbuf_alloc(buffer, len,
+							 K_NO_WAIT);
+	if (!packet) {
+		return false;
+	}
+
+	packet->hdr.len = len;
+	packet->hdr.data = data;
+	mpsc_pbuf_commit(buffer, (union mpsc_pbuf_generic *)packet);
+
+	return true;
+}
+
+static int reader_get(struct mpsc_pbuf_buffer *buffer,
+		      struct mpsc_pbuf_reader *reader)
+{
+	union test_item *t;
+	int data;
+
+	t = (union test_item *)mpsc_pbuf_reader_claim(buffer, reader,
+						       K_NO_WAIT);
+	if (!t) {
+		return -1;
+	}
+
+	data = t->data.data;
+	mpsc_pbuf_reader_free(buffer, reader, &t->item);
+
+	return data;
+}
+
+/* A reader which keeps up reads every packet while packets are dropped for a
+ * slow reader in overwrite mode.
+ */
+void readers_overwrite(bool pow2)
+{
+	struct mpsc_pbuf_buffer buffer;
+	struct mpsc_pbuf_reader fast, slow;
+	int repeat = 4 * ARRAY_SIZE(buf32);
+	int exp_slow = 0;
+	int slow_cnt = 0;
+	int data;
+
+	init_readers(&buffer, pow2);
+	zassert_equal(mpsc_pbuf_reader_add(&buffer, &fast, 0), 0, NULL);
+	zassert_equal(mpsc_pbuf_reader_add(&buffer, &slow,
+					   MPSC_PBUF_READER_MODE_OVERWRITE),
+		      0, NULL);
+
+	for (int i = 0; i < repeat; i++) {
+		zassert_true(reader_put(&buffer, 1 + i % 7, i), NULL);
+		zassert_equal(reader_get(&buffer, &fast), i, NULL);
+
+		if (i % 16 == 0) {
+			data = reader_get(&buffer, &slow);
+			zassert_true(data >= exp_slow, NULL);
+			exp_slow = data + 1;
+			slow_cnt++;
+		}
+	}
+
+	while ((data = reader_get(&buffer, &slow)) >= 0) {
+		zassert_true(data >= exp_slow, NULL);
+		exp_slow = data + 1;
+		slow_cnt++;
+	}
+
+	zassert_equal(exp_slow, repeat, NULL);
+	zassert_false(mpsc_pbuf_reader_is_pending(&buffer, &fast), NULL);
+	zassert_true(readers_drop_cnt > 0, NULL);
+	zassert_equal(mpsc_pbuf_reader_dropped(&buffer, &slow),
+		      readers_drop_cnt, NULL);
+	zassert_equal(slow_cnt + readers_drop_cnt, repeat, NULL);
+	zassert_equal(mpsc_pbuf_reader_dropped(&buffer, &slow), 0, NULL);
+	zassert_equal(mpsc_pbuf_reader_dropped(&buffer, &fast), 0, NULL);
+}
+
+void test_readers_overwrite(void)
+{
+	readers_overwrite(true);
+	readers_overwrite(false);
+}
+
+/* Space is held until every reader has read the packets. */
+void readers_no_overwrite(bool pow2)
+{
+	struct mpsc_pbuf_buffer buffer;
+	struct mpsc_pbuf_reader r0, r1;
+	uint32_t len = 5;
+	int cnt = 0;
+
+	init_readers(&buffer, pow2);
+	zassert_equal(mpsc_pbuf_reader_add(&buffer, &r0, 0), 0, NULL);
+	zassert_equal(mpsc_pbuf_reader_add(&buffer, &r1, 0), 0, NULL);
+
+	/* Put some data to include wrapping */
+	for (int i = 0; i < 7; i++) {
+		zassert_true(reader_put(&buffer, len, i), NULL);
+		zassert_equal(reader_get(&buffer, &r0), i, NULL);
+		zassert_equal(reader_get(&buffer, &r1), i, NULL);
+	}
+
+	while (reader_put(&buffer, len, cnt)) {
+		cnt++;
+	}
+
+	/* Space at the end of the buffer is lost to the wrapping. */
+	zassert_true(cnt >= (buffer.size - len) / len, NULL);
+	zassert_true(cnt <= (buffer.size - 1) / len, NULL);
+	zassert_equal(reader_get(&buffer, &r0), 0, NULL);
+	zassert_false(reader_put(&buffer, len, cnt), NULL);
+	zassert_equal(reader_get(&buffer, &r1), 0, NULL);
+	zassert_true(reader_put(&buffer, len, cnt), NULL);
+
+	for (int i = 1; i <= cnt; i++) {
+		zassert_equal(reader_get(&buffer, &r0), i, NULL);
+		zassert_equal(reader_get(&buffer, &r1), i, NULL);
+	}
+
+	zassert_equal(reader_get(&buffer, &r0), -1, NULL);
+	zassert_equal(reader_get(&buffer, &r1), -1, NULL);
+	zassert_equal(readers_drop_cnt, 0, NULL);
+}
+
+void test_readers_no_overwrite(void)
+{
+	readers_no_overwrite(true);
+	readers_no_overwrite(false);
+}
+
+/* The packet claimed by a reader in overwrite mode is not dropped. */
+void reader_overwrite_while_claimed(bool pow2)
+{
+	struct mpsc_pbuf_buffer buffer;
+	struct mpsc_pbuf_reader reader;
+	struct test_data_var *p;
+	uint32_t len = 5;
+	int cnt = 0;
+	int data;
+
+	init_readers(&buffer, pow2);
+	zassert_equal(mpsc_pbuf_reader_add(&buffer, &reader,
+					   MPSC_PBUF_READER_MODE_OVERWRITE),
+		      0, NULL);
+
+	while (cnt < (buffer.size / len) + 5) {
+		zassert_true(reader_put(&buffer, len, cnt), NULL);
+		cnt++;
+	}
+
+	p = (struct test_data_var *)mpsc_pbuf_reader_claim(&buffer, &reader,
+							    K_NO_WAIT);
+	zassert_true(p, NULL);
+	data = p->hdr.data;
+	zassert_true(data > 0, NULL);
+
+	zassert_false(reader_put(&buffer, len, cnt), NULL);
+	zassert_equal(p->hdr.data, data, NULL);
+	zassert_equal(p->hdr.len, len, NULL);
+
+	mpsc_pbuf_reader_free(&buffer, &reader, (union mpsc_pbuf_generic *)p);
+	zassert_true(reader_put(&buffer, len, cnt), NULL);
+	cnt++;
+
+	while ((data = reader_get(&buffer, &reader)) >= 0) {
+		zassert_true(data < cnt, NULL);
+	}
+
+	zassert_equal(data, -1, NULL);
+	zassert_equal(mpsc_pbuf_reader_dropped(&buffer, &reader),
+		      readers_drop_cnt, NULL);
+}
+
+void test_reader_overwrite_while_claimed(void)
+{
+	reader_overwrite_while_claimed(true);
+	reader_overwrite_while_claimed(false);
+}
+
+/* Without readers space is reclaimed without dropping, a reader added later
+ * starts with the oldest packet held by the buffer.
+ */
+void test_reader_add(void)
+{
+	struct mpsc_pbuf_buffer buffer;
+	struct mpsc_pbuf_reader readers[CONFIG_MPSC_PBUF_READERS + 1];
+	int repeat = ARRAY_SIZE(buf32);
+	int data, prev = -1;
+
+	init_readers(&buffer, true);
+
+	for (int i = 0; i < repeat; i++) {
+		zassert_true(reader_put(&buffer, 3, i), NULL);
+	}
+
+	zassert_equal(readers_drop_cnt, 0, NULL);
+
+	for (int i = 0; i < CONFIG_MPSC_PBUF_READERS; i++) {
+		zassert_equal(mpsc_pbuf_reader_add(&buffer, &readers[i], 0), 0,
+			      NULL);
+	}
+
+	zassert_equal(mpsc_pbuf_reader_add(&buffer,
+					   &readers[CONFIG_MPSC_PBUF_READERS],
+					   0),
+		      -ENOMEM, NULL);
+
+	zassert_true(mpsc_pbuf_reader_is_pending(&buffer, &readers[0]), NULL);
+	while ((data = reader_get(&buffer, &readers[0])) >= 0) {
+		zassert_true(prev < 0 || data == prev + 1, NULL);
+		prev = data;
+	}
+
+	zassert_equal(prev, repeat - 1, NULL);
+
+	mpsc_pbuf_reader_remove(&buffer, &readers[0]);
+	zassert_equal(mpsc_pbuf_reader_add(&buffer,
+					   &readers[CONFIG_MPSC_PBUF_READERS],
+					   0),
+		      0, NULL);
+}
+
+K_THREAD_STACK_DEFINE(reader_stack, 1024);
+static struct k_thread reader_thread;
+static int reader_data;
+
+static void reader_entry(void *p0, void *p1, void *p2)
+{
+	struct mpsc_pbuf_buffer *buffer = p0;
+	struct mpsc_pbuf_reader *reader = p1;
+	union test_item *t;
+
+	t = (union test_item *)mpsc_pbuf_reader_claim(buffer, reader,
+						       K_FOREVER);
+	reader_data = t->data.data;
+	mpsc_pbuf_reader_free(buffer, reader, &t->item);
+}
+
+/* A reader pends until a packet is committed. */
+void test_reader_pending_claim(void)
+{
+	struct mpsc_pbuf_buffer buffer;
+	struct mpsc_pbuf_reader reader;
+	int prio = k_thread_priority_get(k_current_get());
+
+	init_readers(&buffer, true);
+	zassert_equal(mpsc_pbuf_reader_add(&buffer, &reader, 0), 0, NULL);
+
+	zassert_equal(mpsc_pbuf_reader_claim(&buffer, &reader, K_MSEC(10)),
+		      NULL, NULL);
+
+	reader_data = -1;
+	k_thread_create(&reader_thread, reader_stack,
+			K_THREAD_STACK_SIZEOF(reader_stack), reader_entry,
+			&buffer, &reader, NULL, prio - 1, 0, K_NO_WAIT);
+	k_sleep(K_MSEC(10));
+	zassert_equal(reader_data, -1, NULL);
+
+	zassert_true(reader_put(&buffer, 2, 123), NULL);
+	zassert_equal(k_thread_join(&reader_thread, K_MSEC(100)), 0, NULL);
+	zassert_equal(reader_data, 123, NULL);
+}
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -1047,7 +1337,12 @@ void test_main(void)
 		ztest_unit_test(test_overwrite_while_claimed),
 		ztest_unit_test(test_overwrite_while_claimed2),
 		ztest_unit_test(test_overwrite_consistency),
-		ztest_unit_test(test_pending_alloc)
+		ztest_unit_test(test_pending_alloc),
+		ztest_unit_test(test_readers_overwrite),
+		ztest_unit_test(test_readers_no_overwrite),
+		ztest_unit_test(test_reader_overwrite_while_claimed),
+		ztest_unit_test(test_reader_add),
+		ztest_unit_test(test_reader_pending_claim)
 		);
 	ztest_run_test_suite(test_log_buffer);
 }
@@ -270,13 +270,18 @@ static void test_p4wq_simple(void)
 	zassert_true(has_run, "high-priority item didn't run");
 }
 
+extern void test_pool_parallel_for(void);
+extern void test_pool_nested(void);
+
 void test_main(void)
 {
 	ztest_test_suite(lib_p4wq_test,
 			 ztest_1cpu_unit_test(test_p4wq_simple),
 			 ztest_unit_test(test_resubmit),
 			 ztest_unit_test(test_fill_queue),
-			 ztest_unit_test(test_stress));
+			 ztest_unit_test(test_stress),
+			 ztest_unit_test(test_pool_parallel_for),
+			 ztest_unit_test(test_pool_nested));
 
 	ztest_run_test_suite(lib_p4wq_test);
 }
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <zephyr.h>
+#include <ztest.h>
+#include <sys/p4wq_pool.h>
+
+#define NUM_WORKERS CONFIG_MP_NUM_CPUS
+#define NUM_INDEXES 1000
+#define WORKER_PRIO 1
+
+K_P4WQ_DEFINE(pool_wq, NUM_WORKERS, 4096);
+K_P4WQ_POOL_DEFINE(pool, NUM_WORKERS);
+
+static atomic_t hits[NUM_INDEXES];
+static atomic_t calls;
+
+static void range_fn(uint32_t start, uint32_t end, void *arg)
+{
+	uint32_t grain = POINTER_TO_UINT(arg);
+
+	zassert_true(end - start <= grain, "range %u-%u exceeds grain",
+		     start, end);
+
+	for (uint32_t i = start; i < end; i++) {
+		atomic_inc(&hits[i]);
+	}
+	atomic_inc(&calls);
+}
+
+/* Every index is handed out exactly once, whatever the grain */
+void test_pool_parallel_for(void)
+{
+	static const uint32_t grains[] = { 1, 7, 64, NUM_INDEXES * 2 };
+
+	k_thread_priority_set(k_current_get(), WORKER_PRIO);
+	k_p4wq_pool_start(&pool, &pool_wq, WORKER_PRIO);
+
+	for (int g = 0; g < ARRAY_SIZE(grains); g++) {
+		memset(hits, 0, sizeof(hits));
+		atomic_clear(&calls);
+
+		zassert_ok(k_p4wq_parallel_for(&pool, 0, NUM_INDEXES,
+					       grains[g], range_fn,
+					       UINT_TO_POINTER(grains[g])),
+			   "parallel_for failed");
+
+		for (int i = 0; i < NUM_INDEXES; i++) {
+			zassert_equal(atomic_get(&hits[i]), 1,
+				      "index %d hit %d times", i,
+				      (int)atomic_get(&hits[i]));
+		}
+		zassert_true(atomic_get(&calls) >=
+			     ceiling_fraction(NUM_INDEXES, grains[g]),
+			     "too few calls");
+	}
+
+	zassert_equal(k_p4wq_parallel_for(&pool, 0, NUM_INDEXES, 0,
+					  range_fn, NULL), -EINVAL,
+		      "zero grain accepted");
+
+	k_p4wq_pool_stop(&pool);
+}
+
+struct fib_task {
+	struct k_p4wq_task task;
+	uint32_t n;
+	uint32_t result;
+};
+
+static void fib_handler(struct k_p4wq_task *task)
+{
+	struct fib_task *f = CONTAINER_OF(task, struct fib_task, task);
+	struct k_p4wq_task_group group;
+	struct fib_task a, b;
+
+	if (f->n < 2) {
+		f->result = f->n;
+		return;
+	}
+
+	a.task.handler = fib_handler;
+	a.n = f->n - 1;
+	b.task.handler = fib_handler;
+	b.n = f->n - 2;
+
+	k_p4wq_task_group_init(&group, &pool);
+	k_p4wq_task_submit(&group, &a.task);
+	k_p4wq_task_submit(&group, &b.task);
+	k_p4wq_task_group_wait(&group);
+
+	f->result = a.result + b.result;
+}
+
+/* Nested fork/join from inside tasks, including joins by workers */
+void test_pool_nested(void)
+{
+	struct k_p4wq_task_group group;
+	struct fib_task f = { .task.handler = fib_handler, .n = 12 };
+
+	k_thread_priority_set(k_current_get(), WORKER_PRIO);
+	k_p4wq_pool_start(&pool, &pool_wq, WORKER_PRIO);
+
+	k_p4wq_task_group_init(&group, &pool);
+	k_p4wq_task_submit(&group, &f.task);
+	k_p4wq_task_group_wait(&group);
+
+	zassert_equal(f.result, 144, "fib(12) = %u", f.result);
+
+	/* Joining a group without tasks returns at once */
+	k_p4wq_task_group_init(&group, &pool);
+	k_p4wq_task_group_wait(&group);
+
+	k_p4wq_pool_stop(&pool);
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <ztest.h>
+#include <irq_offload.h>
+#include <sys/mpsc_ring_buffer.h>
+
+#define STACKSIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+#define PRODUCERS	4
+#define ITEMS		2000
+#define MAX_LEN		4
+/* Items written from interrupts use the type following the threads' ones */
+#define ISR_TYPE	PRODUCERS
+#define ISR_ITEMS	200
+
+static K_THREAD_STACK_ARRAY_DEFINE(producer_stack, PRODUCERS, STACKSIZE);
+static struct k_thread producer_data[PRODUCERS];
+
+MPSC_RING_BUF_DECLARE_POW2(mpsc_bytes, 4);
+MPSC_RING_BUF_ITEM_DECLARE_POW2(mpsc_items, 3);
+MPSC_RING_BUF_ITEM_DECLARE_POW2(mpsc_stress, 6);
+
+static uint32_t isr_seq;
+
+/**
+ * @brief Test byte writes and reads of a multi producer ring buffer
+ *
+ * @details Data is written whole or not at all, is read back in order
+ * across the end of the buffer, and failed writes are counted.
+ *
+ * @ingroup lib_ringbuffer_tests
+ */
+void test_mpsc_ringbuffer_bytes(void)
+{
+	uint8_t in[16], out[16];
+	uint8_t *data;
+	uint32_t len;
+
+	for (int i = 0; i < sizeof(in); i++) {
+		in[i] = i;
+	}
+
+	zassert_equal(mpsc_ring_buf_capacity_get(&mpsc_bytes), 16, NULL);
+	zassert_true(mpsc_ring_buf_is_empty(&mpsc_bytes), NULL);
+
+	zassert_equal(mpsc_ring_buf_put(&mpsc_bytes, in, 12), 12, NULL);
+	zassert_equal(mpsc_ring_buf_space_get(&mpsc_bytes), 4, NULL);
+	zassert_equal(mpsc_ring_buf_put(&mpsc_bytes, in, 5), 0,
+		      "Partial write");
+	zassert_equal(atomic_get(&mpsc_bytes.dropped_put_count), 1, NULL);
+
+	zassert_equal(mpsc_ring_buf_get(&mpsc_bytes, out, 10), 10, NULL);
+	zassert_equal(memcmp(out, in, 10), 0, NULL);
+
+	/* Wraps around the end of the buffer */
+	zassert_equal(mpsc_ring_buf_put(&mpsc_bytes, &in[4], 12), 12, NULL);
+	zassert_equal(mpsc_ring_buf_space_get(&mpsc_bytes), 2, NULL);
+
+	len = mpsc_ring_buf_get_claim(&mpsc_bytes, &data, 16);
+	zassert_equal(len, 6, "Claim must stop at the end of the buffer");
+	zassert_equal(memcmp(data, &in[10], 2), 0, NULL);
+	zassert_equal(memcmp(&data[2], &in[4], 4), 0, NULL);
+	zassert_equal(mpsc_ring_buf_get_finish(&mpsc_bytes, 15), -EINVAL,
+		      NULL);
+	zassert_equal(mpsc_ring_buf_get_finish(&mpsc_bytes, len), 0, NULL);
+
+	zassert_equal(mpsc_ring_buf_get(&mpsc_bytes, out, sizeof(out)), 8,
+		      NULL);
+	zassert_equal(memcmp(out, &in[8], 8), 0, NULL);
+	zassert_true(mpsc_ring_buf_is_empty(&mpsc_bytes), NULL);
+	zassert_equal(mpsc_ring_buf_get(&mpsc_bytes, out, sizeof(out)), 0,
+		      NULL);
+}
+
+/**
+ * @brief Test item writes and reads of a multi producer ring buffer
+ *
+ * @details Items keep their type, value and data across the end of the
+ * buffer, and reads into a too small area report the needed size.
+ *
+ * @ingroup lib_ringbuffer_tests
+ */
+void test_mpsc_ringbuffer_items(void)
+{
+	uint32_t in[4] = { 0x11111111, 0x22222222, 0x33333333, 0x44444444 };
+	uint32_t out[4];
+	uint16_t type;
+	uint8_t value, size32;
+
+	zassert_equal(mpsc_ring_buf_item_get(&mpsc_items, &type, &value, out,
+					     &size32), -EAGAIN, NULL);
+
+	for (int i = 0; i < 3; i++) {
+		zassert_equal(mpsc_ring_buf_item_put(&mpsc_items, 0x1234, i,
+						     in, 2), 0, NULL);
+
+		size32 = 1;
+		zassert_equal(mpsc_ring_buf_item_get(&mpsc_items, &type,
+						     &value, out, &size32),
+			      -EMSGSIZE, NULL);
+		zassert_equal(size32, 2, NULL);
+
+		size32 = ARRAY_SIZE(out);
+		zassert_equal(mpsc_ring_buf_item_get(&mpsc_items, &type,
+						     &value, out, &size32),
+			      0, NULL);
+		zassert_equal(type, 0x1234, NULL);
+		zassert_equal(value, i, NULL);
+		zassert_equal(size32, 2, NULL);
+		zassert_equal(memcmp(out, in, 2 * sizeof(uint32_t)), 0, NULL);
+	}
+
+	/* Two items of five words do not fit in eight */
+	zassert_equal(mpsc_ring_buf_item_put(&mpsc_items, 1, 0, in, 4), 0,
+		      NULL);
+	zassert_equal(mpsc_ring_buf_item_put(&mpsc_items, 2, 0, in, 4),
+		      -EMSGSIZE, NULL);
+	zassert_equal(atomic_get(&mpsc_items.dropped_put_count), 1, NULL);
+
+	size32 = ARRAY_SIZE(out);
+	zassert_equal(mpsc_ring_buf_item_get(&mpsc_items, &type, &value, NULL,
+					     &size32), 0, NULL);
+	zassert_equal(type, 1, NULL);
+	zassert_equal(size32, 4, NULL);
+	zassert_true(mpsc_ring_buf_is_empty(&mpsc_items), NULL);
+}
+
+static void put_item(uint16_t type, uint32_t seq)
+{
+	uint32_t data[MAX_LEN];
+	uint8_t len = seq % MAX_LEN + 1;
+
+	for (int i = 0; i < len; i++) {
+		data[i] = seq ^ ((uint32_t)type << 24) ^ i;
+	}
+
+	while (mpsc_ring_buf_item_put(&mpsc_stress, type, seq & 0xff,
+				      data, len) != 0) {
+		k_yield();
+	}
+}
+
+static void producer(void *p1, void *p2, void *p3)
+{
+	uint16_t type = POINTER_TO_UINT(p1);
+
+	for (uint32_t seq = 0; seq < ITEMS; seq++) {
+		put_item(type, seq);
+	}
+}
+
+static void isr_put(const void *arg)
+{
+	uint32_t data = isr_seq ^ ((uint32_t)ISR_TYPE << 24);
+
+	/* An interrupt cannot wait for room, the item is retried later */
+	if (mpsc_ring_buf_item_put(&mpsc_stress, ISR_TYPE, isr_seq & 0xff,
+				   &data, 1) == 0) {
+		isr_seq++;
+	}
+}
+
+/**
+ * @brief Test concurrent writes to a multi producer ring buffer
+ *
+ * @details Several threads, on all CPUs, and an interrupt write items
+ * without a lock while a single reader takes them. Each writer's items
+ * must be read whole and in the order it wrote them.
+ *
+ * @ingroup lib_ringbuffer_tests
+ */
+void test_mpsc_ringbuffer_stress(void)
+{
+	uint32_t next[PRODUCERS + 1] = { 0 };
+	uint32_t total = 0, expected = PRODUCERS * ITEMS + ISR_ITEMS;
+	uint32_t data[MAX_LEN];
+	uint16_t type;
+	uint8_t value, size32;
+	int old_prio = k_thread_priority_get(k_current_get());
+	int prio = 10;
+
+	k_thread_priority_set(k_current_get(), prio);
+	isr_seq = 0;
+
+	for (int i = 0; i < PRODUCERS; i++) {
+		k_thread_create(&producer_data[i], producer_stack[i],
+				STACKSIZE, producer, UINT_TO_POINTER(i),
+				NULL, NULL, prio, 0, K_NO_WAIT);
+	}
+
+	while (total < expected) {
+		if (isr_seq < ISR_ITEMS && total % 16 == 0) {
+			irq_offload(isr_put, NULL);
+		}
+
+		size32 = ARRAY_SIZE(data);
+		if (mpsc_ring_buf_item_get(&mpsc_stress, &type, &value, data,
+					   &size32) == -EAGAIN) {
+			if (isr_seq < ISR_ITEMS) {
+				irq_offload(isr_put, NULL);
+			}
+			k_yield();
+			continue;
+		}
+
+		zassert_true(type <= ISR_TYPE, "Bad type %u", type);
+		zassert_equal(value, next[type] & 0xff,
+			      "Item of %u out of order", type);
+		zassert_equal(size32, type == ISR_TYPE ? 1 :
+			      next[type] % MAX_LEN + 1, NULL);
+		for (int i = 0; i < size32; i++) {
+			zassert_equal(data[i],
+				      next[type] ^ ((uint32_t)type << 24) ^ i,
+				      "Corrupted item of %u", type);
+		}
+
+		next[type]++;
+		total++;
+	}
+
+	for (int i = 0; i < PRODUCERS; i++) {
+		k_thread_join(&producer_data[i], K_FOREVER);
+		zassert_equal(next[i], ITEMS, NULL);
+	}
+
+	zassert_equal(next[ISR_TYPE], ISR_ITEMS, NULL);
+	zassert_true(mpsc_ring_buf_is_empty(&mpsc_stress), NULL);
+	zassert_equal(mpsc_ring_buf_space_get(&mpsc_stress),
+		      mpsc_ring_buf_capacity_get(&mpsc_stress), NULL);
+
+	k_thread_priority_set(k_current_get(), old_prio);
+}
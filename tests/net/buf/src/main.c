@@ -66,6 +66,7 @@ static void var_destroy(struct net_buf *buf);
 NET_BUF_POOL_HEAP_DEFINE(bufs_pool, 10, buf_destroy);
 NET_BUF_POOL_FIXED_DEFINE(fixed_pool, 10, 128, fixed_destroy);
 NET_BUF_POOL_VAR_DEFINE(var_pool, 10, 1024, var_destroy);
+NET_BUF_POOL_FIXED_DEFINE(usage_pool, 4, 32, NULL);
 
 static void buf_destroy(struct net_buf *buf)
 {
@@ -457,6 +458,40 @@ static void test_net_buf_var_pool(void)
 	zassert_equal(destroy_called, 3, "Incorrect destroy callback count");
 }
 
+static void test_net_buf_pool_usage(void)
+{
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+	struct net_buf *bufs[4];
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(bufs); i++) {
+		bufs[i] = net_buf_alloc(&usage_pool, K_NO_WAIT);
+		zassert_not_null(bufs[i], "Failed to get buffer");
+	}
+
+	zassert_equal(atomic_get(&usage_pool.avail_count), 0,
+		      "Invalid available count");
+	zassert_equal(atomic_get(&usage_pool.max_used), ARRAY_SIZE(bufs),
+		      "Invalid peak usage");
+
+	zassert_is_null(net_buf_alloc(&usage_pool, K_NO_WAIT),
+			"Got buffer from empty pool");
+	zassert_equal(atomic_get(&usage_pool.alloc_failures), 1,
+		      "Failed allocation not counted");
+
+	for (i = 0; i < ARRAY_SIZE(bufs); i++) {
+		net_buf_unref(bufs[i]);
+	}
+
+	zassert_equal(atomic_get(&usage_pool.avail_count), ARRAY_SIZE(bufs),
+		      "Invalid available count");
+	zassert_equal(atomic_get(&usage_pool.max_used), ARRAY_SIZE(bufs),
+		      "Peak usage not kept");
+#else
+	ztest_test_skip();
+#endif
+}
+
 static void test_net_buf_byte_order(void)
 {
 	struct net_buf *buf;
@@ -692,6 +727,7 @@ void test_main(void)
 			 ztest_unit_test(test_net_buf_clone),
 			 ztest_unit_test(test_net_buf_fixed_pool),
 			 ztest_unit_test(test_net_buf_var_pool),
+			 ztest_unit_test(test_net_buf_pool_usage),
 			 ztest_unit_test(test_net_buf_byte_order)
 			 );
 
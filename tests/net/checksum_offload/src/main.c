@@ -79,6 +79,7 @@ static struct net_context *udp_v4_ctx_2;
 static bool test_failed;
 static bool test_started;
 static bool start_receiving;
+static bool mark_chksum_done;
 
 static K_SEM_DEFINE(wait_data, 0, UINT_MAX);
 
@@ -152,6 +153,7 @@ static int eth_tx_offloading_disabled(const struct device *dev,
 
 	if (start_receiving) {
 		struct net_udp_hdr hdr, *udp_hdr;
+		struct net_pkt *rx_pkt;
 		uint16_t port;
 		uint8_t lladdr[6];
 
@@ -183,6 +185,10 @@ static int eth_tx_offloading_disabled(const struct device *dev,
 		udp_hdr->src_port = udp_hdr->dst_port;
 		udp_hdr->dst_port = port;
 
+		if (mark_chksum_done) {
+			udp_hdr->chksum ^= htons(0x8000);
+		}
+
 		memcpy(lladdr,
 		       ((struct net_eth_hdr *)net_pkt_data(pkt))->src.addr,
 		       sizeof(lladdr));
@@ -192,8 +198,12 @@ static int eth_tx_offloading_disabled(const struct device *dev,
 		memcpy(((struct net_eth_hdr *)net_pkt_data(pkt))->dst.addr,
 		       lladdr, sizeof(lladdr));
 
-		if (net_recv_data(net_pkt_iface(pkt),
-				  net_pkt_clone(pkt, K_NO_WAIT)) < 0) {
+		rx_pkt = net_pkt_clone(pkt, K_NO_WAIT);
+		zassert_not_null(rx_pkt, "Cannot clone packet");
+
+		net_pkt_set_chksum_done(rx_pkt, mark_chksum_done);
+
+		if (net_recv_data(net_pkt_iface(pkt), rx_pkt) < 0) {
 			test_failed = true;
 			zassert_true(false, "Packet %p receive failed\n", pkt);
 		}
@@ -820,6 +830,45 @@ static void test_rx_chksum_offload_disabled_test_v4(void)
 	k_sleep(K_MSEC(10));
 }
 
+static void test_rx_chksum_done_test_v4(void)
+{
+	int ret, len;
+	struct sockaddr_in dst_addr4 = {
+		.sin_family = AF_INET,
+		.sin_port = htons(TEST_PORT),
+	};
+
+	memcpy(&dst_addr4.sin_addr, &in4addr_dst, sizeof(struct in_addr));
+
+	len = strlen(test_data);
+
+	/* The device of the interface does not offload the checksums, but
+	 * it tells it verified the ones of this packet, so it is accepted
+	 * with a bad UDP checksum.
+	 */
+	test_started = true;
+	start_receiving = true;
+	mark_chksum_done = true;
+
+	ret = net_context_recv(udp_v4_ctx_1, recv_cb_offload_disabled,
+			       K_NO_WAIT, NULL);
+	zassert_equal(ret, 0, "Recv UDP failed (%d)\n", ret);
+
+	ret = net_context_sendto(udp_v4_ctx_1, test_data, len,
+				 (struct sockaddr *)&dst_addr4,
+				 sizeof(struct sockaddr_in),
+				 NULL, K_FOREVER, NULL);
+	zassert_equal(ret, len, "Send UDP pkt failed (%d)\n", ret);
+
+	if (k_sem_take(&wait_data, WAIT_TIME)) {
+		DBG("Timeout while waiting interface data\n");
+		zassert_false(true, "Timeout");
+	}
+
+	start_receiving = false;
+	mark_chksum_done = false;
+}
+
 static void test_rx_chksum_offload_enabled_test_v6(void)
 {
 	struct eth_context *ctx; /* This is interface context */
@@ -939,6 +988,7 @@ void test_main(void)
 			 ztest_unit_test(test_tx_chksum_offload_enabled_test_v4),
 			 ztest_unit_test(test_rx_chksum_offload_disabled_test_v6),
 			 ztest_unit_test(test_rx_chksum_offload_disabled_test_v4),
+			 ztest_unit_test(test_rx_chksum_done_test_v4),
 			 ztest_unit_test(test_rx_chksum_offload_enabled_test_v6),
 			 ztest_unit_test(test_rx_chksum_offload_enabled_test_v4)
 			 );
@@ -0,0 +1,402 @@
+/* main.c - Application main entry point */
+
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_IPV4_LOG_LEVEL);
+
+#include <zephyr/types.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/printk.h>
+#include <linker/sections.h>
+
+#include <ztest.h>
+
+#include <net/dummy.h>
+#include <net/buf.h>
+#include <net/net_ip.h>
+#include <net/net_if.h>
+
+#define NET_LOG_ENABLED 1
+#include "net_private.h"
+
+#include "ipv4.h"
+#include "udp_internal.h"
+
+static struct in_addr my_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 2 } } };
+
+#define MY_PORT 4242
+#define PEER_PORT 4243
+
+#define TEST_MTU 576
+#define MAX_FRAGS 16
+
+/* Payload carried by each fragment but the last one */
+#define FRAG_PAYLOAD ((TEST_MTU - NET_IPV4H_LEN) & ~7)
+
+#define WAIT_TIME K_SECONDS(1)
+#define ALLOC_TIMEOUT K_MSEC(500)
+
+static struct net_if *iface;
+
+static struct net_pkt *frags[MAX_FRAGS];
+static int frag_count;
+static struct k_sem wait_frag;
+
+static uint16_t recv_len;
+static bool recv_data_ok;
+static int recv_count;
+
+static int net_iface_dev_init(const struct device *dev)
+{
+	return 0;
+}
+
+static void net_iface_init(struct net_if *iface)
+{
+	static uint8_t mac[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_ETHERNET);
+}
+
+/* The sent fragments are kept to be checked, and received back */
+static int sender_iface(const struct device *dev, struct net_pkt *pkt)
+{
+	if (frag_count < MAX_FRAGS) {
+		frags[frag_count++] = pkt;
+	} else {
+		net_pkt_unref(pkt);
+	}
+
+	k_sem_give(&wait_frag);
+
+	return 0;
+}
+
+static struct dummy_api net_iface_api = {
+	.iface_api.init = net_iface_init,
+	.send = sender_iface,
+};
+
+NET_DEVICE_INIT(net_ipv4_frag_test, "net_ipv4_frag_test",
+		net_iface_dev_init, NULL, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&net_iface_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), TEST_MTU);
+
+static uint8_t pattern(size_t pos)
+{
+	return pos * 7 + (pos >> 8);
+}
+
+static enum net_verdict udp_data_received(struct net_conn *conn,
+					  struct net_pkt *pkt,
+					  union net_ip_header *ip_hdr,
+					  union net_proto_header *proto_hdr,
+					  void *user_data)
+{
+	uint8_t byte;
+	size_t i;
+
+	recv_count++;
+	recv_len = ntohs(proto_hdr->udp->len) - NET_UDPH_LEN;
+	recv_data_ok = net_pkt_remaining_data(pkt) == recv_len;
+
+	for (i = 0; recv_data_ok && i < recv_len; i++) {
+		if (net_pkt_read_u8(pkt, &byte) || byte != pattern(i)) {
+			recv_data_ok = false;
+		}
+	}
+
+	net_pkt_unref(pkt);
+
+	return NET_OK;
+}
+
+static void release_frags(void)
+{
+	while (frag_count) {
+		if (frags[--frag_count]) {
+			net_pkt_unref(frags[frag_count]);
+		}
+	}
+}
+
+static void count_reass_cb(struct net_ipv4_reassembly *reass,
+			   void *user_data)
+{
+	(*(int *)user_data)++;
+}
+
+static int pending_reassemblies(void)
+{
+	int count = 0;
+
+	net_ipv4_frag_foreach(count_reass_cb, &count);
+
+	return count;
+}
+
+/* Send an UDP datagram to the peer, and wait for its fragments */
+static int send_datagram(uint16_t len, int expected)
+{
+	struct net_pkt *pkt;
+	uint16_t i;
+	int ret;
+
+	release_frags();
+
+	pkt = net_pkt_alloc_with_buffer(iface, NET_UDPH_LEN + len, AF_INET,
+					IPPROTO_UDP, ALLOC_TIMEOUT);
+	zassert_not_null(pkt, "packet");
+
+	ret = net_ipv4_create(pkt, &my_addr, &peer_addr);
+	zassert_equal(ret, 0, "Cannot create IPv4 header");
+
+	ret = net_udp_create(pkt, htons(MY_PORT), htons(PEER_PORT));
+	zassert_equal(ret, 0, "Cannot create UDP header");
+
+	for (i = 0; i < len; i++) {
+		ret = net_pkt_write_u8(pkt, pattern(i));
+		zassert_equal(ret, 0, "Cannot write data");
+	}
+
+	net_pkt_cursor_init(pkt);
+	ret = net_ipv4_finalize(pkt, IPPROTO_UDP);
+	zassert_equal(ret, 0, "Cannot finalize packet");
+
+	ret = net_send_data(pkt);
+	zassert_equal(ret, 0, "Cannot send packet (%d)", ret);
+
+	while (frag_count < expected) {
+		if (k_sem_take(&wait_frag, WAIT_TIME)) {
+			break;
+		}
+	}
+
+	return frag_count;
+}
+
+/* Make the sent fragment look received from the peer */
+static void loop_back(struct net_pkt *pkt)
+{
+	struct net_ipv4_hdr *hdr = NET_IPV4_HDR(pkt);
+	struct in_addr addr;
+
+	/* The header checksum does not change */
+	net_ipaddr_copy(&addr, &hdr->src);
+	net_ipaddr_copy(&hdr->src, &hdr->dst);
+	net_ipaddr_copy(&hdr->dst, &addr);
+
+	net_pkt_set_overwrite(pkt, true);
+	net_pkt_cursor_init(pkt);
+}
+
+static enum net_verdict recv_frag(int idx)
+{
+	struct net_pkt *pkt = frags[idx];
+	enum net_verdict verdict;
+
+	frags[idx] = NULL;
+	loop_back(pkt);
+
+	verdict = net_ipv4_input(pkt);
+	if (verdict == NET_DROP) {
+		net_pkt_unref(pkt);
+	}
+
+	return verdict;
+}
+
+static void set_frag_offset(struct net_pkt *pkt, uint16_t offset, bool more)
+{
+	struct net_ipv4_hdr *hdr = NET_IPV4_HDR(pkt);
+	uint16_t flags = offset / 8U | (more ? NET_IPV4_MF << 13 : 0);
+
+	hdr->offset[0] = flags >> 8;
+	hdr->offset[1] = flags;
+	hdr->chksum = 0U;
+	hdr->chksum = net_calc_chksum_ipv4(pkt);
+}
+
+static void test_setup(void)
+{
+	struct net_if_addr *ifaddr;
+	static struct net_conn_handle *handle;
+	struct sockaddr remote_addr = { 0 };
+	struct sockaddr local_addr = { 0 };
+	int ret;
+
+	k_sem_init(&wait_frag, 0, UINT_MAX);
+
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	zassert_not_null(iface, "Interface");
+
+	ifaddr = net_if_ipv4_addr_add(iface, &my_addr, NET_ADDR_MANUAL, 0);
+	zassert_not_null(ifaddr, "Cannot add IPv4 address");
+
+	net_if_up(iface);
+
+	net_ipaddr_copy(&net_sin(&local_addr)->sin_addr, &my_addr);
+	local_addr.sa_family = AF_INET;
+
+	net_ipaddr_copy(&net_sin(&remote_addr)->sin_addr, &peer_addr);
+	remote_addr.sa_family = AF_INET;
+
+	/* The fragments we send are looped back, ports unchanged */
+	ret = net_udp_register(AF_INET, &remote_addr, &local_addr,
+			       MY_PORT, PEER_PORT, NULL, udp_data_received,
+			       NULL, &handle);
+	zassert_equal(ret, 0, "Cannot register UDP handler");
+}
+
+static void test_send_ipv4_fragment(void)
+{
+	uint16_t len = 3 * FRAG_PAYLOAD + 100 - NET_UDPH_LEN;
+	uint16_t id = 0U;
+	int i;
+
+	zassert_equal(send_datagram(len, 4), 4, "Wrong fragment count");
+
+	for (i = 0; i < 4; i++) {
+		struct net_ipv4_hdr *hdr = NET_IPV4_HDR(frags[i]);
+		uint16_t flags = (hdr->offset[0] << 8) | hdr->offset[1];
+		bool last = i == 3;
+
+		zassert_equal(net_calc_chksum_ipv4(frags[i]), 0,
+			      "Wrong header checksum");
+		zassert_equal(ntohs(hdr->len), NET_IPV4H_LEN +
+			      (last ? 100 : FRAG_PAYLOAD),
+			      "Wrong length of fragment %d", i);
+		zassert_equal(net_pkt_get_len(frags[i]), ntohs(hdr->len),
+			      "Wrong packet length of fragment %d", i);
+		zassert_equal((flags & 0x1fff) * 8U, i * FRAG_PAYLOAD,
+			      "Wrong offset of fragment %d", i);
+		zassert_equal(!!(flags & (NET_IPV4_MF << 13)), !last,
+			      "Wrong MF flag of fragment %d", i);
+
+		if (i == 0) {
+			id = (hdr->id[0] << 8) | hdr->id[1];
+		}
+
+		zassert_equal((hdr->id[0] << 8) | hdr->id[1], id,
+			      "Wrong id of fragment %d", i);
+	}
+}
+
+static void test_recv_ipv4_fragment(void)
+{
+	uint16_t len = 3 * FRAG_PAYLOAD + 100 - NET_UDPH_LEN;
+	int i;
+
+	zassert_equal(send_datagram(len, 4), 4, "Wrong fragment count");
+
+	recv_count = 0;
+
+	/* In the reverse order, with a duplicate in between */
+	zassert_equal(recv_frag(3), NET_OK, "Last fragment not kept");
+
+	frags[3] = net_pkt_clone(frags[2], ALLOC_TIMEOUT);
+	zassert_not_null(frags[3], "Cannot clone fragment");
+	zassert_equal(recv_frag(2), NET_OK, "Fragment not kept");
+	zassert_equal(recv_frag(3), NET_DROP, "Duplicate not dropped");
+
+	for (i = 1; i >= 0; i--) {
+		zassert_equal(recv_frag(i), NET_OK, "Fragment %d not kept", i);
+	}
+
+	zassert_equal(recv_count, 1, "Datagram not received");
+	zassert_equal(recv_len, len, "Wrong datagram length");
+	zassert_true(recv_data_ok, "Wrong datagram data");
+	zassert_equal(pending_reassemblies(), 0, "Reassembly pending");
+}
+
+static void test_recv_ipv4_fragment_overlap(void)
+{
+	uint16_t len = 3 * FRAG_PAYLOAD + 100 - NET_UDPH_LEN;
+
+	zassert_equal(send_datagram(len, 4), 4, "Wrong fragment count");
+
+	recv_count = 0;
+
+	zassert_equal(recv_frag(0), NET_OK, "Fragment not kept");
+	zassert_equal(pending_reassemblies(), 1, "No reassembly pending");
+
+	set_frag_offset(frags[1], FRAG_PAYLOAD - 8, true);
+	zassert_equal(recv_frag(1), NET_DROP, "Overlap not dropped");
+	zassert_equal(pending_reassemblies(), 0, "Reassembly not cancelled");
+
+	zassert_equal(recv_frag(2), NET_OK, "Fragment not kept");
+	zassert_equal(recv_frag(3), NET_OK, "Fragment not kept");
+	zassert_equal(recv_count, 0, "Datagram received");
+
+	release_frags();
+}
+
+static void test_recv_ipv4_fragment_timeout(void)
+{
+	uint16_t len = 3 * FRAG_PAYLOAD + 100 - NET_UDPH_LEN;
+
+	/* The fragments of the previous test are still waiting */
+	zassert_equal(pending_reassemblies(), 1, "No reassembly pending");
+
+	k_sleep(K_SECONDS(CONFIG_NET_IPV4_FRAGMENT_TIMEOUT + 1));
+
+	zassert_equal(pending_reassemblies(), 0, "Reassembly not expired");
+
+	/* The slots are available again */
+	zassert_equal(send_datagram(len, 4), 4, "Wrong fragment count");
+
+	recv_count = 0;
+
+	for (int i = 0; i < 4; i++) {
+		zassert_equal(recv_frag(i), NET_OK, "Fragment %d not kept", i);
+	}
+
+	zassert_equal(recv_count, 1, "Datagram not received");
+	zassert_true(recv_data_ok, "Wrong datagram data");
+}
+
+static void test_recv_ipv4_fragment_too_many(void)
+{
+	int count = CONFIG_NET_IPV4_FRAGMENT_MAX_PKT + 1;
+	uint16_t len = (count - 1) * FRAG_PAYLOAD + 100 - NET_UDPH_LEN;
+
+	/* One more fragment than can be reassembled */
+	zassert_equal(send_datagram(len, count), count,
+		      "Wrong fragment count");
+
+	recv_count = 0;
+
+	for (int i = 0; i < count - 1; i++) {
+		zassert_equal(recv_frag(i), NET_OK, "Fragment %d not kept", i);
+	}
+
+	zassert_equal(pending_reassemblies(), 1, "No reassembly pending");
+	zassert_equal(recv_frag(count - 1), NET_DROP,
+		      "Fragment over the limit not dropped");
+	zassert_equal(pending_reassemblies(), 0, "Reassembly not cancelled");
+	zassert_equal(recv_count, 0, "Datagram received");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_ipv4_fragment_test,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_send_ipv4_fragment),
+			 ztest_unit_test(test_recv_ipv4_fragment),
+			 ztest_unit_test(test_recv_ipv4_fragment_overlap),
+			 ztest_unit_test(test_recv_ipv4_fragment_timeout),
+			 ztest_unit_test(test_recv_ipv4_fragment_too_many)
+			 );
+
+	ztest_run_test_suite(net_ipv4_fragment_test);
+}
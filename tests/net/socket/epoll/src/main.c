@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2021 Nuvoton Technology Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <stdio.h>
+#include <ztest_assert.h>
+
+#include <net/socket.h>
+#include <sys/fdtable.h>
+
+#include "../../socket_helpers.h"
+
+#define BUF_AND_SIZE(buf) buf, sizeof(buf) - 1
+#define STRLEN(buf) (sizeof(buf) - 1)
+
+#define TEST_STR_SMALL "test"
+
+#define SERVER_PORT 4242
+#define CLIENT_PORT 9898
+
+/* On QEMU, waits take +10ms from the requested time. */
+#define FUZZ 10
+
+static int c_sock;
+static int s_sock;
+static int epfd;
+
+static void setup_udp(void)
+{
+	struct sockaddr_in6 c_addr;
+	struct sockaddr_in6 s_addr;
+	int res;
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, CLIENT_PORT,
+			    &c_sock, &c_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &s_sock, &s_addr);
+
+	res = bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed");
+
+	res = connect(c_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed");
+
+	epfd = epoll_create1(0);
+	zassert_true(epfd >= 0, "epoll_create1 failed");
+}
+
+static void teardown_udp(void)
+{
+	zassert_equal(close(epfd), 0, "close failed");
+	zassert_equal(close(c_sock), 0, "close failed");
+	zassert_equal(close(s_sock), 0, "close failed");
+}
+
+static void add(int fd, uint32_t events)
+{
+	struct epoll_event ev = { .events = events, .data.fd = fd };
+
+	zassert_equal(epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev), 0,
+		      "epoll_ctl failed");
+}
+
+static void send_small(void)
+{
+	ssize_t len;
+
+	len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+}
+
+static void recv_small(void)
+{
+	char buf[10];
+	ssize_t len;
+
+	len = recv(s_sock, buf, sizeof(buf), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+}
+
+void test_epoll_level_triggered(void)
+{
+	struct epoll_event ev[2];
+	uint32_t tstamp;
+	int res;
+
+	setup_udp();
+	add(c_sock, EPOLLIN);
+	add(s_sock, EPOLLIN);
+
+	/* Nothing ready, with a timeout of 0 and of 30 */
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(epfd, ev, ARRAY_SIZE(ev), 0);
+	zassert_true(k_uptime_get_32() - tstamp <= FUZZ, "");
+	zassert_equal(res, 0, "");
+
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(epfd, ev, ARRAY_SIZE(ev), 30);
+	tstamp = k_uptime_get_32() - tstamp;
+	zassert_true(tstamp >= 30U && tstamp <= 30 + FUZZ * 2, "tstamp %d",
+		     tstamp);
+	zassert_equal(res, 0, "");
+
+	/* Only the socket which received something is reported */
+	send_small();
+
+	res = epoll_wait(epfd, ev, ARRAY_SIZE(ev), 100);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev[0].data.fd, s_sock, "");
+	zassert_equal(ev[0].events, EPOLLIN, "");
+
+	/* Still readable, so reported again */
+	res = epoll_wait(epfd, ev, ARRAY_SIZE(ev), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev[0].data.fd, s_sock, "");
+
+	recv_small();
+
+	res = epoll_wait(epfd, ev, ARRAY_SIZE(ev), 0);
+	zassert_equal(res, 0, "");
+
+	teardown_udp();
+}
+
+void test_epoll_edge_triggered(void)
+{
+	struct epoll_event ev[2];
+	int res;
+
+	setup_udp();
+	add(s_sock, EPOLLIN | EPOLLET);
+
+	send_small();
+
+	res = epoll_wait(epfd, ev, ARRAY_SIZE(ev), 100);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev[0].data.fd, s_sock, "");
+
+	/* Data left unread is not reported again... */
+	res = epoll_wait(epfd, ev, ARRAY_SIZE(ev), 0);
+	zassert_equal(res, 0, "");
+
+	/* ...until more arrives */
+	send_small();
+
+	res = epoll_wait(epfd, ev, ARRAY_SIZE(ev), 100);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev[0].data.fd, s_sock, "");
+
+	recv_small();
+	recv_small();
+
+	teardown_udp();
+}
+
+void test_epoll_oneshot(void)
+{
+	struct epoll_event mod = { .events = EPOLLIN | EPOLLONESHOT };
+	struct epoll_event ev[2];
+	int res;
+
+	setup_udp();
+	add(s_sock, EPOLLIN | EPOLLONESHOT);
+
+	send_small();
+
+	res = epoll_wait(epfd, ev, ARRAY_SIZE(ev), 100);
+	zassert_equal(res, 1, "");
+
+	send_small();
+	res = epoll_wait(epfd, ev, ARRAY_SIZE(ev), 30);
+	zassert_equal(res, 0, "disabled socket reported");
+
+	/* Re-arming reports the pending data */
+	mod.data.fd = s_sock;
+	res = epoll_ctl(epfd, EPOLL_CTL_MOD, s_sock, &mod);
+	zassert_equal(res, 0, "");
+
+	res = epoll_wait(epfd, ev, ARRAY_SIZE(ev), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev[0].data.fd, s_sock, "");
+
+	recv_small();
+	recv_small();
+
+	teardown_udp();
+}
+
+void test_epoll_ctl(void)
+{
+	struct epoll_event ev = { .events = EPOLLOUT };
+	int res;
+
+	setup_udp();
+
+	/* Writable sockets are reported right away */
+	add(c_sock, EPOLLOUT);
+	res = epoll_wait(epfd, &ev, 1, 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev.events, EPOLLOUT, "");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_ADD, c_sock, &ev);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, EEXIST, "");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_DEL, c_sock, NULL);
+	zassert_equal(res, 0, "");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_DEL, c_sock, NULL);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, ENOENT, "");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_MOD, c_sock, &ev);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, ENOENT, "");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_ADD, epfd, &ev);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, EINVAL, "");
+
+	/* A closed socket leaves the set by itself */
+	add(s_sock, EPOLLIN);
+	send_small();
+	zassert_equal(close(s_sock), 0, "close failed");
+
+	res = epoll_wait(epfd, &ev, 1, 30);
+	zassert_equal(res, 0, "");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_DEL, s_sock, NULL);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, ENOENT, "");
+
+	zassert_equal(close(epfd), 0, "close failed");
+	zassert_equal(close(c_sock), 0, "close failed");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(socket_epoll,
+			 ztest_unit_test(test_epoll_level_triggered),
+			 ztest_unit_test(test_epoll_edge_triggered),
+			 ztest_unit_test(test_epoll_oneshot),
+			 ztest_unit_test(test_epoll_ctl));
+
+	ztest_run_test_suite(socket_epoll);
+}
@@ -10,6 +10,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include <ztest_assert.h>
 #include <fcntl.h>
 #include <net/socket.h>
+#include <net/buf.h>
 
 #include "../../socket_helpers.h"
 
@@ -937,6 +938,148 @@ void test_socket_permission(void)
 #endif /* CONFIG_USERSPACE */
 }
 
+#define TEST_STR_ZC "zero-copy send and receive"
+
+NET_BUF_POOL_DEFINE(zc_pool, 4, 16, 0, NULL);
+
+static struct net_buf *zc_buf_get(const char *str)
+{
+	struct net_buf *frags = NULL;
+	size_t len = strlen(str);
+
+	while (len > 0) {
+		struct net_buf *frag = net_buf_alloc(&zc_pool, K_NO_WAIT);
+		size_t chunk;
+
+		zassert_not_null(frag, "out of buffers");
+		chunk = MIN(len, net_buf_tailroom(frag));
+		net_buf_add_mem(frag, str, chunk);
+		frags = frags ? net_buf_frag_add(frags, frag) : frag;
+		str += chunk;
+		len -= chunk;
+	}
+
+	return frags;
+}
+
+/* Receive len bytes with zsock_recv_buf(), which hands over the data of
+ * one segment per call.
+ */
+static void test_recv_buf(int sock, char *buf, size_t len)
+{
+	struct net_buf *frags;
+	size_t recved = 0;
+	ssize_t rv;
+
+	while (recved < len) {
+		rv = zsock_recv_buf(sock, &frags, 0, NULL, NULL);
+		zassert_true(rv > 0, "recv_buf failed (%d)", errno);
+		zassert_true(recved + rv <= len, "received too much");
+		zassert_equal(net_buf_frags_len(frags), rv, "length mismatch");
+
+		net_buf_linearize(&buf[recved], len - recved, frags, 0, rv);
+		net_buf_unref(frags);
+		recved += rv;
+	}
+}
+
+void test_v4_send_buf_recv_buf(void)
+{
+	/* Test if data sent with zsock_send_buf() from several buffers
+	 * comes out with zsock_recv_buf(), also after a partial recv().
+	 */
+	int c_sock;
+	int s_sock;
+	int new_sock;
+	struct sockaddr_in c_saddr;
+	struct sockaddr_in s_saddr;
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	char rx_buf[sizeof(TEST_STR_ZC)] = {0};
+	struct net_buf *frags;
+	ssize_t rv;
+
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &c_sock, &c_saddr);
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &s_sock, &s_saddr);
+
+	test_bind(s_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_listen(s_sock);
+
+	test_connect(c_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_accept(s_sock, &new_sock, &addr, &addrlen);
+
+	frags = zc_buf_get(TEST_STR_ZC);
+	zassert_not_null(frags->frags, "payload not split");
+
+	rv = zsock_send_buf(c_sock, frags, 0, NULL, 0);
+	zassert_equal(rv, strlen(TEST_STR_ZC), "send_buf failed (%d)", errno);
+
+	test_recv_buf(new_sock, rx_buf, strlen(TEST_STR_ZC));
+	zassert_equal(strcmp(rx_buf, TEST_STR_ZC), 0, "unexpected data");
+
+	/* The rest of a partly read segment is handed over */
+	memset(rx_buf, 0, sizeof(rx_buf));
+	test_send(c_sock, TEST_STR_ZC, strlen(TEST_STR_ZC), 0);
+
+	rv = recv(new_sock, rx_buf, 5, 0);
+	zassert_equal(rv, 5, "unexpected received bytes");
+
+	test_recv_buf(new_sock, &rx_buf[5], strlen(TEST_STR_ZC) - 5);
+	zassert_equal(strcmp(rx_buf, TEST_STR_ZC), 0, "unexpected data");
+
+	rv = zsock_recv_buf(new_sock, &frags, ZSOCK_MSG_DONTWAIT, NULL, NULL);
+	zassert_equal(rv, -1, "unexpected data");
+	zassert_equal(errno, EAGAIN, "unexpected errno");
+	zassert_is_null(frags, "buffers returned without data");
+
+	test_close(c_sock);
+
+	rv = zsock_recv_buf(new_sock, &frags, 0, NULL, NULL);
+	zassert_equal(rv, 0, "EOF not reported");
+	zassert_is_null(frags, "buffers returned at EOF");
+
+	test_close(new_sock);
+	test_close(s_sock);
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
+void test_v4_send_buf_recv_buf_enotconn(void)
+{
+	/* Test that the zero-copy calls fail on an unconnected stream
+	 * socket, leaving the buffers to the caller.
+	 */
+	int c_sock;
+	struct sockaddr_in c_saddr;
+	struct net_buf *frags;
+	ssize_t rv;
+
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &c_sock, &c_saddr);
+
+	rv = zsock_recv_buf(c_sock, &frags, 0, NULL, NULL);
+	zassert_equal(rv, -1, "recv_buf succeeded");
+	zassert_equal(errno, ENOTCONN, "unexpected errno");
+	zassert_is_null(frags, "buffers returned on error");
+
+	rv = zsock_recv_buf(c_sock, &frags, ZSOCK_MSG_PEEK, NULL, NULL);
+	zassert_equal(rv, -1, "unsupported flag accepted");
+	zassert_equal(errno, EINVAL, "unexpected errno");
+
+	frags = zc_buf_get(TEST_STR_SMALL);
+
+	rv = zsock_send_buf(c_sock, frags, 0, NULL, 0);
+	zassert_equal(rv, -1, "send_buf succeeded");
+	zassert_equal(errno, EDESTADDRREQ, "unexpected errno");
+	zassert_equal(frags->ref, 1, "reference taken on error");
+
+	net_buf_unref(frags);
+
+	test_close(c_sock);
+}
+
 void test_main(void)
 {
 #ifdef CONFIG_USERSPACE
@@ -969,6 +1112,8 @@ void test_main(void)
 		ztest_unit_test(test_v6_so_rcvtimeo),
 		ztest_unit_test(test_v4_msg_waitall),
 		ztest_unit_test(test_v6_msg_waitall),
+		ztest_unit_test(test_v4_send_buf_recv_buf),
+		ztest_unit_test(test_v4_send_buf_recv_buf_enotconn),
 		ztest_user_unit_test(test_socket_permission)
 		);
 
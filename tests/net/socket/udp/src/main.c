@@ -14,6 +14,8 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
 
 #include <net/socket.h>
 #include <net/ethernet.h>
+#include <net/net_context.h>
+#include <net/buf.h>
 
 #include "ipv6.h"
 #include "../../socket_helpers.h"
@@ -1212,6 +1214,515 @@ void test_v6_msg_trunc(void)
 		       (struct sockaddr *)&server_addr, sizeof(server_addr));
 }
 
+NET_BUF_POOL_DEFINE(zc_pool, 10, 256, 0, NULL);
+
+static struct net_buf *zc_buf_get(const void *data, size_t len)
+{
+	struct net_buf *frags = NULL;
+
+	while (len > 0) {
+		struct net_buf *frag = net_buf_alloc(&zc_pool, K_NO_WAIT);
+		size_t chunk;
+
+		zassert_not_null(frag, "out of buffers");
+		chunk = MIN(len, net_buf_tailroom(frag));
+		net_buf_add_mem(frag, data, chunk);
+		frags = frags ? net_buf_frag_add(frags, frag) : frag;
+		data = (const uint8_t *)data + chunk;
+		len -= chunk;
+	}
+
+	return frags;
+}
+
+/* A datagram spread over two buffers, sent with zsock_send_buf(), comes
+ * out whole with zsock_recv_buf() along with its source address.
+ */
+void test_v4_send_buf_recv_buf(void)
+{
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct sockaddr_in addr;
+	socklen_t addrlen = sizeof(addr);
+	struct net_buf *frags;
+	ssize_t rv;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, CLIENT_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	rv = bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "server bind failed");
+	rv = bind(client_sock, (struct sockaddr *)&client_addr,
+		  sizeof(client_addr));
+	zassert_equal(rv, 0, "client bind failed");
+
+	frags = zc_buf_get(TEST_STR2, STRLEN(TEST_STR2));
+	zassert_not_null(frags->frags, "payload not split");
+
+	rv = zsock_send_buf(client_sock, frags, 0,
+			    (struct sockaddr *)&server_addr,
+			    sizeof(server_addr));
+	zassert_equal(rv, STRLEN(TEST_STR2), "send_buf failed (%d)", errno);
+
+	rv = zsock_recv_buf(server_sock, &frags, 0, (struct sockaddr *)&addr,
+			    &addrlen);
+	zassert_equal(rv, STRLEN(TEST_STR2), "recv_buf failed (%d)", errno);
+	zassert_not_null(frags, "no buffers returned");
+	zassert_equal(net_buf_frags_len(frags), rv, "length mismatch");
+	zassert_equal(net_buf_linearize(rx_buf, sizeof(rx_buf), frags, 0, rv),
+		      rv, NULL);
+	zassert_mem_equal(rx_buf, TEST_STR2, rv, "invalid rx data");
+	net_buf_unref(frags);
+
+	zassert_equal(addrlen, sizeof(addr), "unexpected addrlen");
+	zassert_equal(addr.sin_port, client_addr.sin_port,
+		      "unexpected source port");
+	zassert_equal(addr.sin_addr.s_addr, client_addr.sin_addr.s_addr,
+		      "unexpected source address");
+
+	/* Nothing else may be queued */
+	rv = zsock_recv_buf(server_sock, &frags, ZSOCK_MSG_DONTWAIT, NULL,
+			    NULL);
+	zassert_equal(rv, -1, "unexpected data");
+	zassert_equal(errno, EAGAIN, "unexpected errno");
+	zassert_is_null(frags, "buffers returned without data");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+/* When zsock_send_buf() fails, for bad arguments, a missing destination
+ * or a datagram too large for one packet, the caller keeps its
+ * reference and no data is sent.
+ */
+void test_v4_send_buf_errors(void)
+{
+	static char big[NET_ETH_MTU + 1];
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct net_buf *frags;
+	ssize_t rv;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	rv = bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "server bind failed");
+
+	rv = zsock_send_buf(client_sock, NULL, 0,
+			    (struct sockaddr *)&server_addr,
+			    sizeof(server_addr));
+	zassert_equal(rv, -1, "NULL buffer accepted");
+	zassert_equal(errno, EINVAL, "unexpected errno");
+
+	frags = zc_buf_get(BUF_AND_SIZE(TEST_STR_SMALL));
+
+	rv = zsock_send_buf(client_sock, frags, ZSOCK_MSG_PEEK,
+			    (struct sockaddr *)&server_addr,
+			    sizeof(server_addr));
+	zassert_equal(rv, -1, "unsupported flag accepted");
+	zassert_equal(errno, EINVAL, "unexpected errno");
+	zassert_equal(frags->ref, 1, "reference taken on error");
+
+	rv = zsock_send_buf(client_sock, frags, 0, NULL, 0);
+	zassert_equal(rv, -1, "sent without destination");
+	zassert_equal(errno, EDESTADDRREQ, "unexpected errno");
+	zassert_equal(frags->ref, 1, "reference taken on error");
+
+	net_buf_unref(frags);
+
+	memset(big, 'a', sizeof(big));
+	frags = zc_buf_get(big, sizeof(big));
+
+	rv = zsock_send_buf(client_sock, frags, 0,
+			    (struct sockaddr *)&server_addr,
+			    sizeof(server_addr));
+	zassert_equal(rv, -1, "oversized datagram sent");
+	zassert_equal(errno, EMSGSIZE, "unexpected errno");
+	zassert_equal(frags->ref, 1, "reference taken on error");
+	zassert_equal(net_buf_frags_len(frags), sizeof(big),
+		      "buffers modified on error");
+
+	net_buf_unref(frags);
+
+	rv = recv(server_sock, rx_buf, sizeof(rx_buf), ZSOCK_MSG_DONTWAIT);
+	zassert_equal(rv, -1, "data sent on error");
+	zassert_equal(errno, EAGAIN, "unexpected errno");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+/* net_context_send_buf() refuses a missing buffer chain, an unconnected
+ * context without destination and an oversized datagram with the caller
+ * keeping its reference, and sends a datagram to a connected peer.
+ */
+void test_v4_net_context_send_buf(void)
+{
+	static char big[NET_ETH_MTU + 1];
+	int server_sock;
+	struct sockaddr_in server_addr;
+	struct net_context *ctx;
+	struct net_buf *frags;
+	int ret;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+	ret = bind(server_sock, (struct sockaddr *)&server_addr,
+		   sizeof(server_addr));
+	zassert_equal(ret, 0, "server bind failed");
+
+	ret = net_context_get(AF_INET, SOCK_DGRAM, IPPROTO_UDP, &ctx);
+	zassert_equal(ret, 0, "context get failed (%d)", ret);
+
+	ret = net_context_send_buf(ctx, NULL, (struct sockaddr *)&server_addr,
+				   sizeof(server_addr), NULL, K_NO_WAIT, NULL);
+	zassert_equal(ret, -EINVAL, "NULL buffer accepted");
+
+	frags = zc_buf_get(BUF_AND_SIZE(TEST_STR_SMALL));
+
+	ret = net_context_send_buf(ctx, frags, NULL, 0, NULL, K_NO_WAIT,
+				   NULL);
+	zassert_equal(ret, -EDESTADDRREQ, "sent without destination");
+	zassert_equal(frags->ref, 1, "reference taken on error");
+
+	ret = net_context_connect(ctx, (struct sockaddr *)&server_addr,
+				  sizeof(server_addr), NULL, K_NO_WAIT, NULL);
+	zassert_equal(ret, 0, "connect failed (%d)", ret);
+
+	ret = net_context_send_buf(ctx, frags, NULL, 0, NULL, K_NO_WAIT,
+				   NULL);
+	zassert_equal(ret, STRLEN(TEST_STR_SMALL), "send failed (%d)", ret);
+
+	ret = recv(server_sock, rx_buf, sizeof(rx_buf), 0);
+	zassert_equal(ret, STRLEN(TEST_STR_SMALL), "recv failed");
+	zassert_mem_equal(rx_buf, BUF_AND_SIZE(TEST_STR_SMALL),
+			  "invalid rx data");
+
+	memset(big, 'a', sizeof(big));
+	frags = zc_buf_get(big, sizeof(big));
+
+	ret = net_context_send_buf(ctx, frags, NULL, 0, NULL, K_NO_WAIT,
+				   NULL);
+	zassert_equal(ret, -EMSGSIZE, "oversized datagram sent");
+	zassert_equal(frags->ref, 1, "reference taken on error");
+	net_buf_unref(frags);
+
+	net_context_put(ctx);
+
+	ret = close(server_sock);
+	zassert_equal(ret, 0, "close failed");
+}
+
+#define MMSG_COUNT 3
+
+static void mmsg_prepare(struct mmsghdr *msgvec, struct iovec *iov,
+			 unsigned int vlen, struct sockaddr *addr,
+			 socklen_t addrlen)
+{
+	memset(msgvec, 0, vlen * sizeof(*msgvec));
+
+	for (unsigned int i = 0; i < vlen; i++) {
+		msgvec[i].msg_hdr.msg_name = addr;
+		msgvec[i].msg_hdr.msg_namelen = addrlen;
+		msgvec[i].msg_hdr.msg_iov = &iov[i];
+		msgvec[i].msg_hdr.msg_iovlen = 1;
+		msgvec[i].msg_len = UINT_MAX;
+	}
+}
+
+/* A batch of datagrams of different lengths goes out and comes in
+ * whole, with msg_len set for each message. recvmmsg() returns once
+ * the queued datagrams are read.
+ */
+void test_v4_sendmmsg_recvmmsg(void)
+{
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct sockaddr_in addr[MMSG_COUNT + 1];
+	struct mmsghdr msgvec[MMSG_COUNT + 1];
+	struct iovec iov[MMSG_COUNT + 1];
+	static const size_t len[MMSG_COUNT] = { 10, 1, 100 };
+	int rv;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, CLIENT_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	rv = bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "server bind failed");
+	rv = bind(client_sock, (struct sockaddr *)&client_addr,
+		  sizeof(client_addr));
+	zassert_equal(rv, 0, "client bind failed");
+
+	mmsg_prepare(msgvec, iov, MMSG_COUNT,
+		     (struct sockaddr *)&server_addr, sizeof(server_addr));
+	for (int i = 0; i < MMSG_COUNT; i++) {
+		iov[i].iov_base = &TEST_STR2[i];
+		iov[i].iov_len = len[i];
+	}
+
+	rv = sendmmsg(client_sock, msgvec, MMSG_COUNT, 0);
+	zassert_equal(rv, MMSG_COUNT, "sendmmsg failed (%d)", errno);
+	for (int i = 0; i < MMSG_COUNT; i++) {
+		zassert_equal(msgvec[i].msg_len, len[i],
+			      "wrong msg_len of message %d", i);
+	}
+
+	/* One message more than was sent */
+	for (int i = 0; i <= MMSG_COUNT; i++) {
+		iov[i].iov_base = &rx_buf[i * 100];
+		iov[i].iov_len = 100;
+	}
+	memset(rx_buf, 0, sizeof(rx_buf));
+	mmsg_prepare(msgvec, iov, MMSG_COUNT + 1, NULL, 0);
+	for (int i = 0; i <= MMSG_COUNT; i++) {
+		msgvec[i].msg_hdr.msg_name = &addr[i];
+		msgvec[i].msg_hdr.msg_namelen = sizeof(addr[i]);
+	}
+
+	/* Only the first message waits, let all of them arrive */
+	k_sleep(WAIT_TIME);
+
+	rv = recvmmsg(server_sock, msgvec, MMSG_COUNT + 1, 0);
+	zassert_equal(rv, MMSG_COUNT, "recvmmsg failed (%d)", errno);
+	for (int i = 0; i < MMSG_COUNT; i++) {
+		zassert_equal(msgvec[i].msg_len, len[i],
+			      "wrong msg_len of message %d", i);
+		zassert_mem_equal(&rx_buf[i * 100], &TEST_STR2[i], len[i],
+				  "invalid rx data of message %d", i);
+		zassert_equal(msgvec[i].msg_hdr.msg_namelen, sizeof(addr[i]),
+			      "unexpected addrlen");
+		zassert_equal(addr[i].sin_port, client_addr.sin_port,
+			      "unexpected source port");
+	}
+	zassert_equal(msgvec[MMSG_COUNT].msg_len, UINT_MAX,
+		      "msg_len set for a message not received");
+
+	/* Nothing queued */
+	rv = recvmmsg(server_sock, msgvec, MMSG_COUNT, ZSOCK_MSG_DONTWAIT);
+	zassert_equal(rv, -1, "unexpected data");
+	zassert_equal(errno, EAGAIN, "unexpected errno");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+/* A batch stops at the first message which fails. The messages before
+ * it are counted and have their msg_len set; the failure itself is
+ * reported, with errno, by a call starting at the failed message.
+ */
+void test_v4_sendmmsg_recvmmsg_partial(void)
+{
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct mmsghdr msgvec[MMSG_COUNT];
+	struct iovec iov[MMSG_COUNT];
+	int rv;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	rv = bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "server bind failed");
+
+	mmsg_prepare(msgvec, iov, MMSG_COUNT,
+		     (struct sockaddr *)&server_addr, sizeof(server_addr));
+	for (int i = 0; i < MMSG_COUNT; i++) {
+		iov[i].iov_base = TEST_STR_SMALL;
+		iov[i].iov_len = STRLEN(TEST_STR_SMALL);
+	}
+
+	/* No destination for the second message */
+	msgvec[1].msg_hdr.msg_name = NULL;
+	msgvec[1].msg_hdr.msg_namelen = 0;
+
+	rv = sendmmsg(client_sock, msgvec, MMSG_COUNT, 0);
+	zassert_equal(rv, 1, "partial batch not counted");
+	zassert_equal(msgvec[0].msg_len, STRLEN(TEST_STR_SMALL),
+		      "wrong msg_len");
+	zassert_equal(msgvec[1].msg_len, UINT_MAX,
+		      "msg_len set for a failed message");
+	zassert_equal(msgvec[2].msg_len, UINT_MAX,
+		      "msg_len set for a message not sent");
+
+	rv = sendmmsg(client_sock, &msgvec[1], MMSG_COUNT - 1, 0);
+	zassert_equal(rv, -1, "failed message sent");
+	zassert_equal(errno, EDESTADDRREQ, "unexpected errno");
+
+	/* The second message of the receive batch is malformed */
+	mmsg_prepare(msgvec, iov, MMSG_COUNT, NULL, 0);
+	for (int i = 0; i < MMSG_COUNT; i++) {
+		iov[i].iov_base = &rx_buf[i * 100];
+		iov[i].iov_len = 100;
+	}
+	msgvec[1].msg_hdr.msg_iovlen = 2;
+
+	rv = sendto(client_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0,
+		    (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(rv, STRLEN(TEST_STR_SMALL), "sendto failed");
+
+	rv = recvmmsg(server_sock, msgvec, MMSG_COUNT, 0);
+	zassert_equal(rv, 1, "partial batch not counted");
+	zassert_equal(msgvec[0].msg_len, STRLEN(TEST_STR_SMALL),
+		      "wrong msg_len");
+	zassert_equal(msgvec[1].msg_len, UINT_MAX,
+		      "msg_len set for a failed message");
+
+	rv = recvmmsg(server_sock, &msgvec[1], MMSG_COUNT - 1, 0);
+	zassert_equal(rv, -1, "malformed message received");
+	zassert_equal(errno, EINVAL, "unexpected errno");
+
+	/* The datagram the failed message did not take is still there */
+	msgvec[1].msg_hdr.msg_iovlen = 1;
+	rv = recvmmsg(server_sock, &msgvec[1], MMSG_COUNT - 1, 0);
+	zassert_equal(rv, 1, "queued datagram lost");
+	zassert_equal(msgvec[1].msg_len, STRLEN(TEST_STR_SMALL),
+		      "wrong msg_len");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+#define SEGMENT_LEN 100
+
+/* A send larger than the UDP_SEGMENT size is split into datagrams of
+ * that size, the last one holding what is left, and a send of one
+ * segment goes out as it is. A segment size leaving no room for the
+ * headers in the MTU is refused when sending.
+ */
+void test_v4_udp_segment(void)
+{
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	static char big[NET_ETH_MTU + 1];
+	struct mmsghdr msgvec[4];
+	struct iovec iov[4];
+	socklen_t optlen = sizeof(int);
+	int segment;
+	int rv;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	rv = bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "server bind failed");
+
+	segment = -1;
+	rv = setsockopt(client_sock, IPPROTO_UDP, UDP_SEGMENT, &segment,
+			sizeof(segment));
+	zassert_equal(rv, -1, "negative segment size accepted");
+	zassert_equal(errno, EINVAL, "unexpected errno");
+
+	segment = SEGMENT_LEN;
+	rv = setsockopt(client_sock, IPPROTO_UDP, UDP_SEGMENT, &segment,
+			sizeof(segment));
+	zassert_equal(rv, 0, "setsockopt failed (%d)", errno);
+
+	segment = 0;
+	rv = getsockopt(client_sock, IPPROTO_UDP, UDP_SEGMENT, &segment,
+			&optlen);
+	zassert_equal(rv, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(segment, SEGMENT_LEN, "wrong segment size");
+
+	/* Two whole segments and a short one */
+	rv = sendto(client_sock, TEST_STR2, 2 * SEGMENT_LEN + 50, 0,
+		    (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(rv, 2 * SEGMENT_LEN + 50, "sendto failed (%d)", errno);
+
+	for (int i = 0; i < ARRAY_SIZE(iov); i++) {
+		iov[i].iov_base = &rx_buf[i * SEGMENT_LEN];
+		iov[i].iov_len = SEGMENT_LEN;
+	}
+	memset(rx_buf, 0, sizeof(rx_buf));
+	mmsg_prepare(msgvec, iov, ARRAY_SIZE(msgvec), NULL, 0);
+
+	k_sleep(WAIT_TIME);
+	rv = recvmmsg(server_sock, msgvec, ARRAY_SIZE(msgvec), 0);
+	zassert_equal(rv, 3, "wrong number of datagrams (%d)", rv);
+	zassert_equal(msgvec[0].msg_len, SEGMENT_LEN, "wrong segment");
+	zassert_equal(msgvec[1].msg_len, SEGMENT_LEN, "wrong segment");
+	zassert_equal(msgvec[2].msg_len, 50, "wrong last segment");
+	zassert_mem_equal(rx_buf, TEST_STR2, 2 * SEGMENT_LEN + 50,
+			  "invalid rx data");
+
+	/* Exactly one segment */
+	rv = sendto(client_sock, TEST_STR2, SEGMENT_LEN, 0,
+		    (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(rv, SEGMENT_LEN, "sendto failed (%d)", errno);
+
+	rv = recv(server_sock, rx_buf, sizeof(rx_buf), 0);
+	zassert_equal(rv, SEGMENT_LEN, "datagram split");
+
+	/* A segment and a byte */
+	rv = sendto(client_sock, TEST_STR2, SEGMENT_LEN + 1, 0,
+		    (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(rv, SEGMENT_LEN + 1, "sendto failed (%d)", errno);
+
+	memset(rx_buf, 0, sizeof(rx_buf));
+	mmsg_prepare(msgvec, iov, ARRAY_SIZE(msgvec), NULL, 0);
+
+	k_sleep(WAIT_TIME);
+	rv = recvmmsg(server_sock, msgvec, ARRAY_SIZE(msgvec), 0);
+	zassert_equal(rv, 2, "wrong number of datagrams (%d)", rv);
+	zassert_equal(msgvec[0].msg_len, SEGMENT_LEN, "wrong segment");
+	zassert_equal(msgvec[1].msg_len, 1, "wrong last segment");
+	zassert_equal(rx_buf[SEGMENT_LEN], TEST_STR2[SEGMENT_LEN],
+		      "invalid rx data");
+
+	/* No room left for the headers */
+	segment = NET_ETH_MTU;
+	rv = setsockopt(client_sock, IPPROTO_UDP, UDP_SEGMENT, &segment,
+			sizeof(segment));
+	zassert_equal(rv, 0, "setsockopt failed (%d)", errno);
+
+	rv = sendto(client_sock, big, sizeof(big), 0,
+		    (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(rv, -1, "oversized segment sent");
+	zassert_equal(errno, EINVAL, "unexpected errno");
+
+	rv = recv(server_sock, rx_buf, sizeof(rx_buf), ZSOCK_MSG_DONTWAIT);
+	zassert_equal(rv, -1, "data sent on error");
+	zassert_equal(errno, EAGAIN, "unexpected errno");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
 void test_main(void)
 {
 	k_thread_system_pool_assign(k_current_get());
@@ -1242,7 +1753,13 @@ void test_main(void)
 			 ztest_unit_test(test_v6_sendmsg_with_txtime),
 			 ztest_user_unit_test(test_v6_sendmsg_with_txtime),
 			 ztest_unit_test(test_v4_msg_trunc),
-			 ztest_unit_test(test_v6_msg_trunc)
+			 ztest_unit_test(test_v6_msg_trunc),
+			 ztest_unit_test(test_v4_send_buf_recv_buf),
+			 ztest_unit_test(test_v4_send_buf_errors),
+			 ztest_unit_test(test_v4_net_context_send_buf),
+			 ztest_unit_test(test_v4_sendmmsg_recvmmsg),
+			 ztest_unit_test(test_v4_sendmmsg_recvmmsg_partial),
+			 ztest_unit_test(test_v4_udp_segment)
 		);
 
 	ztest_run_test_suite(socket_udp);
@@ -125,6 +125,9 @@ static void handle_syn_resend(void);
 static void handle_client_fin_wait_2_test(sa_family_t af, struct tcphdr *th);
 static void handle_client_closing_test(sa_family_t af, struct tcphdr *th);
 static void handle_server_recv_out_of_order(struct net_pkt *pkt);
+static void handle_client_sack_reneging(struct net_pkt *pkt,
+					struct tcphdr *th);
+static void handle_server_sack(struct net_pkt *pkt, struct tcphdr *th);
 
 static void verify_flags(struct tcphdr *th, uint8_t flags,
 			 const char *fun, int line)
@@ -213,6 +216,10 @@ static uint8_t tcp_options[20] = {
 	0x01, /* NOP */
 	0x03, 0x03, 0x07 /* Win scale*/ };
 
+/* Options for the tester to add to the segments it sends, if set */
+static const uint8_t *test_opts;
+static size_t test_opts_len;
+
 static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 					      uint16_t src_port,
 					      uint16_t dst_port,
@@ -221,12 +228,14 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 					      size_t len)
 {
 	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
+	const uint8_t *opts = test_opts;
 	struct net_pkt *pkt;
 	struct tcphdr *th;
-	uint8_t opts_len = 0;
+	uint8_t opts_len = test_opts_len;
 	int ret = -EINVAL;
 
 	if ((test_case_no == 4U) && (flags & SYN)) {
+		opts = tcp_options;
 		opts_len = sizeof(tcp_options);
 	}
 
@@ -262,11 +271,7 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 	th->th_sport = src_port;
 	th->th_dport = dst_port;
 
-	if ((test_case_no == 4U) && (flags & SYN)) {
-		th->th_off = 10U;
-	} else {
-		th->th_off = 5U;
-	}
+	th->th_off = 5U + opts_len / 4U;
 
 	th->th_flags = flags;
 	th->th_win = NET_IPV6_MTU;
@@ -281,9 +286,9 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 		goto fail;
 	}
 
-	if ((test_case_no == 4U) && (flags & SYN)) {
+	if (opts_len) {
 		/* Add TCP Options */
-		ret = net_pkt_write(pkt, tcp_options, opts_len);
+		ret = net_pkt_write(pkt, opts, opts_len);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -388,6 +393,55 @@ fail:
 	return -EINVAL;
 }
 
+static size_t read_data_len(struct net_pkt *pkt, struct tcphdr *th)
+{
+	return net_pkt_get_len(pkt) - net_pkt_ip_hdr_len(pkt) -
+		net_pkt_ip_opts_len(pkt) - th->th_off * 4U;
+}
+
+/* Returns the number of SACK blocks found in the options */
+static int read_sack_blocks(struct net_pkt *pkt, struct tcphdr *th,
+			    struct tcp_sack_block *blocks)
+{
+	uint8_t opts[40];
+	size_t len = th->th_off * 4U - sizeof(struct tcphdr);
+	int count = 0;
+	size_t i;
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	if (net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) +
+			 net_pkt_ip_opts_len(pkt) + sizeof(struct tcphdr)) ||
+	    net_pkt_read(pkt, opts, len)) {
+		zassert_true(false, "Cannot read TCP options");
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	for (i = 0; i < len && opts[i] != TCPOPT_END; ) {
+		if (opts[i] == TCPOPT_NOP) {
+			i++;
+			continue;
+		}
+
+		if (opts[i] == TCPOPT_SACK) {
+			count = (opts[i + 1] - 2) / 8;
+
+			for (int j = 0; j < count; j++) {
+				blocks[j].start = ntohl(UNALIGNED_GET(
+					(uint32_t *)&opts[i + 2 + j * 8]));
+				blocks[j].end = ntohl(UNALIGNED_GET(
+					(uint32_t *)&opts[i + 6 + j * 8]));
+			}
+		}
+
+		i += opts[i + 1];
+	}
+
+	return count;
+}
+
 static int tester_send(const struct device *dev, struct net_pkt *pkt)
 {
 	struct tcphdr th;
@@ -420,6 +474,12 @@ static int tester_send(const struct device *dev, struct net_pkt *pkt)
 	case 9:
 		handle_server_recv_out_of_order(pkt);
 		break;
+	case 10:
+		handle_client_sack_reneging(pkt, &th);
+		break;
+	case 11:
+		handle_server_sack(pkt, &th);
+		break;
 	default:
 		zassert_true(false, "Undefined test case");
 	}
@@ -648,7 +708,7 @@ static void handle_server_test(sa_family_t af, struct tcphdr *th)
 	case T_SYN_ACK:
 		test_verify_flags(th, SYN | ACK);
 		seq++;
-		ack = ntohs(th->th_seq) + 1U;
+		ack = ntohl(th->th_seq) + 1U;
 		reply = prepare_ack_packet(af, htons(MY_PORT),
 					   htons(PEER_PORT));
 		t_state = T_DATA;
@@ -1484,6 +1544,235 @@ static void test_server_timeout_out_of_order_data(void)
 	net_tcp_put(ooo_ctx);
 }
 
+static const uint8_t sack_perm_opts[] = {
+	TCPOPT_NOP, TCPOPT_NOP, TCPOPT_SACK_PERM, 2
+};
+
+/* The tester advertises a small window, the data fits in one segment */
+#define SACK_DATA_LEN 4
+#define SACK_HOLE_LEN 1
+
+static void handle_client_sack_reneging(struct net_pkt *pkt,
+					struct tcphdr *th)
+{
+	sa_family_t af = net_pkt_family(pkt);
+	uint8_t sack_opts[12] = { TCPOPT_NOP, TCPOPT_NOP, TCPOPT_SACK, 10 };
+	struct net_pkt *reply;
+	int ret;
+
+	switch (t_state) {
+	case T_SYN:
+		test_verify_flags(th, SYN);
+		zassert_true(th->th_off > 5U, "SACK not offered");
+		seq = 0U;
+		ack = ntohl(th->th_seq) + 1U;
+		test_opts = sack_perm_opts;
+		test_opts_len = sizeof(sack_perm_opts);
+		reply = prepare_syn_ack_packet(af, htons(MY_PORT),
+					       th->th_sport);
+		test_opts_len = 0;
+		t_state = T_SYN_ACK;
+		break;
+	case T_SYN_ACK:
+		test_verify_flags(th, ACK);
+		seq++;
+		t_state = T_DATA;
+		test_sem_give();
+		return;
+	case T_DATA:
+		/* Report all but the start of the data as received */
+		test_verify_flags(th, PSH | ACK);
+		zassert_equal(ntohl(th->th_seq), ack, NULL);
+		zassert_equal(read_data_len(pkt, th), SACK_DATA_LEN, NULL);
+		UNALIGNED_PUT(htonl(ack + SACK_HOLE_LEN),
+			      (uint32_t *)&sack_opts[4]);
+		UNALIGNED_PUT(htonl(ack + SACK_DATA_LEN),
+			      (uint32_t *)&sack_opts[8]);
+		test_opts = sack_opts;
+		test_opts_len = sizeof(sack_opts);
+		reply = prepare_ack_packet(af, htons(MY_PORT), th->th_sport);
+		test_opts_len = 0;
+		t_state = T_DATA_ACK;
+		break;
+	case T_DATA_ACK:
+		/* Then drop what was reported, the retransmission after the
+		 * timeout has to carry it again
+		 */
+		test_verify_flags(th, PSH | ACK);
+		zassert_equal(ntohl(th->th_seq), ack, NULL);
+		zassert_equal(read_data_len(pkt, th), SACK_DATA_LEN,
+			      "SACKed data not retransmitted");
+		ack += SACK_DATA_LEN;
+		reply = prepare_ack_packet(af, htons(MY_PORT), th->th_sport);
+		t_state = T_FIN;
+		test_sem_give();
+		break;
+	case T_FIN:
+		test_verify_flags(th, FIN | ACK);
+		ack = ntohl(th->th_seq) + 1U;
+		reply = prepare_fin_ack_packet(af, htons(MY_PORT),
+					       th->th_sport);
+		t_state = T_FIN_ACK;
+		break;
+	case T_FIN_ACK:
+		test_verify_flags(th, ACK);
+		test_sem_give();
+		return;
+	default:
+		zassert_true(false, "%s unexpected state", __func__);
+		return;
+	}
+
+	ret = net_recv_data(iface, reply);
+	if (ret < 0) {
+		zassert_true(false, "%s failed", __func__);
+	}
+}
+
+/* Test case scenario IPv4, SACK enabled
+ *   send SYN,
+ *   expect SYN ACK offering SACK,
+ *   send ACK,
+ *   send Data,
+ *   expect ACK with SACK for all but the first byte,
+ *   expect Data retransmitted whole after the timeout,
+ *   send FIN,
+ *   expect FIN ACK,
+ *   send ACK.
+ *   any failures cause test case to fail.
+ */
+static void test_client_sack_reneging(void)
+{
+	struct net_context *ctx;
+	int ret;
+
+	if (!IS_ENABLED(CONFIG_NET_TCP_SACK)) {
+		return;
+	}
+
+	t_state = T_SYN;
+	test_case_no = 10;
+	seq = ack = 0;
+
+	ret = net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP, &ctx);
+	if (ret < 0) {
+		zassert_true(false, "Failed to get net_context");
+	}
+
+	net_context_ref(ctx);
+
+	ret = net_context_connect(ctx, (struct sockaddr *)&peer_addr_s,
+				  sizeof(struct sockaddr_in),
+				  NULL,
+				  K_MSEC(100), NULL);
+	if (ret < 0) {
+		zassert_true(false, "Failed to connect to peer");
+	}
+
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	ret = net_context_send(ctx, lorem_ipsum, SACK_DATA_LEN, NULL,
+			       K_NO_WAIT, NULL);
+	if (ret < 0) {
+		zassert_true(false, "Failed to send data to peer");
+	}
+
+	/* Peer will release the semaphore after the retransmission */
+	test_sem_take(K_MSEC(CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT * 2),
+		      __LINE__);
+
+	net_tcp_put(ctx);
+
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	k_sleep(K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY));
+}
+
+static uint32_t sack_ack;
+static struct tcp_sack_block sack_blocks[TCP_SACK_BLOCKS];
+static int sack_count;
+
+static void handle_server_sack(struct net_pkt *pkt, struct tcphdr *th)
+{
+	sack_ack = ntohl(th->th_ack);
+	sack_count = read_sack_blocks(pkt, th, sack_blocks);
+
+	test_sem_give();
+}
+
+static void send_server_sack_data(uint32_t offset, size_t len)
+{
+	struct net_pkt *pkt;
+	int ret;
+
+	seq = offset;
+	pkt = prepare_data_packet(AF_INET6, htons(MY_PORT), htons(PEER_PORT),
+				  &lorem_ipsum[offset], len);
+	zassert_not_null(pkt, "Cannot create pkt");
+
+	ret = net_recv_data(iface, pkt);
+	zassert_true(ret == 0, "recv data failed (%d)", ret);
+
+	test_sem_take(K_MSEC(100), __LINE__);
+}
+
+static void check_server_sack(uint32_t expected_ack,
+			      const struct tcp_sack_block *expected, int count)
+{
+	zassert_equal(sack_ack, expected_ack, "Expected ACK %u but got %u",
+		      expected_ack, sack_ack);
+	zassert_equal(sack_count, count, "Expected %d SACK blocks, got %d",
+		      count, sack_count);
+
+	for (int i = 0; i < count; i++) {
+		zassert_equal(sack_blocks[i].start, expected[i].start,
+			      "Block %d starts at %u", i, sack_blocks[i].start);
+		zassert_equal(sack_blocks[i].end, expected[i].end,
+			      "Block %d ends at %u", i, sack_blocks[i].end);
+	}
+}
+
+/* Out-of-order data around holes is reported with a SACK block per
+ * contiguous range, the range received last first, and each range is
+ * passed on once the data before it has arrived.
+ */
+static void test_server_sack_blocks(void)
+{
+	struct net_context *ctx;
+
+	if (!IS_ENABLED(CONFIG_NET_TCP_SACK) ||
+	    CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT == 0) {
+		return;
+	}
+
+	k_sem_reset(&test_sem);
+
+	test_opts = sack_perm_opts;
+	test_opts_len = sizeof(sack_perm_opts);
+	ctx = create_server_socket(0, 0);
+	test_opts_len = 0;
+
+	/* The data starts at sequence number 1 */
+	test_case_no = 11;
+
+	send_server_sack_data(21, 10);
+	check_server_sack(1, (struct tcp_sack_block[]) {
+			{ 21, 31 } }, 1);
+
+	send_server_sack_data(41, 10);
+	check_server_sack(1, (struct tcp_sack_block[]) {
+			{ 41, 51 }, { 21, 31 } }, 2);
+
+	send_server_sack_data(1, 20);
+	check_server_sack(31, (struct tcp_sack_block[]) {
+			{ 41, 51 } }, 1);
+
+	send_server_sack_data(31, 10);
+	check_server_sack(51, NULL, 0);
+
+	net_tcp_put(ctx);
+}
+
 /** Test case main entry */
 void test_main(void)
 {
@@ -1499,7 +1788,9 @@ void test_main(void)
 			 ztest_unit_test(test_client_closing_ipv6),
 			 ztest_unit_test(test_client_invalid_rst),
 			 ztest_unit_test(test_server_recv_out_of_order_data),
-			 ztest_unit_test(test_server_timeout_out_of_order_data)
+			 ztest_unit_test(test_server_timeout_out_of_order_data),
+			 ztest_unit_test(test_client_sack_reneging),
+			 ztest_unit_test(test_server_sack_blocks)
 			 );
 
 	ztest_run_test_suite(test_tcp_fn);
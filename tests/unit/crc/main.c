@@ -11,6 +11,8 @@
 #include "../../../lib/os/crc32_sw.c"
 #include "../../../lib/os/crc32c_sw.c"
 #include "../../../lib/os/crc7_sw.c"
+#include "../../../lib/os/crc32_engine.c"
+#include "../../../lib/os/crc_tables.c"
 
 void test_crc32c(void)
 {
@@ -229,6 +231,128 @@ void test_crc8(void)
 	zassert_equal(fcs, expected, "0x%02x vs 0x%02x", fcs, expected);
 }
 
+/* Bit at a time versions of the CRCs, to check the tables against */
+static uint32_t crc32_reflected_bitwise(uint32_t poly, uint32_t crc,
+					const uint8_t *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		crc ^= data[i];
+
+		for (int b = 0; b < 8; b++) {
+			crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+		}
+	}
+
+	return crc;
+}
+
+static uint16_t crc16_bitwise(bool reflected, uint16_t crc,
+			      const uint8_t *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		crc ^= reflected ? data[i] : data[i] << 8;
+
+		for (int b = 0; b < 8; b++) {
+			if (reflected) {
+				crc = (crc & 1) ? (crc >> 1) ^ 0x8408 : crc >> 1;
+			} else {
+				crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 :
+				      crc << 1;
+			}
+		}
+	}
+
+	return crc;
+}
+
+static uint8_t crc_test_data[300];
+
+static void fill_test_data(void)
+{
+	uint32_t x = 0x12345678;
+
+	for (size_t i = 0; i < sizeof(crc_test_data); i++) {
+		x = x * 1103515245U + 12345U;
+		crc_test_data[i] = x >> 16;
+	}
+}
+
+/* Every start alignment and every tail length of the tables, and of
+ * the CRC instructions when they are used.
+ */
+void test_crc_lengths(void)
+{
+	fill_test_data();
+
+	for (size_t off = 0; off < 8; off++) {
+		for (size_t len = 0; len < 100; len++) {
+			const uint8_t *data = crc_test_data + off;
+
+			zassert_equal(crc32_ieee(data, len),
+				      ~crc32_reflected_bitwise(0xedb88320,
+							       ~0U, data, len),
+				      "crc32_ieee at %zu len %zu", off, len);
+			zassert_equal(crc32_c(0, data, len, true, true),
+				      ~crc32_reflected_bitwise(0x82f63b78,
+							       ~0U, data, len),
+				      "crc32_c at %zu len %zu", off, len);
+			zassert_equal(crc16_ccitt(0xffff, data, len),
+				      crc16_bitwise(true, 0xffff, data, len),
+				      "crc16_ccitt at %zu len %zu", off, len);
+			zassert_equal(crc16_itu_t(0xffff, data, len),
+				      crc16_bitwise(false, 0xffff, data, len),
+				      "crc16_itu_t at %zu len %zu", off, len);
+			zassert_equal(crc8_ccitt(0xff, data, len),
+				      crc8(data, len, 0x07, 0xff, false),
+				      "crc8_ccitt at %zu len %zu", off, len);
+		}
+	}
+}
+
+#if defined(CONFIG_CRC_HW_HOOK)
+static int hw_calls;
+
+static uint32_t hw_crc32_ieee(uint32_t crc, const uint8_t *data, size_t len)
+{
+	hw_calls++;
+
+	return crc32_reflected_bitwise(0xedb88320, crc, data, len);
+}
+
+static const struct crc_hw_api hw_api = {
+	.crc32_ieee = hw_crc32_ieee,
+	.min_len = 16,
+};
+#endif
+
+void test_crc_hw_hook(void)
+{
+#if defined(CONFIG_CRC_HW_HOOK)
+	uint8_t test2[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+
+	fill_test_data();
+	crc_hw_register(&hw_api);
+
+	/* Too short for the unit, and not supported by it */
+	zassert_equal(crc32_ieee(test2, sizeof(test2)), 0xCBF43926, NULL);
+	zassert_equal(crc32_c(0, test2, sizeof(test2), true, true),
+		      0xE3069283, NULL);
+	zassert_equal(crc32_c(0, crc_test_data, 64, true, true),
+		      ~crc32_reflected_bitwise(0x82f63b78, ~0U,
+					       crc_test_data, 64), NULL);
+	zassert_equal(hw_calls, 0, "CRC unit called");
+
+	/* Streams mixing both sides of the threshold */
+	zassert_equal(crc32_ieee_update(crc32_ieee(crc_test_data, 64),
+					crc_test_data + 64, 3),
+		      crc32_ieee_update(crc32_ieee(crc_test_data, 3),
+					crc_test_data + 3, 64), NULL);
+	zassert_equal(hw_calls, 2, "CRC unit not called");
+
+	crc_hw_register(NULL);
+#endif
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_crc,
@@ -241,6 +365,8 @@ void test_main(void)
 			 ztest_unit_test(test_crc16_itu_t),
 			 ztest_unit_test(test_crc8_ccitt),
 			 ztest_unit_test(test_crc7_be),
-			 ztest_unit_test(test_crc8));
+			 ztest_unit_test(test_crc8),
+			 ztest_unit_test(test_crc_lengths),
+			 ztest_unit_test(test_crc_hw_hook));
 	ztest_run_test_suite(test_crc);
 }